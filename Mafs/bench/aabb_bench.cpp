@@ -0,0 +1,67 @@
+#include "bench.hpp"
+#include "../include/mafs/aabb.hpp"
+#include <random>
+#include <vector>
+
+template<size_t W>
+void run_packets(const std::vector<mafs::aabb3f>& boxes, const std::vector<mafs::rayf>& rays, const mafs::aabb3f& query) {
+    using namespace mafs;
+    const std::vector<aabb_packet<W>> packets = pack_aabbs<W>(std::span<const aabb3f>(boxes));
+    std::vector<uint32_t> masks(packets.size());
+    const std::string name = "aabb_packet<" + std::to_string(W) + ">";
+    double ms = bench::time_ms([&] {
+        for (const rayf& r : rays)
+            intersect(std::span<const aabb_packet<W>>(packets), r, 1e30f, std::span(masks));
+        bench::do_not_optimize(masks);
+    });
+    bench::report("  ray, " + name, ms, double(boxes.size() * rays.size()), "tests");
+    ms = bench::time_ms([&] {
+        overlaps(std::span<const aabb_packet<W>>(packets), query, std::span(masks));
+        bench::do_not_optimize(masks);
+    });
+    bench::report("  box, " + name, ms, double(boxes.size()), "tests");
+}
+
+int main() {
+    using namespace mafs;
+    constexpr size_t box_count = 1 << 18;
+    constexpr size_t ray_count = 16;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f), size(0.1f, 2.0f);
+    std::normal_distribution<float> dir;
+    std::vector<aabb3f> boxes(box_count);
+    for (aabb3f& b : boxes)
+        b = aabb3f::from_center_extents(vec3f{ pos(rng), pos(rng), pos(rng) }, vec3f{ size(rng), size(rng), size(rng) });
+    std::vector<rayf> rays;
+    for (size_t i = 0; i < ray_count; i++)
+        rays.emplace_back(vec3f{ pos(rng), pos(rng), pos(rng) }, vec3f{ dir(rng), dir(rng), dir(rng) });
+    const aabb3f query = aabb3f::from_center_extents(vec3f(0.0f), vec3f(20.0f));
+
+    std::cout << box_count << " boxes" << std::endl;
+    std::vector<uint8_t> hits(box_count);
+    double ms = bench::time_ms([&] {
+        for (const rayf& r : rays)
+            for (size_t i = 0; i < box_count; i++)
+                hits[i] = boxes[i].intersects(r, 1e30f);
+        bench::do_not_optimize(hits);
+    });
+    bench::report("  ray, scalar", ms, double(box_count * ray_count), "tests");
+    ms = bench::time_ms([&] {
+        for (size_t i = 0; i < box_count; i++)
+            hits[i] = boxes[i].overlaps(query);
+        bench::do_not_optimize(hits);
+    });
+    bench::report("  box, scalar", ms, double(box_count), "tests");
+    run_packets<8>(boxes, rays, query);
+    run_packets<4>(boxes, rays, query);
+
+    const mat4f m{ vec4f{ 0.8f, 0.6f, 0.0f, 0.0f }, vec4f{ -0.6f, 0.8f, 0.0f, 0.0f }, vec4f{ 0.0f, 0.0f, 1.0f, 0.0f }, vec4f{ 1.0f, 2.0f, 3.0f, 1.0f } };
+    std::vector<aabb3f> moved(box_count);
+    ms = bench::time_ms([&] {
+        for (size_t i = 0; i < box_count; i++)
+            moved[i] = boxes[i].transform(m);
+        bench::do_not_optimize(moved);
+    });
+    bench::report("  transform (Arvo)", ms, double(box_count), "boxes");
+    return 0;
+}
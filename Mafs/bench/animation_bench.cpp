@@ -0,0 +1,76 @@
+#include "bench.hpp"
+#include "../include/mafs/animation.hpp"
+#include <algorithm>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    constexpr size_t track_count = 100000;
+    constexpr size_t key_count = 32;
+    constexpr int frames = 16;
+    constexpr float frame_time = 1.0f / 60.0f;
+
+    std::vector<float> times(key_count);
+    std::vector<vec3f> values(key_count), tangents(key_count);
+    std::vector<quatf> rotations(key_count);
+    for (size_t k = 0; k < key_count; k++) {
+        times[k] = float(k) * 0.1f;
+        values[k] = vec3f{ float(k), float(k % 3), -float(k) };
+        tangents[k] = vec3f{ 1.0f, 0.0f, -1.0f };
+        rotations[k] = quatf::from_axis_angle(vec3f{ 0.0f, 1.0f, 0.0f }, float(k) * 0.3f);
+    }
+    vec3_tracks linear, hermite(interpolation::hermite);
+    quat_tracks nlerp_tracks, slerp_tracks(quat_interpolation::slerp);
+    for (size_t i = 0; i < track_count; i++) {
+        linear.add(times, values);
+        hermite.add(times, values, tangents, tangents);
+        nlerp_tracks.add(times, rotations);
+        slerp_tracks.add(times, rotations);
+    }
+    std::vector<vec3f> out(track_count);
+    std::vector<quatf> qout(track_count);
+
+    // Reference: per-track array-of-structs keys, binary search and scalar lerp.
+    struct key { float time; vec3f value; };
+    std::vector<key> aos(track_count * key_count);
+    for (size_t i = 0; i < track_count; i++)
+        for (size_t k = 0; k < key_count; k++)
+            aos[i * key_count + k] = key{ times[k], values[k] };
+    double scalar = bench::time_ms([&] {
+        for (int f = 0; f < frames; f++) {
+            const float t = 1.0f + float(f) * frame_time;
+            for (size_t i = 0; i < track_count; i++) {
+                const key* keys = &aos[i * key_count];
+                const key* next = std::upper_bound(keys, keys + key_count, t, [](float v, const key& k) { return v < k.time; });
+                const key* prev = next - 1;
+                const float u = (t - prev->time) / (next->time - prev->time);
+                out[i] = prev->value.lerp(next->value, u);
+            }
+            bench::do_not_optimize(out);
+        }
+    }) / frames;
+    bench::report("binary search + lerp", scalar, double(track_count), "tracks");
+
+    auto run = [&](const char* name, auto&& sample) {
+        double ms = bench::time_ms([&] {
+            for (int f = 0; f < frames; f++)
+                sample(1.0f + float(f) * frame_time);
+        }) / frames;
+        bench::report(name, ms, double(track_count), "tracks");
+    };
+    run("vec3 linear", [&](float t) { linear.sample(t, std::span(out)); bench::do_not_optimize(out); });
+    run("vec3 hermite", [&](float t) { hermite.sample(t, std::span(out)); bench::do_not_optimize(out); });
+    run("quat nlerp", [&](float t) { nlerp_tracks.sample(t, std::span(qout)); bench::do_not_optimize(qout); });
+    run("quat slerp", [&](float t) { slerp_tracks.sample(t, std::span(qout)); bench::do_not_optimize(qout); });
+
+    std::vector<vec3f> blended(track_count);
+    std::vector<quatf> qblended(track_count);
+    double blend = bench::time_ms([&] {
+        blend_poses(std::span<const vec3f>(out), std::span<const vec3f>(out), 0.5f, std::span(blended));
+        blend_poses(std::span<const quatf>(qout), std::span<const quatf>(qout), 0.5f, std::span(qblended));
+        bench::do_not_optimize(blended);
+        bench::do_not_optimize(qblended);
+    });
+    bench::report("blend vec3 + quat poses", blend, double(track_count), "joints");
+    return 0;
+}
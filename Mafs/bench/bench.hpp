@@ -0,0 +1,44 @@
+#pragma once
+#include <chrono>
+#include <iostream>
+#include <string>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace mafs::bench {
+
+    // Keeps the optimizer from discarding a computed value.
+    template<typename T>
+    void do_not_optimize(const T& value) {
+#if defined(_MSC_VER)
+        static volatile const void* sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r"(&value) : "memory");
+#endif
+    }
+
+    // Runs fn `reps` times and returns the best wall time of a single run in milliseconds.
+    template<typename F>
+    double time_ms(F&& fn, int reps = 5) {
+        double best = 1e300;
+        for (int i = 0; i < reps; i++) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            auto stop = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+            best = ms < best ? ms : best;
+        }
+        return best;
+    }
+
+    inline void report(const std::string& name, double ms, double items = 0.0, const std::string& unit = "items") {
+        std::cout << name << ": " << ms << " ms";
+        if (items > 0.0)
+            std::cout << " (" << items / (ms * 1e3) << " M" << unit << "/s)";
+        std::cout << std::endl;
+    }
+
+} // namespace mafs::bench
@@ -0,0 +1,90 @@
+#include "bench.hpp"
+#include "../include/mafs/bvh.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+template<typename Tree>
+void run_queries(const std::string& name, const Tree& tree, const std::vector<mafs::rayf>& rays) {
+    using namespace mafs;
+    size_t hits = 0;
+    double ms = bench::time_ms([&] {
+        hits = 0;
+        for (const rayf& r : rays)
+            hits += bool(tree.intersect(r));
+        bench::do_not_optimize(hits);
+    }, 3);
+    bench::report("  " + name + ", closest hit", ms, double(rays.size()), "rays");
+    ms = bench::time_ms([&] {
+        hits = 0;
+        for (const rayf& r : rays)
+            hits += tree.occluded(r);
+        bench::do_not_optimize(hits);
+    }, 3);
+    bench::report("  " + name + ", any hit", ms, double(rays.size()), "rays");
+}
+
+int main() {
+    using namespace mafs;
+    // A 1024 x 1024 height field: about two million triangles.
+    constexpr uint32_t grid = 1024;
+    std::vector<vec3f> positions;
+    std::vector<uint32_t> indices;
+    positions.reserve((grid + 1) * (grid + 1));
+    for (uint32_t z = 0; z <= grid; z++)
+        for (uint32_t x = 0; x <= grid; x++) {
+            const float fx = float(x) * 0.1f, fz = float(z) * 0.1f;
+            positions.push_back(vec3f{ fx, 2.0f * std::sin(fx * 0.37f) * std::cos(fz * 0.23f) + 0.3f * std::sin(fx * 2.1f + fz * 1.7f), fz });
+        }
+    indices.reserve(size_t(grid) * grid * 6);
+    for (uint32_t z = 0; z < grid; z++)
+        for (uint32_t x = 0; x < grid; x++) {
+            const uint32_t i = z * (grid + 1) + x;
+            indices.insert(indices.end(), { i, i + 1, i + grid + 1, i + 1, i + grid + 2, i + grid + 1 });
+        }
+    const double triangles = double(indices.size() / 3);
+    std::cout << size_t(triangles) << " triangles, " << hardware_threads() << " hardware threads" << std::endl;
+
+    bvh tree;
+    bvh_build_options options;
+    options.threads = 1;
+    double ms = bench::time_ms([&] { tree = bvh::build(positions, indices, options); }, 3);
+    bench::report("  build, 1 thread", ms, triangles, "triangles");
+    options.threads = hardware_threads();
+    ms = bench::time_ms([&] { tree = bvh::build(positions, indices, options); }, 3);
+    bench::report("  build, " + std::to_string(options.threads) + " threads", ms, triangles, "triangles");
+    std::cout << tree.nodes.size() << " nodes" << std::endl;
+
+    bvh4 tree4;
+    ms = bench::time_ms([&] { tree4 = bvh4::from_bvh(tree); }, 3);
+    bench::report("  collapse to bvh4", ms);
+    bvh8 tree8;
+    ms = bench::time_ms([&] { tree8 = bvh8::from_bvh(tree); }, 3);
+    bench::report("  collapse to bvh8", ms);
+
+    // Primary rays of a 512 x 512 pinhole camera are coherent; rays from random points above the
+    // terrain are not, and mostly wait on memory with a tree this size.
+    std::vector<rayf> camera;
+    const vec3f eye{ 10.0f, 12.0f, 10.0f }, forward = vec3f{ 1.0f, -0.35f, 1.0f }.normalize();
+    const vec3f right = forward.cross(vec3f{ 0.0f, 1.0f, 0.0f }).normalize(), up = right.cross(forward);
+    for (int y = 0; y < 512; y++)
+        for (int x = 0; x < 512; x++) {
+            const float u = (float(x) + 0.5f) / 256.0f - 1.0f, v = (float(y) + 0.5f) / 256.0f - 1.0f;
+            camera.emplace_back(eye, (forward + right * (u * 0.7f) + up * (v * 0.7f)).normalize());
+        }
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> pos(0.0f, float(grid) * 0.1f), height(5.0f, 30.0f), dir(-1.0f, 1.0f), down(-1.0f, -0.1f);
+    std::vector<rayf> scattered;
+    for (int i = 0; i < 262144; i++)
+        scattered.emplace_back(vec3f{ pos(rng), height(rng), pos(rng) }, vec3f{ dir(rng), down(rng), dir(rng) }.normalize());
+
+    std::cout << "camera rays" << std::endl;
+    run_queries("binary", tree, camera);
+    run_queries("bvh4", tree4, camera);
+    run_queries("bvh8", tree8, camera);
+    std::cout << "scattered rays" << std::endl;
+    run_queries("binary", tree, scattered);
+    run_queries("bvh4", tree4, scattered);
+    run_queries("bvh8", tree8, scattered);
+    return 0;
+}
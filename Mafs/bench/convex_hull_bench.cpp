@@ -0,0 +1,33 @@
+#include "bench.hpp"
+#include "../include/mafs/convex_hull.hpp"
+#include <random>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    constexpr size_t count = 100000;
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> pos(-1.0f, 1.0f);
+    std::normal_distribution<float> normal;
+    // A scanned-looking blob: most points inside, a few thousand on the hull.
+    std::vector<vec3f> blob(count), shell(count);
+    for (vec3f& p : blob)
+        p = vec3f{ normal(rng) * 2.0f, normal(rng), normal(rng) * 0.5f };
+    // The worst case: every point is a hull vertex.
+    for (vec3f& p : shell)
+        p = vec3f{ normal(rng), normal(rng), normal(rng) }.normalize() * 10.0f;
+    std::cout << count << " points, " << hardware_threads() << " hardware threads" << std::endl;
+
+    convex_hullf hull;
+    for (const auto& [name, points] : { std::pair{ "gaussian blob", &blob }, std::pair{ "sphere surface", &shell } }) {
+        hull.build(*points);
+        std::cout << "  " << name << ": " << hull.vertices.size() << " hull vertices" << std::endl;
+        double ms = bench::time_ms([&] { hull.build(*points, 0, 1); });
+        bench::report(std::string("    hull, 1 thread"), ms, double(count), "points");
+        ms = bench::time_ms([&] { hull.build(*points); });
+        bench::report("    hull, " + std::to_string(hardware_threads()) + " threads", ms, double(count), "points");
+        ms = bench::time_ms([&] { hull.build(*points, 64); });
+        bench::report(std::string("    hull limited to 64 vertices"), ms, double(count), "points");
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "bench.hpp"
+#include "../include/mafs/expr.hpp"
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    constexpr size_t count = 1 << 16;
+    constexpr mat4 flip_y{ {1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f} };
+    constexpr mat4 half = mat4(0.5f);
+
+    mat4 proj = perspective(1.0f, 1.5f, 0.1f, 100.0f);
+    mat4 view = look_at(vec3f{ 3.0f, 2.0f, 5.0f }, vec3f{ 0.0f }, vec3f{ 0.0f, 1.0f, 0.0f });
+    std::vector<mat4> parents(count, mat4::identity());
+    std::vector<mat4> models(count, mat4::identity());
+    std::vector<vec4f> points(count);
+    for (size_t i = 0; i < count; i++) {
+        parents[i][3] = vec4f{ -float(i % 3), float(i % 13), float(i % 2), 1.0f };
+        models[i][3] = vec4f{ float(i % 17), float(i % 5), -float(i % 11), 1.0f };
+        points[i] = vec4f{ float(i % 7) * 0.1f, float(i % 3), 1.0f, 1.0f };
+    }
+    std::vector<vec4f> out(count);
+
+    // Shared prefix: the compiler may hoist proj * view out of the eager loop.
+    double eager = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            out[i] = proj * view * models[i] * points[i];
+        bench::do_not_optimize(out);
+    });
+    bench::report("eager proj * view * model * v", eager, double(count), "vecs");
+    double lazy = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            out[i] = chain(proj) * view * models[i] * points[i];
+        bench::do_not_optimize(out);
+    });
+    bench::report("chain(proj) * view * model * v", lazy, double(count), "vecs");
+
+    // Every factor varies per element, so nothing can be hoisted.
+    double eager_varying = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            out[i] = parents[i] * models[i] * parents[count - 1 - i] * points[i];
+        bench::do_not_optimize(out);
+    });
+    bench::report("eager parent * model * parent' * v", eager_varying, double(count), "vecs");
+    double lazy_varying = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            out[i] = chain(parents[i]) * models[i] * parents[count - 1 - i] * points[i];
+        bench::do_not_optimize(out);
+    });
+    bench::report("chain(parent) * model * parent' * v", lazy_varying, double(count), "vecs");
+
+    // Constant factors: fixed<> pairs are folded while compiling.
+    double eager_fixed = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            out[i] = models[i] * flip_y * half * points[i];
+        bench::do_not_optimize(out);
+    });
+    bench::report("eager model * flip * half * v", eager_fixed, double(count), "vecs");
+    double lazy_fixed = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            out[i] = chain(models[i]) * fixed<flip_y> * fixed<half> * points[i];
+        bench::do_not_optimize(out);
+    });
+    bench::report("chain(model) * fixed<flip> * fixed<half> * v", lazy_fixed, double(count), "vecs");
+    return 0;
+}
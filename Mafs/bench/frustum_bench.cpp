@@ -0,0 +1,76 @@
+#include "bench.hpp"
+#include "../include/mafs/frustum.hpp"
+#include <random>
+#include <vector>
+
+template<size_t W>
+void run_packets(const mafs::view_frustumf& f, const std::vector<mafs::spheref>& spheres, const std::vector<mafs::aabb3f>& boxes) {
+    using namespace mafs;
+    const auto sphere_packets = pack_spheres<W>(std::span<const spheref>(spheres));
+    const auto box_packets = pack_aabbs<W>(std::span<const aabb3f>(boxes));
+    std::vector<uint32_t> out(sphere_packets.size() * W);
+    const std::string tag = ", W = " + std::to_string(W);
+    size_t n = 0;
+    double ms = bench::time_ms([&] {
+        n = cull(f, std::span<const sphere_packet<W>>(sphere_packets), std::span(out));
+        bench::do_not_optimize(out);
+    });
+    bench::report("  spheres" + tag, ms, double(spheres.size()), "objects");
+    ms = bench::time_ms([&] {
+        n = cull(f, std::span<const aabb_packet<W>>(box_packets), std::span(out));
+        bench::do_not_optimize(out);
+    });
+    bench::report("  boxes" + tag, ms, double(boxes.size()), "objects");
+    ms = bench::time_ms([&] {
+        n = cull(f, std::span<const sphere_packet<W>>(sphere_packets), std::span(out), hardware_threads());
+        bench::do_not_optimize(out);
+    });
+    bench::report("  spheres" + tag + ", " + std::to_string(hardware_threads()) + " threads", ms, double(spheres.size()), "objects");
+    ms = bench::time_ms([&] {
+        n = cull(f, std::span<const aabb_packet<W>>(box_packets), std::span(out), hardware_threads());
+        bench::do_not_optimize(out);
+    });
+    bench::report("  boxes" + tag + ", " + std::to_string(hardware_threads()) + " threads", ms, double(boxes.size()), "objects");
+    bench::do_not_optimize(n);
+}
+
+int main() {
+    using namespace mafs;
+    constexpr size_t count = 1 << 20;
+    const mat4f view = look_at(vec3f{ 0.0f, 5.0f, 0.0f }, vec3f{ 1.0f, 5.0f, -1.0f }, vec3f{ 0.0f, 1.0f, 0.0f });
+    const view_frustumf f = view_frustumf::from_matrix(perspective(1.2f, 16.0f / 9.0f, 0.1f, 500.0f) * view);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f), size(0.5f, 4.0f);
+    std::vector<spheref> spheres(count);
+    std::vector<aabb3f> boxes(count);
+    for (size_t i = 0; i < count; i++) {
+        const vec3f c{ pos(rng), pos(rng) * 0.05f, pos(rng) };
+        spheres[i] = spheref{ c, size(rng) };
+        boxes[i] = aabb3f::from_center_extents(c, vec3f{ size(rng), size(rng), size(rng) });
+    }
+
+    // Reference: the per-object loop with a push_back per visible object.
+    std::vector<uint32_t> visible;
+    visible.reserve(count);
+    double ms = bench::time_ms([&] {
+        visible.clear();
+        for (uint32_t i = 0; i < count; i++)
+            if (f.intersects(spheres[i]))
+                visible.push_back(i);
+        bench::do_not_optimize(visible);
+    });
+    std::cout << count << " objects, " << visible.size() << " visible spheres" << std::endl;
+    bench::report("  spheres, scalar", ms, double(count), "objects");
+    ms = bench::time_ms([&] {
+        visible.clear();
+        for (uint32_t i = 0; i < count; i++)
+            if (f.intersects(boxes[i]))
+                visible.push_back(i);
+        bench::do_not_optimize(visible);
+    });
+    bench::report("  boxes, scalar", ms, double(count), "objects");
+    run_packets<4>(f, spheres, boxes);
+    run_packets<8>(f, spheres, boxes);
+    return 0;
+}
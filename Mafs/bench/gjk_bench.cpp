@@ -0,0 +1,64 @@
+#include "bench.hpp"
+#include "../include/mafs/gjk.hpp"
+#include <random>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    // Pairs of bodies in near contact, each moved a little per frame like a physics step.
+    constexpr size_t pair_count = 1 << 14, frames = 8;
+    std::mt19937 rng(18);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f), angle(0.0f, 6.28f);
+    std::normal_distribution<float> normal;
+    std::vector<vec3f> rock(32);
+    for (vec3f& p : rock)
+        p = vec3f{ normal(rng), normal(rng), normal(rng) }.normalize() * 0.5f;
+    convex_hullf hull;
+    hull.build(rock);
+    const aabb3f box(vec3f(-0.5f), vec3f(0.5f));
+
+    struct pose {
+        quat<float> rotation;
+        vec3f position;
+    };
+    std::vector<pose> a(pair_count), b(pair_count);
+    for (size_t i = 0; i < pair_count; i++) {
+        a[i] = { quat<float>::from_axis_angle(vec3f{ unit(rng), unit(rng), unit(rng) }.normalize(), angle(rng)), vec3f(0.0f) };
+        b[i] = { quat<float>::from_axis_angle(vec3f{ unit(rng), unit(rng), unit(rng) }.normalize(), angle(rng)), vec3f{ unit(rng), unit(rng), unit(rng) }.normalize() * 1.05f };
+    }
+    std::cout << pair_count << " pairs x " << frames << " frames" << std::endl;
+
+    auto run = [&](const char* name, auto make_a, auto make_b, bool warm, bool penetration) {
+        std::vector<gjk_cache<float>> caches(pair_count);
+        float sum = 0.0f;
+        const double ms = bench::time_ms([&] {
+            for (size_t f = 0; f < frames; f++) {
+                const vec3f step = vec3f{ 0.002f, -0.001f, 0.0015f } * float(f);
+                for (size_t i = 0; i < pair_count; i++) {
+                    gjk_cache<float> cold;
+                    gjk_cache<float>& cache = warm ? caches[i] : cold;
+                    const auto sa = make_a(a[i]);
+                    const auto sb = make_b(pose{ b[i].rotation, b[i].position + step });
+                    sum += penetration ? gjk_penetration(sa, sb, cache).depth : gjk_distance(sa, sb, cache).distance;
+                }
+            }
+            bench::do_not_optimize(sum);
+        }, 3);
+        bench::report(std::string("  ") + name, ms, double(pair_count * frames), "queries");
+    };
+    auto as_hull = [&](const pose& p) { return transformed<convex_points<float>>{ convex_points<float>{ hull.vertices }, p.rotation, p.position }; };
+    auto as_box = [&](const pose& p) { return transformed<aabb3f>{ box, p.rotation, p.position }; };
+    auto as_sphere = [&](const pose& p) { return spheref{ p.position, 0.5f }; };
+    auto as_capsule = [&](const pose& p) { return capsulef{ p.position - p.rotation.rotate(vec3f{ 0.0f, 0.4f, 0.0f }), p.position + p.rotation.rotate(vec3f{ 0.0f, 0.4f, 0.0f }), 0.3f }; };
+
+    run("sphere-sphere distance", as_sphere, as_sphere, false, false);
+    run("capsule-box distance, cold", as_capsule, as_box, false, false);
+    run("capsule-box distance, warm", as_capsule, as_box, true, false);
+    run("box-box distance, cold", as_box, as_box, false, false);
+    run("box-box distance, warm", as_box, as_box, true, false);
+    run("hull-hull distance, cold", as_hull, as_hull, false, false);
+    run("hull-hull distance, warm", as_hull, as_hull, true, false);
+    run("box-box penetration (GJK + EPA), warm", as_box, as_box, true, true);
+    run("hull-hull penetration (GJK + EPA), warm", as_hull, as_hull, true, true);
+    return 0;
+}
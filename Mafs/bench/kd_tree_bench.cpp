@@ -0,0 +1,116 @@
+#include "bench.hpp"
+#include "../include/mafs/kd_tree.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    constexpr size_t count = 1 << 21, query_count = 1 << 16, brute_count = 64, k = 8;
+    constexpr size_t W = 8;
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f), noise(-0.5f, 0.5f);
+    // Points on a few noisy planes, like a scan of a room.
+    std::vector<vec3f> points(count);
+    for (size_t i = 0; i < count; i++) {
+        const float a = pos(rng), b = pos(rng);
+        switch (i % 3) {
+        case 0: points[i] = vec3f{ a, noise(rng), b }; break;
+        case 1: points[i] = vec3f{ a, b, -100.0f + noise(rng) }; break;
+        default: points[i] = vec3f{ 100.0f + noise(rng), a, b }; break;
+        }
+    }
+    std::vector<vec3f> queries(query_count);
+    for (size_t i = 0; i < query_count; i++)
+        queries[i] = points[rng() % count] + vec3f{ noise(rng), noise(rng), noise(rng) };
+    std::cout << count << " points, " << hardware_threads() << " hardware threads" << std::endl;
+
+    kd_tree3f tree;
+    double ms = bench::time_ms([&] { tree = kd_tree3f::build(points, 1); }, 3);
+    bench::report("  build, 1 thread", ms, double(count), "points");
+    ms = bench::time_ms([&] { tree = kd_tree3f::build(points); }, 3);
+    bench::report("  build, " + std::to_string(hardware_threads()) + " threads", ms, double(count), "points");
+
+    // Brute force: a distance scan over every point per query, then a selection.
+    std::vector<float> distances(count);
+    std::vector<uint32_t> order(count);
+    size_t sink = 0;
+    ms = bench::time_ms([&] {
+        for (size_t q = 0; q < brute_count; q++) {
+            for (size_t i = 0; i < count; i++)
+                distances[i] = (points[i] - queries[q]).length_squared();
+            sink += size_t(std::min_element(distances.begin(), distances.end()) - distances.begin());
+        }
+        bench::do_not_optimize(sink);
+    }, 3);
+    bench::report("  nearest, brute force", ms, double(brute_count) * double(count), "distances");
+
+    // The same scan on SoA packets, W distances per step.
+    std::vector<vec<float, W>> xs(count / W), ys(count / W), zs(count / W);
+    for (size_t i = 0; i < count; i++) {
+        xs[i / W][i % W] = points[i].x;
+        ys[i / W][i % W] = points[i].y;
+        zs[i / W][i % W] = points[i].z;
+    }
+    std::vector<vec<float, W>> packet_distances(count / W);
+    ms = bench::time_ms([&] {
+        for (size_t q = 0; q < brute_count; q++) {
+            const vec<float, W> qx(queries[q].x), qy(queries[q].y), qz(queries[q].z);
+            vec<float, W> best(std::numeric_limits<float>::infinity());
+            for (size_t p = 0; p < xs.size(); p++) {
+                const vec<float, W> dx = xs[p] - qx, dy = ys[p] - qy, dz = zs[p] - qz;
+                packet_distances[p] = dx * dx + dy * dy + dz * dz;
+                best = min(best, packet_distances[p]);
+            }
+            sink += size_t(*std::min_element(best.begin(), best.end()));
+        }
+        bench::do_not_optimize(sink);
+    }, 3);
+    bench::report("  nearest, brute force packets", ms, double(brute_count) * double(count), "distances");
+    ms = bench::time_ms([&] {
+        for (size_t q = 0; q < brute_count; q++) {
+            for (size_t i = 0; i < count; i++) {
+                distances[i] = (points[i] - queries[q]).length_squared();
+                order[i] = uint32_t(i);
+            }
+            std::nth_element(order.begin(), order.begin() + k, order.end(), [&](uint32_t a, uint32_t b) { return distances[a] < distances[b]; });
+            sink += order[0];
+        }
+        bench::do_not_optimize(sink);
+    }, 3);
+    bench::report("  knn, k = 8, brute force", ms, double(brute_count) * double(count), "distances");
+
+    ms = bench::time_ms([&] {
+        for (const vec3f& q : queries)
+            sink += tree.nearest(q).index;
+        bench::do_not_optimize(sink);
+    }, 3);
+    bench::report("  nearest, tree", ms, double(query_count), "queries");
+    std::vector<kd_neighbor<float>> out(query_count * k);
+    std::vector<uint32_t> counts(query_count);
+    ms = bench::time_ms([&] {
+        tree.knn(queries, k, out, counts, 1);
+        bench::do_not_optimize(out);
+    }, 3);
+    bench::report("  knn, k = 8, tree", ms, double(query_count), "queries");
+    ms = bench::time_ms([&] {
+        tree.knn(queries, k, out, counts);
+        bench::do_not_optimize(out);
+    }, 3);
+    bench::report("  knn, k = 8, tree, " + std::to_string(hardware_threads()) + " threads", ms, double(query_count), "queries");
+
+    std::vector<uint32_t> offsets;
+    std::vector<kd_neighbor<float>> found;
+    ms = bench::time_ms([&] {
+        tree.radius_search(queries, 1.0f, offsets, found, 1);
+        bench::do_not_optimize(found);
+    }, 3);
+    std::cout << "  " << double(found.size()) / double(query_count) << " points per radius query" << std::endl;
+    bench::report("  radius 1, tree", ms, double(query_count), "queries");
+    ms = bench::time_ms([&] {
+        tree.radius_search(queries, 1.0f, offsets, found);
+        bench::do_not_optimize(found);
+    }, 3);
+    bench::report("  radius 1, tree, " + std::to_string(hardware_threads()) + " threads", ms, double(query_count), "queries");
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "bench.hpp"
+#include "../include/mafs/bvh.hpp"
+#include "../include/mafs/lbvh.hpp"
+#include <random>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    // Debris: small boxes scattered through a volume, all of them moving.
+    constexpr size_t count = 1 << 20, query_count = 1 << 14;
+    std::mt19937 rng(15);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f), size(0.05f, 0.5f), step(-0.2f, 0.2f), dir(-1.0f, 1.0f);
+    std::vector<aabb3f> boxes(count);
+    for (aabb3f& b : boxes)
+        b = aabb3f::from_center_extents(vec3f{ pos(rng), pos(rng), pos(rng) }, vec3f{ size(rng), size(rng), size(rng) });
+    std::cout << count << " boxes, " << hardware_threads() << " hardware threads" << std::endl;
+
+    lbvh tree;
+    tree.build(boxes);
+    double ms = bench::time_ms([&] { tree.build(boxes, 1); });
+    bench::report("  lbvh build, 1 thread", ms, double(count), "primitives");
+    ms = bench::time_ms([&] { tree.build(boxes); });
+    bench::report("  lbvh build, " + std::to_string(hardware_threads()) + " threads", ms, double(count), "primitives");
+
+    std::vector<aabb3f> moved = boxes;
+    for (aabb3f& b : moved) {
+        const vec3f d{ step(rng), step(rng), step(rng) };
+        b = aabb3f(b.min + d, b.max + d);
+    }
+    ms = bench::time_ms([&] { tree.refit(moved, 1); });
+    bench::report("  lbvh refit, 1 thread", ms, double(count), "primitives");
+    ms = bench::time_ms([&] { tree.refit(moved); });
+    bench::report("  lbvh refit, " + std::to_string(hardware_threads()) + " threads", ms, double(count), "primitives");
+
+    // A SAH build over one triangle per box, for scale.
+    std::vector<vec3f> positions;
+    std::vector<uint32_t> indices;
+    for (const aabb3f& b : boxes) {
+        const uint32_t base = uint32_t(positions.size());
+        positions.push_back(b.min);
+        positions.push_back(vec3f{ b.max.x, b.min.y, b.min.z });
+        positions.push_back(b.max);
+        indices.insert(indices.end(), { base, base + 1, base + 2 });
+    }
+    ms = bench::time_ms([&] { bvh b = bvh::build(positions, indices); bench::do_not_optimize(b); }, 3);
+    bench::report("  SAH bvh build", ms, double(count), "primitives");
+
+    tree.build(boxes);
+    std::vector<rayf> rays;
+    for (size_t i = 0; i < query_count; i++)
+        rays.emplace_back(vec3f{ pos(rng), pos(rng), pos(rng) }, vec3f{ dir(rng), dir(rng), dir(rng) });
+    size_t hits = 0;
+    ms = bench::time_ms([&] {
+        for (const rayf& r : rays)
+            tree.query(r, 20.0f, [&](uint32_t) { hits++; });
+        bench::do_not_optimize(hits);
+    }, 3);
+    bench::report("  ray queries, t_max = 20", ms, double(query_count), "rays");
+    ms = bench::time_ms([&] {
+        for (const rayf& r : rays)
+            tree.query(aabb3f::from_center_extents(r.origin, vec3f(2.0f)), [&](uint32_t) { hits++; });
+        bench::do_not_optimize(hits);
+    }, 3);
+    bench::report("  box queries, 4 wide", ms, double(query_count), "boxes");
+    return 0;
+}
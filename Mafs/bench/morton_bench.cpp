@@ -0,0 +1,55 @@
+#include "bench.hpp"
+#include "../include/mafs/morton.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    constexpr size_t count = 1 << 22;
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+    std::vector<vec3f> points(count);
+    for (vec3f& p : points)
+        p = vec3f{ pos(rng), pos(rng), pos(rng) };
+    const aabb3f bounds = aabb3f::from_points(points);
+#if defined(MAFS_BMI2)
+    std::cout << count << " points, pdep, " << hardware_threads() << " hardware threads" << std::endl;
+#else
+    std::cout << count << " points, magic bits, " << hardware_threads() << " hardware threads" << std::endl;
+#endif
+
+    std::vector<uint32_t> codes30(count);
+    std::vector<uint64_t> codes63(count);
+    double ms = bench::time_ms([&] { morton_codes(std::span<const vec3f>(points), bounds, std::span<uint32_t>(codes30), 1); bench::do_not_optimize(codes30); });
+    bench::report("  encode 30-bit", ms, double(count), "points");
+    ms = bench::time_ms([&] { morton_codes(std::span<const vec3f>(points), bounds, std::span<uint64_t>(codes63), 1); bench::do_not_optimize(codes63); });
+    bench::report("  encode 63-bit", ms, double(count), "points");
+
+    std::vector<uint32_t> keys30(count), values(count);
+    std::vector<uint64_t> keys63(count);
+    auto reset = [&] {
+        std::copy(codes30.begin(), codes30.end(), keys30.begin());
+        std::copy(codes63.begin(), codes63.end(), keys63.begin());
+        for (size_t i = 0; i < count; i++)
+            values[i] = uint32_t(i);
+    };
+    // Each timed run includes the copy back to unsorted input; it is timed alone below.
+    const double copy_ms = bench::time_ms([&] { reset(); bench::do_not_optimize(values); });
+    ms = bench::time_ms([&] { reset(); radix_sort(std::span<uint32_t>(keys30), std::span<uint32_t>(values), 30, 1); });
+    bench::report("  radix sort 30-bit pairs, 1 thread", ms - copy_ms, double(count), "pairs");
+    ms = bench::time_ms([&] { reset(); radix_sort(std::span<uint32_t>(keys30), std::span<uint32_t>(values), 30); });
+    bench::report("  radix sort 30-bit pairs, " + std::to_string(hardware_threads()) + " threads", ms - copy_ms, double(count), "pairs");
+    ms = bench::time_ms([&] { reset(); radix_sort(std::span<uint64_t>(keys63), std::span<uint32_t>(values), 63, 1); });
+    bench::report("  radix sort 63-bit pairs, 1 thread", ms - copy_ms, double(count), "pairs");
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(count);
+    ms = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            pairs[i] = { codes30[i], uint32_t(i) };
+        std::sort(pairs.begin(), pairs.end());
+        bench::do_not_optimize(pairs);
+    }, 3);
+    bench::report("  std::sort 30-bit pairs", ms, double(count), "pairs");
+    return 0;
+}
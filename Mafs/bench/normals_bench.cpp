@@ -0,0 +1,49 @@
+#include "bench.hpp"
+#include "../include/mafs/normals.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    // A wavy grid of about a million triangles with planar UVs.
+    constexpr uint32_t n = 724;
+    std::vector<vec3f> positions;
+    std::vector<vec<float, 2>> uvs;
+    std::vector<uint32_t> indices;
+    for (uint32_t j = 0; j <= n; j++)
+        for (uint32_t i = 0; i <= n; i++) {
+            const float u = float(i) / float(n), v = float(j) / float(n);
+            positions.push_back(vec3f{ u, v, std::sin(u * 40.0f) * std::cos(v * 30.0f) * 0.02f });
+            uvs.push_back(vec<float, 2>{ u, v });
+        }
+    for (uint32_t j = 0; j < n; j++)
+        for (uint32_t i = 0; i < n; i++) {
+            const uint32_t a = j * (n + 1) + i, b = a + 1, c = a + n + 1, d = c + 1;
+            indices.insert(indices.end(), { a, b, d, a, d, c });
+        }
+    const size_t triangles = indices.size() / 3, vertices = positions.size();
+    std::cout << triangles << " triangles, " << vertices << " vertices, " << hardware_threads() << " hardware threads" << std::endl;
+
+    mesh_normals mesh;
+    std::vector<vec3f> normals(vertices);
+    std::vector<uint32_t> packed(vertices);
+    std::vector<vec4f> tangents(vertices);
+    for (size_t threads : { size_t(1), hardware_threads() }) {
+        const std::string suffix = ", " + std::to_string(threads) + " thread" + (threads > 1 ? "s" : "");
+        double ms = bench::time_ms([&] { mesh.build(indices, vertices, threads); }, 5);
+        bench::report("build corner adjacency" + suffix, ms, double(triangles), "triangles");
+        ms = bench::time_ms([&] { mesh.compute_normals(positions, normals, normal_weighting::area, threads); }, 5);
+        bench::report("area-weighted normals" + suffix, ms, double(triangles), "triangles");
+        ms = bench::time_ms([&] { mesh.compute_normals(positions, normals, normal_weighting::angle, threads); }, 5);
+        bench::report("angle-weighted normals" + suffix, ms, double(triangles), "triangles");
+        ms = bench::time_ms([&] { mesh.compute_normals(positions, std::span<uint32_t>(packed), normal_weighting::angle, threads); }, 5);
+        bench::report("angle-weighted normals, packed" + suffix, ms, double(triangles), "triangles");
+        ms = bench::time_ms([&] { mesh.compute_tangents(positions, normals, uvs, tangents, threads); }, 5);
+        bench::report("tangents" + suffix, ms, double(triangles), "triangles");
+        if (hardware_threads() == 1)
+            break;
+    }
+    bench::do_not_optimize(tangents[vertices / 2].x);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "bench.hpp"
+#include "../include/mafs/bvh.hpp"
+#include "../include/mafs/octree.hpp"
+#include <random>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    // A level with mostly static props and a few percent of objects moving every frame.
+    constexpr size_t count = 1 << 17, moving = count / 20, query_count = 1000;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f), size(0.2f, 3.0f), step(-0.5f, 0.5f), dir(-1.0f, 1.0f);
+    std::vector<aabb3f> boxes(count);
+    for (aabb3f& b : boxes)
+        b = aabb3f::from_center_extents(vec3f{ pos(rng), 0.05f * pos(rng), pos(rng) }, vec3f{ size(rng), size(rng), size(rng) });
+    std::cout << count << " objects, " << moving << " moving per frame" << std::endl;
+
+    loose_octreef tree(aabb3f(vec3f(-500.0f), vec3f(500.0f)), 10);
+    double ms = bench::time_ms([&] {
+        tree.clear();
+        for (const aabb3f& b : boxes)
+            tree.insert(b);
+    });
+    bench::report("  insert all", ms, double(count), "objects");
+
+    // Each frame moves the same objects a little; time one frame of updates.
+    size_t stayed = 0;
+    ms = bench::time_ms([&] {
+        for (uint32_t h = 0; h < moving; h++) {
+            const vec3f d{ step(rng), 0.0f, step(rng) };
+            stayed += tree.move(h * 20, aabb3f(tree.bounds(h * 20).min + d, tree.bounds(h * 20).max + d));
+        }
+    }, 20);
+    bench::report("  frame of moves", ms, double(moving), "moves");
+    std::cout << "  " << 100.0 * double(stayed) / double(moving * 20) << "% of moves stayed in their node" << std::endl;
+
+    // The alternative: a BVH over the boxes (two triangles each) rebuilt every frame.
+    std::vector<vec3f> positions;
+    std::vector<uint32_t> indices;
+    for (const aabb3f& b : boxes) {
+        const uint32_t base = uint32_t(positions.size());
+        positions.push_back(b.min);
+        positions.push_back(vec3f{ b.max.x, b.min.y, b.min.z });
+        positions.push_back(b.max);
+        indices.insert(indices.end(), { base, base + 1, base + 2 });
+    }
+    ms = bench::time_ms([&] { bvh b = bvh::build(positions, indices); bench::do_not_optimize(b); }, 3);
+    bench::report("  bvh rebuild, same objects", ms, double(count), "objects");
+
+    const view_frustumf f = view_frustumf::from_matrix(perspective(1.2f, 16.0f / 9.0f, 0.1f, 300.0f) *
+        look_at(vec3f{ 0.0f, 5.0f, 0.0f }, vec3f{ 1.0f, 5.0f, -1.0f }, vec3f{ 0.0f, 1.0f, 0.0f }));
+    size_t found = 0;
+    ms = bench::time_ms([&] {
+        found = 0;
+        tree.query(f, [&](uint32_t) { found++; });
+        bench::do_not_optimize(found);
+    });
+    std::cout << "  " << found << " objects in the frustum" << std::endl;
+    bench::report("  frustum, octree", ms, double(count), "objects");
+    ms = bench::time_ms([&] {
+        found = 0;
+        for (const loose_octreef::object& o : tree.objects)
+            found += f.intersects(o.bounds);
+        bench::do_not_optimize(found);
+    });
+    bench::report("  frustum, every box", ms, double(count), "objects");
+
+    std::vector<spheref> spheres(query_count);
+    std::vector<rayf> rays;
+    for (size_t i = 0; i < query_count; i++) {
+        spheres[i] = spheref{ vec3f{ pos(rng), 0.0f, pos(rng) }, 10.0f };
+        rays.emplace_back(vec3f{ pos(rng), 0.0f, pos(rng) }, vec3f{ dir(rng), 0.01f * dir(rng), dir(rng) });
+    }
+    ms = bench::time_ms([&] {
+        for (const spheref& s : spheres)
+            tree.query(s, [&](uint32_t h) { found += h; });
+        bench::do_not_optimize(found);
+    });
+    bench::report("  sphere r = 10", ms, double(query_count), "queries");
+    ms = bench::time_ms([&] {
+        for (const rayf& r : rays)
+            tree.query(r, 100.0f, [&](uint32_t h) { found += h; });
+        bench::do_not_optimize(found);
+    });
+    bench::report("  ray, t_max = 100", ms, double(query_count), "queries");
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "bench.hpp"
+#include "../include/mafs/quantize.hpp"
+#include <random>
+#include <vector>
+
+template<typename Codec>
+void run_quat(const char* name, const std::vector<mafs::quatf>& rotations) {
+    using namespace mafs;
+    const size_t count = rotations.size();
+    std::vector<typename Codec::storage> codes(count);
+    std::vector<quatf> decoded(count);
+    std::cout << name << " (" << Codec::bits << " bits)" << std::endl;
+    double ms = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            codes[i] = Codec::encode(rotations[i]);
+        bench::do_not_optimize(codes);
+    });
+    bench::report("  encode, scalar", ms, double(count), "quats");
+    ms = bench::time_ms([&] {
+        Codec::encode_batch(std::span<const quatf>(rotations), std::span(codes));
+        bench::do_not_optimize(codes);
+    });
+    bench::report("  encode_batch", ms, double(count), "quats");
+    ms = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            decoded[i] = Codec::decode(codes[i]);
+        bench::do_not_optimize(decoded);
+    });
+    bench::report("  decode, scalar", ms, double(count), "quats");
+    ms = bench::time_ms([&] {
+        Codec::decode_batch(std::span<const typename Codec::storage>(codes), std::span(decoded));
+        bench::do_not_optimize(decoded);
+    });
+    bench::report("  decode_batch", ms, double(count), "quats");
+    const quantization_error err = Codec::measure(rotations, codes);
+    std::cout << "  max error " << err.max << " rad, rms " << err.rms << " rad" << std::endl;
+}
+
+int main() {
+    using namespace mafs;
+    constexpr size_t count = 1 << 20;
+    std::mt19937 rng(1);
+    std::normal_distribution<float> dist;
+    std::vector<quatf> rotations(count);
+    std::vector<vec3f> positions(count);
+    for (size_t i = 0; i < count; i++) {
+        rotations[i] = quatf(dist(rng), dist(rng), dist(rng), dist(rng)).normalize();
+        positions[i] = vec3f{ dist(rng), dist(rng), dist(rng) } * 10.0f;
+    }
+    run_quat<quat_codec29>("quat_codec29", rotations);
+    run_quat<quat_codec32>("quat_codec32", rotations);
+    run_quat<quat_codec48>("quat_codec48", rotations);
+
+    // Bounds of the data, as a mesh or level would supply them.
+    vec3f lo = positions[0], hi = positions[0];
+    for (const vec3f& p : positions) {
+        lo = min(lo, p);
+        hi = max(hi, p);
+    }
+    const vec3_codec<16> codec(lo, hi);
+    std::vector<vec3_codec<16>::storage> codes(count);
+    std::vector<vec3f> decoded(count);
+    std::cout << "vec3_codec<16> (48 bits)" << std::endl;
+    double ms = bench::time_ms([&] {
+        for (size_t i = 0; i < count; i++)
+            codes[i] = codec.encode(positions[i]);
+        bench::do_not_optimize(codes);
+    });
+    bench::report("  encode, scalar", ms, double(count), "vectors");
+    ms = bench::time_ms([&] {
+        codec.encode_batch(std::span<const vec3f>(positions), std::span(codes));
+        bench::do_not_optimize(codes);
+    });
+    bench::report("  encode_batch", ms, double(count), "vectors");
+    ms = bench::time_ms([&] {
+        codec.decode_batch(std::span<const vec3_codec<16>::storage>(codes), std::span(decoded));
+        bench::do_not_optimize(decoded);
+    });
+    bench::report("  decode_batch", ms, double(count), "vectors");
+    const quantization_error err = codec.measure(positions, codes);
+    std::cout << "  max error " << err.max << ", rms " << err.rms << std::endl;
+    return 0;
+}
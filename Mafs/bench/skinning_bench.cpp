@@ -0,0 +1,91 @@
+#include "bench.hpp"
+#include "../include/mafs/skinning.hpp"
+#include "../include/mafs/transform.hpp"
+#include <random>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    constexpr size_t vertex_count = 100000;
+    constexpr size_t bone_count = 64;
+    constexpr size_t mesh_count = 8;
+
+    std::mt19937 rng(1);
+    std::normal_distribution<float> dist;
+    std::uniform_real_distribution<float> unit(0.05f, 1.0f);
+    std::uniform_int_distribution<int> bone(0, int(bone_count) - 1);
+    std::vector<mat4f> palette4;
+    std::vector<mat3x4f> palette3;
+    std::vector<dual_quatf> palette_dq;
+    for (size_t b = 0; b < bone_count; b++) {
+        const quatf r = quatf(dist(rng), dist(rng), dist(rng), dist(rng)).normalize();
+        const vec3f t{ dist(rng), dist(rng), dist(rng) };
+        palette4.push_back(compose_trs(t, r, vec3f(1.0f)));
+        palette3.push_back(mat3x4f{ palette4.back()[0].xyz(), palette4.back()[1].xyz(), palette4.back()[2].xyz(), t });
+        palette_dq.push_back(dual_quatf::from_rotation_translation(r, t));
+    }
+    std::vector<skin_joints> joints(vertex_count);
+    std::vector<vec4f> weights(vertex_count);
+    std::vector<vec3f> positions(vertex_count), normals(vertex_count);
+    for (size_t v = 0; v < vertex_count; v++) {
+        // Neighbouring vertices share nearby bones, as in a real mesh.
+        const int b0 = int(v * bone_count / vertex_count);
+        joints[v] = skin_joints{ uint16_t(b0), uint16_t((b0 + 1) % int(bone_count)), uint16_t(bone(rng)), uint16_t(bone(rng)) };
+        const vec4f w{ unit(rng), unit(rng), unit(rng), unit(rng) };
+        weights[v] = w / (w.x + w.y + w.z + w.w);
+        positions[v] = vec3f{ dist(rng), dist(rng), dist(rng) };
+        normals[v] = vec3f{ dist(rng), dist(rng), dist(rng) }.normalize();
+    }
+    std::vector<vec3f> out_positions(vertex_count), out_normals(vertex_count);
+
+    // Reference: per-vertex scalar LBS, transforming by each bone and summing.
+    double scalar = bench::time_ms([&] {
+        for (size_t v = 0; v < vertex_count; v++) {
+            const vec4f p{ positions[v].x, positions[v].y, positions[v].z, 1.0f };
+            const vec4f n{ normals[v].x, normals[v].y, normals[v].z, 0.0f };
+            vec4f sp, sn;
+            for (size_t k = 0; k < 4; k++) {
+                sp += palette4[joints[v][k]] * p * weights[v][k];
+                sn += palette4[joints[v][k]] * n * weights[v][k];
+            }
+            out_positions[v] = sp.xyz();
+            out_normals[v] = sn.xyz().normalize();
+        }
+        bench::do_not_optimize(out_positions);
+        bench::do_not_optimize(out_normals);
+    });
+    bench::report("scalar LBS (mat4)", scalar, double(vertex_count), "vertices");
+
+    auto run = [&](const char* name, auto&& skin) {
+        double ms = bench::time_ms([&] {
+            skin();
+            bench::do_not_optimize(out_positions);
+            bench::do_not_optimize(out_normals);
+        });
+        bench::report(name, ms, double(vertex_count), "vertices");
+    };
+    run("LBS mat3x4", [&] { skin_lbs(skin_job<mat3x4f>{ palette3, joints, weights, positions, normals, out_positions, out_normals }); });
+    run("LBS mat4", [&] { skin_lbs(skin_job<mat4f>{ palette4, joints, weights, positions, normals, out_positions, out_normals }); });
+    run("LBS mat3x4, positions only", [&] { skin_lbs(skin_job<mat3x4f>{ palette3, joints, weights, positions, {}, out_positions, {} }); });
+    run("DQS", [&] { skin_dqs(skin_job<dual_quatf>{ palette_dq, joints, weights, positions, normals, out_positions, out_normals }); });
+
+    // Several meshes at once, split across threads.
+    std::vector<std::vector<vec3f>> mesh_positions(mesh_count, std::vector<vec3f>(vertex_count)), mesh_normals = mesh_positions;
+    std::vector<skin_job<mat3x4f>> jobs;
+    std::vector<skin_job<dual_quatf>> dq_jobs;
+    for (size_t m = 0; m < mesh_count; m++) {
+        jobs.push_back(skin_job<mat3x4f>{ palette3, joints, weights, positions, normals, mesh_positions[m], mesh_normals[m] });
+        dq_jobs.push_back(skin_job<dual_quatf>{ palette_dq, joints, weights, positions, normals, mesh_positions[m], mesh_normals[m] });
+    }
+    std::cout << "\n" << mesh_count << " meshes, " << hardware_threads() << " threads" << std::endl;
+    auto run_meshes = [&](const char* name, auto&& skin) {
+        double ms = bench::time_ms([&] {
+            skin();
+            bench::do_not_optimize(mesh_positions);
+        });
+        bench::report(name, ms, double(vertex_count * mesh_count), "vertices");
+    };
+    run_meshes("LBS mat3x4, all meshes", [&] { skin_lbs(std::span<const skin_job<mat3x4f>>(jobs)); });
+    run_meshes("DQS, all meshes", [&] { skin_dqs(std::span<const skin_job<dual_quatf>>(dq_jobs)); });
+    return 0;
+}
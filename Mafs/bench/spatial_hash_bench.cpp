@@ -0,0 +1,45 @@
+#include "bench.hpp"
+#include "../include/mafs/spatial_hash.hpp"
+#include <random>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    // A particle box at roughly the density of a fluid simulation: about 8 particles per cell.
+    constexpr size_t count = 1 << 20, query_count = 1 << 17;
+    constexpr float cell = 1.0f, radius = 1.0f;
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<float> pos(0.0f, 51.2f);
+    std::vector<vec3f> points(count);
+    for (vec3f& p : points)
+        p = vec3f{ pos(rng), pos(rng), pos(rng) };
+    std::cout << count << " particles, " << hardware_threads() << " hardware threads" << std::endl;
+
+    spatial_hash_grid grid(cell, count);
+    double ms = bench::time_ms([&] { grid.build(points, 1); }, 5);
+    bench::report("  build, random order, 1 thread", ms, double(count), "particles");
+    // A simulation that keeps its particles in the previous frame's cell order scatters
+    // mostly into nearby slots, which is the usual per-frame rebuild.
+    const std::vector<vec3f> frame = grid.positions;
+    ms = bench::time_ms([&] { grid.build(frame, 1); }, 5);
+    bench::report("  rebuild, cell order, 1 thread", ms, double(count), "particles");
+    ms = bench::time_ms([&] { grid.build(frame); }, 5);
+    bench::report("  rebuild, cell order, " + std::to_string(hardware_threads()) + " threads", ms, double(count), "particles");
+
+    // Queries at particles in input order hop across the table; in cell order consecutive
+    // queries reuse the same runs.
+    size_t sink = 0;
+    ms = bench::time_ms([&] {
+        for (size_t i = 0; i < query_count; i++)
+            grid.for_each_neighbor(points[i], radius, [&](uint32_t slot, float) { sink += slot; });
+        bench::do_not_optimize(sink);
+    }, 3);
+    bench::report("  neighbors, input order", ms, double(query_count), "queries");
+    ms = bench::time_ms([&] {
+        for (size_t i = 0; i < query_count; i++)
+            grid.for_each_neighbor(grid.positions[i], radius, [&](uint32_t slot, float) { sink += slot; });
+        bench::do_not_optimize(sink);
+    }, 3);
+    bench::report("  neighbors, cell order", ms, double(query_count), "queries");
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "bench.hpp"
+#include "../include/mafs/aabb.hpp"
+#include "../include/mafs/sphere.hpp"
+#include <random>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    // Meshlets of 64 vertices, each a patch of a surface somewhere in a large scene.
+    constexpr size_t meshlet_count = 1 << 14, meshlet_size = 64, mesh_size = 1 << 20;
+    std::mt19937 rng(16);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f), local(-1.0f, 1.0f);
+    std::vector<vec3f> points;
+    std::vector<uint32_t> offsets{ 0 };
+    for (size_t m = 0; m < meshlet_count; m++) {
+        const vec3f c{ pos(rng), pos(rng), pos(rng) };
+        for (size_t i = 0; i < meshlet_size; i++)
+            points.push_back(c + vec3f{ local(rng), local(rng), local(rng) * 0.2f });
+        offsets.push_back(uint32_t(points.size()));
+    }
+    std::cout << meshlet_count << " meshlets of " << meshlet_size << " vertices, " << hardware_threads() << " hardware threads" << std::endl;
+
+    std::vector<spheref> ritter(meshlet_count), minimal(meshlet_count);
+    double ms = bench::time_ms([&] { bounding_spheres(std::span<const vec3f>(points), std::span<const uint32_t>(offsets), std::span<spheref>(ritter), sphere_fit::ritter, 1); });
+    bench::report("  Ritter meshlet spheres, 1 thread", ms, double(meshlet_count), "meshlets");
+    ms = bench::time_ms([&] { bounding_spheres(std::span<const vec3f>(points), std::span<const uint32_t>(offsets), std::span<spheref>(minimal), sphere_fit::minimal, 1); });
+    bench::report("  minimal meshlet spheres, 1 thread", ms, double(meshlet_count), "meshlets");
+    ms = bench::time_ms([&] { bounding_spheres(std::span<const vec3f>(points), std::span<const uint32_t>(offsets), std::span<spheref>(minimal), sphere_fit::minimal); });
+    bench::report("  minimal meshlet spheres, " + std::to_string(hardware_threads()) + " threads", ms, double(meshlet_count), "meshlets");
+    double ratio = 0.0;
+    for (size_t m = 0; m < meshlet_count; m++)
+        ratio += double(ritter[m].radius / minimal[m].radius);
+    std::cout << "  Ritter radius / minimal radius: " << ratio / double(meshlet_count) << " on average" << std::endl;
+
+    // One large mesh.
+    std::vector<vec3f> mesh(mesh_size);
+    for (vec3f& p : mesh)
+        p = vec3f{ pos(rng), pos(rng) * 0.5f, pos(rng) * 0.25f };
+    ms = bench::time_ms([&] { spheref s = ritter_sphere(std::span<const vec3f>(mesh)); bench::do_not_optimize(s); });
+    bench::report("  Ritter sphere of a mesh", ms, double(mesh_size), "points");
+    ms = bench::time_ms([&] { spheref s = minimal_sphere(std::span<const vec3f>(mesh)); bench::do_not_optimize(s); }, 3);
+    bench::report("  minimal sphere of a mesh", ms, double(mesh_size), "points");
+    ms = bench::time_ms([&] { aabb3f b = aabb3f::from_points(std::span<const vec3f>(mesh)); bench::do_not_optimize(b); });
+    bench::report("  aabb of a mesh, for scale", ms, double(mesh_size), "points");
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "bench.hpp"
+#include "../include/mafs/sweep_and_prune.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    constexpr size_t count = 100000;
+    std::cout << count << " bodies of 0.5 to 1.5 units" << std::endl;
+
+    // Bodies drifting through a cube; the denser the cube, the more endpoints a move passes.
+    auto scene = [&](float world, float speed) {
+        std::mt19937 rng(48);
+        std::uniform_real_distribution<float> pos(0.0f, world), size(0.5f, 1.5f), step(-speed, speed);
+        std::vector<aabb3f> boxes(count);
+        std::vector<vec3f> velocity(count);
+        for (size_t i = 0; i < count; i++) {
+            const vec3f lo{ pos(rng), pos(rng), pos(rng) };
+            boxes[i] = aabb3f(lo, lo + vec3f{ size(rng), size(rng), size(rng) });
+            velocity[i] = vec3f{ step(rng), step(rng), step(rng) };
+        }
+        std::cout << "world of " << world << " units, speed up to " << speed << " per frame" << std::endl;
+
+        sweep_and_prunef sap;
+        double ms = bench::time_ms([&] {
+            sap = sweep_and_prunef();
+            for (const aabb3f& b : boxes)
+                sap.insert(b);
+            sap.update();
+        }, 3);
+        bench::report("  first update, sort and sweep", ms, double(count), "bodies");
+        std::cout << "  " << sap.pair_count() << " pairs" << std::endl;
+
+        // Every `stride`-th body moves each frame.
+        size_t deltas = 0;
+        for (size_t stride : { 1, 10, 100 }) {
+            ms = bench::time_ms([&] {
+                for (size_t i = 0; i < count; i += stride) {
+                    boxes[i] = aabb3f(boxes[i].min + velocity[i], boxes[i].max + velocity[i]);
+                    sap.move(uint32_t(i), boxes[i]);
+                }
+                sap.update();
+                deltas += sap.added.size() + sap.removed.size();
+            }, 10);
+            bench::report("  frame, 1 in " + std::to_string(stride) + " bodies moving", ms, double(count / stride), "moved bodies");
+        }
+        std::cout << "  " << deltas << " pair changes" << std::endl;
+
+        ms = bench::time_ms([&] {
+            for (uint32_t i = 0; i < 100; i++)
+                sap.remove(i * 997);
+            sap.update();
+            for (uint32_t i = 0; i < 100; i++)
+                sap.insert(boxes[i * 997]);
+            sap.update();
+        }, 3);
+        bench::report("  100 removals, then 100 insertions", ms);
+    };
+    scene(80.0f, 0.03f);
+    scene(400.0f, 0.01f);
+    return 0;
+}
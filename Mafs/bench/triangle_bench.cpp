@@ -0,0 +1,99 @@
+#include "bench.hpp"
+#include "../include/mafs/triangle.hpp"
+#include <random>
+#include <vector>
+
+template<size_t W>
+void run_packets(const std::vector<mafs::vec3f>& positions, const std::vector<uint32_t>& indices, const std::vector<mafs::rayf>& rays) {
+    using namespace mafs;
+    const auto packets = pack_triangles<W>(std::span<const vec3f>(positions), std::span<const uint32_t>(indices));
+    const double tests = double(rays.size()) * double(indices.size() / 3);
+    const std::string tag = ", W = " + std::to_string(W);
+    size_t hits = 0;
+    double ms = bench::time_ms([&] {
+        hits = 0;
+        triangle_packet_hit<W> h;
+        for (const rayf& r : rays)
+            for (const auto& p : packets)
+                hits += std::popcount(intersect(p, r, 100.0f, h));
+        bench::do_not_optimize(hits);
+    });
+    bench::report("  one ray, W triangles" + tag, ms, tests, "tests");
+    ms = bench::time_ms([&] {
+        hits = 0;
+        triangle_packet_hit<W> h;
+        for (const rayf& r : rays)
+            for (const auto& p : packets)
+                hits += std::popcount(intersect_watertight(p, r, 100.0f, h));
+        bench::do_not_optimize(hits);
+    });
+    bench::report("  one ray, W triangles, watertight" + tag, ms, tests, "tests");
+
+    std::vector<ray_packet<W>> ray_packets(rays.size() / W);
+    for (size_t i = 0; i < ray_packets.size() * W; i++)
+        ray_packets[i / W].set(i % W, rays[i]);
+    const vec<float, W> t_max(100.0f);
+    ms = bench::time_ms([&] {
+        hits = 0;
+        triangle_packet_hit<W> h;
+        for (const auto& rp : ray_packets)
+            for (size_t t = 0; t < indices.size(); t += 3)
+                hits += std::popcount(intersect(rp, positions[indices[t]], positions[indices[t + 1]], positions[indices[t + 2]], t_max, h));
+        bench::do_not_optimize(hits);
+    });
+    bench::report("  W rays, one triangle" + tag, ms, tests, "tests");
+    ms = bench::time_ms([&] {
+        hits = 0;
+        triangle_packet_hit<W> h;
+        for (const auto& rp : ray_packets)
+            for (size_t t = 0; t < indices.size(); t += 3)
+                hits += std::popcount(intersect_watertight(rp, positions[indices[t]], positions[indices[t + 1]], positions[indices[t + 2]], t_max, h));
+        bench::do_not_optimize(hits);
+    });
+    bench::report("  W rays, one triangle, watertight" + tag, ms, tests, "tests");
+}
+
+int main() {
+    using namespace mafs;
+    // Every ray against every triangle, as in a leaf or a brute-force visibility pass.
+    constexpr size_t triangle_count = 4096, ray_count = 1024;
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<float> pos(-10.0f, 10.0f), offset(-1.0f, 1.0f), dir(-1.0f, 1.0f);
+    std::vector<vec3f> positions;
+    std::vector<uint32_t> indices;
+    for (size_t i = 0; i < triangle_count; i++) {
+        const vec3f c{ pos(rng), pos(rng), pos(rng) };
+        for (int k = 0; k < 3; k++) {
+            indices.push_back(uint32_t(positions.size()));
+            positions.push_back(c + vec3f{ offset(rng), offset(rng), offset(rng) });
+        }
+    }
+    std::vector<rayf> rays;
+    for (size_t i = 0; i < ray_count; i++)
+        rays.emplace_back(vec3f{ pos(rng), pos(rng), pos(rng) }, vec3f{ dir(rng), dir(rng), dir(rng) });
+    const double tests = double(ray_count) * double(triangle_count);
+
+    size_t hits = 0;
+    double ms = bench::time_ms([&] {
+        hits = 0;
+        triangle_hit<float> h;
+        for (const rayf& r : rays)
+            for (size_t t = 0; t < indices.size(); t += 3)
+                hits += intersect_triangle(r, positions[indices[t]], positions[indices[t + 1]], positions[indices[t + 2]], 100.0f, h);
+        bench::do_not_optimize(hits);
+    });
+    std::cout << triangle_count << " triangles x " << ray_count << " rays, " << hits << " hits" << std::endl;
+    bench::report("  scalar", ms, tests, "tests");
+    ms = bench::time_ms([&] {
+        hits = 0;
+        triangle_hit<float> h;
+        for (const rayf& r : rays)
+            for (size_t t = 0; t < indices.size(); t += 3)
+                hits += intersect_triangle_watertight(r, positions[indices[t]], positions[indices[t + 1]], positions[indices[t + 2]], 100.0f, h);
+        bench::do_not_optimize(hits);
+    });
+    bench::report("  scalar, watertight", ms, tests, "tests");
+    run_packets<4>(positions, indices, rays);
+    run_packets<8>(positions, indices, rays);
+    return 0;
+}
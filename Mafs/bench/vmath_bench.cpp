@@ -0,0 +1,54 @@
+#include "bench.hpp"
+#include "../include/mafs/vmath.hpp"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Runs a packet kernel over `in` eight lanes at a time.
+template<typename F>
+void run_packets(const std::vector<float>& in, std::vector<float>& out, F kernel) {
+    for (size_t i = 0; i < in.size(); i += 8) {
+        mafs::vec<float, 8> x;
+        std::memcpy(&x[0], &in[i], sizeof(x));
+        mafs::vec<float, 8> y = kernel(x);
+        std::memcpy(&out[i], &y[0], sizeof(y));
+    }
+}
+
+int main() {
+    using namespace mafs;
+    constexpr size_t count = 1 << 20;
+    std::vector<float> angles(count), unit(count), positive(count), out(count);
+    for (size_t i = 0; i < count; i++) {
+        angles[i] = float(i) * 0.001f - 500.0f;
+        unit[i] = float(i) / float(count) * 2.0f - 1.0f;
+        positive[i] = float(i + 1) * 0.01f;
+    }
+
+    auto compare = [&](const char* name, const std::vector<float>& in, auto scalar, auto accurate, auto fast) {
+        double s = bench::time_ms([&] {
+            for (size_t i = 0; i < count; i++)
+                out[i] = scalar(in[i]);
+            bench::do_not_optimize(out);
+        });
+        double a = bench::time_ms([&] { run_packets(in, out, accurate); bench::do_not_optimize(out); });
+        double f = bench::time_ms([&] { run_packets(in, out, fast); bench::do_not_optimize(out); });
+        bench::report(std::string("std::") + name, s, double(count), "vals");
+        bench::report(std::string("mafs::") + name + " accurate", a, double(count), "vals");
+        bench::report(std::string("mafs::") + name + " fast", f, double(count), "vals");
+    };
+    using packet = vec<float, 8>;
+    compare("sin", angles, [](float x) { return std::sin(x); },
+        [](const packet& x) { return mafs::sin(x); }, [](const packet& x) { return mafs::sin<precision::fast>(x); });
+    compare("atan2", unit, [](float x) { return std::atan2(x, 0.5f); },
+        [](const packet& x) { return mafs::atan2(x, packet(0.5f)); }, [](const packet& x) { return mafs::atan2<precision::fast>(x, packet(0.5f)); });
+    compare("acos", unit, [](float x) { return std::acos(x); },
+        [](const packet& x) { return mafs::acos(x); }, [](const packet& x) { return mafs::acos<precision::fast>(x); });
+    compare("exp", unit, [](float x) { return std::exp(x * 80.0f); },
+        [](const packet& x) { return mafs::exp(x * 80.0f); }, [](const packet& x) { return mafs::exp<precision::fast>(x * 80.0f); });
+    compare("log", positive, [](float x) { return std::log(x); },
+        [](const packet& x) { return mafs::log(x); }, [](const packet& x) { return mafs::log<precision::fast>(x); });
+    compare("pow", positive, [](float x) { return std::pow(x, 2.2f); },
+        [](const packet& x) { return mafs::pow(x, packet(2.2f)); }, [](const packet& x) { return mafs::pow<precision::fast>(x, packet(2.2f)); });
+    return 0;
+}
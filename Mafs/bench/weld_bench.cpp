@@ -0,0 +1,49 @@
+#include "bench.hpp"
+#include "../include/mafs/weld.hpp"
+#include <cmath>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+int main() {
+    using namespace mafs;
+    // A triangle soup: a wavy grid with every triangle's corners written out, as importers do,
+    // each copy off by up to 1e-6.
+    constexpr uint32_t n = 400;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> jitter(-1e-6f, 1e-6f);
+    auto grid_point = [](uint32_t i, uint32_t j) {
+        const float u = float(i) / float(n), v = float(j) / float(n);
+        return vec3f{ u, v, std::sin(u * 20.0f) * std::cos(v * 15.0f) * 0.05f };
+    };
+    std::vector<vec3f> soup;
+    for (uint32_t j = 0; j < n; j++)
+        for (uint32_t i = 0; i < n; i++)
+            for (auto [di, dj] : { std::pair{ 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } })
+                soup.push_back(grid_point(i + di, j + dj) + vec3f{ jitter(rng), jitter(rng), jitter(rng) });
+    std::cout << soup.size() << " soup vertices, " << (n + 1) * (n + 1) << " distinct, " << hardware_threads() << " hardware threads" << std::endl;
+
+    vertex_weld weld;
+    for (size_t threads : { size_t(1), hardware_threads() }) {
+        const double ms = bench::time_ms([&] { weld.build(soup, 1e-4f, {}, threads); }, 5);
+        bench::report("weld with tolerance 1e-4, " + std::to_string(threads) + " thread" + (threads > 1 ? "s" : ""), ms, double(soup.size()), "vertices");
+        std::cout << "  " << weld.size() << " welded vertices" << std::endl;
+        if (hardware_threads() == 1)
+            break;
+    }
+
+    // Baseline: snapping to the tolerance grid and deduplicating cells with std::unordered_map,
+    // which splits copies that straddle a cell boundary.
+    size_t snapped = 0;
+    const double ms = bench::time_ms([&] {
+        std::unordered_map<vec3i, uint32_t> cells;
+        cells.reserve(soup.size());
+        for (const vec3f& p : soup)
+            cells.try_emplace(vec3i{ int(std::floor(p.x * 1e4f)), int(std::floor(p.y * 1e4f)), int(std::floor(p.z * 1e4f)) }, uint32_t(cells.size()));
+        snapped = cells.size();
+    }, 5);
+    bench::report("snap to grid + unordered_map<vec3i>", ms, double(soup.size()), "vertices");
+    std::cout << "  " << snapped << " cells" << std::endl;
+    return 0;
+}
@@ -0,0 +1,274 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+#include "matrix.hpp"
+#include "ray.hpp"
+
+namespace mafs
+{
+	// Axis-aligned box, closed on both ends. The default box is empty (min = +inf, max = -inf),
+	// so merging anything into it gives that thing back.
+	template<std::floating_point T = float, size_t N = 3>
+	class aabb
+	{
+	public:
+		//-----------------------------Constructors-----------------------------
+		constexpr aabb() : min(std::numeric_limits<T>::infinity()), max(-std::numeric_limits<T>::infinity()) {}
+		constexpr aabb(const vec<T, N>& min, const vec<T, N>& max) : min(min), max(max) {}
+		static constexpr aabb empty() { return aabb(); }
+		static constexpr aabb from_point(const vec<T, N>& p) { return aabb(p, p); }
+		static constexpr aabb from_center_extents(const vec<T, N>& center, const vec<T, N>& half_extents)
+		{
+			return aabb(center - half_extents, center + half_extents);
+		}
+		static constexpr aabb from_points(std::span<const vec<T, N>> points)
+		{
+			aabb res;
+			for (const vec<T, N>& p : points)
+				res = res.merge(p);
+			return res;
+		}
+		//-----------------------------Operators-----------------------------
+		bool operator==(const aabb& o) const { return min == o.min && max == o.max; }
+		bool operator!=(const aabb& o) const { return !(*this == o); }
+
+		friend std::ostream& operator<<(std::ostream& out, const aabb& b)
+		{
+			return out << b.min << " - " << b.max;
+		}
+		//-----------------------------Functions-----------------------------
+		constexpr bool is_empty() const
+		{
+			for (size_t i = 0; i < N; i++)
+				if (max[i] < min[i])
+					return true;
+			return false;
+		}
+		constexpr vec<T, N> center() const { return (min + max) * T(0.5); }
+		constexpr vec<T, N> extents() const { return max - min; }
+
+		constexpr aabb merge(const aabb& o) const { return aabb(mafs::min(min, o.min), mafs::max(max, o.max)); }
+		constexpr aabb merge(const vec<T, N>& p) const { return aabb(mafs::min(min, p), mafs::max(max, p)); }
+		// Grows every side by margin; a negative margin shrinks.
+		constexpr aabb expand(const vec<T, N>& margin) const { return aabb(min - margin, max + margin); }
+		constexpr aabb expand(T margin) const { return expand(vec<T, N>(margin)); }
+
+		constexpr T surface_area() const requires (N == 3)
+		{
+			if (is_empty())
+				return T(0);
+			const vec<T, N> e = extents();
+			return T(2) * (e.x * e.y + e.y * e.z + e.z * e.x);
+		}
+		constexpr T volume() const
+		{
+			if (is_empty())
+				return T(0);
+			const vec<T, N> e = extents();
+			T res = T(1);
+			for (size_t i = 0; i < N; i++)
+				res *= e[i];
+			return res;
+		}
+
+		constexpr bool contains(const vec<T, N>& p) const
+		{
+			for (size_t i = 0; i < N; i++)
+				if (p[i] < min[i] || max[i] < p[i])
+					return false;
+			return true;
+		}
+		constexpr bool contains(const aabb& o) const
+		{
+			for (size_t i = 0; i < N; i++)
+				if (o.min[i] < min[i] || max[i] < o.max[i])
+					return false;
+			return true;
+		}
+		constexpr bool overlaps(const aabb& o) const
+		{
+			for (size_t i = 0; i < N; i++)
+				if (o.max[i] < min[i] || max[i] < o.min[i])
+					return false;
+			return true;
+		}
+		// Squared distance from p to the nearest point of the box: 0 inside, inf for empty boxes.
+		constexpr T distance_squared(const vec<T, N>& p) const
+		{
+			T res = T(0);
+			for (size_t i = 0; i < N; i++)
+			{
+				const T d = p[i] < min[i] ? min[i] - p[i] : max[i] < p[i] ? p[i] - max[i] : T(0);
+				res += d * d;
+			}
+			return res;
+		}
+
+		// Box around the transformed box, by Arvo's method: each column of m contributes the
+		// smaller of its products with min and max to the new min, the larger to the new max.
+		// m must be affine.
+		constexpr aabb transform(const mat<T, 4, 4>& m) const requires (N == 3)
+		{
+			if (is_empty())
+				return *this;
+			vec<T, 3> lo = m[3].xyz(), hi = lo;
+			for (size_t c = 0; c < 3; c++)
+			{
+				const vec<T, 3> a = m[c].xyz() * min[c], b = m[c].xyz() * max[c];
+				lo += mafs::min(a, b);
+				hi += mafs::max(a, b);
+			}
+			return aabb(lo, hi);
+		}
+
+		// Slab test over [0, t_max]. The ray's direction signs pick the near and far planes, so an
+		// empty box never hits. t_entry is 0 when the origin is inside. An axis where the direction
+		// is zero and the origin lies exactly on a plane gives NaN, which the max/min ordering
+		// drops, so that axis does not reject the hit.
+		constexpr bool intersect(const ray<T, N>& r, T t_max, T& t_entry) const
+		{
+			T t0 = T(0), t1 = t_max;
+			for (size_t i = 0; i < N; i++)
+			{
+				const T near_plane = r.negative[i] ? max[i] : min[i];
+				const T far_plane = r.negative[i] ? min[i] : max[i];
+				const T t_near = (near_plane - r.origin[i]) * r.inv_direction[i];
+				const T t_far = (far_plane - r.origin[i]) * r.inv_direction[i];
+				t0 = t0 < t_near ? t_near : t0;
+				t1 = t_far < t1 ? t_far : t1;
+			}
+			t_entry = t0;
+			return t0 <= t1;
+		}
+		constexpr bool intersects(const ray<T, N>& r, T t_max = std::numeric_limits<T>::infinity()) const
+		{
+			T t_entry;
+			return intersect(r, t_max, t_entry);
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		vec<T, N> min;
+		vec<T, N> max;
+	};
+
+	using aabb2f = aabb<float, 2>;
+	using aabb3f = aabb<float, 3>;
+	using aabb3d = aabb<double, 3>;
+
+	// W boxes in SoA layout, min[a][l] being axis a of lane l, for testing one ray or box
+	// against W boxes at once. Lanes without a box hold the empty box and never report a hit.
+	// W = 4 fits SSE2 registers; W = 8 is faster once AVX is enabled.
+	template<size_t W, std::floating_point T = float>
+	struct aabb_packet
+	{
+		static_assert(W >= 1 && W <= 32, "Packet masks hold at most 32 lanes");
+		static constexpr T inf = std::numeric_limits<T>::infinity();
+
+		constexpr void set(size_t lane, const aabb<T, 3>& box)
+		{
+			for (size_t a = 0; a < 3; a++)
+			{
+				min[a][lane] = box.min[a];
+				max[a][lane] = box.max[a];
+			}
+		}
+		constexpr aabb<T, 3> get(size_t lane) const
+		{
+			return aabb<T, 3>(vec<T, 3>{ min[0][lane], min[1][lane], min[2][lane] }, vec<T, 3>{ max[0][lane], max[1][lane], max[2][lane] });
+		}
+
+		vec<T, W> min[3] = { vec<T, W>(inf), vec<T, W>(inf), vec<T, W>(inf) };
+		vec<T, W> max[3] = { vec<T, W>(-inf), vec<T, W>(-inf), vec<T, W>(-inf) };
+	};
+
+	namespace detail
+	{
+		// Bit l is set where a[l] <= b[l].
+		template<typename T, size_t W>
+		constexpr uint32_t less_equal_mask(const vec<T, W>& a, const vec<T, W>& b)
+		{
+			uint32_t mask = 0;
+			size_t i = 0;
+#if defined(MAFS_SSE2)
+			if (!std::is_constant_evaluated())
+			{
+				if constexpr (std::is_same_v<T, float>)
+				{
+#if defined(__AVX__)
+					for (; i + 8 <= W; i += 8)
+						mask |= uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i]), _CMP_LE_OQ))) << i;
+#endif
+					for (; i + 4 <= W; i += 4)
+						mask |= uint32_t(_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])))) << i;
+				}
+				else if constexpr (std::is_same_v<T, double>)
+				{
+					for (; i + 2 <= W; i += 2)
+						mask |= uint32_t(_mm_movemask_pd(_mm_cmple_pd(_mm_loadu_pd(&a[i]), _mm_loadu_pd(&b[i])))) << i;
+				}
+			}
+#endif
+			for (; i < W; i++)
+				mask |= uint32_t(a[i] <= b[i]) << i;
+			return mask;
+		}
+	}
+
+	// The slab test of aabb::intersect on W boxes. Bit l of the result is set when lane l is hit;
+	// t_entry holds the entry distances of those lanes.
+	template<size_t W, std::floating_point T>
+	constexpr uint32_t intersect(const aabb_packet<W, T>& p, const ray<T, 3>& r, T t_max, vec<T, W>& t_entry)
+	{
+		vec<T, W> t0(T(0)), t1(t_max);
+		for (size_t a = 0; a < 3; a++)
+		{
+			// The signs are per ray, so picking the planes is not a per-lane select.
+			const vec<T, W>& near_plane = r.negative[a] ? p.max[a] : p.min[a];
+			const vec<T, W>& far_plane = r.negative[a] ? p.min[a] : p.max[a];
+			const vec<T, W> origin(r.origin[a]);
+			t0 = max(t0, (near_plane - origin) * r.inv_direction[a]);
+			t1 = min(t1, (far_plane - origin) * r.inv_direction[a]);
+		}
+		t_entry = t0;
+		return detail::less_equal_mask(t0, t1);
+	}
+	// Bit l of the result is set when lane l overlaps box.
+	template<size_t W, std::floating_point T>
+	constexpr uint32_t overlaps(const aabb_packet<W, T>& p, const aabb<T, 3>& box)
+	{
+		uint32_t mask = W == 32 ? ~0u : (1u << W) - 1;
+		for (size_t a = 0; a < 3; a++)
+			mask &= detail::less_equal_mask(p.min[a], vec<T, W>(box.max[a])) & detail::less_equal_mask(vec<T, W>(box.min[a]), p.max[a]);
+		return mask;
+	}
+
+	// Packs boxes W per packet; box i goes to lane i % W of packet i / W.
+	template<size_t W, std::floating_point T>
+	std::vector<aabb_packet<W, T>> pack_aabbs(std::span<const aabb<T, 3>> boxes)
+	{
+		std::vector<aabb_packet<W, T>> res((boxes.size() + W - 1) / W);
+		for (size_t i = 0; i < boxes.size(); i++)
+			res[i / W].set(i % W, boxes[i]);
+		return res;
+	}
+	// One ray against many boxes: masks[p] gets the hit mask of packets[p].
+	template<size_t W, std::floating_point T>
+	void intersect(std::span<const aabb_packet<W, T>> packets, const ray<T, 3>& r, T t_max, std::span<uint32_t> masks)
+	{
+		assert(packets.size() == masks.size() && "Batch sizes do not match");
+		vec<T, W> t_entry;
+		for (size_t p = 0; p < packets.size(); p++)
+			masks[p] = intersect(packets[p], r, t_max, t_entry);
+	}
+	// One box against many: masks[p] gets the overlap mask of packets[p].
+	template<size_t W, std::floating_point T>
+	void overlaps(std::span<const aabb_packet<W, T>> packets, const aabb<T, 3>& box, std::span<uint32_t> masks)
+	{
+		assert(packets.size() == masks.size() && "Batch sizes do not match");
+		for (size_t p = 0; p < packets.size(); p++)
+			masks[p] = overlaps(packets[p], box);
+	}
+
+}// namespace mafs
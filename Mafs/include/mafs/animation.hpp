@@ -0,0 +1,369 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+#include "quat.hpp"
+#include "vmath.hpp"
+
+// Keyframe tracks for many joints at once. Keys of every track live in shared arrays; on top of
+// them each track caches its active segment (the two keys around the playback time) in
+// structure-of-arrays form. A sample first refreshes the segments whose validity range no longer
+// holds the time, which for monotonic playback only happens when a key is crossed and is found
+// through the track's cursor. The interpolation then streams through the segment arrays
+// W tracks per vec<float, W> packet, with no per-track gathers.
+namespace mafs
+{
+	enum class interpolation { linear, hermite };
+	enum class quat_interpolation { nlerp, slerp };
+
+	namespace detail
+	{
+		// Index k of the segment [times[k], times[k + 1]] holding t, clamped to the track. The cursor
+		// from the previous call makes monotonic playback a compare or two; seeking falls back to
+		// binary search.
+		inline uint32_t seek_key(const float* times, uint32_t count, uint32_t& cursor, float t)
+		{
+			uint32_t k = cursor;
+			if (t < times[k])
+			{
+				const uint32_t upper = uint32_t(std::upper_bound(times, times + k, t) - times);
+				k = upper > 0 ? upper - 1 : 0;
+			}
+			else
+			{
+				for (uint32_t steps = 0; k + 1 < count && times[k + 1] <= t; k++)
+				{
+					if (++steps > 4)
+					{
+						k = uint32_t(std::upper_bound(times + k + 1, times + count, t) - times) - 1;
+						break;
+					}
+				}
+			}
+			cursor = k;
+			return k;
+		}
+
+		// Cached segment bookkeeping shared by all track kinds. [begin, end) is the time range the
+		// cached keys are valid for; it is unbounded past either end of the track, where the value
+		// is held and inv_dt is 0.
+		struct segment_cache
+		{
+			std::vector<uint32_t> first, count, cursor;
+			std::vector<float> begin, end, t0, inv_dt;
+
+			size_t add(uint32_t key_first, uint32_t key_count)
+			{
+				first.push_back(key_first);
+				count.push_back(key_count);
+				cursor.push_back(0);
+				// An empty range, so the first sample fills the cache.
+				begin.push_back(std::numeric_limits<float>::infinity());
+				end.push_back(-std::numeric_limits<float>::infinity());
+				t0.push_back(0.0f);
+				inv_dt.push_back(0.0f);
+				return first.size() - 1;
+			}
+			bool stale(size_t track, float t) const
+			{
+				return t < begin[track] || t >= end[track];
+			}
+			// Moves the track to the segment holding t; returns the key indices (k0 == k1 when held)
+			// and the segment length.
+			float refresh(size_t track, const float* times, float t, uint32_t& k0, uint32_t& k1)
+			{
+				const float inf = std::numeric_limits<float>::infinity();
+				const uint32_t n = count[track];
+				k0 = seek_key(times, n, cursor[track], t);
+				const bool before = t < times[0];
+				const bool after = k0 + 1 >= n;
+				k1 = before || after ? k0 : k0 + 1;
+				begin[track] = before ? -inf : times[k0];
+				end[track] = before ? times[0] : (after ? inf : times[k1]);
+				t0[track] = times[k0];
+				const float dt = times[k1] - times[k0];
+				inv_dt[track] = k1 != k0 ? 1.0f / dt : 0.0f;
+				return dt;
+			}
+		};
+
+		template<size_t W>
+		vec<float, W> load_lanes(const float* p, size_t lanes)
+		{
+			vec<float, W> res;
+			if (lanes == W)
+			{
+				for (size_t l = 0; l < W; l++)
+					res[l] = p[l];
+			}
+			else
+			{
+				for (size_t l = 0; l < lanes; l++)
+					res[l] = p[l];
+			}
+			return res;
+		}
+
+		template<size_t W>
+		struct quat_lanes
+		{
+			vec<float, W> x, y, z, w;
+		};
+
+		// Normalizes the lanes in place; one packet sqrt instead of W scalar ones.
+		template<size_t W>
+		constexpr void normalize_lanes(quat_lanes<W>& q)
+		{
+			const vec<float, W> inv = vec<float, W>(1.0f) / sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+			q.x *= inv;
+			q.y *= inv;
+			q.z *= inv;
+			q.w *= inv;
+		}
+
+		template<size_t W>
+		constexpr quat_lanes<W> nlerp_lanes(const quat_lanes<W>& a, quat_lanes<W> b, const vec<float, W>& u)
+		{
+			const vec<float, W> d = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+			const vec<bool, W> flip = less_than(d, vec<float, W>(0.0f));
+			b = quat_lanes<W>{ select(flip, -b.x, b.x), select(flip, -b.y, b.y), select(flip, -b.z, b.z), select(flip, -b.w, b.w) };
+			quat_lanes<W> res{ a.x + (b.x - a.x) * u, a.y + (b.y - a.y) * u, a.z + (b.z - a.z) * u, a.w + (b.w - a.w) * u };
+			normalize_lanes(res);
+			return res;
+		}
+	}// namespace detail
+
+	// Many vec3 keyframe tracks (translations or scales). Hermite tracks follow the glTF cubic
+	// spline convention: tangents are per unit time and get scaled by the segment length.
+	class vec3_tracks
+	{
+	public:
+		//-----------------------------Constructors-----------------------------
+		explicit vec3_tracks(interpolation mode = interpolation::linear) : mode(mode) {}
+
+		//-----------------------------Functions-----------------------------
+		// times must be strictly increasing; hermite tracks need one in and one out tangent per key.
+		// Returns the track index.
+		size_t add(std::span<const float> times, std::span<const vec3f> values,
+			std::span<const vec3f> in_tangents = {}, std::span<const vec3f> out_tangents = {})
+		{
+			assert(!times.empty() && times.size() == values.size() && "Every key needs a time and a value");
+			assert((mode == interpolation::linear || (in_tangents.size() == values.size() && out_tangents.size() == values.size()))
+				&& "Hermite tracks need in and out tangents for every key");
+			assert(std::adjacent_find(times.begin(), times.end(), std::greater_equal<float>()) == times.end() && "Key times must increase");
+			cache.add(uint32_t(key_times.size()), uint32_t(times.size()));
+			key_times.insert(key_times.end(), times.begin(), times.end());
+			keys.insert(keys.end(), values.begin(), values.end());
+			if (mode == interpolation::hermite)
+			{
+				key_in.insert(key_in.end(), in_tangents.begin(), in_tangents.end());
+				key_out.insert(key_out.end(), out_tangents.begin(), out_tangents.end());
+			}
+			for (size_t c = 0; c < 3; c++)
+			{
+				p0[c].push_back(0.0f);
+				p1[c].push_back(0.0f);
+				if (mode == interpolation::hermite)
+				{
+					m0[c].push_back(0.0f);
+					m1[c].push_back(0.0f);
+				}
+			}
+			return size() - 1;
+		}
+		size_t size() const { return cache.first.size(); }
+
+		// Samples every track at `time` (clamped to each track's key range) into out[track].
+		template<size_t W = 8>
+		void sample(float time, std::span<vec3f> out)
+		{
+			assert(out.size() == size() && "Output must hold one value per track");
+			for (size_t track = 0; track < size(); track++)
+				if (cache.stale(track, time))
+					refresh(track, time);
+
+			for (size_t base = 0; base < size(); base += W)
+			{
+				const size_t lanes = std::min(W, size() - base);
+				const vec<float, W> u = (vec<float, W>(time) - detail::load_lanes<W>(&cache.t0[base], lanes))
+					* detail::load_lanes<W>(&cache.inv_dt[base], lanes);
+				vec<float, W> res[3];
+				if (mode == interpolation::linear)
+				{
+					for (size_t c = 0; c < 3; c++)
+					{
+						const vec<float, W> a = detail::load_lanes<W>(&p0[c][base], lanes);
+						res[c] = a + (detail::load_lanes<W>(&p1[c][base], lanes) - a) * u;
+					}
+				}
+				else
+				{
+					// Tangents in the cache are already scaled by the segment length.
+					const vec<float, W> u2 = u * u, u3 = u2 * u;
+					const vec<float, W> h01 = u2 * 3.0f - u3 * 2.0f;
+					const vec<float, W> h00 = vec<float, W>(1.0f) - h01;
+					const vec<float, W> h10 = u3 - u2 * 2.0f + u;
+					const vec<float, W> h11 = u3 - u2;
+					for (size_t c = 0; c < 3; c++)
+						res[c] = detail::load_lanes<W>(&p0[c][base], lanes) * h00 + detail::load_lanes<W>(&m0[c][base], lanes) * h10
+							+ detail::load_lanes<W>(&p1[c][base], lanes) * h01 + detail::load_lanes<W>(&m1[c][base], lanes) * h11;
+				}
+				for (size_t l = 0; l < lanes; l++)
+					out[base + l] = vec3f{ res[0][l], res[1][l], res[2][l] };
+			}
+		}
+
+	private:
+		void refresh(size_t track, float time)
+		{
+			const uint32_t first = cache.first[track];
+			uint32_t k0, k1;
+			const float dt = cache.refresh(track, key_times.data() + first, time, k0, k1);
+			for (size_t c = 0; c < 3; c++)
+			{
+				p0[c][track] = keys[first + k0][c];
+				p1[c][track] = keys[first + k1][c];
+				if (mode == interpolation::hermite)
+				{
+					m0[c][track] = key_out[first + k0][c] * dt;
+					m1[c][track] = key_in[first + k1][c] * dt;
+				}
+			}
+		}
+
+		interpolation mode;
+		std::vector<float> key_times;
+		std::vector<vec3f> keys, key_in, key_out;
+		detail::segment_cache cache;
+		std::vector<float> p0[3], p1[3], m0[3], m1[3];
+	};
+
+	// Many rotation tracks. Each cached segment stores its end key already flipped onto the
+	// shorter arc and, for slerp, the arc angle, so sampling is a packet sin pair per segment.
+	class quat_tracks
+	{
+	public:
+		//-----------------------------Constructors-----------------------------
+		explicit quat_tracks(quat_interpolation mode = quat_interpolation::nlerp) : mode(mode) {}
+
+		//-----------------------------Functions-----------------------------
+		// times must be strictly increasing and the keys normalized. Returns the track index.
+		size_t add(std::span<const float> times, std::span<const quatf> values)
+		{
+			assert(!times.empty() && times.size() == values.size() && "Every key needs a time and a value");
+			assert(std::adjacent_find(times.begin(), times.end(), std::greater_equal<float>()) == times.end() && "Key times must increase");
+			cache.add(uint32_t(key_times.size()), uint32_t(times.size()));
+			key_times.insert(key_times.end(), times.begin(), times.end());
+			keys.insert(keys.end(), values.begin(), values.end());
+			for (size_t c = 0; c < 4; c++)
+			{
+				q0[c].push_back(0.0f);
+				q1[c].push_back(0.0f);
+			}
+			theta.push_back(0.0f);
+			inv_sin.push_back(0.0f);
+			return size() - 1;
+		}
+		size_t size() const { return cache.first.size(); }
+
+		template<size_t W = 8>
+		void sample(float time, std::span<quatf> out)
+		{
+			assert(out.size() == size() && "Output must hold one value per track");
+			for (size_t track = 0; track < size(); track++)
+				if (cache.stale(track, time))
+					refresh(track, time);
+
+			for (size_t base = 0; base < size(); base += W)
+			{
+				const size_t lanes = std::min(W, size() - base);
+				const vec<float, W> u = (vec<float, W>(time) - detail::load_lanes<W>(&cache.t0[base], lanes))
+					* detail::load_lanes<W>(&cache.inv_dt[base], lanes);
+				detail::quat_lanes<W> a{ detail::load_lanes<W>(&q0[0][base], lanes), detail::load_lanes<W>(&q0[1][base], lanes),
+					detail::load_lanes<W>(&q0[2][base], lanes), detail::load_lanes<W>(&q0[3][base], lanes) };
+				detail::quat_lanes<W> b{ detail::load_lanes<W>(&q1[0][base], lanes), detail::load_lanes<W>(&q1[1][base], lanes),
+					detail::load_lanes<W>(&q1[2][base], lanes), detail::load_lanes<W>(&q1[3][base], lanes) };
+				vec<float, W> wa = vec<float, W>(1.0f) - u, wb = u;
+				if (mode == quat_interpolation::slerp)
+				{
+					// inv_sin is 0 for nearly equal keys, which keep the lerp weights.
+					const vec<float, W> angle = detail::load_lanes<W>(&theta[base], lanes);
+					const vec<float, W> is = detail::load_lanes<W>(&inv_sin[base], lanes);
+					const vec<bool, W> parallel = less_than(is, vec<float, W>(1e-30f));
+					wa = select(parallel, wa, sin(wa * angle) * is);
+					wb = select(parallel, wb, sin(wb * angle) * is);
+				}
+				detail::quat_lanes<W> res{ a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb };
+				detail::normalize_lanes(res);
+				for (size_t l = 0; l < lanes; l++)
+					out[base + l] = quatf(res.x[l], res.y[l], res.z[l], res.w[l]);
+			}
+		}
+
+	private:
+		void refresh(size_t track, float time)
+		{
+			const uint32_t first = cache.first[track];
+			uint32_t k0, k1;
+			cache.refresh(track, key_times.data() + first, time, k0, k1);
+			const quatf& a = keys[first + k0];
+			quatf b = keys[first + k1];
+			float d = a.dot(b);
+			if (d < 0.0f)
+			{
+				b = -b;
+				d = -d;
+			}
+			for (size_t c = 0; c < 4; c++)
+			{
+				q0[c][track] = a[c];
+				q1[c][track] = b[c];
+			}
+			theta[track] = std::acos(std::min(d, 1.0f));
+			inv_sin[track] = d < 1.0f - 1e-5f ? 1.0f / std::sin(theta[track]) : 0.0f;
+		}
+
+		quat_interpolation mode;
+		std::vector<float> key_times;
+		std::vector<quatf> keys;
+		detail::segment_cache cache;
+		std::vector<float> q0[4], q1[4], theta, inv_sin;
+	};
+
+	//-----------------------------Pose blending-----------------------------
+	// out[i] = a[i] + (b[i] - a[i]) * weight, for translations and scales.
+	inline void blend_poses(std::span<const vec3f> a, std::span<const vec3f> b, float weight, std::span<vec3f> out)
+	{
+		assert(a.size() == b.size() && a.size() == out.size() && "Pose sizes do not match");
+		for (size_t i = 0; i < a.size(); i++)
+			out[i] = a[i].lerp(b[i], weight);
+	}
+
+	// Shortest-arc nlerp of every joint rotation, W joints per packet.
+	template<size_t W = 8>
+	void blend_poses(std::span<const quatf> a, std::span<const quatf> b, float weight, std::span<quatf> out)
+	{
+		assert(a.size() == b.size() && a.size() == out.size() && "Pose sizes do not match");
+		const vec<float, W> u(weight);
+		for (size_t base = 0; base < a.size(); base += W)
+		{
+			const size_t lanes = std::min(W, a.size() - base);
+			detail::quat_lanes<W> la{ {}, {}, {}, vec<float, W>(1.0f) }, lb = la;
+			for (size_t l = 0; l < lanes; l++)
+			{
+				const quatf& qa = a[base + l];
+				const quatf& qb = b[base + l];
+				la.x[l] = qa[0]; la.y[l] = qa[1]; la.z[l] = qa[2]; la.w[l] = qa[3];
+				lb.x[l] = qb[0]; lb.y[l] = qb[1]; lb.z[l] = qb[2]; lb.w[l] = qb[3];
+			}
+			const detail::quat_lanes<W> res = detail::nlerp_lanes(la, lb, u);
+			for (size_t l = 0; l < lanes; l++)
+				out[base + l] = quatf(res.x[l], res.y[l], res.z[l], res.w[l]);
+		}
+	}
+
+}// namespace mafs
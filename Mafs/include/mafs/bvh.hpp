@@ -0,0 +1,610 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+#include "aabb.hpp"
+#include "parallel.hpp"
+#include "triangle.hpp"
+
+namespace mafs
+{
+	struct bvh_build_options
+	{
+		// Leaves never hold more triangles than this; the SAH may stop splitting earlier.
+		uint32_t max_leaf_size = 8;
+		// SAH candidates per axis, at most 64.
+		uint32_t bins = 16;
+		// Cost of visiting a node relative to one triangle test.
+		float traversal_cost = 1.0f;
+		size_t threads = hardware_threads();
+	};
+
+	// 32 bytes. Interior nodes have count == 0 and their two children at first and first + 1;
+	// leaves hold bvh::triangles [first, first + count).
+	struct bvh_node
+	{
+		constexpr bool is_leaf() const { return count > 0; }
+
+		aabb3f bounds;
+		uint32_t first = 0;
+		uint32_t count = 0;
+	};
+	static_assert(sizeof(bvh_node) == 32, "bvh_node should fill half a cache line");
+
+	// A triangle as one vertex and two edges, the form Möller-Trumbore reads.
+	struct bvh_triangle
+	{
+		vec3f v0;
+		vec3f e1;
+		vec3f e2;
+	};
+
+	// Closest hit; triangle is the index in the mesh the hierarchy was built from.
+	struct bvh_hit
+	{
+		static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+		explicit operator bool() const { return triangle != none; }
+
+		float t = std::numeric_limits<float>::infinity();
+		float u = 0.0f;
+		float v = 0.0f;
+		uint32_t triangle = none;
+	};
+
+	namespace detail
+	{
+		inline constexpr uint32_t bvh_max_bins = 64;
+		// Nodes deeper than this split at the centroid median, which bounds the depth, and
+		// with it the traversal stack, by bvh_sah_depth + 32.
+		inline constexpr uint32_t bvh_sah_depth = 32;
+		inline constexpr size_t bvh_stack_size = 64;
+		// Nodes with fewer triangles than these are binned or forked on the calling thread.
+		inline constexpr uint32_t bvh_parallel_bin_size = 1u << 16;
+		inline constexpr uint32_t bvh_fork_size = 1u << 12;
+
+		struct bvh_bin
+		{
+			aabb3f bounds;
+			aabb3f centroids;
+			uint32_t count = 0;
+		};
+
+		// A triangle's box and mesh index. The builder partitions these by value, so binning reads
+		// them in order instead of through an index array.
+		struct bvh_primitive
+		{
+			aabb3f bounds;
+			uint32_t id;
+		};
+
+		struct bvh_stack_entry
+		{
+			uint32_t node;
+			float t;
+		};
+
+		class bvh_builder
+		{
+		public:
+			//-----------------------------Constructors-----------------------------
+			bvh_builder(std::span<bvh_primitive> prims, std::span<bvh_node> nodes, const bvh_build_options& options)
+				: prims(prims), nodes(nodes), options(options)
+			{
+				assert(options.bins >= 2 && options.bins <= bvh_max_bins && "Bin count out of range");
+				fork_depth = options.threads > 1 ? uint32_t(std::bit_width(options.threads - 1)) : 0;
+			}
+			//-----------------------------Functions-----------------------------
+			// bins is scratch for 3 * bvh_max_bins bins, owned by the calling thread.
+			void build(uint32_t node, uint32_t begin, uint32_t end, const aabb3f& bounds, const aabb3f& centroid_bounds, uint32_t depth, bvh_bin* bins)
+			{
+				const uint32_t count = end - begin;
+				nodes[node].bounds = bounds;
+				const vec3f extent = centroid_bounds.extents();
+				if (count == 1 || (count <= options.max_leaf_size && extent.x <= 0.0f && extent.y <= 0.0f && extent.z <= 0.0f))
+				{
+					make_leaf(node, begin, count);
+					return;
+				}
+
+				uint32_t mid = begin;
+				aabb3f child_bounds[2], child_centroids[2];
+				if (depth >= bvh_sah_depth || !split_sah(begin, end, bounds, centroid_bounds, bins, mid, child_bounds, child_centroids))
+				{
+					if (count <= options.max_leaf_size)
+					{
+						make_leaf(node, begin, count);
+						return;
+					}
+					split_median(begin, end, centroid_bounds, mid, child_bounds, child_centroids);
+				}
+
+				const uint32_t left = node_count.fetch_add(2);
+				nodes[node].first = left;
+				nodes[node].count = 0;
+				const bool fork = depth < fork_depth && count >= bvh_fork_size;
+				parallel_invoke(
+					[&]
+					{
+						std::vector<bvh_bin> own(fork ? 3 * bvh_max_bins : 0);
+						build(left, begin, mid, child_bounds[0], child_centroids[0], depth + 1, fork ? own.data() : bins);
+					},
+					[&] { build(left + 1, mid, end, child_bounds[1], child_centroids[1], depth + 1, bins); },
+					fork);
+			}
+
+			std::atomic<uint32_t> node_count{ 1 };
+
+		private:
+			void make_leaf(uint32_t node, uint32_t begin, uint32_t count)
+			{
+				nodes[node].first = begin;
+				nodes[node].count = count;
+			}
+
+			static uint32_t bin_index(float c, float lo, float scale, uint32_t bin_count)
+			{
+				const float k = (c - lo) * scale;
+				return uint32_t(k < float(bin_count - 1) ? k : float(bin_count - 1));
+			}
+
+			// Axis a uses bins [a * bin_count, (a + 1) * bin_count).
+			void bin_range(uint32_t begin, uint32_t end, const aabb3f& centroid_bounds, const vec3f& scale, uint32_t bin_count, bvh_bin* bins) const
+			{
+				for (uint32_t i = begin; i < end; i++)
+				{
+					const aabb3f& b = prims[i].bounds;
+					const vec3f c = b.center();
+					for (size_t a = 0; a < 3; a++)
+					{
+						bvh_bin& bin = bins[a * bin_count + bin_index(c[a], centroid_bounds.min[a], scale[a], bin_count)];
+						bin.bounds = bin.bounds.merge(b);
+						bin.centroids = bin.centroids.merge(c);
+						bin.count++;
+					}
+				}
+			}
+
+			// Bins the centroids on all three axes and sweeps each for the cheapest split. Returns
+			// false when a leaf is cheaper or no bin boundary separates the triangles. Small nodes
+			// use one bin per triangle at most, which keeps clearing the bins cheap near the leaves.
+			bool split_sah(uint32_t begin, uint32_t end, const aabb3f& bounds, const aabb3f& centroid_bounds, bvh_bin* bins,
+				uint32_t& mid, aabb3f* child_bounds, aabb3f* child_centroids)
+			{
+				const uint32_t count = end - begin;
+				const uint32_t bin_count = std::min(options.bins, count);
+				const vec3f extent = centroid_bounds.extents();
+				vec3f scale;
+				for (size_t a = 0; a < 3; a++)
+					scale[a] = extent[a] > 0.0f ? float(bin_count) / extent[a] : 0.0f;
+
+				std::fill_n(bins, 3 * bin_count, bvh_bin());
+				const size_t chunks = count >= bvh_parallel_bin_size ? std::min<size_t>(options.threads, count / (bvh_parallel_bin_size / 4)) : 1;
+				if (chunks > 1)
+				{
+					std::vector<bvh_bin> partial(chunks * 3 * bin_count);
+					parallel_for(chunks, [&](size_t first, size_t last)
+					{
+						for (size_t c = first; c < last; c++)
+							bin_range(begin + uint32_t(count * c / chunks), begin + uint32_t(count * (c + 1) / chunks), centroid_bounds, scale, bin_count, &partial[c * 3 * bin_count]);
+					}, 1, options.threads);
+					for (size_t c = 0; c < chunks; c++)
+						for (size_t b = 0; b < 3 * bin_count; b++)
+						{
+							const bvh_bin& p = partial[c * 3 * bin_count + b];
+							bins[b].bounds = bins[b].bounds.merge(p.bounds);
+							bins[b].centroids = bins[b].centroids.merge(p.centroids);
+							bins[b].count += p.count;
+						}
+				}
+				else
+					bin_range(begin, end, centroid_bounds, scale, bin_count, bins);
+
+				float best_cost = std::numeric_limits<float>::infinity();
+				size_t best_axis = 0;
+				uint32_t best_split = 0;
+				for (size_t a = 0; a < 3; a++)
+				{
+					if (!(extent[a] > 0.0f))
+						continue;
+					const bvh_bin* axis_bins = &bins[a * bin_count];
+					float right_cost[bvh_max_bins];
+					aabb3f right;
+					uint32_t right_count = 0;
+					for (uint32_t b = bin_count - 1; b > 0; b--)
+					{
+						right = right.merge(axis_bins[b].bounds);
+						right_count += axis_bins[b].count;
+						right_cost[b] = right.surface_area() * float(right_count);
+					}
+					aabb3f left;
+					uint32_t left_count = 0;
+					for (uint32_t b = 1; b < bin_count; b++)
+					{
+						left = left.merge(axis_bins[b - 1].bounds);
+						left_count += axis_bins[b - 1].count;
+						const float cost = left.surface_area() * float(left_count) + right_cost[b];
+						if (left_count > 0 && left_count < count && cost < best_cost)
+						{
+							best_cost = cost;
+							best_axis = a;
+							best_split = b;
+						}
+					}
+				}
+				if (best_split == 0)
+					return false;
+				const float area = bounds.surface_area();
+				const float split_cost = options.traversal_cost + (area > 0.0f ? best_cost / area : 0.0f);
+				if (count <= options.max_leaf_size && float(count) <= split_cost)
+					return false;
+
+				const bvh_bin* axis_bins = &bins[best_axis * bin_count];
+				for (size_t side = 0; side < 2; side++)
+				{
+					child_bounds[side] = aabb3f();
+					child_centroids[side] = aabb3f();
+				}
+				for (uint32_t b = 0; b < bin_count; b++)
+				{
+					const size_t side = b < best_split ? 0 : 1;
+					child_bounds[side] = child_bounds[side].merge(axis_bins[b].bounds);
+					child_centroids[side] = child_centroids[side].merge(axis_bins[b].centroids);
+				}
+				const float lo = centroid_bounds.min[best_axis], axis_scale = scale[best_axis];
+				bvh_primitive* split = std::partition(prims.data() + begin, prims.data() + end, [&](const bvh_primitive& p)
+				{
+					return bin_index(p.bounds.center()[best_axis], lo, axis_scale, bin_count) < best_split;
+				});
+				mid = uint32_t(split - prims.data());
+				return true;
+			}
+
+			// Halves the range at the centroid median of the widest axis.
+			void split_median(uint32_t begin, uint32_t end, const aabb3f& centroid_bounds, uint32_t& mid, aabb3f* child_bounds, aabb3f* child_centroids)
+			{
+				const vec3f extent = centroid_bounds.extents();
+				const size_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+				mid = begin + (end - begin) / 2;
+				std::nth_element(prims.data() + begin, prims.data() + mid, prims.data() + end, [&](const bvh_primitive& a, const bvh_primitive& b)
+				{
+					return a.bounds.center()[axis] < b.bounds.center()[axis];
+				});
+				const uint32_t ranges[3] = { begin, mid, end };
+				for (size_t side = 0; side < 2; side++)
+				{
+					child_bounds[side] = aabb3f();
+					child_centroids[side] = aabb3f();
+					for (uint32_t i = ranges[side]; i < ranges[side + 1]; i++)
+					{
+						child_bounds[side] = child_bounds[side].merge(prims[i].bounds);
+						child_centroids[side] = child_centroids[side].merge(prims[i].bounds.center());
+					}
+				}
+			}
+
+			std::span<bvh_primitive> prims;
+			std::span<bvh_node> nodes;
+			const bvh_build_options& options;
+			uint32_t fork_depth = 0;
+		};
+	}
+
+	// Binary bounding volume hierarchy over a triangle mesh, built with binned SAH. Triangles are
+	// copied in leaf order so a leaf's triangles are contiguous.
+	class bvh
+	{
+	public:
+		//-----------------------------Constructors-----------------------------
+		// indices holds three vertex indices per triangle. Subtrees are built in parallel, and the
+		// binning of large nodes near the root is split across threads too.
+		static bvh build(std::span<const vec3f> positions, std::span<const uint32_t> indices, const bvh_build_options& options = {})
+		{
+			assert(indices.size() % 3 == 0 && "Indices must come in triangles");
+			const uint32_t count = uint32_t(indices.size() / 3);
+			bvh res;
+			if (count == 0)
+				return res;
+
+			std::vector<detail::bvh_primitive> prims(count);
+			parallel_for(count, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const vec3f& a = positions[indices[3 * i]];
+					const vec3f& b = positions[indices[3 * i + 1]];
+					const vec3f& c = positions[indices[3 * i + 2]];
+					prims[i] = detail::bvh_primitive{ aabb3f(min(min(a, b), c), max(max(a, b), c)), uint32_t(i) };
+				}
+			}, 4096, options.threads);
+			aabb3f bounds, centroid_bounds;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				bounds = bounds.merge(prims[i].bounds);
+				centroid_bounds = centroid_bounds.merge(prims[i].bounds.center());
+			}
+
+			res.nodes.resize(2 * size_t(count) - 1);
+			detail::bvh_builder builder(prims, res.nodes, options);
+			std::vector<detail::bvh_bin> bins(3 * detail::bvh_max_bins);
+			builder.build(0, 0, count, bounds, centroid_bounds, 0, bins.data());
+			res.nodes.resize(builder.node_count.load());
+
+			res.triangles.resize(count);
+			res.triangle_ids.resize(count);
+			parallel_for(count, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const uint32_t id = prims[i].id;
+					res.triangle_ids[i] = id;
+					const vec3f& v0 = positions[indices[3 * id]];
+					res.triangles[i] = bvh_triangle{ v0, positions[indices[3 * id + 1]] - v0, positions[indices[3 * id + 2]] - v0 };
+				}
+			}, 4096, options.threads);
+			return res;
+		}
+		//-----------------------------Functions-----------------------------
+		aabb3f bounds() const { return nodes.empty() ? aabb3f() : nodes[0].bounds; }
+
+		// Closest hit in [0, t_max). Children are visited nearest first, and stacked nodes whose
+		// boxes start beyond the current hit are skipped.
+		bvh_hit intersect(const rayf& r, float t_max = std::numeric_limits<float>::infinity()) const
+		{
+			bvh_hit hit;
+			hit.t = t_max;
+			float t_root;
+			if (nodes.empty() || !nodes[0].bounds.intersect(r, t_max, t_root))
+				return hit;
+			detail::bvh_stack_entry stack[detail::bvh_stack_size];
+			size_t top = 0;
+			stack[top++] = detail::bvh_stack_entry{ 0, t_root };
+			while (top > 0)
+			{
+				const detail::bvh_stack_entry entry = stack[--top];
+				if (entry.t > hit.t)
+					continue;
+				const bvh_node* node = &nodes[entry.node];
+				while (!node->is_leaf())
+				{
+					float t0, t1;
+					const bool hit0 = nodes[node->first].bounds.intersect(r, hit.t, t0);
+					const bool hit1 = nodes[node->first + 1].bounds.intersect(r, hit.t, t1);
+					if (hit0 && hit1)
+					{
+						const bool swap = t1 < t0;
+						stack[top++] = detail::bvh_stack_entry{ node->first + (swap ? 0u : 1u), swap ? t0 : t1 };
+						node = &nodes[node->first + (swap ? 1u : 0u)];
+					}
+					else if (hit0 || hit1)
+						node = &nodes[node->first + (hit0 ? 0u : 1u)];
+					else
+						break;
+				}
+				if (!node->is_leaf())
+					continue;
+				for (uint32_t i = node->first; i < node->first + node->count; i++)
+				{
+					triangle_hit<float> th;
+					if (detail::intersect_triangle_edges(r, triangles[i].v0, triangles[i].e1, triangles[i].e2, hit.t, th))
+					{
+						hit.t = th.t;
+						hit.u = th.u;
+						hit.v = th.v;
+						hit.triangle = triangle_ids[i];
+					}
+				}
+			}
+			return hit;
+		}
+
+		// Any hit in [0, t_max), for shadow and visibility rays; stops at the first one found.
+		bool occluded(const rayf& r, float t_max = std::numeric_limits<float>::infinity()) const
+		{
+			if (nodes.empty() || !nodes[0].bounds.intersects(r, t_max))
+				return false;
+			uint32_t stack[detail::bvh_stack_size];
+			size_t top = 0;
+			stack[top++] = 0;
+			while (top > 0)
+			{
+				const bvh_node& node = nodes[stack[--top]];
+				if (node.is_leaf())
+				{
+					triangle_hit<float> th;
+					for (uint32_t i = node.first; i < node.first + node.count; i++)
+						if (detail::intersect_triangle_edges(r, triangles[i].v0, triangles[i].e1, triangles[i].e2, t_max, th))
+							return true;
+					continue;
+				}
+				for (uint32_t c = node.first; c < node.first + 2; c++)
+					if (nodes[c].bounds.intersects(r, t_max))
+						stack[top++] = c;
+			}
+			return false;
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		std::vector<bvh_node> nodes;
+		std::vector<bvh_triangle> triangles;
+		// Mesh index of each entry of triangles.
+		std::vector<uint32_t> triangle_ids;
+	};
+
+	// W children per node, collapsed from a binary bvh; children boxes are tested as one
+	// aabb_packet. Lane l is a leaf when count[l] > 0, holding triangles [child[l], child[l] +
+	// count[l]); otherwise child[l] is a node index. Unused lanes have an empty box, so they are
+	// never entered.
+	template<size_t W>
+	struct wide_bvh_node
+	{
+		aabb_packet<W> bounds;
+		uint32_t child[W] = {};
+		uint32_t count[W] = {};
+	};
+
+	template<size_t W>
+	class wide_bvh
+	{
+	public:
+		//-----------------------------Constructors-----------------------------
+		// Each binary node pulls up grandchildren, opening the child with the largest surface
+		// area first, until it has W children or only leaves are left.
+		static wide_bvh from_bvh(const bvh& b)
+		{
+			wide_bvh res;
+			res.triangles = b.triangles;
+			res.triangle_ids = b.triangle_ids;
+			if (!b.nodes.empty())
+			{
+				res.nodes.reserve(b.nodes.size() / 2 + 1);
+				res.collapse(b, 0);
+			}
+			return res;
+		}
+		//-----------------------------Functions-----------------------------
+		bvh_hit intersect(const rayf& r, float t_max = std::numeric_limits<float>::infinity()) const
+		{
+			bvh_hit hit;
+			hit.t = t_max;
+			if (nodes.empty())
+				return hit;
+			stack_entry stack[stack_size];
+			size_t top = 0;
+			stack[top++] = stack_entry{ 0, 0, 0.0f };
+			while (top > 0)
+			{
+				const stack_entry entry = stack[--top];
+				if (entry.t > hit.t)
+					continue;
+				if (entry.count > 0)
+				{
+					for (uint32_t i = entry.ref; i < entry.ref + entry.count; i++)
+					{
+						triangle_hit<float> th;
+						if (detail::intersect_triangle_edges(r, triangles[i].v0, triangles[i].e1, triangles[i].e2, hit.t, th))
+						{
+							hit.t = th.t;
+							hit.u = th.u;
+							hit.v = th.v;
+							hit.triangle = triangle_ids[i];
+						}
+					}
+					continue;
+				}
+				const wide_bvh_node<W>& node = nodes[entry.ref];
+				vec<float, W> t_entry;
+				uint32_t mask = mafs::intersect(node.bounds, r, hit.t, t_entry);
+				// Push the hit children farthest first so the nearest is popped next.
+				const size_t first = top;
+				for (; mask != 0; mask &= mask - 1)
+				{
+					const uint32_t l = uint32_t(std::countr_zero(mask));
+					stack_entry e{ node.child[l], node.count[l], t_entry[l] };
+					size_t k = top++;
+					for (; k > first && stack[k - 1].t < e.t; k--)
+						stack[k] = stack[k - 1];
+					stack[k] = e;
+				}
+			}
+			return hit;
+		}
+
+		bool occluded(const rayf& r, float t_max = std::numeric_limits<float>::infinity()) const
+		{
+			if (nodes.empty())
+				return false;
+			stack_entry stack[stack_size];
+			size_t top = 0;
+			stack[top++] = stack_entry{ 0, 0, 0.0f };
+			while (top > 0)
+			{
+				const stack_entry entry = stack[--top];
+				if (entry.count > 0)
+				{
+					triangle_hit<float> th;
+					for (uint32_t i = entry.ref; i < entry.ref + entry.count; i++)
+						if (detail::intersect_triangle_edges(r, triangles[i].v0, triangles[i].e1, triangles[i].e2, t_max, th))
+							return true;
+					continue;
+				}
+				const wide_bvh_node<W>& node = nodes[entry.ref];
+				vec<float, W> t_entry;
+				for (uint32_t mask = mafs::intersect(node.bounds, r, t_max, t_entry); mask != 0; mask &= mask - 1)
+				{
+					const uint32_t l = uint32_t(std::countr_zero(mask));
+					stack[top++] = stack_entry{ node.child[l], node.count[l], t_entry[l] };
+				}
+			}
+			return false;
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		std::vector<wide_bvh_node<W>> nodes;
+		std::vector<bvh_triangle> triangles;
+		std::vector<uint32_t> triangle_ids;
+
+	private:
+		struct stack_entry
+		{
+			uint32_t ref;
+			uint32_t count;
+			float t;
+		};
+		// Each level pushes at most W - 1 entries beyond the one it pops.
+		static constexpr size_t stack_size = detail::bvh_stack_size * (W - 1) + 1;
+
+		uint32_t collapse(const bvh& b, uint32_t binary)
+		{
+			uint32_t children[W];
+			size_t count = 0;
+			if (b.nodes[binary].is_leaf())
+				children[count++] = binary;
+			else
+			{
+				children[count++] = b.nodes[binary].first;
+				children[count++] = b.nodes[binary].first + 1;
+			}
+			while (count < W)
+			{
+				size_t open = W;
+				float best = -1.0f;
+				for (size_t c = 0; c < count; c++)
+				{
+					const bvh_node& n = b.nodes[children[c]];
+					if (!n.is_leaf() && n.bounds.surface_area() > best)
+					{
+						best = n.bounds.surface_area();
+						open = c;
+					}
+				}
+				if (open == W)
+					break;
+				const uint32_t first = b.nodes[children[open]].first;
+				children[open] = first;
+				children[count++] = first + 1;
+			}
+
+			const uint32_t index = uint32_t(nodes.size());
+			nodes.emplace_back();
+			for (size_t c = 0; c < count; c++)
+			{
+				const bvh_node& n = b.nodes[children[c]];
+				const uint32_t child = n.is_leaf() ? n.first : collapse(b, children[c]);
+				wide_bvh_node<W>& node = nodes[index];
+				node.bounds.set(c, n.bounds);
+				node.child[c] = child;
+				node.count[c] = n.count;
+			}
+			return index;
+		}
+	};
+
+	using bvh4 = wide_bvh<4>;
+	using bvh8 = wide_bvh<8>;
+
+}// namespace mafs
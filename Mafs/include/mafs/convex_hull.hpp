@@ -0,0 +1,423 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "parallel.hpp"
+#include "sphere.hpp"
+#include "vec.hpp"
+
+namespace mafs
+{
+	// 3D convex hull by Quickhull (Barber, Dobkin and Huhdanpaa 1996). The hull is a closed
+	// triangle mesh wound counter-clockwise seen from outside; coplanar regions come out as
+	// several triangles, as faces are not merged. Points within the tolerance of a face count as
+	// inside it, which keeps nearly coplanar input from producing slivers. Which faces a new
+	// point replaces goes by the sign of its distance alone, though: a face it is above by less
+	// than the tolerance would leave a dent, and on many nearly cocircular points the dents
+	// add up until the mesh folds. Face planes of float input are kept in double for the same
+	// reason.
+	//
+	// The mesh is kept as half-edges: face f owns half-edges 3f, 3f + 1 and 3f + 2, the k-th
+	// running from its vertex k to vertex k + 1, so only the twins are stored. Faces, with their
+	// outside point lists, live in a pool with a free list and keep their capacity across
+	// builds, so cooking many hulls with one object allocates little once warm.
+	template<std::floating_point T = float>
+	class convex_hull
+	{
+	public:
+		//-----------------------------Functions-----------------------------
+		// Builds the hull of points. With max_vertices (at least 4) set, the hull stops growing
+		// once it has that many vertices; as each step adds the point farthest out, the result
+		// is a coarse hull of a subset of the points, which need not contain them all. The
+		// initial partitioning of the points over the first faces runs on up to `threads`
+		// threads. Fewer than four points or a flat input give an empty hull.
+		void build(std::span<const vec<T, 3>> points, size_t max_vertices = 0, size_t threads = hardware_threads())
+		{
+			assert(points.size() < size_t(none) && "Indices are 32-bit");
+			assert((max_vertices == 0 || max_vertices >= 4) && "A hull has at least 4 vertices");
+			vertices.clear();
+			indices.clear();
+			vertex_ids.clear();
+			for (face& f : faces)
+				f.outside.clear();
+			free_faces.clear();
+			for (uint32_t i = 0; i < faces.size(); i++)
+				free_faces.push_back(uint32_t(faces.size()) - 1 - i);
+			twins.resize(faces.size() * 3);
+			std::fill(alive.begin(), alive.end(), uint8_t(0));
+			alive.resize(faces.size(), 0);
+			pending.clear();
+			if (points.size() < 4)
+				return;
+
+			vec<T, 3> extent;
+			for (const vec<T, 3>& p : points)
+				extent = max(extent, abs(p));
+			tolerance = T(3) * (extent.x + extent.y + extent.z) * std::numeric_limits<T>::epsilon();
+			uint32_t simplex[4];
+			if (!initial_simplex(points, simplex))
+				return;
+			partition(points, simplex, threads);
+
+			// A step can bury earlier vertices, so the count comes from the faces: a closed
+			// triangle mesh of genus 0 has F = 2V - 4.
+			face_count = 4;
+			uint32_t stamp = 0;
+			while (!pending.empty() && (max_vertices == 0 || (face_count + 4) / 2 < max_vertices))
+			{
+				const uint32_t f = pending.back();
+				if (!alive[f] || faces[f].outside.empty())
+				{
+					pending.pop_back();
+					continue;
+				}
+				add_point(points, faces[f].furthest, f, ++stamp);
+			}
+			extract(points);
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		// Hull vertices, and three indices into them per triangle. vertex_ids[i] is the input
+		// index of vertices[i].
+		std::vector<vec<T, 3>> vertices;
+		std::vector<uint32_t> indices;
+		std::vector<uint32_t> vertex_ids;
+		// Points within this distance of a face plane count as on it; scaled to the input.
+		T tolerance = T(0);
+
+	private:
+		static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+		// Differences and products of floats are exact or nearly so in double.
+		using wide = std::conditional_t<std::is_same_v<T, float>, double, T>;
+
+		struct face
+		{
+			uint32_t v[3] = { 0, 0, 0 };
+			vec<wide, 3> normal;
+			wide offset = wide(0);
+			// Point of the outside set farthest from the plane.
+			uint32_t furthest = none;
+			wide furthest_distance = wide(0);
+			// Last horizon search that found the face visible.
+			uint32_t visited = 0;
+			std::vector<uint32_t> outside;
+		};
+
+		struct horizon_edge
+		{
+			uint32_t from, to, twin;
+		};
+
+		static vec<wide, 3> widen(const vec<T, 3>& p) { return { wide(p.x), wide(p.y), wide(p.z) }; }
+		wide distance(const face& f, const vec<T, 3>& p) const { return f.normal.dot(widen(p)) - f.offset; }
+		// vec::normalize gives zero below a fixed length, which small inputs reach.
+		template<std::floating_point U>
+		static vec<U, 3> unit(const vec<U, 3>& v)
+		{
+			const U len = v.norm();
+			return len > U(0) ? v / len : vec<U, 3>();
+		}
+
+		// Unit normal of triangle abc, from the two edges at the vertex opposite the longest. A
+		// sliver's two long edges are nearly parallel and their cross product mostly rounding.
+		static vec<wide, 3> plane_normal(const vec<wide, 3>& a, const vec<wide, 3>& b, const vec<wide, 3>& c)
+		{
+			const vec<wide, 3> ab = b - a, bc = c - b, ca = a - c;
+			const wide lab = ab.length_squared(), lbc = bc.length_squared(), lca = ca.length_squared();
+			if (lab >= lbc && lab >= lca)
+				return unit(bc.cross(ca));
+			if (lbc >= lca)
+				return unit(ca.cross(ab));
+			return unit(ab.cross(bc));
+		}
+
+		uint32_t new_face(std::span<const vec<T, 3>> points, uint32_t a, uint32_t b, uint32_t c)
+		{
+			uint32_t f;
+			if (free_faces.empty())
+			{
+				f = uint32_t(faces.size());
+				faces.emplace_back();
+				twins.resize(twins.size() + 3);
+				alive.push_back(0);
+			}
+			else
+			{
+				f = free_faces.back();
+				free_faces.pop_back();
+			}
+			face& res = faces[f];
+			res.v[0] = a;
+			res.v[1] = b;
+			res.v[2] = c;
+			res.normal = plane_normal(widen(points[a]), widen(points[b]), widen(points[c]));
+			res.offset = res.normal.dot(widen(points[a]));
+			res.furthest = none;
+			res.furthest_distance = wide(0);
+			res.visited = 0;
+			res.outside.clear();
+			alive[f] = 1;
+			return f;
+		}
+
+		// The two farthest apart of the axis-extreme points, the point farthest from their line
+		// and the point farthest from the plane of the three.
+		bool initial_simplex(std::span<const vec<T, 3>> points, uint32_t simplex[4])
+		{
+			size_t lo[3], hi[3];
+			detail::extreme_points(points, lo, hi);
+			const size_t candidates[6] = { lo[0], hi[0], lo[1], hi[1], lo[2], hi[2] };
+			T best = T(-1);
+			for (size_t i = 0; i < 6; i++)
+				for (size_t j = i + 1; j < 6; j++)
+				{
+					const T d2 = (points[candidates[i]] - points[candidates[j]]).length_squared();
+					if (d2 > best)
+					{
+						best = d2;
+						simplex[0] = uint32_t(candidates[i]);
+						simplex[1] = uint32_t(candidates[j]);
+					}
+				}
+			if (best <= tolerance * tolerance)
+				return false;
+
+			const vec<T, 3> a = points[simplex[0]], ab = unit(points[simplex[1]] - a);
+			best = T(-1);
+			for (uint32_t i = 0; i < points.size(); i++)
+			{
+				const vec<T, 3> ap = points[i] - a;
+				const T d2 = (ap - ab * ab.dot(ap)).length_squared();
+				if (d2 > best)
+				{
+					best = d2;
+					simplex[2] = i;
+				}
+			}
+			if (best <= tolerance * tolerance)
+				return false;
+
+			const vec<T, 3> n = unit(ab.cross(points[simplex[2]] - a));
+			best = T(-1);
+			for (uint32_t i = 0; i < points.size(); i++)
+			{
+				const T d = std::abs(n.dot(points[i] - a));
+				if (d > best)
+				{
+					best = d;
+					simplex[3] = i;
+				}
+			}
+			if (best <= tolerance)
+				return false;
+
+			// Each face of the tetrahedron, wound to face away from the fourth vertex.
+			const uint32_t tri[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+			for (const uint32_t* t : tri)
+			{
+				uint32_t u = simplex[t[0]], v = simplex[t[1]], w = simplex[t[2]];
+				if ((points[v] - points[u]).cross(points[w] - points[u]).dot(points[simplex[t[3]]] - points[u]) > T(0))
+					std::swap(v, w);
+				new_face(points, u, v, w);
+			}
+			// Twins by matching each half-edge with its reverse.
+			for (uint32_t e = 0; e < 12; e++)
+				for (uint32_t o = 0; o < 12; o++)
+					if (origin(e) == origin(next(o)) && origin(next(e)) == origin(o))
+						twins[e] = o;
+			return true;
+		}
+
+		uint32_t origin(uint32_t edge) const { return faces[edge / 3].v[edge % 3]; }
+		static uint32_t next(uint32_t edge) { return edge - edge % 3 + (edge + 1) % 3; }
+
+		// Every point goes to the first of the four faces it lies above, or nowhere if it is
+		// inside them all. Chunks of points are classified in parallel and their lists are
+		// appended in chunk order, so the result does not depend on the thread count.
+		void partition(std::span<const vec<T, 3>> points, const uint32_t simplex[4], size_t threads)
+		{
+			const size_t n = points.size();
+			const size_t chunks = std::max<size_t>(1, std::min(threads, n / 16384));
+			struct chunk_result
+			{
+				std::vector<uint32_t> outside[4];
+				uint32_t furthest[4] = { none, none, none, none };
+				wide furthest_distance[4] = { wide(0), wide(0), wide(0), wide(0) };
+			};
+			std::vector<chunk_result> results(chunks);
+			parallel_for(chunks, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+				{
+					chunk_result& r = results[c];
+					for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; i++)
+					{
+						if (i == simplex[0] || i == simplex[1] || i == simplex[2] || i == simplex[3])
+							continue;
+						for (uint32_t f = 0; f < 4; f++)
+						{
+							const wide d = distance(faces[f], points[i]);
+							if (d > tolerance)
+							{
+								r.outside[f].push_back(uint32_t(i));
+								if (d > r.furthest_distance[f])
+								{
+									r.furthest_distance[f] = d;
+									r.furthest[f] = uint32_t(i);
+								}
+								break;
+							}
+						}
+					}
+				}
+			}, 1, threads);
+			for (uint32_t f = 0; f < 4; f++)
+			{
+				face& dst = faces[f];
+				for (const chunk_result& r : results)
+				{
+					dst.outside.insert(dst.outside.end(), r.outside[f].begin(), r.outside[f].end());
+					if (r.furthest_distance[f] > dst.furthest_distance)
+					{
+						dst.furthest_distance = r.furthest_distance[f];
+						dst.furthest = r.furthest[f];
+					}
+				}
+				if (!dst.outside.empty())
+					pending.push_back(f);
+			}
+		}
+
+		// Adds eye, the farthest point outside face f: the faces it sees, those it is above at
+		// all, are found by a depth-first walk from f, whose non-visible neighbors give the
+		// horizon as a loop of edges in order. The visible faces are replaced by a fan from the horizon to eye, and
+		// their outside points go to the first new face they lie above.
+		void add_point(std::span<const vec<T, 3>> points, uint32_t eye, uint32_t f, uint32_t stamp)
+		{
+			const vec<T, 3> p = points[eye];
+			visible.clear();
+			horizon.clear();
+			faces[f].visited = stamp;
+			visible.push_back(f);
+			// Each entry is the next edge to cross and how many edges of its face are left.
+			walk.clear();
+			walk.push_back({ 3 * f, 3 });
+			while (!walk.empty())
+			{
+				auto& [edge, left] = walk.back();
+				if (left == 0)
+				{
+					walk.pop_back();
+					continue;
+				}
+				const uint32_t e = edge;
+				edge = next(e);
+				left--;
+				const uint32_t t = twins[e];
+				const uint32_t g = t / 3;
+				if (faces[g].visited == stamp)
+					continue;
+				if (distance(faces[g], p) > wide(0))
+				{
+					faces[g].visited = stamp;
+					visible.push_back(g);
+					walk.push_back({ next(t), 2 });
+				}
+				else
+					horizon.push_back({ origin(e), origin(next(e)), t });
+			}
+
+			orphans.clear();
+			for (uint32_t v : visible)
+			{
+				for (uint32_t i : faces[v].outside)
+					if (i != eye)
+						orphans.push_back(i);
+				faces[v].outside.clear();
+				alive[v] = 0;
+				free_faces.push_back(v);
+			}
+
+			created.clear();
+			for (const horizon_edge& h : horizon)
+			{
+				const uint32_t nf = new_face(points, h.from, h.to, eye);
+				twins[3 * nf] = h.twin;
+				twins[h.twin] = 3 * nf;
+				created.push_back(nf);
+			}
+			for (size_t i = 0; i < created.size(); i++)
+			{
+				const uint32_t a = created[i], b = created[(i + 1) % created.size()];
+				twins[3 * a + 1] = 3 * b + 2;
+				twins[3 * b + 2] = 3 * a + 1;
+			}
+
+			for (uint32_t i : orphans)
+			{
+				for (uint32_t nf : created)
+				{
+					face& dst = faces[nf];
+					const wide d = distance(dst, points[i]);
+					if (d > tolerance)
+					{
+						dst.outside.push_back(i);
+						if (d > dst.furthest_distance)
+						{
+							dst.furthest_distance = d;
+							dst.furthest = i;
+						}
+						break;
+					}
+				}
+			}
+			for (uint32_t nf : created)
+				if (!faces[nf].outside.empty())
+					pending.push_back(nf);
+			face_count += created.size() - visible.size();
+		}
+
+		void extract(std::span<const vec<T, 3>> points)
+		{
+			remap.assign(points.size(), none);
+			for (uint32_t f = 0; f < faces.size(); f++)
+			{
+				if (!alive[f])
+					continue;
+				for (uint32_t v : faces[f].v)
+				{
+					if (remap[v] == none)
+					{
+						remap[v] = uint32_t(vertices.size());
+						vertices.push_back(points[v]);
+						vertex_ids.push_back(v);
+					}
+					indices.push_back(remap[v]);
+				}
+			}
+		}
+
+		std::vector<face> faces;
+		std::vector<uint32_t> twins;
+		std::vector<uint8_t> alive;
+		std::vector<uint32_t> free_faces;
+		// Faces that had outside points when last touched; stale entries are skipped.
+		std::vector<uint32_t> pending;
+		size_t face_count = 0;
+		// Scratch of add_point and extract.
+		std::vector<uint32_t> visible;
+		std::vector<horizon_edge> horizon;
+		std::vector<std::pair<uint32_t, uint32_t>> walk;
+		std::vector<uint32_t> orphans;
+		std::vector<uint32_t> created;
+		std::vector<uint32_t> remap;
+	};
+
+	using convex_hullf = convex_hull<float>;
+	using convex_hulld = convex_hull<double>;
+
+}// namespace mafs
@@ -0,0 +1,86 @@
+#pragma once
+#include "quat.hpp"
+
+namespace mafs
+{
+	// Unit dual quaternion for rigid transforms: real is the rotation, dual = 0.5 * (t, 0) * real
+	// carries the translation t. Blending dual quaternions and renormalizing keeps the result
+	// rigid, which is what dual-quaternion skinning relies on.
+	template<std::floating_point T = float>
+	class dual_quat
+	{
+	public:
+		//-----------------------------Constructors-----------------------------
+		constexpr dual_quat() : real(), dual(T(0), T(0), T(0), T(0)) {}
+		constexpr dual_quat(const quat<T>& real, const quat<T>& dual) : real(real), dual(dual) {}
+		static constexpr dual_quat identity() { return dual_quat(); }
+		// Rotates by r, then translates by t.
+		static constexpr dual_quat from_rotation_translation(const quat<T>& r, const vec<T, 3>& t)
+		{
+			return dual_quat(r, quat<T>(t.x * T(0.5), t.y * T(0.5), t.z * T(0.5), T(0)) * r);
+		}
+		// m must be rigid (rotation and translation only).
+		static constexpr dual_quat from_mat4(const mat<T, 4, 4>& m)
+		{
+			return from_rotation_translation(quat<T>::from_mat4(m), m[3].xyz());
+		}
+		//-----------------------------Operators-----------------------------
+		// (*this * o) applies o first, then *this.
+		constexpr dual_quat operator*(const dual_quat& o) const
+		{
+			return dual_quat(real * o.real, quat<T>((real * o.dual).q + (dual * o.real).q));
+		}
+		constexpr dual_quat operator+(const dual_quat& o) const
+		{
+			return dual_quat(quat<T>(real.q + o.real.q), quat<T>(dual.q + o.dual.q));
+		}
+		constexpr dual_quat operator*(T t) const
+		{
+			return dual_quat(quat<T>(real.q * t), quat<T>(dual.q * t));
+		}
+
+		bool operator==(const dual_quat& o) const { return real == o.real && dual == o.dual; }
+		bool operator!=(const dual_quat& o) const { return !(*this == o); }
+
+		friend std::ostream& operator<<(std::ostream& out, const dual_quat& o)
+		{
+			return out << o.real << " + e" << o.dual;
+		}
+		//-----------------------------Functions-----------------------------
+		// Divides by |real|. A blend can leave dual with a component along real; translation()
+		// does not see it, so it is not projected out.
+		constexpr dual_quat normalize() const
+		{
+			const T inv = T(1) / real.norm();
+			return *this * inv;
+		}
+		constexpr dual_quat conjugate() const { return dual_quat(real.conjugate(), dual.conjugate()); }
+		constexpr vec<T, 3> translation() const
+		{
+			return (dual * real.conjugate()).xyz() * T(2);
+		}
+		constexpr vec<T, 3> transform_point(const vec<T, 3>& p) const
+		{
+			return real * p + translation();
+		}
+		constexpr vec<T, 3> transform_vector(const vec<T, 3>& v) const
+		{
+			return real * v;
+		}
+		constexpr mat<T, 4, 4> to_mat4() const
+		{
+			mat<T, 4, 4> m = real.to_mat4();
+			const vec<T, 3> t = translation();
+			m[3] = vec<T, 4>{ t.x, t.y, t.z, T(1) };
+			return m;
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		quat<T> real;
+		quat<T> dual;
+	};
+
+	using dual_quatf = dual_quat<float>;
+	using dual_quatd = dual_quat<double>;
+
+}// namespace mafs
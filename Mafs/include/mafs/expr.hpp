@@ -0,0 +1,135 @@
+#pragma once
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "matrix.hpp"
+
+// Opt-in lazy matrix products.
+//
+//   vec4 p = mafs::chain(proj) * view * model * v;   // proj * (view * (model * v))
+//   mat4 pv = mafs::chain(proj) * view;              // plain product, evaluated on conversion
+//
+// A chain that ends in a vector is evaluated right-to-left as matrix-vector products only.
+// Factors written as mafs::fixed<M> (M a constexpr mat) are compile-time constants, and
+// adjacent fixed factors are multiplied together while compiling. A chain only keeps
+// pointers to its runtime factors, so evaluate it within the expression that builds it.
+// Chains pay off when the factors change per vector; a prefix shared by many vectors
+// (proj * view) is still cheaper to multiply once outside the loop.
+namespace mafs
+{
+	template<typename M>
+	struct mat_dims;
+	template<typename T, size_t R, size_t C>
+	struct mat_dims<mat<T, R, C>>
+	{
+		using value_type = T;
+		static constexpr size_t rows = R;
+		static constexpr size_t cols = C;
+	};
+
+	template<typename T, size_t R, size_t C>
+	struct mat_ref
+	{
+		using mat_type = mat<T, R, C>;
+		constexpr const mat_type& get() const { return *m; }
+		const mat_type* m;
+	};
+
+	template<auto M>
+	struct fixed_mat
+	{
+		using mat_type = std::remove_cvref_t<decltype(M)>;
+		static constexpr mat_type value = M;
+		constexpr const mat_type& get() const { return value; }
+	};
+	template<auto M>
+	inline constexpr fixed_mat<M> fixed{};
+
+	template<typename F>
+	inline constexpr bool is_fixed_mat = false;
+	template<auto M>
+	inline constexpr bool is_fixed_mat<fixed_mat<M>> = true;
+
+	template<typename... F>
+	class mat_chain
+	{
+		using factor_tuple = std::tuple<F...>;
+		using first_type = typename std::tuple_element_t<0, factor_tuple>::mat_type;
+		using last_type = typename std::tuple_element_t<sizeof...(F) - 1, factor_tuple>::mat_type;
+	public:
+		using value_type = typename mat_dims<first_type>::value_type;
+		static constexpr size_t rows = mat_dims<first_type>::rows;
+		static constexpr size_t cols = mat_dims<last_type>::cols;
+		using result_type = mat<value_type, rows, cols>;
+
+		//-----------------------------Constructors-----------------------------
+		constexpr explicit mat_chain(const factor_tuple& f) : factors{ f } {}
+		//-----------------------------Operators-----------------------------
+		template<size_t R, size_t C>
+		constexpr auto operator*(const mat<value_type, R, C>& m) const
+		{
+			static_assert(R == cols, "Matrix dimensions do not match");
+			return mat_chain<F..., mat_ref<value_type, R, C>>(std::tuple_cat(factors, std::tuple{ mat_ref<value_type, R, C>{ &m } }));
+		}
+		template<auto M>
+		constexpr auto operator*(fixed_mat<M> f) const
+		{
+			static_assert(std::is_same_v<typename mat_dims<std::remove_cvref_t<decltype(M)>>::value_type, value_type>, "Matrix types do not match");
+			static_assert(mat_dims<std::remove_cvref_t<decltype(M)>>::rows == cols, "Matrix dimensions do not match");
+			using last = std::tuple_element_t<sizeof...(F) - 1, factor_tuple>;
+			if constexpr (is_fixed_mat<last>)
+				return replace_last(std::make_index_sequence<sizeof...(F) - 1>{}, fixed_mat<last::value * M>{});
+			else
+				return mat_chain<F..., fixed_mat<M>>(std::tuple_cat(factors, std::tuple{ f }));
+		}
+		constexpr vec<value_type, rows> operator*(const vec<value_type, cols>& v) const
+		{
+			return apply<sizeof...(F) - 1>(v);
+		}
+		constexpr operator result_type() const { return eval(); }
+		//-----------------------------Functions-----------------------------
+		constexpr result_type eval() const
+		{
+			return product<1>(std::get<0>(factors).get());
+		}
+		constexpr size_t size() const { return sizeof...(F); }
+
+		//-----------------------------Public Variables -----------------------------
+		factor_tuple factors;
+
+	private:
+		template<size_t I, typename V>
+		constexpr auto apply(const V& v) const
+		{
+			if constexpr (I == 0)
+				return std::get<0>(factors).get() * v;
+			else
+				return apply<I - 1>(std::get<I>(factors).get() * v);
+		}
+		template<size_t I, typename M>
+		constexpr auto product(const M& acc) const
+		{
+			if constexpr (I == sizeof...(F))
+				return acc;
+			else
+				return product<I + 1>(acc * std::get<I>(factors).get());
+		}
+		template<size_t... I, typename G>
+		constexpr auto replace_last(std::index_sequence<I...>, G g) const
+		{
+			return mat_chain<std::tuple_element_t<I, factor_tuple>..., G>(std::tuple{ std::get<I>(factors)..., g });
+		}
+	};
+
+	template<typename T, size_t R, size_t C>
+	constexpr auto chain(const mat<T, R, C>& m)
+	{
+		return mat_chain<mat_ref<T, R, C>>(std::tuple{ mat_ref<T, R, C>{ &m } });
+	}
+	template<auto M>
+	constexpr auto chain(fixed_mat<M> f)
+	{
+		return mat_chain<fixed_mat<M>>(std::tuple{ f });
+	}
+
+}// namespace mafs
@@ -0,0 +1,225 @@
+#pragma once
+#include <cstdint>
+#include "aabb.hpp"
+#include "parallel.hpp"
+#include "sphere.hpp"
+
+namespace mafs
+{
+	// Six planes (n, d) with unit normals pointing inwards, so dot(n, p) + d is the signed
+	// distance of p from each plane, positive inside. The order is left, right, bottom, top,
+	// near, far in clip-space terms; with reversed z the last two trade places.
+	template<std::floating_point T = float>
+	class view_frustum
+	{
+	public:
+		//-----------------------------Constructors-----------------------------
+		// Gribb/Hartmann: each clip-space bound -w <= x <= w etc. is a sum or difference of two
+		// rows of m. Pass projection * view to get world-space planes, or projection * view *
+		// model for object space. A plane with a zero normal, such as the far plane of an
+		// infinite projection, is stored as (0, 0, 0, 1) and always passes.
+		static constexpr view_frustum from_matrix(const mat<T, 4, 4>& m, clip_depth depth = clip_depth::minus_one_to_one)
+		{
+			vec<T, 4> rows[4];
+			for (size_t r = 0; r < 4; r++)
+				rows[r] = vec<T, 4>{ m[0][r], m[1][r], m[2][r], m[3][r] };
+			view_frustum res;
+			res.planes[0] = rows[3] + rows[0];
+			res.planes[1] = rows[3] - rows[0];
+			res.planes[2] = rows[3] + rows[1];
+			res.planes[3] = rows[3] - rows[1];
+			res.planes[4] = depth == clip_depth::zero_to_one ? rows[2] : rows[3] + rows[2];
+			res.planes[5] = rows[3] - rows[2];
+			for (vec<T, 4>& p : res.planes)
+			{
+				const T len = p.xyz().norm();
+				p = len > T(0) ? p / len : vec<T, 4>{ T(0), T(0), T(0), T(1) };
+			}
+			return res;
+		}
+		//-----------------------------Functions-----------------------------
+		constexpr T distance(size_t plane, const vec<T, 3>& p) const
+		{
+			return planes[plane].xyz().dot(p) + planes[plane].w;
+		}
+		constexpr bool contains(const vec<T, 3>& p) const
+		{
+			for (size_t i = 0; i < 6; i++)
+				if (distance(i, p) < T(0))
+					return false;
+			return true;
+		}
+		// The tests below are conservative: an object outside but near a corner of the frustum
+		// can pass, since each plane is tested on its own.
+		constexpr bool intersects(const sphere<T>& s) const
+		{
+			if (!(s.radius >= T(0)))
+				return false;
+			for (size_t i = 0; i < 6; i++)
+				if (!(distance(i, s.center) >= -s.radius))
+					return false;
+			return true;
+		}
+		// Tests the corner furthest along each plane normal; empty boxes never pass.
+		constexpr bool intersects(const aabb<T, 3>& b) const
+		{
+			for (const vec<T, 4>& p : planes)
+			{
+				const vec<T, 3> corner{ p.x < T(0) ? b.min.x : b.max.x, p.y < T(0) ? b.min.y : b.max.y, p.z < T(0) ? b.min.z : b.max.z };
+				if (!(p.xyz().dot(corner) + p.w >= T(0)))
+					return false;
+			}
+			return true;
+		}
+		// Exact: the whole box is inside when the corner nearest along each plane normal is.
+		constexpr bool contains(const aabb<T, 3>& b) const
+		{
+			if (b.is_empty())
+				return false;
+			for (const vec<T, 4>& p : planes)
+			{
+				const vec<T, 3> corner{ p.x < T(0) ? b.max.x : b.min.x, p.y < T(0) ? b.max.y : b.min.y, p.z < T(0) ? b.max.z : b.min.z };
+				if (!(p.xyz().dot(corner) + p.w >= T(0)))
+					return false;
+			}
+			return true;
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		vec<T, 4> planes[6];
+	};
+
+	using view_frustumf = view_frustum<float>;
+	using view_frustumd = view_frustum<double>;
+
+	// The planes of a frustum broadcast to W lanes, with the box corner each plane tests picked
+	// up front. Build it once per batch; the packet tests then do no per-plane setup.
+	template<size_t W, std::floating_point T = float>
+	struct frustum_packet
+	{
+		//-----------------------------Constructors-----------------------------
+		constexpr frustum_packet(const view_frustum<T>& f)
+		{
+			for (size_t i = 0; i < 6; i++)
+			{
+				const vec<T, 4>& p = f.planes[i];
+				x[i] = vec<T, W>(p.x);
+				y[i] = vec<T, W>(p.y);
+				z[i] = vec<T, W>(p.z);
+				d[i] = vec<T, W>(p.w);
+				use_min[i] = vec<bool, 3>{ p.x < T(0), p.y < T(0), p.z < T(0) };
+			}
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		vec<T, W> x[6], y[6], z[6], d[6];
+		// Per plane and axis, whether the furthest corner along the normal is on the min side.
+		vec<bool, 3> use_min[6];
+	};
+
+	// Bit l is set when lane l of the packet is at least partly inside f. Empty lanes never are.
+	template<size_t W, std::floating_point T>
+	constexpr uint32_t inside_mask(const frustum_packet<W, T>& f, const sphere_packet<W, T>& s)
+	{
+		uint32_t mask = detail::less_equal_mask(vec<T, W>(T(0)), s.radius);
+		for (size_t i = 0; i < 6; i++)
+		{
+			const vec<T, W> dist = s.x * f.x[i] + s.y * f.y[i] + s.z * f.z[i] + (s.radius + f.d[i]);
+			mask &= detail::less_equal_mask(vec<T, W>(T(0)), dist);
+		}
+		return mask;
+	}
+	template<size_t W, std::floating_point T>
+	constexpr uint32_t inside_mask(const frustum_packet<W, T>& f, const aabb_packet<W, T>& b)
+	{
+		uint32_t mask = W == 32 ? ~0u : (1u << W) - 1;
+		for (size_t i = 0; i < 6; i++)
+		{
+			// The normal's signs are shared by all lanes, so the corner pick is not a per-lane select.
+			const vec<T, W>& x = f.use_min[i].x ? b.min[0] : b.max[0];
+			const vec<T, W>& y = f.use_min[i].y ? b.min[1] : b.max[1];
+			const vec<T, W>& z = f.use_min[i].z ? b.min[2] : b.max[2];
+			const vec<T, W> dist = x * f.x[i] + y * f.y[i] + z * f.z[i] + f.d[i];
+			mask &= detail::less_equal_mask(vec<T, W>(T(0)), dist);
+		}
+		return mask;
+	}
+
+	namespace detail
+	{
+		// Writes base + l for every set bit l of mask to out and returns how many. All W slots
+		// are written, so the loop has no branches; out needs room for W indices.
+		template<size_t W>
+		inline size_t append_lanes(uint32_t mask, uint32_t base, uint32_t* out)
+		{
+			size_t n = 0;
+			for (size_t l = 0; l < W; l++)
+			{
+				out[n] = base + uint32_t(l);
+				n += (mask >> l) & 1u;
+			}
+			return n;
+		}
+		template<size_t W, std::floating_point T, typename Packet>
+		size_t cull_range(const view_frustum<T>& f, std::span<const Packet> packets, size_t begin, size_t end, uint32_t* out)
+		{
+			const frustum_packet<W, T> planes(f);
+			size_t n = 0;
+			for (size_t p = begin; p < end; p++)
+				n += append_lanes<W>(inside_mask(planes, packets[p]), uint32_t(p * W), out + n);
+			return n;
+		}
+		// Each chunk of packets compacts into its own slice of out, then the slices are moved
+		// down in order. The move touches only the visible indices.
+		template<size_t W, std::floating_point T, typename Packet>
+		size_t cull_parallel(const view_frustum<T>& f, std::span<const Packet> packets, std::span<uint32_t> out, size_t threads, size_t chunk)
+		{
+			assert(out.size() >= packets.size() * W && "Output needs room for every lane");
+			assert(packets.size() * W <= size_t(UINT32_MAX) && "Indices are 32-bit");
+			chunk = std::max<size_t>(chunk, 1);
+			const size_t chunk_count = (packets.size() + chunk - 1) / chunk;
+			std::vector<size_t> counts(chunk_count);
+			parallel_for(chunk_count, [&](size_t begin, size_t end)
+			{
+				for (size_t c = begin; c < end; c++)
+					counts[c] = cull_range<W>(f, packets, c * chunk, std::min(packets.size(), (c + 1) * chunk), out.data() + c * chunk * W);
+			}, 1, threads);
+			size_t n = chunk_count > 0 ? counts[0] : 0;
+			for (size_t c = 1; c < chunk_count; c++)
+			{
+				const uint32_t* slice = out.data() + c * chunk * W;
+				std::copy(slice, slice + counts[c], out.data() + n);
+				n += counts[c];
+			}
+			return n;
+		}
+	}
+
+	// Writes the indices of the objects at least partly inside f to out, in increasing order,
+	// and returns how many there are. Object i is lane i % W of packet i / W. out needs room for
+	// packets.size() * W indices.
+	template<size_t W, std::floating_point T>
+	size_t cull(const view_frustum<T>& f, std::span<const sphere_packet<W, T>> packets, std::span<uint32_t> out)
+	{
+		assert(out.size() >= packets.size() * W && "Output needs room for every lane");
+		return detail::cull_range<W>(f, packets, 0, packets.size(), out.data());
+	}
+	template<size_t W, std::floating_point T>
+	size_t cull(const view_frustum<T>& f, std::span<const aabb_packet<W, T>> packets, std::span<uint32_t> out)
+	{
+		assert(out.size() >= packets.size() * W && "Output needs room for every lane");
+		return detail::cull_range<W>(f, packets, 0, packets.size(), out.data());
+	}
+	// As above, on up to `threads` threads in chunks of `chunk` packets. The result is the same.
+	template<size_t W, std::floating_point T>
+	size_t cull(const view_frustum<T>& f, std::span<const sphere_packet<W, T>> packets, std::span<uint32_t> out, size_t threads, size_t chunk = 1024)
+	{
+		return detail::cull_parallel<W>(f, packets, out, threads, chunk);
+	}
+	template<size_t W, std::floating_point T>
+	size_t cull(const view_frustum<T>& f, std::span<const aabb_packet<W, T>> packets, std::span<uint32_t> out, size_t threads, size_t chunk = 1024)
+	{
+		return detail::cull_parallel<W>(f, packets, out, threads, chunk);
+	}
+
+}// namespace mafs
@@ -0,0 +1,721 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include "aabb.hpp"
+#include "convex_hull.hpp"
+#include "quat.hpp"
+#include "sphere.hpp"
+
+namespace mafs
+{
+	// Shapes for the GJK and EPA queries below. A shape is a convex core, described by
+	// support(shape, d), the point of the core farthest along d, and a margin, the radius of
+	// the ball swept over the core. Spheres and capsules are a point and a segment with a
+	// margin, so the queries solve them exactly on the core. Other shapes take part by
+	// overloading support and margin, found by argument-dependent lookup, or through
+	// support_callback.
+
+	template<std::floating_point T = float>
+	struct capsule
+	{
+		vec<T, 3> a, b;
+		T radius = T(0);
+	};
+
+	using capsulef = capsule<float>;
+	using capsuled = capsule<double>;
+
+	// Points whose convex hull is the shape, e.g. the vertices of a cooked hull.
+	template<std::floating_point T = float>
+	struct convex_points
+	{
+		std::span<const vec<T, 3>> points;
+	};
+
+	// A shape placed by a rotation then a translation; transformed<aabb3f> is an oriented box.
+	template<typename Shape, std::floating_point T = float>
+	struct transformed
+	{
+		Shape shape;
+		quat<T> rotation;
+		vec<T, 3> translation;
+	};
+
+	// Any support function F(d) -> vec<T, 3>.
+	template<typename F, std::floating_point T = float>
+	struct support_callback
+	{
+		F fn;
+		T radius = T(0);
+	};
+
+	template<std::floating_point T>
+	vec<T, 3> support(const sphere<T>& s, const vec<T, 3>&) { return s.center; }
+	template<std::floating_point T>
+	T margin(const sphere<T>& s) { return s.radius; }
+
+	template<std::floating_point T>
+	vec<T, 3> support(const capsule<T>& c, const vec<T, 3>& d) { return d.dot(c.b - c.a) > T(0) ? c.b : c.a; }
+	template<std::floating_point T>
+	T margin(const capsule<T>& c) { return c.radius; }
+
+	template<std::floating_point T>
+	vec<T, 3> support(const aabb<T, 3>& b, const vec<T, 3>& d)
+	{
+		return vec<T, 3>{ d.x > T(0) ? b.max.x : b.min.x, d.y > T(0) ? b.max.y : b.min.y, d.z > T(0) ? b.max.z : b.min.z };
+	}
+	template<std::floating_point T>
+	T margin(const aabb<T, 3>&) { return T(0); }
+
+	// Linear scan; hulls for collision are small, and the scan has no branches to mispredict
+	// beyond the running maximum.
+	template<std::floating_point T>
+	vec<T, 3> support(const convex_points<T>& c, const vec<T, 3>& d)
+	{
+		assert(!c.points.empty() && "A shape needs a point");
+		size_t best = 0;
+		T best_dot = c.points[0].dot(d);
+		for (size_t i = 1; i < c.points.size(); i++)
+		{
+			const T dot = c.points[i].dot(d);
+			if (dot > best_dot)
+			{
+				best_dot = dot;
+				best = i;
+			}
+		}
+		return c.points[best];
+	}
+	template<std::floating_point T>
+	T margin(const convex_points<T>&) { return T(0); }
+
+	template<std::floating_point T>
+	vec<T, 3> support(const convex_hull<T>& h, const vec<T, 3>& d) { return support(convex_points<T>{ h.vertices }, d); }
+	template<std::floating_point T>
+	T margin(const convex_hull<T>&) { return T(0); }
+
+	template<typename Shape, std::floating_point T>
+	vec<T, 3> support(const transformed<Shape, T>& t, const vec<T, 3>& d)
+	{
+		return t.translation + t.rotation.rotate(support(t.shape, t.rotation.conjugate().rotate(d)));
+	}
+	template<typename Shape, std::floating_point T>
+	T margin(const transformed<Shape, T>& t) { return margin(t.shape); }
+
+	template<typename F, std::floating_point T>
+	vec<T, 3> support(const support_callback<F, T>& s, const vec<T, 3>& d) { return s.fn(d); }
+	template<typename F, std::floating_point T>
+	T margin(const support_callback<F, T>& s) { return s.radius; }
+
+	// Search directions of the last simplex of a pair. Passing the same cache to the next
+	// query of the pair restarts GJK from the supports along these directions, which for
+	// shapes that moved a little is a simplex next to the answer; a new cache starts cold.
+	template<std::floating_point T = float>
+	struct gjk_cache
+	{
+		vec<T, 3> directions[4];
+		uint32_t count = 0;
+	};
+
+	// Closest points of two separated shapes, on their surfaces, and the unit normal from A to
+	// B. When the shapes touch or overlap, intersecting is set and distance is 0.
+	template<std::floating_point T = float>
+	struct gjk_result
+	{
+		bool intersecting = false;
+		T distance = T(0);
+		vec<T, 3> point_a, point_b;
+		vec<T, 3> normal;
+		uint32_t iterations = 0;
+	};
+
+	// Moving B by depth along normal separates the shapes; point_a and point_b are the deepest
+	// points of each shape inside the other. A negative depth is the distance of separated
+	// shapes, whose points are then the closest points.
+	template<std::floating_point T = float>
+	struct contact
+	{
+		T depth = T(0);
+		vec<T, 3> normal;
+		vec<T, 3> point_a, point_b;
+	};
+
+	namespace detail
+	{
+		template<std::floating_point T>
+		constexpr T gjk_tolerance() { return T(100) * std::numeric_limits<T>::epsilon(); }
+
+		template<std::floating_point T>
+		struct gjk_simplex
+		{
+			// Vertex i of the Minkowski difference is a[i] - b[i], found along direction d[i].
+			vec<T, 3> w[4], a[4], b[4], d[4];
+			T lambda[4];
+			uint32_t count = 0;
+
+			void keep(std::initializer_list<uint32_t> which, std::initializer_list<T> weights)
+			{
+				vec<T, 3> nw[4], na[4], nb[4], nd[4];
+				uint32_t k = 0;
+				for (uint32_t i : which)
+				{
+					nw[k] = w[i];
+					na[k] = a[i];
+					nb[k] = b[i];
+					nd[k] = d[i];
+					k++;
+				}
+				k = 0;
+				for (T l : weights)
+					lambda[k++] = l;
+				for (uint32_t i = 0; i < k; i++)
+				{
+					w[i] = nw[i];
+					a[i] = na[i];
+					b[i] = nb[i];
+					d[i] = nd[i];
+				}
+				count = k;
+			}
+
+			vec<T, 3> point() const
+			{
+				vec<T, 3> res;
+				for (uint32_t i = 0; i < count; i++)
+					res += w[i] * lambda[i];
+				return res;
+			}
+			void witnesses(vec<T, 3>& pa, vec<T, 3>& pb) const
+			{
+				pa = pb = vec<T, 3>();
+				for (uint32_t i = 0; i < count; i++)
+				{
+					pa += a[i] * lambda[i];
+					pb += b[i] * lambda[i];
+				}
+			}
+
+			// Closest point of triangle (i, j, k) to the origin (Ericson 5.1.5), as the
+			// smallest feature holding it. Returns the squared distance without changing the
+			// simplex when apply is false.
+			T solve_triangle(uint32_t i, uint32_t j, uint32_t k, bool apply)
+			{
+				const vec<T, 3> A = w[i], B = w[j], C = w[k];
+				const vec<T, 3> ab = B - A, ac = C - A;
+				const T d1 = -ab.dot(A), d2 = -ac.dot(A);
+				if (d1 <= T(0) && d2 <= T(0))
+					return finish({ i }, { T(1) }, apply);
+				const T d3 = -ab.dot(B), d4 = -ac.dot(B);
+				if (d3 >= T(0) && d4 <= d3)
+					return finish({ j }, { T(1) }, apply);
+				const T vc = d1 * d4 - d3 * d2;
+				if (vc <= T(0) && d1 >= T(0) && d3 <= T(0))
+				{
+					const T v = d1 / (d1 - d3);
+					return finish({ i, j }, { T(1) - v, v }, apply);
+				}
+				const T d5 = -ab.dot(C), d6 = -ac.dot(C);
+				if (d6 >= T(0) && d5 <= d6)
+					return finish({ k }, { T(1) }, apply);
+				const T vb = d5 * d2 - d1 * d6;
+				if (vb <= T(0) && d2 >= T(0) && d6 <= T(0))
+				{
+					const T v = d2 / (d2 - d6);
+					return finish({ i, k }, { T(1) - v, v }, apply);
+				}
+				const T va = d3 * d6 - d5 * d4;
+				if (va <= T(0) && d4 - d3 >= T(0) && d5 - d6 >= T(0))
+				{
+					const T v = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+					return finish({ j, k }, { T(1) - v, v }, apply);
+				}
+				const T denom = T(1) / (va + vb + vc);
+				const T v = vb * denom, u = vc * denom;
+				return finish({ i, j, k }, { T(1) - v - u, v, u }, apply);
+			}
+
+			T finish(std::initializer_list<uint32_t> which, std::initializer_list<T> weights, bool apply)
+			{
+				vec<T, 3> p;
+				auto l = weights.begin();
+				for (uint32_t i : which)
+					p += w[i] * *l++;
+				if (apply)
+					keep(which, weights);
+				return p.length_squared();
+			}
+
+			// Whether vertex l is within rounding of the plane of face (i, j, k): the distance
+			// to the plane is at most the GJK tolerance of the longest edge.
+			bool in_plane(uint32_t i, uint32_t j, uint32_t k, uint32_t l) const
+			{
+				T longest = T(0);
+				for (uint32_t a = 0; a < 4; a++)
+					for (uint32_t b = a + 1; b < 4; b++)
+						longest = std::max(longest, (w[a] - w[b]).length_squared());
+				const vec<T, 3> n = (w[j] - w[i]).cross(w[k] - w[i]);
+				return std::abs(n.dot(w[l] - w[i])) <= gjk_tolerance<T>() * std::sqrt(longest) * n.norm();
+			}
+
+			// Reduces the simplex to the feature closest to the origin and sets the weights.
+			// Returns false when the origin is inside the tetrahedron.
+			bool solve()
+			{
+				switch (count)
+				{
+				case 1:
+					lambda[0] = T(1);
+					return true;
+				case 2:
+				{
+					const vec<T, 3> ab = w[1] - w[0];
+					const T len2 = ab.length_squared();
+					const T t = len2 > T(0) ? -w[0].dot(ab) / len2 : T(0);
+					if (t <= T(0))
+						keep({ 0 }, { T(1) });
+					else if (t >= T(1))
+						keep({ 1 }, { T(1) });
+					else
+						keep({ 0, 1 }, { T(1) - t, t });
+					return true;
+				}
+				case 3:
+					solve_triangle(0, 1, 2, true);
+					return true;
+				default:
+				{
+					// The origin is outside a face when it is on the other side of it from the
+					// fourth vertex. A tetrahedron flat to within rounding has no inside, and the
+					// sign of its volume is noise, so then all faces are tried.
+					static constexpr uint32_t face[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+					bool outside[4];
+					bool any = false;
+					for (uint32_t f = 0; f < 4; f++)
+					{
+						const vec<T, 3> A = w[face[f][0]];
+						const vec<T, 3> n = (w[face[f][1]] - A).cross(w[face[f][2]] - A);
+						const T side_o = -n.dot(A), side_d = n.dot(w[face[f][3]] - A);
+						outside[f] = side_o * side_d < T(0) || in_plane(face[f][0], face[f][1], face[f][2], face[f][3]);
+						any = any || outside[f];
+					}
+					if (!any)
+						return false;
+					uint32_t best = 4;
+					T best_d2 = std::numeric_limits<T>::infinity();
+					for (uint32_t f = 0; f < 4; f++)
+					{
+						if (!outside[f])
+							continue;
+						const T d2 = solve_triangle(face[f][0], face[f][1], face[f][2], false);
+						if (d2 < best_d2)
+						{
+							best_d2 = d2;
+							best = f;
+						}
+					}
+					solve_triangle(face[best][0], face[best][1], face[best][2], true);
+					return true;
+				}
+				}
+			}
+		};
+
+		template<typename A, typename B, std::floating_point T>
+		void gjk_add(gjk_simplex<T>& s, const A& a, const B& b, const vec<T, 3>& d)
+		{
+			const uint32_t i = s.count++;
+			s.d[i] = d;
+			s.a[i] = support(a, d);
+			s.b[i] = support(b, -d);
+			s.w[i] = s.a[i] - s.b[i];
+		}
+
+		// GJK on the cores. Returns false when they intersect; otherwise the simplex holds the
+		// closest feature and its weights. The cache is read and then updated.
+		template<typename A, typename B, std::floating_point T>
+		bool gjk_cores(const A& a, const B& b, gjk_cache<T>& cache, gjk_simplex<T>& s, uint32_t& iterations)
+		{
+			constexpr uint32_t max_iterations = 64;
+			constexpr T rel = gjk_tolerance<T>();
+			s.count = 0;
+			for (uint32_t i = 0; i < cache.count; i++)
+			{
+				gjk_add(s, a, b, cache.directions[i]);
+				// Supports that moved onto each other leave a degenerate simplex; drop them.
+				for (uint32_t j = 0; j + 1 < s.count; j++)
+					if ((s.w[j] - s.w[s.count - 1]).length_squared() <= rel * rel * s.w[j].length_squared())
+					{
+						s.count--;
+						break;
+					}
+			}
+			if (s.count == 0)
+				gjk_add(s, a, b, vec<T, 3>{ T(1), T(0), T(0) });
+			bool separated = s.solve();
+			vec<T, 3> v = s.point();
+			T vv = v.length_squared();
+			iterations = 0;
+			while (separated && iterations < max_iterations)
+			{
+				iterations++;
+				// The origin on the simplex: touching cores count as intersecting.
+				if (vv <= rel * rel * s.w[0].length_squared() || vv == T(0))
+				{
+					separated = false;
+					break;
+				}
+				if (s.count == 4)
+					break;
+				const uint32_t added = s.count;
+				gjk_add(s, a, b, -v);
+				// No vertex further toward the origin than the closest point: converged.
+				if (vv - v.dot(s.w[added]) <= rel * vv)
+				{
+					s.count--;
+					break;
+				}
+				// A vertex equal to one already held, or one that adds no volume, cannot bring the
+				// simplex nearer.
+				bool duplicate = added == 3 && s.in_plane(0, 1, 2, 3);
+				for (uint32_t j = 0; j < added; j++)
+					duplicate = duplicate || s.w[j] == s.w[added];
+				if (duplicate)
+				{
+					s.count--;
+					break;
+				}
+				gjk_simplex<T> prev = s;
+				prev.count--;
+				separated = s.solve();
+				if (!separated)
+					break;
+				const vec<T, 3> nv = s.point();
+				const T nvv = nv.length_squared();
+				// Rounding can stall progress close to the answer; keep the better simplex.
+				if (nvv >= vv)
+				{
+					s = prev;
+					break;
+				}
+				v = nv;
+				vv = nvv;
+			}
+			cache.count = s.count;
+			for (uint32_t i = 0; i < s.count; i++)
+				cache.directions[i] = s.d[i];
+			return separated;
+		}
+	}
+
+	// GJK distance between two convex shapes. The cores are solved exactly up to a relative
+	// tolerance of 100 ulps, and the margins are then taken off along the normal.
+	template<typename A, typename B, std::floating_point T = float>
+	gjk_result<T> gjk_distance(const A& a, const B& b, gjk_cache<T>& cache)
+	{
+		detail::gjk_simplex<T> s;
+		gjk_result<T> res;
+		const bool separated = detail::gjk_cores(a, b, cache, s, res.iterations);
+		const T ra = margin(a), rb = margin(b);
+		vec<T, 3> pa, pb;
+		s.witnesses(pa, pb);
+		const T core = pa.distance(pb);
+		if (!separated || core <= ra + rb)
+		{
+			res.intersecting = true;
+			res.point_a = pa;
+			res.point_b = pb;
+			return res;
+		}
+		res.normal = (pb - pa) / core;
+		res.distance = core - ra - rb;
+		res.point_a = pa + res.normal * ra;
+		res.point_b = pb - res.normal * rb;
+		return res;
+	}
+
+	namespace detail
+	{
+		// The full shape: the support of the core pushed out by the margin.
+		template<typename Shape, std::floating_point T>
+		vec<T, 3> inflated_support(const Shape& s, const vec<T, 3>& d)
+		{
+			const T r = margin(s);
+			const T len = d.norm();
+			return r > T(0) && len > T(0) ? support(s, d) + d * (r / len) : support(s, d);
+		}
+
+		// Expanding polytope on the Minkowski difference of the full shapes, in fixed storage.
+		template<std::floating_point T>
+		struct epa_polytope
+		{
+			static constexpr uint32_t max_vertices = 64;
+			static constexpr uint32_t max_faces = 2 * max_vertices - 4;
+
+			struct face
+			{
+				uint32_t v[3];
+				vec<T, 3> normal;
+				T distance;
+			};
+			struct edge
+			{
+				uint32_t from, to;
+			};
+
+			vec<T, 3> w[max_vertices], a[max_vertices];
+			uint32_t vertex_count = 0;
+			face faces[max_faces];
+			uint32_t face_count = 0;
+
+			bool add_face(uint32_t i, uint32_t j, uint32_t k)
+			{
+				if (face_count == max_faces)
+					return false;
+				vec<T, 3> n = (w[j] - w[i]).cross(w[k] - w[i]);
+				const T len = n.norm();
+				if (len <= T(0))
+					return false;
+				n /= len;
+				faces[face_count++] = face{ { i, j, k }, n, n.dot(w[i]) };
+				return true;
+			}
+		};
+	}
+
+	// Penetration of two convex shapes. Separated shapes give their distance as a negative
+	// depth. Overlaps within the margins are resolved on the cores, exactly; deeper ones by EPA
+	// from a GJK simplex of the full shapes around the origin, with the polytope in fixed
+	// storage of 64 vertices, which bounds the work and never allocates. The cache is updated
+	// as by gjk_distance.
+	template<typename A, typename B, std::floating_point T = float>
+	contact<T> gjk_penetration(const A& a, const B& b, gjk_cache<T>& cache)
+	{
+		detail::gjk_simplex<T> s;
+		uint32_t iterations = 0;
+		const bool separated = detail::gjk_cores(a, b, cache, s, iterations);
+		const T ra = margin(a), rb = margin(b);
+		contact<T> res;
+		if (separated)
+		{
+			vec<T, 3> pa, pb;
+			s.witnesses(pa, pb);
+			const T core = pa.distance(pb);
+			if (core > T(0))
+			{
+				res.normal = (pb - pa) / core;
+				res.depth = ra + rb - core;
+				res.point_a = pa + res.normal * ra;
+				res.point_b = pb - res.normal * rb;
+				return res;
+			}
+		}
+
+		// The core simplex holds the origin in the difference of the cores, but the supports
+		// of the full shapes along its directions need not. GJK on the full shapes, warm
+		// started from the core simplex, ends on a simplex that does.
+		auto sa = [&](const vec<T, 3>& d) { return detail::inflated_support(a, d); };
+		auto sb = [&](const vec<T, 3>& d) { return detail::inflated_support(b, d); };
+		const support_callback<decltype(sa), T> full_a{ sa };
+		const support_callback<decltype(sb), T> full_b{ sb };
+		gjk_cache<T> seed;
+		seed.count = s.count;
+		for (uint32_t i = 0; i < s.count; i++)
+			seed.directions[i] = s.d[i];
+		uint32_t full_iterations = 0;
+		if (detail::gjk_cores(full_a, full_b, seed, s, full_iterations))
+		{
+			// Only rounding leaves the full shapes apart here: they just touch.
+			s.witnesses(res.point_a, res.point_b);
+			const T gap = res.point_a.distance(res.point_b);
+			res.normal = gap > T(0) ? (res.point_b - res.point_a) / gap : vec<T, 3>{ T(1), T(0), T(0) };
+			res.depth = -gap;
+			return res;
+		}
+
+		// Grow the simplex to a tetrahedron around the origin. The simplex holds the origin,
+		// so any tetrahedron on it does too.
+		detail::epa_polytope<T> poly;
+		const T rel = detail::gjk_tolerance<T>();
+		auto add_vertex = [&](const vec<T, 3>& d)
+		{
+			const uint32_t i = poly.vertex_count++;
+			poly.a[i] = sa(d);
+			poly.w[i] = poly.a[i] - sb(-d);
+			return i;
+		};
+		for (uint32_t i = 0; i < s.count; i++)
+		{
+			poly.a[i] = s.a[i];
+			poly.w[i] = s.w[i];
+		}
+		poly.vertex_count = s.count;
+		const T scale = std::max(poly.w[0].norm(), T(1)) * rel;
+		static const vec<T, 3> axes[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+		if (poly.vertex_count == 1)
+			for (const vec<T, 3>& d : axes)
+			{
+				add_vertex(d);
+				if ((poly.w[1] - poly.w[0]).norm() > scale)
+					break;
+				poly.vertex_count--;
+			}
+		if (poly.vertex_count == 2)
+		{
+			const vec<T, 3> u = poly.w[1] - poly.w[0];
+			for (const vec<T, 3>& axis : axes)
+			{
+				const vec<T, 3> d = u.cross(axis);
+				if (d.length_squared() <= T(0))
+					continue;
+				add_vertex(d);
+				if (u.cross(poly.w[2] - poly.w[0]).norm() > scale * u.norm())
+					break;
+				poly.vertex_count--;
+			}
+		}
+		if (poly.vertex_count == 3)
+		{
+			const vec<T, 3> n = (poly.w[1] - poly.w[0]).cross(poly.w[2] - poly.w[0]);
+			add_vertex(n);
+			if (std::abs(n.dot(poly.w[3] - poly.w[0])) <= scale * n.norm())
+			{
+				poly.vertex_count--;
+				add_vertex(-n);
+			}
+		}
+		if (poly.vertex_count < 4)
+		{
+			// Flat Minkowski difference: the shapes just touch.
+			res.point_a = poly.a[0];
+			res.point_b = poly.a[0] - poly.w[0];
+			res.normal = vec<T, 3>{ T(1), T(0), T(0) };
+			return res;
+		}
+
+		const vec<T, 3> centroid = (poly.w[0] + poly.w[1] + poly.w[2] + poly.w[3]) * T(0.25);
+		static constexpr uint32_t tet[4][3] = { { 0, 1, 2 }, { 0, 3, 1 }, { 0, 2, 3 }, { 1, 3, 2 } };
+		for (const uint32_t* t : tet)
+		{
+			uint32_t i = t[0], j = t[1], k = t[2];
+			if ((poly.w[j] - poly.w[i]).cross(poly.w[k] - poly.w[i]).dot(poly.w[i] - centroid) < T(0))
+				std::swap(j, k);
+			poly.add_face(i, j, k);
+		}
+
+		typename detail::epa_polytope<T>::edge horizon[detail::epa_polytope<T>::max_vertices * 3];
+		typename detail::epa_polytope<T>::face best{};
+		while (poly.face_count > 0)
+		{
+			uint32_t closest = 0;
+			for (uint32_t f = 1; f < poly.face_count; f++)
+				if (poly.faces[f].distance < poly.faces[closest].distance)
+					closest = f;
+			best = poly.faces[closest];
+			if (poly.vertex_count == poly.max_vertices)
+				break;
+			const uint32_t v = add_vertex(best.normal);
+			// The polytope reaches the boundary along this normal: done.
+			const T tol = rel * std::max(best.distance, T(1));
+			if (best.normal.dot(poly.w[v]) - best.distance <= tol)
+			{
+				poly.vertex_count--;
+				break;
+			}
+			// Faces seen from the new vertex go; their unshared edges form the horizon. The seen
+			// faces are walked from the closest one across shared edges, so the region removed
+			// is connected even where rounding makes faces far from it look seen. Faces the
+			// vertex is nearly in the plane of stay: flat regions, common on boxes, would
+			// otherwise tear the horizon on rounding noise.
+			auto seen = [&](uint32_t f) { return poly.faces[f].normal.dot(poly.w[v] - poly.w[poly.faces[f].v[0]]) > tol; };
+			bool gone[detail::epa_polytope<T>::max_faces] = {};
+			uint32_t stack[detail::epa_polytope<T>::max_faces];
+			uint32_t top = 0;
+			uint32_t edge_count = 0;
+			gone[closest] = true;
+			stack[top++] = closest;
+			while (top > 0)
+			{
+				const auto& face = poly.faces[stack[--top]];
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					const uint32_t from = face.v[k], to = face.v[(k + 1) % 3];
+					uint32_t other = poly.face_count;
+					for (uint32_t g = 0; g < poly.face_count && other == poly.face_count; g++)
+						for (uint32_t m = 0; m < 3; m++)
+							if (poly.faces[g].v[m] == to && poly.faces[g].v[(m + 1) % 3] == from)
+								other = g;
+					if (other < poly.face_count && gone[other])
+						continue;
+					if (other < poly.face_count && seen(other))
+					{
+						gone[other] = true;
+						stack[top++] = other;
+						continue;
+					}
+					horizon[edge_count++] = { from, to };
+				}
+			}
+			// A kept face enclosed by removed ones would leave a horizon of several loops, and
+			// the cone over it would fold the polytope. Stop at the best face found instead.
+			constexpr uint32_t none = detail::epa_polytope<T>::max_vertices;
+			uint32_t next[detail::epa_polytope<T>::max_vertices];
+			std::fill(next, next + poly.vertex_count, none);
+			bool simple = edge_count >= 3;
+			for (uint32_t e = 0; e < edge_count; e++)
+			{
+				simple = simple && next[horizon[e].from] == none;
+				next[horizon[e].from] = horizon[e].to;
+			}
+			uint32_t walked = 0;
+			for (uint32_t at = horizon[0].from; simple && walked < edge_count; walked++)
+			{
+				at = next[at];
+				if (at == none || (at == horizon[0].from) != (walked + 1 == edge_count))
+					simple = false;
+			}
+			if (!simple)
+			{
+				poly.vertex_count--;
+				break;
+			}
+			uint32_t kept = 0;
+			bool stop = false;
+			for (uint32_t f = 0; f < poly.face_count; f++)
+				if (!gone[f])
+					poly.faces[kept++] = poly.faces[f];
+			poly.face_count = kept;
+			// The polytope only grows, so no new face may be nearer the origin than the best
+			// one. Slivers around a vertex next to old ones miss that by rounding; a face far
+			// nearer means the polytope folded, and the best face is as good as it gets.
+			const T fold = std::sqrt(std::numeric_limits<T>::epsilon()) * std::max(best.distance, T(1));
+			for (uint32_t e = 0; e < edge_count && !stop; e++)
+				stop = !poly.add_face(horizon[e].from, horizon[e].to, v) || poly.faces[poly.face_count - 1].distance < best.distance - fold;
+			if (stop)
+				break;
+		}
+		if (poly.face_count == 0)
+			return res;
+
+		// The origin projected on the closest face, in barycentric coordinates of the face. If
+		// the polytope ran out of room, that is the best face found so far.
+		const auto& face = best;
+		const vec<T, 3> p = face.normal * face.distance;
+		const vec<T, 3> w0 = poly.w[face.v[0]], w1 = poly.w[face.v[1]], w2 = poly.w[face.v[2]];
+		const vec<T, 3> e1 = w1 - w0, e2 = w2 - w0, ep = p - w0;
+		const T d11 = e1.dot(e1), d12 = e1.dot(e2), d22 = e2.dot(e2), dp1 = ep.dot(e1), dp2 = ep.dot(e2);
+		const T denom = d11 * d22 - d12 * d12;
+		const T l1 = denom > T(0) ? (d22 * dp1 - d12 * dp2) / denom : T(0);
+		const T l2 = denom > T(0) ? (d11 * dp2 - d12 * dp1) / denom : T(0);
+		const T l0 = T(1) - l1 - l2;
+		// Translating B by p moves the origin to the boundary of A - B.
+		res.depth = face.distance;
+		res.normal = face.normal;
+		res.point_a = poly.a[face.v[0]] * l0 + poly.a[face.v[1]] * l1 + poly.a[face.v[2]] * l2;
+		res.point_b = res.point_a - p;
+		return res;
+	}
+
+}// namespace mafs
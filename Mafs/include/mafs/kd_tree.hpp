@@ -0,0 +1,285 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+#include "aabb.hpp"
+#include "parallel.hpp"
+
+namespace mafs
+{
+	// A query result; index is the position of the point in the array the tree was built from.
+	template<std::floating_point T = float>
+	struct kd_neighbor
+	{
+		static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+		uint32_t index = none;
+		T distance_squared = std::numeric_limits<T>::infinity();
+	};
+
+	// Static k-d tree over points. The layout is implicit: the points are reordered so that
+	// every range [begin, end) of more than leaf_size points is a node whose median sits at
+	// mid = (begin + end) / 2, split on axes[mid], with the subtrees at [begin, mid) and
+	// [mid + 1, end). There are no child links, and a subtree is one contiguous block.
+	template<std::floating_point T = float, size_t N = 3>
+	class kd_tree
+	{
+	public:
+		// Ranges this small are scanned instead of split.
+		static constexpr size_t leaf_size = 8;
+
+		//-----------------------------Constructors-----------------------------
+		// Each node splits its widest axis at the median. The two halves of the nodes near the
+		// root are built on separate threads.
+		static kd_tree build(std::span<const vec<T, N>> points, size_t threads = hardware_threads())
+		{
+			assert(points.size() < size_t(kd_neighbor<T>::none) && "Indices are 32-bit");
+			kd_tree res;
+			std::vector<entry> entries(points.size());
+			parallel_for(points.size(), [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					entries[i] = entry{ points[i], uint32_t(i) };
+			}, 4096, threads);
+			res.axes.resize(points.size());
+			const uint32_t fork_depth = threads > 1 ? uint32_t(std::bit_width(threads - 1)) : 0;
+			res.build_range(entries, 0, entries.size(), 0, fork_depth);
+
+			res.points.resize(points.size());
+			res.ids.resize(points.size());
+			parallel_for(points.size(), [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					res.points[i] = entries[i].p;
+					res.ids[i] = entries[i].id;
+				}
+			}, 4096, threads);
+			return res;
+		}
+		//-----------------------------Functions-----------------------------
+		size_t size() const { return points.size(); }
+
+		// The out.size() nearest points with distance below max_distance, nearest first. out
+		// doubles as the search heap, so nothing is allocated. Returns how many were found.
+		size_t knn(const vec<T, N>& q, std::span<kd_neighbor<T>> out, T max_distance = std::numeric_limits<T>::infinity()) const
+		{
+			if (out.empty())
+				return 0;
+			if (out.size() == 1)
+			{
+				const kd_neighbor<T> n = nearest(q, max_distance);
+				if (n.index == kd_neighbor<T>::none)
+					return 0;
+				out[0] = n;
+				return 1;
+			}
+			heap h{ out, 0, max_distance * max_distance, max_distance * max_distance };
+			knn_range(q, 0, points.size(), h);
+			std::sort_heap(out.begin(), out.begin() + h.count, closer);
+			return h.count;
+		}
+		// The nearest point, or index none when no point is closer than max_distance.
+		kd_neighbor<T> nearest(const vec<T, N>& q, T max_distance = std::numeric_limits<T>::infinity()) const
+		{
+			closest c{ kd_neighbor<T>{}, max_distance * max_distance };
+			knn_range(q, 0, points.size(), c);
+			return c.best;
+		}
+		// Appends every point within radius of q, boundary included, in no particular order.
+		void radius_search(const vec<T, N>& q, T radius, std::vector<kd_neighbor<T>>& out) const
+		{
+			radius_range(q, 0, points.size(), radius * radius, out);
+		}
+
+		// Batched kNN on up to `threads` threads: query i writes its neighbors to
+		// out[i * k, (i + 1) * k) and their number to counts[i].
+		void knn(std::span<const vec<T, N>> queries, size_t k, std::span<kd_neighbor<T>> out, std::span<uint32_t> counts,
+			size_t threads = hardware_threads(), T max_distance = std::numeric_limits<T>::infinity()) const
+		{
+			assert(out.size() >= queries.size() * k && counts.size() >= queries.size() && "Output too small");
+			parallel_for(queries.size(), [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					counts[i] = uint32_t(knn(queries[i], out.subspan(i * k, k), max_distance));
+			}, 64, threads);
+		}
+		// Batched radius search. The neighbors of query i end up in
+		// out[offsets[i], offsets[i + 1]); out and offsets are overwritten.
+		void radius_search(std::span<const vec<T, N>> queries, T radius, std::vector<uint32_t>& offsets, std::vector<kd_neighbor<T>>& out,
+			size_t threads = hardware_threads()) const
+		{
+			offsets.assign(queries.size() + 1, 0);
+			out.clear();
+			if (queries.empty())
+				return;
+			// Each chunk gathers its results on its own, and the chunks are then joined in order.
+			const size_t chunk_count = std::max<size_t>(1, std::min(threads, queries.size() / 64));
+			std::vector<std::vector<kd_neighbor<T>>> found(chunk_count);
+			parallel_for(chunk_count, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+					for (size_t i = queries.size() * c / chunk_count; i < queries.size() * (c + 1) / chunk_count; i++)
+					{
+						const size_t before = found[c].size();
+						radius_range(queries[i], 0, points.size(), radius * radius, found[c]);
+						offsets[i + 1] = uint32_t(found[c].size() - before);
+					}
+			}, 1, threads);
+			for (size_t i = 0; i < queries.size(); i++)
+				offsets[i + 1] += offsets[i];
+			out.reserve(offsets.back());
+			for (const std::vector<kd_neighbor<T>>& f : found)
+				out.insert(out.end(), f.begin(), f.end());
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		// Points in tree order, with the index each had in the input.
+		std::vector<vec<T, N>> points;
+		std::vector<uint32_t> ids;
+		// Split axis of the node whose median is at this position; unused inside leaves.
+		std::vector<uint8_t> axes;
+
+	private:
+		struct entry
+		{
+			vec<T, N> p;
+			uint32_t id;
+		};
+		// The first count entries of out form a max-heap on distance once count reaches out.size().
+		struct heap
+		{
+			std::span<kd_neighbor<T>> out;
+			size_t count;
+			T worst;
+			T limit;
+		};
+		// k = 1 keeps the best so far; worst is its distance, or the limit before one is found.
+		struct closest
+		{
+			kd_neighbor<T> best;
+			T worst;
+		};
+
+		static bool closer(const kd_neighbor<T>& a, const kd_neighbor<T>& b) { return a.distance_squared < b.distance_squared; }
+
+		void build_range(std::vector<entry>& entries, size_t begin, size_t end, uint32_t depth, uint32_t fork_depth)
+		{
+			if (end - begin <= leaf_size)
+				return;
+			aabb<T, N> bounds;
+			for (size_t i = begin; i < end; i++)
+				bounds = bounds.merge(entries[i].p);
+			const vec<T, N> extent = bounds.extents();
+			size_t axis = 0;
+			for (size_t a = 1; a < N; a++)
+				if (extent[a] > extent[axis])
+					axis = a;
+			const size_t mid = (begin + end) / 2;
+			std::nth_element(entries.begin() + begin, entries.begin() + mid, entries.begin() + end, [axis](const entry& a, const entry& b)
+			{
+				return a.p[axis] < b.p[axis];
+			});
+			axes[mid] = uint8_t(axis);
+			parallel_invoke(
+				[&] { build_range(entries, begin, mid, depth + 1, fork_depth); },
+				[&] { build_range(entries, mid + 1, end, depth + 1, fork_depth); },
+				depth < fork_depth && end - begin >= 4096);
+		}
+
+		void consider(const vec<T, N>& q, size_t i, heap& h) const
+		{
+			const T d = (points[i] - q).length_squared();
+			if (!(d < h.worst))
+				return;
+			const kd_neighbor<T> n{ ids[i], d };
+			if (h.count < h.out.size())
+			{
+				h.out[h.count++] = n;
+				std::push_heap(h.out.begin(), h.out.begin() + h.count, closer);
+			}
+			else
+			{
+				std::pop_heap(h.out.begin(), h.out.end(), closer);
+				h.out.back() = n;
+				std::push_heap(h.out.begin(), h.out.end(), closer);
+			}
+			if (h.count == h.out.size())
+				h.worst = std::min(h.limit, h.out[0].distance_squared);
+		}
+		void consider(const vec<T, N>& q, size_t i, closest& c) const
+		{
+			const T d = (points[i] - q).length_squared();
+			if (!(d < c.worst))
+				return;
+			c.best = kd_neighbor<T>{ ids[i], d };
+			c.worst = d;
+		}
+
+		// Near side first; the far side only when the splitting plane is closer than the
+		// current k-th neighbor.
+		template<typename Search>
+		void knn_range(const vec<T, N>& q, size_t begin, size_t end, Search& h) const
+		{
+			while (end - begin > leaf_size)
+			{
+				const size_t mid = (begin + end) / 2;
+				const size_t axis = axes[mid];
+				const T diff = q[axis] - points[mid][axis];
+				consider(q, mid, h);
+				if (diff < T(0))
+				{
+					knn_range(q, begin, mid, h);
+					if (!(diff * diff < h.worst))
+						return;
+					begin = mid + 1;
+				}
+				else
+				{
+					knn_range(q, mid + 1, end, h);
+					if (!(diff * diff < h.worst))
+						return;
+					end = mid;
+				}
+			}
+			for (size_t i = begin; i < end; i++)
+				consider(q, i, h);
+		}
+
+		void radius_range(const vec<T, N>& q, size_t begin, size_t end, T radius_squared, std::vector<kd_neighbor<T>>& out) const
+		{
+			while (end - begin > leaf_size)
+			{
+				const size_t mid = (begin + end) / 2;
+				const size_t axis = axes[mid];
+				const T diff = q[axis] - points[mid][axis];
+				const T d = (points[mid] - q).length_squared();
+				if (d <= radius_squared)
+					out.push_back(kd_neighbor<T>{ ids[mid], d });
+				// Both sides when the ball crosses the splitting plane, else only the one holding q.
+				if (diff * diff <= radius_squared)
+				{
+					radius_range(q, begin, mid, radius_squared, out);
+					begin = mid + 1;
+				}
+				else if (diff < T(0))
+					end = mid;
+				else
+					begin = mid + 1;
+			}
+			for (size_t i = begin; i < end; i++)
+			{
+				const T d = (points[i] - q).length_squared();
+				if (d <= radius_squared)
+					out.push_back(kd_neighbor<T>{ ids[i], d });
+			}
+		}
+	};
+
+	using kd_tree3f = kd_tree<float, 3>;
+	using kd_tree3d = kd_tree<double, 3>;
+
+}// namespace mafs
@@ -0,0 +1,249 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+#include "aabb.hpp"
+#include "morton.hpp"
+#include "parallel.hpp"
+
+namespace mafs
+{
+	// Interior node of an lbvh. A child index with lbvh::leaf_bit set names leaf
+	// (index & ~leaf_bit), otherwise another interior node.
+	struct lbvh_node
+	{
+		aabb3f bounds;
+		uint32_t left = 0;
+		uint32_t right = 0;
+	};
+
+	// Linear BVH over boxes (Karras 2012). The primitives are sorted by the 30-bit Morton code
+	// of their box centers and the hierarchy is the binary radix tree over the sorted codes:
+	// every interior node is found on its own from the codes around it, so the topology is
+	// built in parallel in one step, and the bounds are then refit bottom-up. Quality is below
+	// a SAH build, but the cost is a sort and two linear passes, which suits geometry that
+	// changes every frame. Equal codes are ordered by their position in the sorted order.
+	class lbvh
+	{
+	public:
+		static constexpr uint32_t leaf_bit = 0x80000000u;
+
+		//-----------------------------Functions-----------------------------
+		size_t size() const { return ids.size(); }
+		// Root as a child index: leaf 0 when there is a single primitive.
+		uint32_t root() const { return ids.size() == 1 ? leaf_bit : 0; }
+		aabb3f bounds() const
+		{
+			return ids.empty() ? aabb3f() : ids.size() == 1 ? leaf_bounds[0] : nodes[0].bounds;
+		}
+
+		// Sorts the boxes and builds the hierarchy on up to `threads` threads. The buffers keep
+		// their capacity, so a per-frame rebuild does not allocate once warm.
+		void build(std::span<const aabb3f> primitive_bounds, size_t threads = hardware_threads())
+		{
+			const size_t n = primitive_bounds.size();
+			assert(n < size_t(leaf_bit) && "Indices are 31-bit");
+			ids.resize(n);
+			codes.resize(n);
+			leaf_bounds.resize(n);
+			leaf_parents.resize(n);
+			nodes.resize(n > 0 ? n - 1 : 0);
+			node_parents.resize(nodes.size());
+			if (n == 0)
+				return;
+
+			// Codes of the box centers over the bounds of the centers.
+			const size_t chunks = std::max<size_t>(1, std::min(threads, n / 16384));
+			std::vector<aabb3f> chunk_bounds(chunks);
+			parallel_for(chunks, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+					for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; i++)
+						chunk_bounds[c] = chunk_bounds[c].merge(primitive_bounds[i].center());
+			}, 1, threads);
+			aabb3f centers;
+			for (const aabb3f& b : chunk_bounds)
+				centers = centers.merge(b);
+			const detail::morton_grid grid(centers, 10);
+			parallel_for(n, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					codes[i] = morton_encode_30(grid.cell(primitive_bounds[i].center()));
+					ids[i] = uint32_t(i);
+				}
+			}, 16384, threads);
+			sort_codes.resize(n);
+			sort_ids.resize(n);
+			radix_sort(std::span<uint32_t>(codes), std::span<uint32_t>(ids), std::span<uint32_t>(sort_codes), std::span<uint32_t>(sort_ids), 30, threads);
+
+			parallel_for(nodes.size(), [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					build_node(uint32_t(i));
+			}, 4096, threads);
+			refit(primitive_bounds, threads);
+		}
+
+		// New boxes for the same primitives, in input order, on the existing topology. Much
+		// cheaper than build() for meshes that deform without changing their connectivity;
+		// the tree degrades as the primitives drift from their Morton order.
+		void refit(std::span<const aabb3f> primitive_bounds, size_t threads = hardware_threads())
+		{
+			assert(primitive_bounds.size() == ids.size() && "One box per primitive");
+			const size_t n = ids.size();
+			if (n < 2)
+			{
+				if (n == 1)
+					leaf_bounds[0] = primitive_bounds[ids[0]];
+				return;
+			}
+			// Each leaf walks up; of the two children of a node, the second to arrive merges
+			// their bounds and carries on, the first stops. The counter's acq_rel ordering
+			// makes the first child's bounds visible to the second.
+			if (visits_size < nodes.size())
+			{
+				visits = std::make_unique<std::atomic<uint32_t>[]>(nodes.size());
+				visits_size = nodes.size();
+			}
+			parallel_for(nodes.size(), [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					visits[i].store(0, std::memory_order_relaxed);
+			}, 16384, threads);
+			parallel_for(n, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					leaf_bounds[i] = primitive_bounds[ids[i]];
+					uint32_t p = leaf_parents[i];
+					while (p != none && visits[p].fetch_add(1, std::memory_order_acq_rel) == 1)
+					{
+						nodes[p].bounds = child_bounds(nodes[p].left).merge(child_bounds(nodes[p].right));
+						p = node_parents[p];
+					}
+				}
+			}, 4096, threads);
+		}
+
+		// Calls fn(primitive) for every primitive whose box overlaps box, in no particular order.
+		template<typename F>
+		void query(const aabb3f& box, F&& fn) const
+		{
+			traverse([&](const aabb3f& b) { return b.overlaps(box); }, fn);
+		}
+		// Calls fn(primitive) for every primitive whose box the ray hits within [0, t_max].
+		template<typename F>
+		void query(const rayf& r, float t_max, F&& fn) const
+		{
+			traverse([&](const aabb3f& b) { return b.intersects(r, t_max); }, fn);
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		// n - 1 interior nodes, node 0 being the root.
+		std::vector<lbvh_node> nodes;
+		// Per leaf, in Morton order: its box, its input index and its code.
+		std::vector<aabb3f> leaf_bounds;
+		std::vector<uint32_t> ids;
+		std::vector<uint32_t> codes;
+
+	private:
+		static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+		// The radix tree is at most 30 code bits plus 31 index bits deep.
+		static constexpr size_t stack_size = 64;
+
+		const aabb3f& child_bounds(uint32_t child) const
+		{
+			return child & leaf_bit ? leaf_bounds[child & ~leaf_bit] : nodes[child].bounds;
+		}
+
+		// Length of the common prefix of keys i and j, -1 when j is out of range. Equal codes
+		// are told apart by their indices.
+		int delta(int64_t i, int64_t j) const
+		{
+			if (j < 0 || j >= int64_t(codes.size()))
+				return -1;
+			const uint32_t a = codes[size_t(i)], b = codes[size_t(j)];
+			return a != b ? std::countl_zero(a ^ b) : 32 + std::countl_zero(uint32_t(i ^ j));
+		}
+
+		// Karras: the direction of the node's range is that of the neighbor sharing the longer
+		// prefix; its far end is found by exponential then binary search, and the split is the
+		// last key sharing more than the range's common prefix with key i.
+		void build_node(uint32_t node)
+		{
+			const int64_t i = node;
+			const int64_t d = delta(i, i + 1) > delta(i, i - 1) ? 1 : -1;
+			const int delta_min = delta(i, i - d);
+			int64_t length_max = 2;
+			while (delta(i, i + length_max * d) > delta_min)
+				length_max *= 2;
+			int64_t length = 0;
+			for (int64_t t = length_max / 2; t >= 1; t /= 2)
+				if (delta(i, i + (length + t) * d) > delta_min)
+					length += t;
+			const int64_t j = i + length * d;
+			const int delta_node = delta(i, j);
+			int64_t split = 0;
+			for (int64_t t = length;;)
+			{
+				t = (t + 1) / 2;
+				if (delta(i, i + (split + t) * d) > delta_node)
+					split += t;
+				if (t == 1)
+					break;
+			}
+			const int64_t gamma = i + split * d + std::min<int64_t>(d, 0);
+			const uint32_t left = std::min(i, j) == gamma ? uint32_t(gamma) | leaf_bit : uint32_t(gamma);
+			const uint32_t right = std::max(i, j) == gamma + 1 ? uint32_t(gamma + 1) | leaf_bit : uint32_t(gamma + 1);
+			nodes[node].left = left;
+			nodes[node].right = right;
+			for (uint32_t child : { left, right })
+			{
+				if (child & leaf_bit)
+					leaf_parents[child & ~leaf_bit] = node;
+				else
+					node_parents[child] = node;
+			}
+			if (node == 0)
+				node_parents[0] = none;
+		}
+
+		template<typename Test, typename F>
+		void traverse(Test&& test, F& fn) const
+		{
+			if (ids.empty())
+				return;
+			uint32_t stack[stack_size];
+			size_t top = 0;
+			stack[top++] = root();
+			while (top > 0)
+			{
+				const uint32_t c = stack[--top];
+				if (!test(child_bounds(c)))
+					continue;
+				if (c & leaf_bit)
+					fn(ids[c & ~leaf_bit]);
+				else
+				{
+					stack[top++] = nodes[c].right;
+					stack[top++] = nodes[c].left;
+				}
+			}
+		}
+
+		std::vector<uint32_t> node_parents;
+		std::vector<uint32_t> leaf_parents;
+		std::vector<uint32_t> sort_codes;
+		std::vector<uint32_t> sort_ids;
+		// Arrival counters of the refit; atomics cannot live in a resizable vector.
+		std::unique_ptr<std::atomic<uint32_t>[]> visits;
+		size_t visits_size = 0;
+	};
+
+}// namespace mafs
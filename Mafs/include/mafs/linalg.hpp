@@ -0,0 +1,489 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <limits>
+#include <span>
+#include "matrix.hpp"
+
+// Fixed-size dense solvers for small systems (3x3 .. ~12x12). Everything works on the stack,
+// nothing allocates, and the scalar factorizations can run in constant expressions.
+// The *_solve_batch functions solve many independent systems of the same size at once:
+// W systems are transposed into lanes (structure of arrays) so every step of the
+// factorization is a loop over lanes that the compiler turns into SIMD.
+namespace mafs
+{
+	namespace detail
+	{
+		template<typename T>
+		constexpr T abs(T x) { return x < T(0) ? -x : x; }
+
+		// std::sqrt outside constant evaluation. Inside it, Newton's iteration from above, which
+		// falls monotonically to the root and stops when rounding stalls it.
+		template<std::floating_point T>
+		constexpr T sqrt(T x)
+		{
+			if (!std::is_constant_evaluated())
+				return std::sqrt(x);
+			if (!(x > T(0)) || x == std::numeric_limits<T>::infinity())
+				return x == T(0) || x == std::numeric_limits<T>::infinity() ? x : std::numeric_limits<T>::quiet_NaN();
+			T r = x > T(1) ? x : T(1);
+			for (;;)
+			{
+				const T next = (r + x / r) * T(0.5);
+				if (next >= r)
+					return r;
+				r = next;
+			}
+		}
+
+		template<typename T, size_t R, size_t C>
+		constexpr T max_abs(const mat<T, R, C>& a)
+		{
+			T res = T(0);
+			for (size_t c = 0; c < C; c++)
+				for (size_t r = 0; r < R; r++)
+					res = abs(a(r, c)) > res ? abs(a(r, c)) : res;
+			return res;
+		}
+	}
+
+	//-----------------------------LU with partial pivoting-----------------------------
+	template<std::floating_point T, size_t N>
+	struct lu_result
+	{
+		mat<T, N, N> lu;               // unit lower L below the diagonal, U on and above it
+		std::array<size_t, N> perm{};  // row i of L*U is row perm[i] of A
+		int sign = 1;                  // sign of the permutation
+		bool singular = false;
+
+		constexpr vec<T, N> solve(const vec<T, N>& b) const
+		{
+			vec<T, N> x;
+			for (size_t i = 0; i < N; i++)
+			{
+				T s = b[perm[i]];
+				for (size_t j = 0; j < i; j++)
+					s -= lu(i, j) * x[j];
+				x[i] = s;
+			}
+			for (size_t i = N; i-- > 0;)
+			{
+				T s = x[i];
+				for (size_t j = i + 1; j < N; j++)
+					s -= lu(i, j) * x[j];
+				x[i] = s / lu(i, i);
+			}
+			return x;
+		}
+		constexpr T determinant() const
+		{
+			T det = T(sign);
+			for (size_t i = 0; i < N; i++)
+				det *= lu(i, i);
+			return det;
+		}
+		constexpr mat<T, N, N> inverse() const
+		{
+			mat<T, N, N> res;
+			for (size_t c = 0; c < N; c++)
+			{
+				vec<T, N> e;
+				e[c] = T(1);
+				res[c] = solve(e);
+			}
+			return res;
+		}
+	};
+
+	template<std::floating_point T, size_t N>
+	constexpr lu_result<T, N> lu(const mat<T, N, N>& a)
+	{
+		lu_result<T, N> res{ a };
+		for (size_t i = 0; i < N; i++)
+			res.perm[i] = i;
+		const T tolerance = std::numeric_limits<T>::epsilon() * T(N) * detail::max_abs(a);
+		mat<T, N, N>& m = res.lu;
+		for (size_t k = 0; k < N; k++)
+		{
+			size_t p = k;
+			for (size_t i = k + 1; i < N; i++)
+				if (detail::abs(m(i, k)) > detail::abs(m(p, k))) p = i;
+			if (detail::abs(m(p, k)) <= tolerance)
+			{
+				res.singular = true;
+				continue;
+			}
+			if (p != k)
+			{
+				for (size_t j = 0; j < N; j++)
+				{
+					T tmp = m(k, j);
+					m(k, j) = m(p, j);
+					m(p, j) = tmp;
+				}
+				size_t tmp = res.perm[k];
+				res.perm[k] = res.perm[p];
+				res.perm[p] = tmp;
+				res.sign = -res.sign;
+			}
+			const T inv_pivot = T(1) / m(k, k);
+			for (size_t i = k + 1; i < N; i++)
+			{
+				const T f = m(i, k) * inv_pivot;
+				m(i, k) = f;
+				for (size_t j = k + 1; j < N; j++)
+					m(i, j) -= f * m(k, j);
+			}
+		}
+		return res;
+	}
+
+	//-----------------------------LDLT (symmetric)-----------------------------
+	// A = L * D * L^T for symmetric A, without square roots. Only the lower triangle of A is read.
+	template<std::floating_point T, size_t N>
+	struct ldlt_result
+	{
+		mat<T, N, N> l;  // unit lower triangular
+		vec<T, N> d{};
+		bool positive_definite = true;
+
+		constexpr vec<T, N> solve(const vec<T, N>& b) const
+		{
+			vec<T, N> x = b;
+			for (size_t i = 0; i < N; i++)
+				for (size_t j = 0; j < i; j++)
+					x[i] -= l(i, j) * x[j];
+			for (size_t i = 0; i < N; i++)
+				x[i] /= d[i];
+			for (size_t i = N; i-- > 0;)
+				for (size_t j = i + 1; j < N; j++)
+					x[i] -= l(j, i) * x[j];
+			return x;
+		}
+	};
+
+	template<std::floating_point T, size_t N>
+	constexpr ldlt_result<T, N> ldlt(const mat<T, N, N>& a)
+	{
+		ldlt_result<T, N> res{ mat<T, N, N>::identity() };
+		const T tolerance = std::numeric_limits<T>::epsilon() * T(N) * detail::max_abs(a);
+		for (size_t j = 0; j < N; j++)
+		{
+			T dj = a(j, j);
+			for (size_t k = 0; k < j; k++)
+				dj -= res.l(j, k) * res.l(j, k) * res.d[k];
+			if (dj <= tolerance) res.positive_definite = false;
+			res.d[j] = dj;
+			const T inv_d = T(1) / dj;
+			for (size_t i = j + 1; i < N; i++)
+			{
+				T s = a(i, j);
+				for (size_t k = 0; k < j; k++)
+					s -= res.l(i, k) * res.l(j, k) * res.d[k];
+				res.l(i, j) = s * inv_d;
+			}
+		}
+		return res;
+	}
+
+	//-----------------------------Householder QR-----------------------------
+	// A = Q * R for R >= C. solve() returns the least-squares solution of A x = b.
+	template<std::floating_point T, size_t R, size_t C>
+		requires (R >= C)
+	struct qr_result
+	{
+		mat<T, R, C> qr;    // strict upper part of R above the diagonal, Householder vectors on and below it
+		vec<T, C> r_diag{};
+		vec<T, C> beta{};   // H_k = I - beta[k] * v_k * v_k^T
+		bool rank_deficient = false;
+
+		constexpr vec<T, R> apply_qt(vec<T, R> b) const
+		{
+			for (size_t k = 0; k < C; k++)
+			{
+				T s = T(0);
+				for (size_t i = k; i < R; i++)
+					s += qr(i, k) * b[i];
+				s *= beta[k];
+				for (size_t i = k; i < R; i++)
+					b[i] -= s * qr(i, k);
+			}
+			return b;
+		}
+		constexpr vec<T, C> solve(const vec<T, R>& b) const
+		{
+			const vec<T, R> y = apply_qt(b);
+			vec<T, C> x;
+			for (size_t i = C; i-- > 0;)
+			{
+				T s = y[i];
+				for (size_t j = i + 1; j < C; j++)
+					s -= qr(i, j) * x[j];
+				x[i] = s / r_diag[i];
+			}
+			return x;
+		}
+	};
+
+	template<std::floating_point T, size_t R, size_t C>
+		requires (R >= C)
+	constexpr qr_result<T, R, C> qr(const mat<T, R, C>& a)
+	{
+		qr_result<T, R, C> res{ a };
+		const T tolerance = std::numeric_limits<T>::epsilon() * T(R) * detail::max_abs(a);
+		mat<T, R, C>& m = res.qr;
+		for (size_t k = 0; k < C; k++)
+		{
+			T norm2 = T(0);
+			for (size_t i = k; i < R; i++)
+				norm2 += m(i, k) * m(i, k);
+			const T norm = detail::sqrt(norm2);
+			if (norm <= tolerance)
+			{
+				res.rank_deficient = true;
+				res.r_diag[k] = T(0);
+				res.beta[k] = T(0);
+				continue;
+			}
+			const T alpha = m(k, k) > T(0) ? -norm : norm;
+			m(k, k) -= alpha;
+			const T beta = T(1) / (norm2 - alpha * (m(k, k) + alpha)); // 2 / (v^T v)
+			for (size_t j = k + 1; j < C; j++)
+			{
+				T s = T(0);
+				for (size_t i = k; i < R; i++)
+					s += m(i, k) * m(i, j);
+				s *= beta;
+				for (size_t i = k; i < R; i++)
+					m(i, j) -= s * m(i, k);
+			}
+			res.r_diag[k] = alpha;
+			res.beta[k] = beta;
+		}
+		return res;
+	}
+
+	//-----------------------------Batched solvers-----------------------------
+	namespace detail
+	{
+		// W systems in structure-of-arrays form: a[row][col][lane], b[row][lane].
+		template<typename T, size_t R, size_t C, size_t W>
+		struct system_lanes
+		{
+			T a[R][C][W];
+			T b[R][W];
+
+			void load(const mat<T, R, C>* as, const vec<T, R>* bs, size_t count)
+			{
+				for (size_t l = 0; l < W; l++)
+				{
+					// Unused lanes get an identity system so they stay finite.
+					const bool used = l < count;
+					for (size_t r = 0; r < R; r++)
+					{
+						for (size_t c = 0; c < C; c++)
+							a[r][c][l] = used ? as[l](r, c) : T(r == c ? 1 : 0);
+						b[r][l] = used ? bs[l][r] : T(0);
+					}
+				}
+			}
+			template<size_t N>
+			void back_substitute(T (&x)[N][W]) const
+			{
+				for (size_t i = N; i-- > 0;)
+				{
+					T s[W];
+					for (size_t l = 0; l < W; l++)
+						s[l] = b[i][l];
+					for (size_t j = i + 1; j < N; j++)
+						for (size_t l = 0; l < W; l++)
+							s[l] -= a[i][j][l] * x[j][l];
+					for (size_t l = 0; l < W; l++)
+						x[i][l] = s[l] / a[i][i][l];
+				}
+			}
+		};
+
+		template<typename T, size_t N, size_t W>
+		void store(const T (&x)[N][W], vec<T, N>* xs, size_t count)
+		{
+			for (size_t l = 0; l < count; l++)
+				for (size_t r = 0; r < N; r++)
+					xs[l][r] = x[r][l];
+		}
+	}
+
+	// Solves a[i] * x[i] = b[i] by Gaussian elimination with partial pivoting, W systems at a time.
+	// Pivot rows are swapped with per-lane selects, so lanes never branch. Singular systems yield non-finite x.
+	template<size_t W = 8, std::floating_point T, size_t N>
+	void lu_solve_batch(std::span<const mat<T, N, N>> a, std::span<const vec<T, N>> b, std::span<vec<T, N>> x)
+	{
+		assert(a.size() == b.size() && a.size() == x.size() && "Batch sizes do not match");
+		detail::system_lanes<T, N, N, W> s;
+		for (size_t first = 0; first < a.size(); first += W)
+		{
+			const size_t count = std::min(W, a.size() - first);
+			s.load(a.data() + first, b.data() + first, count);
+			for (size_t k = 0; k < N; k++)
+			{
+				size_t pivot[W];
+				T best[W];
+				for (size_t l = 0; l < W; l++)
+				{
+					pivot[l] = k;
+					best[l] = detail::abs(s.a[k][k][l]);
+				}
+				for (size_t i = k + 1; i < N; i++)
+					for (size_t l = 0; l < W; l++)
+					{
+						const T v = detail::abs(s.a[i][k][l]);
+						pivot[l] = v > best[l] ? i : pivot[l];
+						best[l] = v > best[l] ? v : best[l];
+					}
+				for (size_t i = k + 1; i < N; i++)
+				{
+					for (size_t j = k; j < N; j++)
+						for (size_t l = 0; l < W; l++)
+						{
+							const bool swap = pivot[l] == i;
+							const T top = s.a[k][j][l], other = s.a[i][j][l];
+							s.a[k][j][l] = swap ? other : top;
+							s.a[i][j][l] = swap ? top : other;
+						}
+					for (size_t l = 0; l < W; l++)
+					{
+						const bool swap = pivot[l] == i;
+						const T top = s.b[k][l], other = s.b[i][l];
+						s.b[k][l] = swap ? other : top;
+						s.b[i][l] = swap ? top : other;
+					}
+				}
+				T inv_pivot[W];
+				for (size_t l = 0; l < W; l++)
+					inv_pivot[l] = T(1) / s.a[k][k][l];
+				for (size_t i = k + 1; i < N; i++)
+				{
+					T f[W];
+					for (size_t l = 0; l < W; l++)
+						f[l] = s.a[i][k][l] * inv_pivot[l];
+					for (size_t j = k + 1; j < N; j++)
+						for (size_t l = 0; l < W; l++)
+							s.a[i][j][l] -= f[l] * s.a[k][j][l];
+					for (size_t l = 0; l < W; l++)
+						s.b[i][l] -= f[l] * s.b[k][l];
+				}
+			}
+			T res[N][W];
+			s.back_substitute(res);
+			detail::store(res, x.data() + first, count);
+		}
+	}
+
+	// Solves symmetric positive definite systems with LDLT, W systems at a time.
+	template<size_t W = 8, std::floating_point T, size_t N>
+	void ldlt_solve_batch(std::span<const mat<T, N, N>> a, std::span<const vec<T, N>> b, std::span<vec<T, N>> x)
+	{
+		assert(a.size() == b.size() && a.size() == x.size() && "Batch sizes do not match");
+		detail::system_lanes<T, N, N, W> s;
+		for (size_t first = 0; first < a.size(); first += W)
+		{
+			const size_t count = std::min(W, a.size() - first);
+			s.load(a.data() + first, b.data() + first, count);
+			// Factor in place: L below the diagonal, D on it.
+			T inv_d[N][W];
+			for (size_t j = 0; j < N; j++)
+			{
+				for (size_t k = 0; k < j; k++)
+					for (size_t l = 0; l < W; l++)
+						s.a[j][j][l] -= s.a[j][k][l] * s.a[j][k][l] * s.a[k][k][l];
+				for (size_t l = 0; l < W; l++)
+					inv_d[j][l] = T(1) / s.a[j][j][l];
+				for (size_t i = j + 1; i < N; i++)
+				{
+					for (size_t k = 0; k < j; k++)
+						for (size_t l = 0; l < W; l++)
+							s.a[i][j][l] -= s.a[i][k][l] * s.a[j][k][l] * s.a[k][k][l];
+					for (size_t l = 0; l < W; l++)
+						s.a[i][j][l] *= inv_d[j][l];
+				}
+			}
+			T res[N][W];
+			for (size_t i = 0; i < N; i++)
+			{
+				for (size_t l = 0; l < W; l++)
+					res[i][l] = s.b[i][l];
+				for (size_t j = 0; j < i; j++)
+					for (size_t l = 0; l < W; l++)
+						res[i][l] -= s.a[i][j][l] * res[j][l];
+			}
+			for (size_t i = 0; i < N; i++)
+				for (size_t l = 0; l < W; l++)
+					res[i][l] *= inv_d[i][l];
+			for (size_t i = N; i-- > 0;)
+				for (size_t j = i + 1; j < N; j++)
+					for (size_t l = 0; l < W; l++)
+						res[i][l] -= s.a[j][i][l] * res[j][l];
+			detail::store(res, x.data() + first, count);
+		}
+	}
+
+	// Least-squares solve of a[i] * x[i] = b[i] with Householder QR, W systems at a time.
+	// Rank-deficient systems yield non-finite x, nearly rank-deficient ones an unreliable x;
+	// qr() reports rank_deficient where that needs telling apart.
+	template<size_t W = 8, std::floating_point T, size_t R, size_t C>
+		requires (R >= C)
+	void qr_solve_batch(std::span<const mat<T, R, C>> a, std::span<const vec<T, R>> b, std::span<vec<T, C>> x)
+	{
+		assert(a.size() == b.size() && a.size() == x.size() && "Batch sizes do not match");
+		detail::system_lanes<T, R, C, W> s;
+		for (size_t first = 0; first < a.size(); first += W)
+		{
+			const size_t count = std::min(W, a.size() - first);
+			s.load(a.data() + first, b.data() + first, count);
+			for (size_t k = 0; k < C; k++)
+			{
+				T norm2[W], alpha[W], beta[W];
+				for (size_t l = 0; l < W; l++)
+					norm2[l] = T(0);
+				for (size_t i = k; i < R; i++)
+					for (size_t l = 0; l < W; l++)
+						norm2[l] += s.a[i][k][l] * s.a[i][k][l];
+				for (size_t l = 0; l < W; l++)
+				{
+					const T norm = std::sqrt(norm2[l]);
+					alpha[l] = s.a[k][k][l] > T(0) ? -norm : norm;
+					s.a[k][k][l] -= alpha[l];
+					beta[l] = T(1) / (norm2[l] - alpha[l] * (s.a[k][k][l] + alpha[l]));
+				}
+				for (size_t j = k + 1; j < C; j++)
+				{
+					T d[W];
+					for (size_t l = 0; l < W; l++)
+						d[l] = T(0);
+					for (size_t i = k; i < R; i++)
+						for (size_t l = 0; l < W; l++)
+							d[l] += s.a[i][k][l] * s.a[i][j][l];
+					for (size_t i = k; i < R; i++)
+						for (size_t l = 0; l < W; l++)
+							s.a[i][j][l] -= d[l] * beta[l] * s.a[i][k][l];
+				}
+				T d[W];
+				for (size_t l = 0; l < W; l++)
+					d[l] = T(0);
+				for (size_t i = k; i < R; i++)
+					for (size_t l = 0; l < W; l++)
+						d[l] += s.a[i][k][l] * s.b[i][l];
+				for (size_t i = k; i < R; i++)
+					for (size_t l = 0; l < W; l++)
+						s.b[i][l] -= d[l] * beta[l] * s.a[i][k][l];
+				// R's diagonal replaces the Householder head, which is no longer needed.
+				for (size_t l = 0; l < W; l++)
+					s.a[k][k][l] = alpha[l];
+			}
+			T res[C][W];
+			s.back_substitute(res);
+			detail::store(res, x.data() + first, count);
+		}
+	}
+
+}// namespace mafs
@@ -1,18 +1,326 @@
 #pragma once
+#include <utility>
+#include "vec.hpp"
 
 namespace mafs
 {
-	template<size_t N = 2, size_t M = 2>
+	// Column-major R x C matrix, laid out the way OpenGL expects it (data[c] is column c).
+	template<typename T = float, size_t R = 4, size_t C = R>
+		requires std::floating_point<T> || std::integral<T>
 	class mat
 	{
+	static_assert(R >= 1 && C >= 1, "Matrix dimensions must be at least 1");
 	public:
+		using col_type = vec<T, R>;
+		using row_type = vec<T, C>;
+		//-----------------------------Constructors-----------------------------
+		constexpr mat() {}
+		constexpr explicit mat(T diagonal)
+		{
+			for (size_t i = 0; i < (R < C ? R : C); i++)
+				data[i][i] = diagonal;
+		}
+		constexpr mat(std::initializer_list<col_type> cols)
+		{
+			assert(cols.size() <= C && "Initializer list to large");
+			std::copy(cols.begin(), cols.end(), data.begin());
+		}
+		static constexpr mat identity() { return mat(T(1)); }
+		//-----------------------------Operators-----------------------------
+		constexpr col_type& operator[] (size_t c) { return data[c]; }
+		constexpr const col_type& operator[] (size_t c) const { return data[c]; }
+		constexpr T& operator() (size_t r, size_t c) { return data[c][r]; }
+		constexpr const T& operator() (size_t r, size_t c) const { return data[c][r]; }
 
+		constexpr mat& operator+=(const mat& m)
+		{
+			for (size_t c = 0; c < C; c++)
+				data[c] += m[c];
+			return *this;
+		}
+		constexpr mat& operator-=(const mat& m)
+		{
+			for (size_t c = 0; c < C; c++)
+				data[c] -= m[c];
+			return *this;
+		}
+		constexpr mat& operator*=(T t)
+		{
+			for (size_t c = 0; c < C; c++)
+				data[c] *= t;
+			return *this;
+		}
+		constexpr mat operator+(const mat& m) const
+		{
+			mat res = *this;
+			res += m;
+			return res;
+		}
+		constexpr mat operator-(const mat& m) const
+		{
+			mat res = *this;
+			res -= m;
+			return res;
+		}
+		constexpr mat operator*(T t) const
+		{
+			mat res = *this;
+			res *= t;
+			return res;
+		}
+		friend constexpr mat operator*(T t, const mat& m)
+		{
+			return m * t;
+		}
+		constexpr col_type operator*(const row_type& v) const
+		{
+			// Unrolled with a fold so the compiler sees straight-line column * scalar updates.
+			return [&]<size_t... I>(std::index_sequence<I...>)
+			{
+				col_type res = data[0] * v[0];
+				((res += data[I + 1] * v[I + 1]), ...);
+				return res;
+			}(std::make_index_sequence<C - 1>{});
+		}
+		template<size_t K>
+		constexpr mat<T, R, K> operator*(const mat<T, C, K>& m) const
+		{
+			mat<T, R, K> res;
+			for (size_t k = 0; k < K; k++)
+				res[k] = *this * m[k];
+			return res;
+		}
+		bool operator==(const mat& m) const
+		{
+			for (size_t c = 0; c < C; c++)
+				if (data[c] != m[c]) return false;
+			return true;
+		}
+		bool operator!=(const mat& m) const { return !(*this == m); }
+
+		friend std::ostream& operator<<(std::ostream& out, const mat& m)
+		{
+			for (size_t r = 0; r < R; r++)
+			{
+				out << "[";
+				for (size_t c = 0; c < C; c++)
+					out << m(r, c) << (c < C - 1 ? "," : "");
+				out << "]" << (r < R - 1 ? "\n" : "");
+			}
+			return out;
+		}
+		//-----------------------------Functions-----------------------------
+		constexpr row_type row(size_t r) const
+		{
+			row_type res;
+			for (size_t c = 0; c < C; c++)
+				res[c] = data[c][r];
+			return res;
+		}
+		constexpr mat<T, C, R> transpose() const
+		{
+			mat<T, C, R> res;
+			for (size_t r = 0; r < R; r++)
+				res[r] = row(r);
+			return res;
+		}
+		// Pointer suitable for glUniformMatrix*fv with transpose = GL_FALSE.
+		const T* ptr() const { return &data[0][0]; }
+
+		//-----------------------------Public Variables -----------------------------
+		std::array<col_type, C> data;
 	};
-	class mat<4, 4>
+
+	using mat3f = mat<float, 3, 3>;
+	using mat3d = mat<double, 3, 3>;
+	using mat4f = mat<float, 4, 4>;
+	using mat4d = mat<double, 4, 4>;
+	using mat3x4f = mat<float, 3, 4>;
+	using mat3x4d = mat<double, 3, 4>;
+	using mat4 = mat4f;
+
+	//-----------------------------Projection and view-----------------------------
+	// Range of clip-space depth after the perspective divide. minus_one_to_one is the GL
+	// default, zero_to_one matches glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE) and D3D/Vulkan.
+	enum class clip_depth { minus_one_to_one, zero_to_one };
+
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> frustum(T left, T right, T bottom, T top, T z_near, T z_far,
+		clip_depth depth = clip_depth::minus_one_to_one)
 	{
-	public:
+		mat<T, 4, 4> res;
+		res[0][0] = T(2) * z_near / (right - left);
+		res[1][1] = T(2) * z_near / (top - bottom);
+		res[2][0] = (right + left) / (right - left);
+		res[2][1] = (top + bottom) / (top - bottom);
+		res[2][3] = T(-1);
+		if (depth == clip_depth::zero_to_one)
+		{
+			res[2][2] = -z_far / (z_far - z_near);
+			res[3][2] = -(z_far * z_near) / (z_far - z_near);
+		}
+		else
+		{
+			res[2][2] = -(z_far + z_near) / (z_far - z_near);
+			res[3][2] = -(T(2) * z_far * z_near) / (z_far - z_near);
+		}
+		return res;
+	}
 
-	};
-	using mat4 = mat<4, 4>;
+	// focal is the vertical focal length, 1 / tan(fovy / 2). Taking it instead of the field of
+	// view keeps std::tan out, so the matrix can be built in constant expressions.
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> perspective_focal(T focal, T aspect, T z_near, T z_far,
+		clip_depth depth = clip_depth::minus_one_to_one)
+	{
+		mat<T, 4, 4> res;
+		res[0][0] = focal / aspect;
+		res[1][1] = focal;
+		res[2][3] = T(-1);
+		if (depth == clip_depth::zero_to_one)
+		{
+			res[2][2] = -z_far / (z_far - z_near);
+			res[3][2] = -(z_far * z_near) / (z_far - z_near);
+		}
+		else
+		{
+			res[2][2] = -(z_far + z_near) / (z_far - z_near);
+			res[3][2] = -(T(2) * z_far * z_near) / (z_far - z_near);
+		}
+		return res;
+	}
+	// fovy is the full vertical field of view in radians.
+	template<std::floating_point T>
+	mat<T, 4, 4> perspective(T fovy, T aspect, T z_near, T z_far,
+		clip_depth depth = clip_depth::minus_one_to_one)
+	{
+		return perspective_focal(T(1) / std::tan(fovy / T(2)), aspect, z_near, z_far, depth);
+	}
+
+	// Near plane maps to depth 1, infinity to depth 0 (or -1 with minus_one_to_one).
+	// Pair with glClipControl(..., GL_ZERO_TO_ONE), glDepthFunc(GL_GREATER) and a depth clear of 0.
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> perspective_infinite_reversed_z_focal(T focal, T aspect, T z_near,
+		clip_depth depth = clip_depth::zero_to_one)
+	{
+		mat<T, 4, 4> res;
+		res[0][0] = focal / aspect;
+		res[1][1] = focal;
+		res[2][3] = T(-1);
+		if (depth == clip_depth::zero_to_one)
+		{
+			res[2][2] = T(0);
+			res[3][2] = z_near;
+		}
+		else
+		{
+			res[2][2] = T(1);
+			res[3][2] = T(2) * z_near;
+		}
+		return res;
+	}
+	template<std::floating_point T>
+	mat<T, 4, 4> perspective_infinite_reversed_z(T fovy, T aspect, T z_near,
+		clip_depth depth = clip_depth::zero_to_one)
+	{
+		return perspective_infinite_reversed_z_focal(T(1) / std::tan(fovy / T(2)), aspect, z_near, depth);
+	}
+
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> ortho(T left, T right, T bottom, T top, T z_near, T z_far,
+		clip_depth depth = clip_depth::minus_one_to_one)
+	{
+		mat<T, 4, 4> res;
+		res[0][0] = T(2) / (right - left);
+		res[1][1] = T(2) / (top - bottom);
+		res[3][0] = -(right + left) / (right - left);
+		res[3][1] = -(top + bottom) / (top - bottom);
+		res[3][3] = T(1);
+		if (depth == clip_depth::zero_to_one)
+		{
+			res[2][2] = T(-1) / (z_far - z_near);
+			res[3][2] = -z_near / (z_far - z_near);
+		}
+		else
+		{
+			res[2][2] = T(-2) / (z_far - z_near);
+			res[3][2] = -(z_far + z_near) / (z_far - z_near);
+		}
+		return res;
+	}
+
+	// Right-handed view matrix from a camera basis: forward and up must be unit length and
+	// orthogonal. Without normalization this works in constant expressions.
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> look_at_basis(const vec<T, 3>& eye, const vec<T, 3>& forward, const vec<T, 3>& up)
+	{
+		const vec<T, 3>& f = forward;
+		const vec<T, 3>& u = up;
+		const vec<T, 3> s = f.cross(u);
+		mat<T, 4, 4> res;
+		res[0] = vec<T, 4>{ s.x, u.x, -f.x, T(0) };
+		res[1] = vec<T, 4>{ s.y, u.y, -f.y, T(0) };
+		res[2] = vec<T, 4>{ s.z, u.z, -f.z, T(0) };
+		res[3] = vec<T, 4>{ -s.dot(eye), -u.dot(eye), f.dot(eye), T(1) };
+		return res;
+	}
+	// Right-handed view matrix, camera looks down -z.
+	template<std::floating_point T>
+	mat<T, 4, 4> look_at(const vec<T, 3>& eye, const vec<T, 3>& center, const vec<T, 3>& up)
+	{
+		const vec<T, 3> f = (center - eye).normalize();
+		const vec<T, 3> s = f.cross(up).normalize();
+		return look_at_basis(eye, f, s.cross(f));
+	}
+
+	//-----------------------------Analytical inverses-----------------------------
+	// Inverse of any matrix produced by frustum, perspective or perspective_infinite_reversed_z.
+	// Only the seven non-zero entries are read, so this costs a handful of divisions.
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> inverse_perspective(const mat<T, 4, 4>& p)
+	{
+		const T inv_a = T(1) / p[0][0];
+		const T inv_c = T(1) / p[1][1];
+		const T inv_f = T(1) / p[3][2];
+		const T inv_g = T(1) / p[2][3];
+		mat<T, 4, 4> res;
+		res[0][0] = inv_a;
+		res[1][1] = inv_c;
+		res[2][3] = inv_f;
+		res[3][0] = -p[2][0] * inv_a * inv_g;
+		res[3][1] = -p[2][1] * inv_c * inv_g;
+		res[3][2] = inv_g;
+		res[3][3] = -p[2][2] * inv_f * inv_g;
+		return res;
+	}
+
+	// Inverse of a matrix produced by ortho.
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> inverse_ortho(const mat<T, 4, 4>& o)
+	{
+		mat<T, 4, 4> res;
+		for (size_t i = 0; i < 3; i++)
+		{
+			res[i][i] = T(1) / o[i][i];
+			res[3][i] = -o[3][i] * res[i][i];
+		}
+		res[3][3] = T(1);
+		return res;
+	}
+
+	// Inverse of a rotation + translation matrix such as the one produced by look_at.
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> inverse_rigid(const mat<T, 4, 4>& m)
+	{
+		mat<T, 4, 4> res;
+		for (size_t c = 0; c < 3; c++)
+			for (size_t r = 0; r < 3; r++)
+				res[c][r] = m[r][c];
+		const vec<T, 3> t = m[3].xyz();
+		for (size_t r = 0; r < 3; r++)
+			res[3][r] = -(res[0][r] * t.x + res[1][r] * t.y + res[2][r] * t.z);
+		res[3][3] = T(1);
+		return res;
+	}
 
-}// namespace mafs
\ No newline at end of file
+}// namespace mafs
@@ -0,0 +1,185 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "aabb.hpp"
+#include "parallel.hpp"
+#if defined(__BMI2__)
+#define MAFS_BMI2 1
+#include <immintrin.h>
+#endif
+
+// Morton (Z-order) codes interleave the bits of three cell coordinates, x in the lowest bit:
+// ... z1 y1 x1 z0 y0 x0. Sorting by code walks the grid along a Z curve, so things close in
+// the order are mostly close in space. The 30-bit codes take 10 bits per axis, the 63-bit
+// codes 21. With BMI2 the bits are scattered by pdep, otherwise by shift-and-mask steps;
+// both give the same codes. pdep is microcoded and slow on AMD before Zen 3, where building
+// without BMI2 is the better choice.
+namespace mafs
+{
+	namespace detail
+	{
+		// Moves bit i of the low 10 bits of x to bit 3i.
+		constexpr uint32_t spread_bits_10(uint32_t x)
+		{
+			x &= 0x3ff;
+			x = (x | x << 16) & 0x030000ff;
+			x = (x | x << 8) & 0x0300f00f;
+			x = (x | x << 4) & 0x030c30c3;
+			x = (x | x << 2) & 0x09249249;
+			return x;
+		}
+		constexpr uint32_t compact_bits_10(uint32_t x)
+		{
+			x &= 0x09249249;
+			x = (x | x >> 2) & 0x030c30c3;
+			x = (x | x >> 4) & 0x0300f00f;
+			x = (x | x >> 8) & 0x030000ff;
+			x = (x | x >> 16) & 0x3ff;
+			return x;
+		}
+		// Moves bit i of the low 21 bits of x to bit 3i.
+		constexpr uint64_t spread_bits_21(uint64_t x)
+		{
+			x &= 0x1fffff;
+			x = (x | x << 32) & 0x001f00000000ffffull;
+			x = (x | x << 16) & 0x001f0000ff0000ffull;
+			x = (x | x << 8) & 0x100f00f00f00f00full;
+			x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+			x = (x | x << 2) & 0x1249249249249249ull;
+			return x;
+		}
+		constexpr uint64_t compact_bits_21(uint64_t x)
+		{
+			x &= 0x1249249249249249ull;
+			x = (x | x >> 2) & 0x10c30c30c30c30c3ull;
+			x = (x | x >> 4) & 0x100f00f00f00f00full;
+			x = (x | x >> 8) & 0x001f0000ff0000ffull;
+			x = (x | x >> 16) & 0x001f00000000ffffull;
+			x = (x | x >> 32) & 0x1fffff;
+			return x;
+		}
+
+		// Maps a box onto a grid of 2^bits cells per axis; points outside land in the border cells.
+		struct morton_grid
+		{
+			morton_grid(const aabb<float, 3>& bounds, unsigned bits) : lo(bounds.min), max_cell(float((1u << bits) - 1))
+			{
+				const vec3f e = bounds.extents();
+				for (size_t i = 0; i < 3; i++)
+					scale[i] = e[i] > 0.0f ? float(1u << bits) / e[i] : 0.0f;
+			}
+			vec3i cell(const vec3f& p) const
+			{
+				const vec3f c = min(max((p - lo) * scale, vec3f(0.0f)), vec3f(max_cell));
+				return vec3i{ int(c.x), int(c.y), int(c.z) };
+			}
+
+			vec3f lo;
+			vec3f scale;
+			float max_cell;
+		};
+	}
+
+	// Cell coordinates must lie in [0, 1024).
+	constexpr uint32_t morton_encode_30(const vec3i& c)
+	{
+		assert(uint32_t(c.x | c.y | c.z) < 1024u && "Cell outside the 10-bit grid");
+#if defined(MAFS_BMI2)
+		if (!std::is_constant_evaluated())
+			return _pdep_u32(uint32_t(c.x), 0x09249249u) | _pdep_u32(uint32_t(c.y), 0x12492492u) | _pdep_u32(uint32_t(c.z), 0x24924924u);
+#endif
+		return detail::spread_bits_10(uint32_t(c.x)) | detail::spread_bits_10(uint32_t(c.y)) << 1 | detail::spread_bits_10(uint32_t(c.z)) << 2;
+	}
+	constexpr vec3i morton_decode_30(uint32_t code)
+	{
+#if defined(MAFS_BMI2)
+		if (!std::is_constant_evaluated())
+			return vec3i{ int(_pext_u32(code, 0x09249249u)), int(_pext_u32(code, 0x12492492u)), int(_pext_u32(code, 0x24924924u)) };
+#endif
+		return vec3i{ int(detail::compact_bits_10(code)), int(detail::compact_bits_10(code >> 1)), int(detail::compact_bits_10(code >> 2)) };
+	}
+	// Cell coordinates must lie in [0, 2^21).
+	constexpr uint64_t morton_encode_63(const vec3i& c)
+	{
+		assert(uint32_t(c.x | c.y | c.z) < (1u << 21) && "Cell outside the 21-bit grid");
+#if defined(MAFS_BMI2)
+		if (!std::is_constant_evaluated())
+			return _pdep_u64(uint64_t(c.x), 0x1249249249249249ull) | _pdep_u64(uint64_t(c.y), 0x2492492492492492ull) | _pdep_u64(uint64_t(c.z), 0x4924924924924924ull);
+#endif
+		return detail::spread_bits_21(uint64_t(c.x)) | detail::spread_bits_21(uint64_t(c.y)) << 1 | detail::spread_bits_21(uint64_t(c.z)) << 2;
+	}
+	constexpr vec3i morton_decode_63(uint64_t code)
+	{
+#if defined(MAFS_BMI2)
+		if (!std::is_constant_evaluated())
+			return vec3i{ int(_pext_u64(code, 0x1249249249249249ull)), int(_pext_u64(code, 0x2492492492492492ull)), int(_pext_u64(code, 0x4924924924924924ull)) };
+#endif
+		return vec3i{ int(detail::compact_bits_21(code)), int(detail::compact_bits_21(code >> 1)), int(detail::compact_bits_21(code >> 2)) };
+	}
+
+	// Code of p quantized to the grid over bounds; points outside are clamped onto it.
+	inline uint32_t morton_code_30(const vec3f& p, const aabb<float, 3>& bounds)
+	{
+		return morton_encode_30(detail::morton_grid(bounds, 10).cell(p));
+	}
+	inline uint64_t morton_code_63(const vec3f& p, const aabb<float, 3>& bounds)
+	{
+		return morton_encode_63(detail::morton_grid(bounds, 21).cell(p));
+	}
+
+	// Batched codes on up to `threads` threads; the width of out picks 30 or 63 bits.
+	template<typename Code>
+		requires std::same_as<Code, uint32_t> || std::same_as<Code, uint64_t>
+	void morton_codes(std::span<const vec3f> points, const aabb<float, 3>& bounds, std::span<Code> out, size_t threads = hardware_threads())
+	{
+		assert(out.size() >= points.size() && "Output too small");
+		const detail::morton_grid grid(bounds, sizeof(Code) == 4 ? 10 : 21);
+		parallel_for(points.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				if constexpr (sizeof(Code) == 4)
+					out[i] = morton_encode_30(grid.cell(points[i]));
+				else
+					out[i] = morton_encode_63(grid.cell(points[i]));
+			}
+		}, 16384, threads);
+	}
+	template<typename Code>
+		requires std::same_as<Code, uint32_t> || std::same_as<Code, uint64_t>
+	void morton_codes(std::span<const vec3i> cells, std::span<Code> out, size_t threads = hardware_threads())
+	{
+		assert(out.size() >= cells.size() && "Output too small");
+		parallel_for(cells.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				if constexpr (sizeof(Code) == 4)
+					out[i] = morton_encode_30(cells[i]);
+				else
+					out[i] = morton_encode_63(cells[i]);
+			}
+		}, 16384, threads);
+	}
+
+	// Indices of points in Morton order: codes over bounds, then a radix sort of (code, index)
+	// pairs. Equal codes keep input order. codes receives the sorted codes.
+	template<typename Code>
+		requires std::same_as<Code, uint32_t> || std::same_as<Code, uint64_t>
+	void morton_order(std::span<const vec3f> points, const aabb<float, 3>& bounds, std::vector<Code>& codes, std::vector<uint32_t>& order,
+		size_t threads = hardware_threads())
+	{
+		assert(points.size() < (size_t(1) << 32) && "Indices are 32-bit");
+		codes.resize(points.size());
+		order.resize(points.size());
+		morton_codes(points, bounds, std::span<Code>(codes), threads);
+		parallel_for(points.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				order[i] = uint32_t(i);
+		}, 16384, threads);
+		radix_sort(std::span<Code>(codes), std::span<uint32_t>(order), sizeof(Code) == 4 ? 30 : 63, threads);
+	}
+
+}// namespace mafs
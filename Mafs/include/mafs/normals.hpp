@@ -0,0 +1,310 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "parallel.hpp"
+#include "quantize.hpp"
+#include "vmath.hpp"
+
+// Smooth vertex normals and tangents of indexed triangle meshes.
+//
+// build() sorts the triangle corners by vertex with a counting sort, so every vertex finds the
+// corners that touch it in one contiguous run. A face pass then runs over the triangles W at a
+// time, with edges, cross products and corner angles computed on vec<float, W> packets, and a
+// vertex pass sums each vertex's corners in triangle order. No two threads write the same
+// value, so there are no atomics, and the results do not depend on the thread count.
+//
+// Tangents follow MikkTSpace: each triangle's tangent along increasing u, signed by its UV
+// winding, is projected into the plane of each corner's vertex normal and weighted by the corner
+// angle in that plane. w is the bitangent sign, bitangent = cross(normal, tangent) * w.
+// MikkTSpace also splits vertices whose triangles disagree on the UV winding; here such a vertex
+// takes the winding with the larger total angle, so mirrored UV seams must already be split.
+namespace mafs
+{
+	enum class normal_weighting
+	{
+		// Each face by its area.
+		area,
+		// Each face by its angle at the vertex, which does not depend on how polygons were triangulated.
+		angle,
+	};
+
+	class mesh_normals
+	{
+	public:
+		// Packed tangents: the direction in unit_vec_codec<15> form, bit 31 set when w is -1.
+		using tangent_codec = unit_vec_codec<15>;
+
+		//-----------------------------Functions-----------------------------
+		static constexpr uint32_t pack_tangent(const vec4f& t)
+		{
+			return tangent_codec::encode(t.xyz()) | (detail::less(t.w, 0.0f) ? 1u << 31 : 0u);
+		}
+		static vec4f unpack_tangent(uint32_t s)
+		{
+			const vec3f t = tangent_codec::decode(s & 0x7fffffffu);
+			return vec4f{ t.x, t.y, t.z, s >> 31 ? -1.0f : 1.0f };
+		}
+
+		// Sorts the corners of a triangle list by vertex; needed once per index buffer before the
+		// computations below. Corner c is index c of the list, of triangle c / 3.
+		void build(std::span<const uint32_t> triangle_indices, size_t vertex_count, size_t threads = hardware_threads())
+		{
+			assert(triangle_indices.size() % 3 == 0 && "Triangle lists hold three indices per triangle");
+			assert(triangle_indices.size() < (size_t(1) << 32) && vertex_count < (size_t(1) << 32) && "Indices are 32-bit");
+			indices.assign(triangle_indices.begin(), triangle_indices.end());
+			const size_t n = indices.size(), v_count = vertex_count;
+			// Each chunk counts and later places the corners of its own range of vertices,
+			// walking all of them in order, so chunks never share a counter and one table of
+			// counters serves them all.
+			const size_t chunks = std::max<size_t>(1, std::min({ threads, n / 65536, v_count }));
+			corner_offsets.assign(v_count + 1, 0);
+			parallel_for(chunks, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+				{
+					uint32_t* count = corner_offsets.data();
+					const uint32_t lo = uint32_t(v_count * c / chunks), span = uint32_t(v_count * (c + 1) / chunks) - lo;
+					for (size_t i = 0; i < n; i++)
+					{
+						assert(indices[i] < v_count && "Index out of range");
+						if (indices[i] - lo < span)
+							count[indices[i]]++;
+					}
+				}
+			}, 1, threads);
+			parallel_exclusive_scan(std::span<uint32_t>(corner_offsets), threads);
+
+			// Scattered in corner order, so every run lists its triangles in order.
+			counts.resize(v_count);
+			corners.resize(n);
+			parallel_for(chunks, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+				{
+					uint32_t* slot = counts.data();
+					const uint32_t lo = uint32_t(v_count * c / chunks), span = uint32_t(v_count * (c + 1) / chunks) - lo;
+					std::copy(corner_offsets.begin() + lo, corner_offsets.begin() + lo + span, slot + lo);
+					for (size_t i = 0; i < n; i++)
+						if (indices[i] - lo < span)
+							corners[slot[indices[i]]++] = uint32_t(i);
+				}
+			}, 1, threads);
+		}
+		size_t vertex_count() const { return corner_offsets.empty() ? 0 : corner_offsets.size() - 1; }
+		size_t triangle_count() const { return indices.size() / 3; }
+
+		// Unit normals; a vertex without a triangle of nonzero area gets +z.
+		template<size_t W = 8>
+		void compute_normals(std::span<const vec3f> positions, std::span<vec3f> out, normal_weighting weighting = normal_weighting::angle, size_t threads = hardware_threads())
+		{
+			vertex_normals<W>(positions, out.size(), weighting, threads, [&](size_t v, const vec3f& n) { out[v] = n; });
+		}
+		// Normals in unit_vec_codec32 form.
+		template<size_t W = 8>
+		void compute_normals(std::span<const vec3f> positions, std::span<unit_vec_codec32::storage> out, normal_weighting weighting = normal_weighting::angle, size_t threads = hardware_threads())
+		{
+			vertex_normals<W>(positions, out.size(), weighting, threads, [&](size_t v, const vec3f& n) { out[v] = unit_vec_codec32::encode(n); });
+		}
+
+		// Unit tangents with the bitangent sign in w. normals should be unit length, as from
+		// compute_normals. A vertex without a usable UV direction gets some tangent
+		// perpendicular to its normal.
+		template<size_t W = 8>
+		void compute_tangents(std::span<const vec3f> positions, std::span<const vec3f> normals, std::span<const vec<float, 2>> uvs, std::span<vec4f> out, size_t threads = hardware_threads())
+		{
+			vertex_tangents<W>(positions, normals, uvs, out.size(), threads, [&](size_t v, const vec4f& t) { out[v] = t; });
+		}
+		// Tangents packed by pack_tangent.
+		template<size_t W = 8>
+		void compute_tangents(std::span<const vec3f> positions, std::span<const vec3f> normals, std::span<const vec<float, 2>> uvs, std::span<uint32_t> out, size_t threads = hardware_threads())
+		{
+			vertex_tangents<W>(positions, normals, uvs, out.size(), threads, [&](size_t v, const vec4f& t) { out[v] = pack_tangent(t); });
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		// The triangle list of the last build, and its corners grouped by vertex: those of vertex
+		// v are corners[corner_offsets[v]] to corners[corner_offsets[v + 1] - 1].
+		std::vector<uint32_t> indices;
+		std::vector<uint32_t> corner_offsets;
+		std::vector<uint32_t> corners;
+
+	private:
+		// Loads the corners of triangles [base, base + W) as packets; lanes past the last
+		// triangle repeat it.
+		template<size_t W, typename P, size_t N>
+		void load_corners(std::span<const vec<float, N>> values, size_t base, size_t lanes, P (&c)[3][N]) const
+		{
+			for (size_t l = 0; l < W; l++)
+			{
+				const size_t t = base + std::min(l, lanes - 1);
+				for (size_t k = 0; k < 3; k++)
+				{
+					const vec<float, N>& p = values[indices[3 * t + k]];
+					for (size_t a = 0; a < N; a++)
+						c[k][a][l] = p[a];
+				}
+			}
+		}
+		// 1 / x where x > 0, else 0.
+		template<size_t W>
+		static vec<float, W> safe_inverse(const vec<float, W>& x)
+		{
+			vec<float, W> res;
+			for (size_t l = 0; l < W; l++)
+				res[l] = detail::blend(detail::less(0.0f, x[l]), 1.0f / x[l], 0.0f);
+			return res;
+		}
+
+		template<size_t W, typename F>
+		void vertex_normals(std::span<const vec3f> positions, [[maybe_unused]] size_t out_size, normal_weighting weighting, size_t threads, F&& write)
+		{
+			using packet = vec<float, W>;
+			assert(out_size == vertex_count() && positions.size() == vertex_count() && "Needs one position and one output per vertex");
+			const size_t faces = triangle_count();
+			const bool by_angle = weighting == normal_weighting::angle;
+			face_vectors.resize(faces);
+			corner_weights.resize(by_angle ? faces : 0);
+
+			// Face pass: cross products, and for angle weighting each corner's angle over the
+			// cross product's length, so that the vertex pass only multiplies.
+			parallel_for((faces + W - 1) / W, [&](size_t first, size_t last)
+			{
+				for (size_t b = first; b < last; b++)
+				{
+					const size_t base = b * W, lanes = std::min(W, faces - base);
+					packet p[3][3];
+					load_corners<W>(positions, base, lanes, p);
+					packet e[3][3];
+					for (size_t k = 0; k < 3; k++)
+						for (size_t a = 0; a < 3; a++)
+							e[k][a] = p[(k + 1) % 3][a] - p[k][a];
+					// e[k] runs from corner k to corner k + 1; the cross product of e[0] and -e[2].
+					const packet nx = e[2][1] * e[0][2] - e[2][2] * e[0][1];
+					const packet ny = e[2][2] * e[0][0] - e[2][0] * e[0][2];
+					const packet nz = e[2][0] * e[0][1] - e[2][1] * e[0][0];
+					for (size_t l = 0; l < lanes; l++)
+						face_vectors[base + l] = vec3f{ nx[l], ny[l], nz[l] };
+					if (!by_angle)
+						continue;
+					const packet length = sqrt(nx * nx + ny * ny + nz * nz);
+					const packet inv_length = safe_inverse(length);
+					packet w[3];
+					for (size_t k = 0; k < 3; k++)
+					{
+						// Corner k lies between e[k] and -e[k - 1]; the sine part is the same for all three.
+						const size_t j = (k + 2) % 3;
+						const packet cos_part = -(e[k][0] * e[j][0] + e[k][1] * e[j][1] + e[k][2] * e[j][2]);
+						w[k] = atan2(length, cos_part) * inv_length;
+					}
+					for (size_t l = 0; l < lanes; l++)
+						corner_weights[base + l] = vec3f{ w[0][l], w[1][l], w[2][l] };
+				}
+			}, 64, threads);
+
+			parallel_for(vertex_count(), [&](size_t begin, size_t end)
+			{
+				for (size_t v = begin; v < end; v++)
+				{
+					vec3f sum(0.0f);
+					for (uint32_t i = corner_offsets[v]; i < corner_offsets[v + 1]; i++)
+					{
+						const uint32_t c = corners[i];
+						sum += by_angle ? face_vectors[c / 3] * corner_weights[c / 3][c % 3] : face_vectors[c / 3];
+					}
+					const float length = sum.norm();
+					write(v, length > 0.0f ? sum / length : vec3f{ 0.0f, 0.0f, 1.0f });
+				}
+			}, 1024, threads);
+		}
+
+		template<size_t W, typename F>
+		void vertex_tangents(std::span<const vec3f> positions, std::span<const vec3f> normals, std::span<const vec<float, 2>> uvs, [[maybe_unused]] size_t out_size, size_t threads, F&& write)
+		{
+			using packet = vec<float, W>;
+			assert(out_size == vertex_count() && positions.size() == vertex_count() && normals.size() == vertex_count() && uvs.size() == vertex_count()
+				&& "Needs one position, normal, UV and output per vertex");
+			const size_t faces = triangle_count();
+			face_vectors.resize(faces);
+			face_signs.resize(faces);
+
+			// Face pass: the tangent along increasing u, normalized and times the sign of the UV
+			// winding, as MikkTSpace stores it; zero for triangles without a UV direction.
+			parallel_for((faces + W - 1) / W, [&](size_t first, size_t last)
+			{
+				for (size_t b = first; b < last; b++)
+				{
+					const size_t base = b * W, lanes = std::min(W, faces - base);
+					packet p[3][3], t[3][2];
+					load_corners<W>(positions, base, lanes, p);
+					load_corners<W>(uvs, base, lanes, t);
+					packet os[3];
+					for (size_t a = 0; a < 3; a++)
+						os[a] = (t[2][1] - t[0][1]) * (p[1][a] - p[0][a]) - (t[1][1] - t[0][1]) * (p[2][a] - p[0][a]);
+					const packet uv_area = (t[1][0] - t[0][0]) * (t[2][1] - t[0][1]) - (t[1][1] - t[0][1]) * (t[2][0] - t[0][0]);
+					const packet scale = safe_inverse(sqrt(os[0] * os[0] + os[1] * os[1] + os[2] * os[2]));
+					for (size_t l = 0; l < lanes; l++)
+					{
+						const float sign = detail::blend(detail::less(0.0f, uv_area[l]), 1.0f, -1.0f);
+						face_vectors[base + l] = vec3f{ os[0][l], os[1][l], os[2][l] } * (sign * scale[l]);
+						face_signs[base + l] = sign;
+					}
+				}
+			}, 64, threads);
+
+			// Vertex pass: projections and corner angles depend on the vertex normal, so they are
+			// computed here, per corner.
+			parallel_for(vertex_count(), [&](size_t begin, size_t end)
+			{
+				for (size_t v = begin; v < end; v++)
+				{
+					const vec3f& n = normals[v];
+					vec3f sum(0.0f);
+					float winding = 0.0f;
+					for (uint32_t i = corner_offsets[v]; i < corner_offsets[v + 1]; i++)
+					{
+						const uint32_t c = corners[i], t = c / 3, k = c % 3;
+						const vec3f tangent = in_plane(face_vectors[t], n);
+						// The corner angle between the edges projected into the plane, as atan2 rather
+						// than MikkTSpace's acos of normalized edges: the same angle, without the square roots.
+						const vec3f e1 = positions[indices[3 * t + (k + 1) % 3]] - positions[v];
+						const vec3f e2 = positions[indices[3 * t + (k + 2) % 3]] - positions[v];
+						const float d1 = n.dot(e1), d2 = n.dot(e2);
+						const float angle = detail::atan2_lane<precision::accurate>(std::abs(n.dot(e1.cross(e2))), e1.dot(e2) - d1 * d2);
+						sum += tangent * angle;
+						winding += face_signs[t] * angle;
+					}
+					const float length = sum.norm();
+					vec3f tangent;
+					if (length > 0.0f)
+						tangent = sum / length;
+					else
+					{
+						// Any direction in the plane: n crossed with the axis least aligned with it.
+						const vec3f axis = std::abs(n.x) < std::abs(n.y) ? vec3f{ 1.0f, 0.0f, 0.0f } : vec3f{ 0.0f, 1.0f, 0.0f };
+						tangent = n.cross(axis).normalize();
+					}
+					write(v, vec4f{ tangent.x, tangent.y, tangent.z, winding < 0.0f ? -1.0f : 1.0f });
+				}
+			}, 1024, threads);
+		}
+		// v projected into the plane of unit normal n and normalized; zero stays zero.
+		static vec3f in_plane(const vec3f& v, const vec3f& n)
+		{
+			const vec3f p = v - n * n.dot(v);
+			const float length = p.norm();
+			return length > 0.0f ? p / length : vec3f(0.0f);
+		}
+
+		// Next free slot in each vertex's run while corners are placed.
+		std::vector<uint32_t> counts;
+		// Per triangle: the cross product or the signed tangent, the corner weights of angle
+		// weighting, and the UV winding.
+		std::vector<vec3f> face_vectors;
+		std::vector<vec3f> corner_weights;
+		std::vector<float> face_signs;
+	};
+
+}// namespace mafs
@@ -0,0 +1,280 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "aabb.hpp"
+#include "frustum.hpp"
+#include "sphere.hpp"
+
+namespace mafs
+{
+	// Loose octree over boxes that move. Cells halve per level as usual, but a node holds any box
+	// that fits its loose bounds, the cell grown by half its size on every side. A box goes to
+	// the deepest level whose cells are at least its size, in the cell holding its center, so a
+	// box moving by less than half a cell stays where it is and a move costs one containment
+	// test. Nodes and objects live in pools with free lists; a handle stays valid until removed.
+	template<std::floating_point T = float>
+	class loose_octree
+	{
+	public:
+		static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+		// Deepest level allowed; bounds the traversal stacks.
+		static constexpr uint32_t max_levels = 16;
+
+		struct node
+		{
+			vec<T, 3> center;
+			// Half the cell size; the loose bounds are center +- 2 * half.
+			T half;
+			uint32_t parent;
+			uint32_t children[8];
+			// Head of the intrusive list of the node's objects.
+			uint32_t first_object;
+			uint32_t object_count;
+		};
+		struct object
+		{
+			aabb<T, 3> bounds;
+			// none while the handle is free.
+			uint32_t node;
+			uint32_t prev;
+			uint32_t next;
+		};
+
+		//-----------------------------Constructors-----------------------------
+		// The root cell is the cube around world. Boxes that do not fit the root's loose bounds
+		// are kept in the root, whose objects every query tests, so nothing is ever lost.
+		explicit loose_octree(const aabb<T, 3>& world, uint32_t max_depth = 8) : max_depth(max_depth)
+		{
+			assert(!world.is_empty() && "World bounds must not be empty");
+			assert(max_depth <= max_levels && "Tree too deep");
+			const vec<T, 3> e = world.extents();
+			nodes.push_back(make_node(world.center(), std::max({ e.x, e.y, e.z }) * T(0.5), none));
+		}
+
+		//-----------------------------Functions-----------------------------
+		size_t size() const { return objects.size() - free_objects.size(); }
+		size_t node_count() const { return nodes.size() - free_nodes.size(); }
+		const aabb<T, 3>& bounds(uint32_t handle) const { return objects[handle].bounds; }
+		static constexpr aabb<T, 3> loose_bounds(const node& n) { return aabb<T, 3>::from_center_extents(n.center, vec<T, 3>(T(2) * n.half)); }
+
+		uint32_t insert(const aabb<T, 3>& b)
+		{
+			assert(!b.is_empty() && "Empty box");
+			uint32_t handle;
+			if (free_objects.empty())
+			{
+				handle = uint32_t(objects.size());
+				objects.push_back(object{});
+			}
+			else
+			{
+				handle = free_objects.back();
+				free_objects.pop_back();
+			}
+			objects[handle].bounds = b;
+			link(handle, place(b));
+			return handle;
+		}
+		void remove(uint32_t handle)
+		{
+			assert(handle < objects.size() && objects[handle].node != none && "Invalid handle");
+			const uint32_t n = objects[handle].node;
+			unlink(handle);
+			objects[handle].node = none;
+			free_objects.push_back(handle);
+			prune(n);
+		}
+		// Returns true when the box still fits its node, which leaves the tree untouched.
+		bool move(uint32_t handle, const aabb<T, 3>& b)
+		{
+			assert(handle < objects.size() && objects[handle].node != none && "Invalid handle");
+			assert(!b.is_empty() && "Empty box");
+			object& o = objects[handle];
+			const uint32_t n = o.node;
+			o.bounds = b;
+			// Root objects may be outside the world, so they are always placed again.
+			if (n != 0 && loose_bounds(nodes[n]).contains(b))
+				return true;
+			unlink(handle);
+			link(handle, place(b));
+			prune(n);
+			return false;
+		}
+		// Removes every object; the pools keep their memory.
+		void clear()
+		{
+			const node root = make_node(nodes[0].center, nodes[0].half, none);
+			nodes.assign(1, root);
+			objects.clear();
+			free_nodes.clear();
+			free_objects.clear();
+		}
+
+		// The queries below call fn(handle) once for every object whose box passes the test,
+		// in no particular order.
+		template<typename F>
+		void query(const aabb<T, 3>& box, F&& fn) const
+		{
+			visit([&](const aabb<T, 3>& loose) { return !loose.overlaps(box) ? outside : box.contains(loose) ? inside : partial; },
+				[&](const aabb<T, 3>& b) { return b.overlaps(box); }, fn);
+		}
+		template<typename F>
+		void query(const sphere<T>& s, F&& fn) const
+		{
+			if (!(s.radius >= T(0)))
+				return;
+			const T radius_squared = s.radius * s.radius;
+			visit([&](const aabb<T, 3>& loose) { return loose.distance_squared(s.center) <= radius_squared ? partial : outside; },
+				[&](const aabb<T, 3>& b) { return b.distance_squared(s.center) <= radius_squared; }, fn);
+		}
+		// As conservative as view_frustum::intersects; subtrees wholly inside are not tested.
+		template<typename F>
+		void query(const view_frustum<T>& f, F&& fn) const
+		{
+			visit([&](const aabb<T, 3>& loose) { return !f.intersects(loose) ? outside : f.contains(loose) ? inside : partial; },
+				[&](const aabb<T, 3>& b) { return f.intersects(b); }, fn);
+		}
+		// Objects whose boxes the ray hits within [0, t_max].
+		template<typename F>
+		void query(const ray<T, 3>& r, T t_max, F&& fn) const
+		{
+			visit([&](const aabb<T, 3>& loose) { return loose.intersects(r, t_max) ? partial : outside; },
+				[&](const aabb<T, 3>& b) { return b.intersects(r, t_max); }, fn);
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		// Node 0 is the root. Free slots of both pools are listed in free_nodes and free_objects.
+		std::vector<node> nodes;
+		std::vector<object> objects;
+		std::vector<uint32_t> free_nodes;
+		std::vector<uint32_t> free_objects;
+		uint32_t max_depth;
+
+	private:
+		enum overlap { outside, partial, inside };
+
+		static node make_node(const vec<T, 3>& center, T half, uint32_t parent)
+		{
+			node res{ center, half, parent, {}, none, 0 };
+			std::fill(std::begin(res.children), std::end(res.children), none);
+			return res;
+		}
+
+		// Walks down from the root along the box center while the child's cells are still at
+		// least the box's size and its loose bounds hold the box, creating nodes on the way.
+		uint32_t place(const aabb<T, 3>& b)
+		{
+			const vec<T, 3> c = b.center(), e = b.extents() * T(0.5);
+			const T size = std::max({ e.x, e.y, e.z });
+			uint32_t n = 0;
+			for (uint32_t depth = 0; depth < max_depth; depth++)
+			{
+				const vec<T, 3> center = nodes[n].center;
+				const T half = nodes[n].half * T(0.5);
+				if (half < size)
+					break;
+				const uint32_t octant = uint32_t(c.x >= center.x) | uint32_t(c.y >= center.y) << 1 | uint32_t(c.z >= center.z) << 2;
+				const vec<T, 3> child_center = center + vec<T, 3>{ octant & 1 ? half : -half, octant & 2 ? half : -half, octant & 4 ? half : -half };
+				if (!aabb<T, 3>::from_center_extents(child_center, vec<T, 3>(T(2) * half)).contains(b))
+					break;
+				uint32_t child = nodes[n].children[octant];
+				if (child == none)
+				{
+					if (free_nodes.empty())
+					{
+						child = uint32_t(nodes.size());
+						nodes.push_back(make_node(child_center, half, n));
+					}
+					else
+					{
+						child = free_nodes.back();
+						free_nodes.pop_back();
+						nodes[child] = make_node(child_center, half, n);
+					}
+					nodes[n].children[octant] = child;
+				}
+				n = child;
+			}
+			return n;
+		}
+
+		void link(uint32_t handle, uint32_t n)
+		{
+			object& o = objects[handle];
+			o.node = n;
+			o.prev = none;
+			o.next = nodes[n].first_object;
+			if (o.next != none)
+				objects[o.next].prev = handle;
+			nodes[n].first_object = handle;
+			nodes[n].object_count++;
+		}
+		void unlink(uint32_t handle)
+		{
+			const object& o = objects[handle];
+			if (o.prev != none)
+				objects[o.prev].next = o.next;
+			else
+				nodes[o.node].first_object = o.next;
+			if (o.next != none)
+				objects[o.next].prev = o.prev;
+			nodes[o.node].object_count--;
+		}
+		// Frees n and then its ancestors for as long as they hold nothing.
+		void prune(uint32_t n)
+		{
+			while (n != 0 && nodes[n].object_count == 0)
+			{
+				const uint32_t* children = nodes[n].children;
+				if (std::any_of(children, children + 8, [](uint32_t c) { return c != none; }))
+					return;
+				const uint32_t parent = nodes[n].parent;
+				*std::find(nodes[parent].children, nodes[parent].children + 8, n) = none;
+				free_nodes.push_back(n);
+				n = parent;
+			}
+		}
+
+		// Depth-first walk. node_test classifies a child's loose bounds; objects of nodes found
+		// inside are reported without object_test. The root's own bounds are never tested.
+		template<typename NodeTest, typename ObjectTest, typename F>
+		void visit(NodeTest&& node_test, ObjectTest&& object_test, F& fn) const
+		{
+			struct entry
+			{
+				uint32_t node;
+				bool inside;
+			};
+			// Each level leaves at most 7 siblings behind.
+			entry stack[7 * max_levels + 8];
+			size_t top = 0;
+			stack[top++] = entry{ 0, false };
+			while (top > 0)
+			{
+				const entry e = stack[--top];
+				const node& n = nodes[e.node];
+				for (uint32_t h = n.first_object; h != none; h = objects[h].next)
+					if (e.inside || object_test(objects[h].bounds))
+						fn(h);
+				// The children's bounds follow from the parent's, so rejected children are never loaded.
+				const T half = n.half * T(0.5);
+				for (uint32_t octant = 0; octant < 8; octant++)
+				{
+					const uint32_t c = n.children[octant];
+					if (c == none)
+						continue;
+					const vec<T, 3> center = n.center + vec<T, 3>{ octant & 1 ? half : -half, octant & 2 ? half : -half, octant & 4 ? half : -half };
+					const overlap o = e.inside ? inside : node_test(aabb<T, 3>::from_center_extents(center, vec<T, 3>(T(2) * half)));
+					if (o != outside)
+						stack[top++] = entry{ c, o == inside };
+				}
+			}
+		}
+	};
+
+	using loose_octreef = loose_octree<float>;
+	using loose_octreed = loose_octree<double>;
+
+}// namespace mafs
@@ -0,0 +1,172 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace mafs
+{
+	// Number of workers the parallel helpers use by default.
+	inline size_t hardware_threads()
+	{
+		const unsigned n = std::thread::hardware_concurrency();
+		return n > 0 ? n : 1;
+	}
+
+	// Splits [0, count) into contiguous ranges of at least min_chunk items, at most one per thread,
+	// and calls fn(begin, end) for each. The calling thread runs the first range, so a single range
+	// costs no thread at all. fn must be safe to call concurrently on disjoint ranges.
+	template<typename F>
+	void parallel_for(size_t count, F&& fn, size_t min_chunk = 1, size_t threads = hardware_threads())
+	{
+		if (count == 0)
+			return;
+		const size_t chunks = std::max<size_t>(1, std::min(threads, (count + min_chunk - 1) / std::max<size_t>(min_chunk, 1)));
+		const size_t step = (count + chunks - 1) / chunks;
+		std::vector<std::thread> workers;
+		workers.reserve(chunks - 1);
+		for (size_t begin = step; begin < count; begin += step)
+			workers.emplace_back([&fn, begin, end = std::min(count, begin + step)] { fn(begin, end); });
+		fn(size_t(0), std::min(count, step));
+		for (std::thread& w : workers)
+			w.join();
+	}
+
+	// In-place exclusive prefix sum; returns the total. Blocks of at least min_block items are
+	// summed in parallel, the block sums are scanned on the calling thread, and each block then
+	// scans itself from its offset, again in parallel.
+	template<typename T>
+	T parallel_exclusive_scan(std::span<T> data, size_t threads = hardware_threads(), size_t min_block = size_t(1) << 14)
+	{
+		const size_t blocks = std::max<size_t>(1, std::min(threads, data.size() / std::max<size_t>(min_block, 1)));
+		std::vector<T> sums(blocks + 1, T(0));
+		parallel_for(blocks, [&](size_t first, size_t last)
+		{
+			for (size_t b = first; b < last; b++)
+			{
+				T sum = T(0);
+				for (size_t i = data.size() * b / blocks; i < data.size() * (b + 1) / blocks; i++)
+					sum += data[i];
+				sums[b + 1] = sum;
+			}
+		}, 1, threads);
+		for (size_t b = 0; b < blocks; b++)
+			sums[b + 1] += sums[b];
+		parallel_for(blocks, [&](size_t first, size_t last)
+		{
+			for (size_t b = first; b < last; b++)
+			{
+				T run = sums[b];
+				for (size_t i = data.size() * b / blocks; i < data.size() * (b + 1) / blocks; i++)
+				{
+					const T v = data[i];
+					data[i] = run;
+					run += v;
+				}
+			}
+		}, 1, threads);
+		return sums[blocks];
+	}
+
+	// Runs a and b and returns when both are done. With parallel set, a runs on a new thread
+	// while the calling thread runs b; recursive builders use this to fork subtrees.
+	template<typename A, typename B>
+	void parallel_invoke(A&& a, B&& b, bool parallel = true)
+	{
+		if (!parallel)
+		{
+			a();
+			b();
+			return;
+		}
+		std::thread worker([&a] { a(); });
+		b();
+		worker.join();
+	}
+
+	// Stable LSD radix sort of keys on their low key_bits bits, 8 per pass, with values moved
+	// along. Each pass counts digits per chunk of the input, scans the counts digit-major and
+	// chunk-minor, and scatters every chunk on its own thread, so equal keys keep their order
+	// whatever the thread count. A pass whose digit is the same for every key is skipped.
+	// key_scratch and value_scratch hold at least keys.size() items; callers that sort every
+	// frame pass the same buffers each time instead of having them allocated.
+	template<std::unsigned_integral K, typename V>
+	void radix_sort(std::span<K> keys, std::span<V> values, std::span<K> key_scratch, std::span<V> value_scratch,
+		size_t key_bits = 8 * sizeof(K), size_t threads = hardware_threads())
+	{
+		assert(keys.size() == values.size() && "One value per key");
+		assert(key_scratch.size() >= keys.size() && value_scratch.size() >= keys.size() && "Scratch too small");
+		const size_t n = keys.size(), chunks = std::max<size_t>(1, std::min(threads, n / 65536));
+		if (n < 2)
+			return;
+		std::span<K> key_from = keys, key_to = key_scratch.first(n);
+		std::span<V> value_from = values, value_to = value_scratch.first(n);
+		std::vector<size_t> offsets(chunks * 256);
+		for (size_t shift = 0; shift < std::min(key_bits, 8 * sizeof(K)); shift += 8)
+		{
+			std::fill(offsets.begin(), offsets.end(), size_t(0));
+			parallel_for(chunks, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+				{
+					// Raw pointers: stores through the spans would make every load reread them.
+					const K* key = key_from.data();
+					size_t* count = offsets.data() + c * 256;
+					for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; i++)
+						count[(key[i] >> shift) & 0xff]++;
+				}
+			}, 1, threads);
+			size_t run = 0;
+			bool single_digit = false;
+			for (size_t d = 0; d < 256; d++)
+			{
+				const size_t start = run;
+				for (size_t c = 0; c < chunks; c++)
+				{
+					const size_t count = offsets[c * 256 + d];
+					offsets[c * 256 + d] = run;
+					run += count;
+				}
+				single_digit = single_digit || run - start == n;
+			}
+			if (single_digit)
+				continue;
+			parallel_for(chunks, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+				{
+					const K* key = key_from.data();
+					V* value = value_from.data();
+					K* key_out = key_to.data();
+					V* value_out = value_to.data();
+					size_t* next = offsets.data() + c * 256;
+					for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; i++)
+					{
+						const size_t slot = next[(key[i] >> shift) & 0xff]++;
+						key_out[slot] = key[i];
+						value_out[slot] = std::move(value[i]);
+					}
+				}
+			}, 1, threads);
+			std::swap(key_from, key_to);
+			std::swap(value_from, value_to);
+		}
+		if (key_from.data() != keys.data())
+			parallel_for(n, [&](size_t begin, size_t end)
+			{
+				std::copy(key_from.begin() + begin, key_from.begin() + end, keys.begin() + begin);
+				std::move(value_from.begin() + begin, value_from.begin() + end, values.begin() + begin);
+			}, 65536, threads);
+	}
+	template<std::unsigned_integral K, typename V>
+	void radix_sort(std::span<K> keys, std::span<V> values, size_t key_bits = 8 * sizeof(K), size_t threads = hardware_threads())
+	{
+		std::vector<K> key_scratch(keys.size());
+		std::vector<V> value_scratch(values.size());
+		radix_sort(keys, values, std::span<K>(key_scratch), std::span<V>(value_scratch), key_bits, threads);
+	}
+
+}// namespace mafs
@@ -0,0 +1,100 @@
+#pragma once
+#include <utility>
+#include "vec.hpp"
+
+namespace mafs
+{
+	// Ray with the reciprocal direction and the per-axis direction signs precomputed for slab
+	// tests. The direction does not need to be normalized; distances are in units of it. Build
+	// rays through the constructor so the derived members stay in sync.
+	template<std::floating_point T = float, size_t N = 3>
+	class ray
+	{
+	public:
+		//-----------------------------Constructors-----------------------------
+		constexpr ray(const vec<T, N>& origin, const vec<T, N>& direction) : origin(origin), direction(direction)
+		{
+			for (size_t i = 0; i < N; i++)
+			{
+				// A zero component gives +-inf, which the slab tests handle.
+				inv_direction[i] = T(1) / direction[i];
+				negative[i] = inv_direction[i] < T(0);
+			}
+		}
+		//-----------------------------Functions-----------------------------
+		constexpr vec<T, N> at(T t) const { return origin + direction * t; }
+
+		//-----------------------------Public Variables -----------------------------
+		vec<T, N> origin;
+		vec<T, N> direction;
+		vec<T, N> inv_direction;
+		vec<bool, N> negative;
+	};
+
+	using rayf = ray<float, 3>;
+	using rayd = ray<double, 3>;
+
+	namespace detail
+	{
+		// The watertight triangle test of Woop, Benthin and Wald works in a space where the ray
+		// runs along +z from the origin with unit speed. kz is the dominant axis of the direction;
+		// kx and ky are swapped for negative directions to keep the winding.
+		template<std::floating_point T>
+		struct watertight_shear
+		{
+			size_t kx, ky, kz;
+			T sx, sy, sz;
+		};
+		template<std::floating_point T>
+		constexpr watertight_shear<T> make_watertight_shear(const vec<T, 3>& d)
+		{
+			const vec<T, 3> a = abs(d);
+			watertight_shear<T> res;
+			res.kz = a.x >= a.y ? (a.x >= a.z ? 0 : 2) : (a.y >= a.z ? 1 : 2);
+			res.kx = res.kz == 2 ? 0 : res.kz + 1;
+			res.ky = res.kx == 2 ? 0 : res.kx + 1;
+			if (d[res.kz] < T(0))
+				std::swap(res.kx, res.ky);
+			res.sx = d[res.kx] / d[res.kz];
+			res.sy = d[res.ky] / d[res.kz];
+			res.sz = T(1) / d[res.kz];
+			return res;
+		}
+	}
+
+	// W rays in SoA layout, for testing coherent rays against one primitive at once. Like ray,
+	// set derives the members the tests need: shear[r] is row r of the matrix taking a point
+	// relative to the origin into the watertight test's space. Unset lanes have a zero
+	// direction and never hit.
+	template<size_t W, std::floating_point T = float>
+	struct ray_packet
+	{
+		static_assert(W >= 1 && W <= 32, "Packet masks hold at most 32 lanes");
+
+		constexpr void set(size_t lane, const ray<T, 3>& r)
+		{
+			const detail::watertight_shear<T> s = detail::make_watertight_shear(r.direction);
+			for (size_t a = 0; a < 3; a++)
+			{
+				origin[a][lane] = r.origin[a];
+				direction[a][lane] = r.direction[a];
+				for (size_t row = 0; row < 3; row++)
+					shear[row][a][lane] = T(0);
+			}
+			shear[0][s.kx][lane] = T(1);
+			shear[0][s.kz][lane] = -s.sx;
+			shear[1][s.ky][lane] = T(1);
+			shear[1][s.kz][lane] = -s.sy;
+			shear[2][s.kz][lane] = s.sz;
+		}
+		constexpr ray<T, 3> get(size_t lane) const
+		{
+			return ray<T, 3>(vec<T, 3>{ origin[0][lane], origin[1][lane], origin[2][lane] }, vec<T, 3>{ direction[0][lane], direction[1][lane], direction[2][lane] });
+		}
+
+		vec<T, W> origin[3];
+		vec<T, W> direction[3];
+		vec<T, W> shear[3][3];
+	};
+
+}// namespace mafs
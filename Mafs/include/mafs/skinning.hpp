@@ -0,0 +1,325 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "dual_quat.hpp"
+#include "parallel.hpp"
+
+// Linear blend (LBS) and dual quaternion (DQS) skinning with four influences per vertex.
+// Vertices are processed W at a time. Each vertex blends its bones as whole four-float chunks
+// of the palette entry, and four blended bones at a time are transposed into packets, one
+// vec<float, W> per bone element. The transform, normalization included, then runs on those
+// packets. The span-of-jobs overloads split all meshes into vertex chunks and spread them over
+// threads.
+namespace mafs
+{
+	using skin_joints = vec<uint16_t, 4>;
+
+	// One mesh to skin. Weights should sum to 1. normals and out_normals are optional but go
+	// together; normals are transformed by the blended rotation part and renormalized, which is
+	// exact for bones without non-uniform scale.
+	template<typename Bone>
+	struct skin_job
+	{
+		std::span<const Bone> palette;
+		std::span<const skin_joints> joints;
+		std::span<const vec4f> weights;
+		std::span<const vec3f> positions;
+		std::span<const vec3f> normals;
+		std::span<vec3f> out_positions;
+		std::span<vec3f> out_normals;
+	};
+
+	namespace detail
+	{
+		template<typename Bone>
+		void check_skin_job([[maybe_unused]] const skin_job<Bone>& job)
+		{
+			assert(job.joints.size() == job.positions.size() && job.weights.size() == job.positions.size()
+				&& job.out_positions.size() == job.positions.size() && "Every vertex needs joints, weights and an output");
+			assert(job.normals.size() == job.out_normals.size() && (job.normals.empty() || job.normals.size() == job.positions.size())
+				&& "Normals and their outputs must match the vertex count");
+		}
+
+		// Blends the bones of vertices [base, base + lanes) into m: m[e][l] is float e of the
+		// blended palette entry of vertex base + l. weight(v) returns the four influence weights of
+		// vertex v. Unused lanes repeat the last vertex, so every lane holds a valid bone.
+		template<size_t W, size_t E, typename Bone, typename F>
+		inline void blend_bones(const skin_job<Bone>& job, size_t base, size_t lanes, vec<float, W>* m, F&& weight)
+		{
+			static_assert(W % 4 == 0, "Skinning packets hold a multiple of four vertices");
+			static_assert(sizeof(Bone) == E * sizeof(float), "Palette entries must be tightly packed floats");
+			// Raw pointers, so the packet stores below cannot force the spans to be reloaded.
+			const float* palette = reinterpret_cast<const float*>(job.palette.data());
+			const skin_joints* joints = job.joints.data();
+			for (size_t l0 = 0; l0 < W; l0 += 4)
+			{
+#if defined(MAFS_SSE2)
+				__m128 acc[4][E / 4];
+				for (size_t i = 0; i < 4; i++)
+				{
+					const size_t v = base + std::min(l0 + i, lanes - 1);
+					const skin_joints j = joints[v];
+					const vec4f w = weight(v);
+					for (size_t q = 0; q < E / 4; q++)
+						acc[i][q] = _mm_setzero_ps();
+					for (size_t k = 0; k < 4; k++)
+					{
+						assert(j[k] < job.palette.size() && "Joint index out of range");
+						const float* bone = palette + size_t(j[k]) * E;
+						const __m128 wk = _mm_set1_ps(w[k]);
+						for (size_t q = 0; q < E / 4; q++)
+							acc[i][q] = _mm_add_ps(acc[i][q], _mm_mul_ps(_mm_loadu_ps(bone + 4 * q), wk));
+					}
+				}
+				for (size_t q = 0; q < E / 4; q++)
+				{
+					__m128 r0 = acc[0][q], r1 = acc[1][q], r2 = acc[2][q], r3 = acc[3][q];
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+					_mm_storeu_ps(&m[4 * q][l0], r0);
+					_mm_storeu_ps(&m[4 * q + 1][l0], r1);
+					_mm_storeu_ps(&m[4 * q + 2][l0], r2);
+					_mm_storeu_ps(&m[4 * q + 3][l0], r3);
+				}
+#else
+				for (size_t i = 0; i < 4; i++)
+				{
+					const size_t v = base + std::min(l0 + i, lanes - 1);
+					const skin_joints j = joints[v];
+					const vec4f w = weight(v);
+					for (size_t e = 0; e < E; e++)
+						m[e][l0 + i] = 0.0f;
+					for (size_t k = 0; k < 4; k++)
+					{
+						assert(j[k] < job.palette.size() && "Joint index out of range");
+						const float* bone = palette + size_t(j[k]) * E;
+						for (size_t e = 0; e < E; e++)
+							m[e][l0 + i] += bone[e] * w[k];
+					}
+				}
+#endif
+			}
+		}
+
+		// Vertex streams of one packet. The last, partial packet of a range is copied into
+		// padded local storage so the kernels always run on W vertices.
+		struct vertex_batch
+		{
+			const vec3f* positions;
+			const vec3f* normals;
+			vec3f* out_positions;
+			vec3f* out_normals;
+		};
+
+		template<typename Bone>
+		vertex_batch direct_batch(const skin_job<Bone>& job, size_t base)
+		{
+			const bool normals = !job.normals.empty();
+			return { &job.positions[base], normals ? &job.normals[base] : nullptr,
+				&job.out_positions[base], normals ? &job.out_normals[base] : nullptr };
+		}
+
+		template<size_t W>
+		struct padded_batch
+		{
+			vec3f positions[W], normals[W], out_positions[W], out_normals[W];
+
+			template<typename Bone>
+			vertex_batch load(const skin_job<Bone>& job, size_t base, size_t lanes)
+			{
+				const bool normals = !job.normals.empty();
+				std::copy_n(&job.positions[base], lanes, this->positions);
+				if (normals)
+					std::copy_n(&job.normals[base], lanes, this->normals);
+				return { this->positions, normals ? this->normals : nullptr, out_positions, normals ? out_normals : nullptr };
+			}
+			template<typename Bone>
+			void store(const skin_job<Bone>& job, size_t base, size_t lanes) const
+			{
+				std::copy_n(out_positions, lanes, &job.out_positions[base]);
+				if (!job.normals.empty())
+					std::copy_n(out_normals, lanes, &job.out_normals[base]);
+			}
+		};
+
+		template<size_t W, size_t R>
+		void skin_lbs_range(const skin_job<mat<float, R, 4>>& job, size_t begin, size_t end)
+		{
+			static_assert(R == 3 || R == 4, "LBS bones are 3x4 or 4x4 matrices");
+			padded_batch<W> tail;
+			for (size_t base = begin; base < end; base += W)
+			{
+				const size_t lanes = std::min(W, end - base);
+				const vertex_batch batch = lanes == W ? direct_batch(job, base) : tail.load(job, base, lanes);
+				// m[c * R + r] holds entry (r, c) of the blended bone.
+				vec<float, W> m[R * 4];
+				blend_bones<W, R * 4>(job, base, lanes, m, [&](size_t v) { return job.weights[v]; });
+
+				vec<float, W> x, y, z;
+				for (size_t l = 0; l < W; l++)
+				{
+					x[l] = batch.positions[l].x;
+					y[l] = batch.positions[l].y;
+					z[l] = batch.positions[l].z;
+				}
+				const vec<float, W> px = m[0] * x + m[R] * y + m[2 * R] * z + m[3 * R];
+				const vec<float, W> py = m[1] * x + m[R + 1] * y + m[2 * R + 1] * z + m[3 * R + 1];
+				const vec<float, W> pz = m[2] * x + m[R + 2] * y + m[2 * R + 2] * z + m[3 * R + 2];
+				for (size_t l = 0; l < W; l++)
+					batch.out_positions[l] = vec3f{ px[l], py[l], pz[l] };
+
+				if (batch.normals)
+				{
+					for (size_t l = 0; l < W; l++)
+					{
+						x[l] = batch.normals[l].x;
+						y[l] = batch.normals[l].y;
+						z[l] = batch.normals[l].z;
+					}
+					vec<float, W> nx = m[0] * x + m[R] * y + m[2 * R] * z;
+					vec<float, W> ny = m[1] * x + m[R + 1] * y + m[2 * R + 1] * z;
+					vec<float, W> nz = m[2] * x + m[R + 2] * y + m[2 * R + 2] * z;
+					const vec<float, W> inv = vec<float, W>(1.0f) / sqrt(nx * nx + ny * ny + nz * nz);
+					nx *= inv;
+					ny *= inv;
+					nz *= inv;
+					for (size_t l = 0; l < W; l++)
+						batch.out_normals[l] = vec3f{ nx[l], ny[l], nz[l] };
+				}
+				if (lanes < W)
+					tail.store(job, base, lanes);
+			}
+		}
+
+		template<size_t W>
+		void skin_dqs_range(const skin_job<dual_quatf>& job, size_t begin, size_t end)
+		{
+			// Antipodal quaternions are the same rotation, so every influence is blended on the
+			// hemisphere of the first one.
+			const auto weight = [&](size_t v)
+			{
+				const skin_joints& j = job.joints[v];
+				vec4f w = job.weights[v];
+				assert(j[0] < job.palette.size() && "Joint index out of range");
+				const quatf& pivot = job.palette[j[0]].real;
+				// Moves the sign of the dot product onto the weight; a branch would mispredict
+				// whenever neighbouring bones disagree.
+				for (size_t k = 1; k < 4; k++)
+					w[k] = std::bit_cast<float>(std::bit_cast<uint32_t>(w[k]) ^ (std::bit_cast<uint32_t>(job.palette[j[k]].real.dot(pivot)) & 0x80000000u));
+				return w;
+			};
+			padded_batch<W> tail;
+			for (size_t base = begin; base < end; base += W)
+			{
+				const size_t lanes = std::min(W, end - base);
+				const vertex_batch batch = lanes == W ? direct_batch(job, base) : tail.load(job, base, lanes);
+				// Real part xyzw in b[0..3], dual part xyzw in b[4..7].
+				vec<float, W> b[8];
+				blend_bones<W, 8>(job, base, lanes, b, weight);
+				const vec<float, W> inv = vec<float, W>(1.0f) / sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]);
+				for (size_t c = 0; c < 8; c++)
+					b[c] *= inv;
+				const vec<float, W>& rx = b[0], & ry = b[1], & rz = b[2], & rw = b[3];
+				const vec<float, W>& dx = b[4], & dy = b[5], & dz = b[6], & dw = b[7];
+
+				// v + w * u + r.xyz x u with u = 2 * (r.xyz x v), as in quat * vec3; points also
+				// get the translation 2 * (d * conj(r)).xyz. The part of d along r drops out of it,
+				// so the blend needs no orthogonalization.
+				const auto transform = [&](const vec3f* in, vec3f* out, bool translate)
+				{
+					vec<float, W> x, y, z;
+					for (size_t l = 0; l < W; l++)
+					{
+						x[l] = in[l].x;
+						y[l] = in[l].y;
+						z[l] = in[l].z;
+					}
+					const vec<float, W> ux = (ry * z - rz * y) * 2.0f;
+					const vec<float, W> uy = (rz * x - rx * z) * 2.0f;
+					const vec<float, W> uz = (rx * y - ry * x) * 2.0f;
+					x += rw * ux + ry * uz - rz * uy;
+					y += rw * uy + rz * ux - rx * uz;
+					z += rw * uz + rx * uy - ry * ux;
+					if (translate)
+					{
+						x += (rw * dx - dw * rx + ry * dz - rz * dy) * 2.0f;
+						y += (rw * dy - dw * ry + rz * dx - rx * dz) * 2.0f;
+						z += (rw * dz - dw * rz + rx * dy - ry * dx) * 2.0f;
+					}
+					for (size_t l = 0; l < W; l++)
+						out[l] = vec3f{ x[l], y[l], z[l] };
+				};
+				transform(batch.positions, batch.out_positions, true);
+				// A rotated unit normal stays unit.
+				if (batch.normals)
+					transform(batch.normals, batch.out_normals, false);
+				if (lanes < W)
+					tail.store(job, base, lanes);
+			}
+		}
+
+		// Splits every job into chunks of at most chunk vertices and runs fn(job, begin, end) on
+		// them, with contiguous runs of chunks per thread.
+		template<typename Bone, typename F>
+		void skin_parallel(std::span<const skin_job<Bone>> jobs, size_t threads, size_t chunk, F&& fn)
+		{
+			struct work_item
+			{
+				uint32_t job;
+				size_t begin, end;
+			};
+			std::vector<work_item> items;
+			for (size_t i = 0; i < jobs.size(); i++)
+			{
+				check_skin_job(jobs[i]);
+				for (size_t begin = 0; begin < jobs[i].positions.size(); begin += chunk)
+					items.push_back({ uint32_t(i), begin, std::min(jobs[i].positions.size(), begin + chunk) });
+			}
+			parallel_for(items.size(), [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; i++)
+					fn(jobs[items[i].job], items[i].begin, items[i].end);
+			}, 1, threads);
+		}
+	}// namespace detail
+
+	//-----------------------------Linear blend skinning-----------------------------
+	// Bones are mat3x4f (affine, bottom row implied) or mat4f (bottom row ignored).
+	template<size_t W = 8, size_t R>
+	void skin_lbs(const skin_job<mat<float, R, 4>>& job)
+	{
+		detail::check_skin_job(job);
+		detail::skin_lbs_range<W>(job, 0, job.positions.size());
+	}
+
+	template<size_t W = 8, size_t R>
+	void skin_lbs(std::span<const skin_job<mat<float, R, 4>>> jobs, size_t threads = hardware_threads(), size_t chunk = 4096)
+	{
+		detail::skin_parallel(jobs, threads, chunk, [](const skin_job<mat<float, R, 4>>& job, size_t begin, size_t end)
+		{
+			detail::skin_lbs_range<W>(job, begin, end);
+		});
+	}
+
+	//-----------------------------Dual quaternion skinning-----------------------------
+	// Bones must be unit dual quaternions. Avoids the volume loss ("candy wrapper") of LBS on
+	// twisting joints; bones cannot carry scale.
+	template<size_t W = 8>
+	void skin_dqs(const skin_job<dual_quatf>& job)
+	{
+		detail::check_skin_job(job);
+		detail::skin_dqs_range<W>(job, 0, job.positions.size());
+	}
+
+	template<size_t W = 8>
+	void skin_dqs(std::span<const skin_job<dual_quatf>> jobs, size_t threads = hardware_threads(), size_t chunk = 4096)
+	{
+		detail::skin_parallel(jobs, threads, chunk, [](const skin_job<dual_quatf>& job, size_t begin, size_t end)
+		{
+			detail::skin_dqs_range<W>(job, begin, end);
+		});
+	}
+
+}// namespace mafs
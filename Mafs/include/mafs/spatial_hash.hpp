@@ -0,0 +1,158 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "parallel.hpp"
+#include "vec.hpp"
+
+namespace mafs
+{
+	// Uniform grid over particles, hashed into a fixed table of buckets. build() counting-sorts
+	// the particles by bucket, so the particles of a cell sit next to each other in indices and
+	// positions, and a neighbor query touches a handful of contiguous runs. Meant to be rebuilt
+	// every frame: the buffers keep their capacity between builds.
+	class spatial_hash_grid
+	{
+	public:
+		//-----------------------------Constructors-----------------------------
+		spatial_hash_grid() = default;
+		// table_size is rounded up to a power of two; about one bucket per particle is a good fit.
+		spatial_hash_grid(float cell_size, size_t table_size)
+			: cell_size(cell_size), inv_cell_size(1.0f / cell_size), mask(uint32_t(std::bit_ceil(std::max<size_t>(table_size, 1)) - 1))
+		{
+			assert(cell_size > 0.0f && "Cell size must be positive");
+			assert(table_size <= (size_t(1) << 31) && "Table too large");
+		}
+
+		//-----------------------------Functions-----------------------------
+		size_t size() const { return indices.size(); }
+		size_t table_size() const { return size_t(mask) + 1; }
+
+		// Cell coordinates are ints: |p| / cell_size must stay below 2^31.
+		vec3i cell(const vec3f& p) const
+		{
+			assert(std::max({ std::abs(p.x), std::abs(p.y), std::abs(p.z) }) * inv_cell_size < 2147483648.0f && "Point too far out for the cell size");
+			return vec3i{ int(std::floor(p.x * inv_cell_size)), int(std::floor(p.y * inv_cell_size)), int(std::floor(p.z * inv_cell_size)) };
+		}
+		// Distinct cells may share a bucket; queries filter by distance, so that only costs time.
+		uint32_t bucket(const vec3i& c) const
+		{
+			return (uint32_t(c.x) * 73856093u ^ uint32_t(c.y) * 19349663u ^ uint32_t(c.z) * 83492791u) & mask;
+		}
+
+		// Counting sort by bucket on up to `threads` threads. The particles' buckets are found in
+		// parallel; then each chunk takes a range of buckets and, walking all the particles in
+		// input order, counts those in its range and later scatters them. One table of counts
+		// serves every chunk, so the scratch does not grow with the thread count, and the result
+		// does not depend on it.
+		void build(std::span<const vec3f> points, size_t threads = hardware_threads())
+		{
+			assert(points.size() < (size_t(1) << 32) && "Indices are 32-bit");
+			const size_t n = points.size(), table = table_size();
+			// Every chunk reads all the keys, so there are no more chunks than threads.
+			const size_t chunks = std::max<size_t>(1, std::min({ threads, n / 16384, table }));
+			keys.resize(n);
+			parallel_for(n, [&](size_t begin, size_t end)
+			{
+				uint32_t* key = keys.data();
+				for (size_t i = begin; i < end; i++)
+					key[i] = bucket(cell(points[i]));
+			}, 16384, threads);
+
+			cell_start.assign(table + 1, 0);
+			parallel_for(chunks, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+				{
+					// Raw pointers: the counter stores would otherwise force the vectors to be
+					// reloaded for every particle.
+					const uint32_t* key = keys.data();
+					uint32_t* count = cell_start.data();
+					const uint32_t lo = uint32_t(table * c / chunks), span = uint32_t(table * (c + 1) / chunks) - lo;
+					for (size_t i = 0; i < n; i++)
+						if (key[i] - lo < span)
+							count[key[i]]++;
+				}
+			}, 1, threads);
+			parallel_exclusive_scan(std::span<uint32_t>(cell_start), threads);
+
+			offsets.resize(table);
+			indices.resize(n);
+			positions.resize(n);
+			parallel_for(chunks, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+				{
+					const uint32_t* key = keys.data();
+					uint32_t* next = offsets.data();
+					uint32_t* index = indices.data();
+					vec3f* position = positions.data();
+					const uint32_t lo = uint32_t(table * c / chunks), span = uint32_t(table * (c + 1) / chunks) - lo;
+					std::copy(cell_start.begin() + lo, cell_start.begin() + lo + span, next + lo);
+					for (size_t i = 0; i < n; i++)
+						if (key[i] - lo < span)
+						{
+							const uint32_t slot = next[key[i]]++;
+							index[slot] = uint32_t(i);
+							position[slot] = points[i];
+						}
+				}
+			}, 1, threads);
+		}
+
+		// Calls fn(slot, distance_squared) for every particle within radius of p, boundary
+		// included, where indices[slot] is its input index and positions[slot] its position.
+		// radius may not exceed the cell size, so at most 27 cells are visited.
+		template<typename F>
+		void for_each_neighbor(const vec3f& p, float radius, F&& fn) const
+		{
+			assert(radius <= cell_size && "Radius larger than a cell");
+			if (indices.empty())
+				return;
+			const vec3i lo = cell(p - vec3f(radius)), hi = cell(p + vec3f(radius));
+			// Cells that collide in the table would otherwise be scanned twice.
+			uint32_t buckets[27];
+			size_t count = 0;
+			for (int z = lo.z; z <= hi.z; z++)
+				for (int y = lo.y; y <= hi.y; y++)
+					for (int x = lo.x; x <= hi.x; x++)
+					{
+						const uint32_t b = bucket(vec3i{ x, y, z });
+						if (std::find(buckets, buckets + count, b) == buckets + count)
+							buckets[count++] = b;
+					}
+			const float radius_squared = radius * radius;
+			for (size_t k = 0; k < count; k++)
+				for (uint32_t slot = cell_start[buckets[k]]; slot < cell_start[buckets[k] + 1]; slot++)
+				{
+					const float d = (positions[slot] - p).length_squared();
+					if (d <= radius_squared)
+						fn(slot, d);
+				}
+		}
+		// Appends the input index of every particle within radius of p, in no particular order.
+		void radius_search(const vec3f& p, float radius, std::vector<uint32_t>& out) const
+		{
+			for_each_neighbor(p, radius, [&](uint32_t slot, float) { out.push_back(indices[slot]); });
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		float cell_size = 1.0f;
+		float inv_cell_size = 1.0f;
+		uint32_t mask = 0;
+		// Bucket b holds slots [cell_start[b], cell_start[b + 1]).
+		std::vector<uint32_t> cell_start;
+		// Particles in bucket order, with the index each had in the input.
+		std::vector<uint32_t> indices;
+		std::vector<vec3f> positions;
+
+	private:
+		// Build scratch, kept so that a rebuild does not allocate.
+		std::vector<uint32_t> keys;
+		std::vector<uint32_t> offsets;
+	};
+
+}// namespace mafs
@@ -0,0 +1,366 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+#include "parallel.hpp"
+#include "vec.hpp"
+
+namespace mafs
+{
+	// Closed ball. A negative radius marks an empty sphere, which contains and overlaps nothing.
+	template<std::floating_point T = float>
+	struct sphere
+	{
+		//-----------------------------Functions-----------------------------
+		constexpr bool contains(const vec<T, 3>& p) const
+		{
+			return (p - center).length_squared() <= radius * radius && radius >= T(0);
+		}
+		constexpr bool overlaps(const sphere& o) const
+		{
+			const T r = radius + o.radius;
+			return (o.center - center).length_squared() <= r * r && radius >= T(0) && o.radius >= T(0);
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		vec<T, 3> center;
+		T radius = T(0);
+	};
+
+	using spheref = sphere<float>;
+	using sphered = sphere<double>;
+
+	// W spheres in SoA layout. Lanes without a sphere have radius -inf so every test rejects them.
+	template<size_t W, std::floating_point T = float>
+	struct sphere_packet
+	{
+		static_assert(W >= 1 && W <= 32, "Packet masks hold at most 32 lanes");
+
+		constexpr void set(size_t lane, const sphere<T>& s)
+		{
+			x[lane] = s.center.x;
+			y[lane] = s.center.y;
+			z[lane] = s.center.z;
+			radius[lane] = s.radius;
+		}
+		constexpr sphere<T> get(size_t lane) const
+		{
+			return sphere<T>{ vec<T, 3>{ x[lane], y[lane], z[lane] }, radius[lane] };
+		}
+
+		vec<T, W> x, y, z;
+		vec<T, W> radius = vec<T, W>(-std::numeric_limits<T>::infinity());
+	};
+
+	// Packs spheres W per packet; sphere i goes to lane i % W of packet i / W.
+	template<size_t W, std::floating_point T>
+	std::vector<sphere_packet<W, T>> pack_spheres(std::span<const sphere<T>> spheres)
+	{
+		std::vector<sphere_packet<W, T>> res((spheres.size() + W - 1) / W);
+		for (size_t i = 0; i < spheres.size(); i++)
+			res[i / W].set(i % W, spheres[i]);
+		return res;
+	}
+
+	namespace detail
+	{
+		// Indices of the first points with the smallest and largest x, y and z. With SSE2, float
+		// points are read as a flat array of coordinates, four points (three packets of four
+		// values) at a time: 12 values hold whole points, so lane l of packet k always carries
+		// axis (4k + l) % 3 of point (4k + l) / 3. Each packet keeps its lanes' minima and maxima
+		// with the point indices that set them, and the 12 lanes are merged once at the end.
+		template<std::floating_point T>
+		void extreme_points(std::span<const vec<T, 3>> points, size_t lo[3], size_t hi[3])
+		{
+			const size_t n = points.size();
+			vec<T, 3> lo_v = points[0], hi_v = points[0];
+			for (size_t a = 0; a < 3; a++)
+				lo[a] = hi[a] = 0;
+			size_t i = 0;
+#if defined(MAFS_SSE2)
+			if constexpr (std::is_same_v<T, float>)
+			{
+				static_assert(sizeof(vec<T, 3>) == 3 * sizeof(T), "Points are read as packed coordinates");
+				assert(n <= size_t(std::numeric_limits<int32_t>::max()) && "Lane indices are 32-bit");
+				if (n >= 4)
+				{
+					const float* data = &points[0].x;
+					__m128 lo_p[3], hi_p[3];
+					__m128i lo_i[3], hi_i[3], lane_point[3];
+					for (int k = 0; k < 3; k++)
+					{
+						lo_p[k] = hi_p[k] = _mm_loadu_ps(data + 4 * k);
+						lane_point[k] = _mm_setr_epi32((4 * k) / 3, (4 * k + 1) / 3, (4 * k + 2) / 3, (4 * k + 3) / 3);
+						lo_i[k] = hi_i[k] = lane_point[k];
+					}
+					for (; i + 4 <= n; i += 4)
+					{
+						const __m128i base = _mm_set1_epi32(int32_t(i));
+						for (int k = 0; k < 3; k++)
+						{
+							const __m128 v = _mm_loadu_ps(data + 3 * i + 4 * k);
+							const __m128i index = _mm_add_epi32(base, lane_point[k]);
+							const __m128i below = _mm_castps_si128(_mm_cmplt_ps(v, lo_p[k]));
+							const __m128i above = _mm_castps_si128(_mm_cmpgt_ps(v, hi_p[k]));
+							lo_p[k] = _mm_min_ps(v, lo_p[k]);
+							hi_p[k] = _mm_max_ps(v, hi_p[k]);
+							lo_i[k] = _mm_or_si128(_mm_and_si128(below, index), _mm_andnot_si128(below, lo_i[k]));
+							hi_i[k] = _mm_or_si128(_mm_and_si128(above, index), _mm_andnot_si128(above, hi_i[k]));
+						}
+					}
+					for (int k = 0; k < 3; k++)
+					{
+						alignas(16) float lo_f[4], hi_f[4];
+						alignas(16) int32_t lo_n[4], hi_n[4];
+						_mm_store_ps(lo_f, lo_p[k]);
+						_mm_store_ps(hi_f, hi_p[k]);
+						_mm_store_si128(reinterpret_cast<__m128i*>(lo_n), lo_i[k]);
+						_mm_store_si128(reinterpret_cast<__m128i*>(hi_n), hi_i[k]);
+						for (int l = 0; l < 4; l++)
+						{
+							const size_t a = size_t(4 * k + l) % 3;
+							if (lo_f[l] < lo_v[a] || (lo_f[l] == lo_v[a] && size_t(lo_n[l]) < lo[a]))
+							{
+								lo_v[a] = lo_f[l];
+								lo[a] = size_t(lo_n[l]);
+							}
+							if (hi_f[l] > hi_v[a] || (hi_f[l] == hi_v[a] && size_t(hi_n[l]) < hi[a]))
+							{
+								hi_v[a] = hi_f[l];
+								hi[a] = size_t(hi_n[l]);
+							}
+						}
+					}
+				}
+			}
+#endif
+			for (; i < n; i++)
+			{
+				for (size_t a = 0; a < 3; a++)
+				{
+					if (points[i][a] < lo_v[a])
+					{
+						lo_v[a] = points[i][a];
+						lo[a] = i;
+					}
+					if (points[i][a] > hi_v[a])
+					{
+						hi_v[a] = points[i][a];
+						hi[a] = i;
+					}
+				}
+			}
+		}
+
+		// Smallest radius r about center with every point passing sphere::contains, i.e. r * r
+		// at least each squared distance as computed in T.
+		template<std::floating_point T>
+		T enclosing_radius(std::span<const vec<T, 3>> points, const vec<T, 3>& center)
+		{
+			T d2_max = T(0);
+			for (const vec<T, 3>& p : points)
+			{
+				const T d2 = (p - center).length_squared();
+				d2_max = d2 > d2_max ? d2 : d2_max;
+			}
+			T r = std::sqrt(d2_max);
+			while (r * r < d2_max)
+				r = std::nextafter(r, std::numeric_limits<T>::infinity());
+			return r;
+		}
+
+		// Smallest sphere with the given one to four points on its surface, centered in their
+		// affine hull. Radius -1 when they are degenerate (three collinear, four coplanar).
+		inline sphere<double> sphere_through(const vec<double, 3>* p, size_t count)
+		{
+			constexpr double tiny = 1e-14;
+			if (count == 1)
+				return sphere<double>{ p[0], 0.0 };
+			if (count == 2)
+				return sphere<double>{ (p[0] + p[1]) * 0.5, p[0].distance(p[1]) * 0.5 };
+			const vec<double, 3> a = p[1] - p[0], b = p[2] - p[0];
+			if (count == 3)
+			{
+				const vec<double, 3> n = a.cross(b);
+				const double d = 2.0 * n.length_squared();
+				if (d <= tiny * a.length_squared() * b.length_squared())
+					return sphere<double>{ p[0], -1.0 };
+				const vec<double, 3> o = (b.cross(n) * a.length_squared() + n.cross(a) * b.length_squared()) / d;
+				return sphere<double>{ p[0] + o, o.norm() };
+			}
+			const vec<double, 3> c = p[3] - p[0];
+			const double det = 2.0 * a.dot(b.cross(c));
+			if (std::abs(det) <= tiny * a.norm() * b.norm() * c.norm())
+				return sphere<double>{ p[0], -1.0 };
+			const vec<double, 3> o = (b.cross(c) * a.length_squared() + c.cross(a) * b.length_squared() + a.cross(b) * c.length_squared()) / det;
+			return sphere<double>{ p[0] + o, o.norm() };
+		}
+
+		// Minimal sphere of the support points and q, with q on its surface since it lies outside
+		// the support's sphere. It is the sphere through q and some of the support points, so
+		// every subset is tried and the smallest candidate that holds them all wins; measuring
+		// each candidate by its farthest point keeps the choice sound under rounding. The
+		// support becomes the chosen subset and q.
+		inline sphere<double> grow_support(vec<double, 3>* support, size_t& count, const vec<double, 3>& q)
+		{
+			sphere<double> best{ q, std::numeric_limits<double>::infinity() };
+			size_t best_mask = 0;
+			for (size_t mask = 0; mask < (size_t(1) << count); mask++)
+			{
+				vec<double, 3> through[4];
+				size_t k = 0;
+				for (size_t i = 0; i < count; i++)
+					if (mask & (size_t(1) << i))
+						through[k++] = support[i];
+				if (k == 4)
+					continue;
+				through[k++] = q;
+				sphere<double> s = sphere_through(through, k);
+				if (s.radius < 0.0)
+					continue;
+				for (size_t i = 0; i < count; i++)
+					s.radius = std::max(s.radius, s.center.distance(support[i]));
+				if (s.radius < best.radius)
+				{
+					best = s;
+					best_mask = mask;
+				}
+			}
+			size_t k = 0;
+			for (size_t i = 0; i < count; i++)
+				if (best_mask & (size_t(1) << i))
+					support[k++] = support[i];
+			support[k++] = q;
+			count = k;
+			return best;
+		}
+
+		// Welzl's algorithm in its iterative move-to-front form, on a shuffled copy in double
+		// precision. A point outside the current sphere grows it through grow_support and moves
+		// to the front, where the following passes meet it first; passes repeat until none grows
+		// the sphere. The shuffle is a fixed-seed LCG, so results do not depend on the platform.
+		template<std::floating_point T>
+		sphere<T> minimal_sphere(std::span<const vec<T, 3>> points, std::vector<vec<double, 3>>& work)
+		{
+			constexpr double tolerance = 1e-12;
+			const size_t n = points.size();
+			if (n == 0)
+				return sphere<T>{ vec<T, 3>(), T(-1) };
+			work.resize(n);
+			uint64_t state = 0x9e3779b97f4a7c15ull;
+			for (size_t i = 0; i < n; i++)
+			{
+				work[i] = vec<double, 3>{ double(points[i].x), double(points[i].y), double(points[i].z) };
+				state = state * 6364136223846793005ull + 1442695040888963407ull;
+				std::swap(work[i], work[size_t((state >> 33) % (i + 1))]);
+			}
+			vec<double, 3> support[4] = { work[0] };
+			size_t count = 1;
+			sphere<double> s{ work[0], 0.0 };
+			for (bool grown = true; grown;)
+			{
+				grown = false;
+				for (size_t i = 0; i < n; i++)
+				{
+					const double limit = s.radius * (1.0 + tolerance);
+					if ((work[i] - s.center).length_squared() <= limit * limit)
+						continue;
+					vec<double, 3> next_support[4] = { support[0], support[1], support[2], support[3] };
+					size_t next_count = count;
+					const sphere<double> next = grow_support(next_support, next_count, work[i]);
+					// Rounding can leave a point a hair outside every candidate; leave it to
+					// the final radius rather than chase it.
+					if (next.radius <= s.radius)
+						continue;
+					std::copy(next_support, next_support + next_count, support);
+					count = next_count;
+					s = next;
+					grown = true;
+					std::rotate(work.begin(), work.begin() + i, work.begin() + i + 1);
+				}
+			}
+			const vec<T, 3> center{ T(s.center.x), T(s.center.y), T(s.center.z) };
+			return sphere<T>{ center, enclosing_radius(points, center) };
+		}
+	}
+
+	// Ritter's bounding sphere: the farthest apart of the points with extreme x, y and z span
+	// the first sphere, which a second pass grows just enough to take in each point outside it.
+	// Typically 5 to 20 percent larger than the minimal sphere, at the cost of a few linear
+	// passes; the radius is then reduced to the farthest point from the final center. An empty
+	// span gives an empty sphere.
+	template<std::floating_point T>
+	sphere<T> ritter_sphere(std::span<const vec<T, 3>> points)
+	{
+		if (points.empty())
+			return sphere<T>{ vec<T, 3>(), T(-1) };
+		size_t lo[3], hi[3];
+		detail::extreme_points(points, lo, hi);
+		size_t axis = 0;
+		T span_max = T(-1);
+		for (size_t a = 0; a < 3; a++)
+		{
+			const T d2 = (points[hi[a]] - points[lo[a]]).length_squared();
+			if (d2 > span_max)
+			{
+				span_max = d2;
+				axis = a;
+			}
+		}
+		vec<T, 3> center = (points[lo[axis]] + points[hi[axis]]) * T(0.5);
+		T radius = std::sqrt(span_max) * T(0.5);
+		T radius2 = radius * radius;
+		for (const vec<T, 3>& p : points)
+		{
+			const T d2 = (p - center).length_squared();
+			if (d2 <= radius2)
+				continue;
+			// The new sphere touches p and the far side of the old one.
+			const T d = std::sqrt(d2);
+			const T grown = (radius + d) * T(0.5);
+			center += (p - center) * ((grown - radius) / d);
+			radius = grown;
+			radius2 = radius * radius;
+		}
+		return sphere<T>{ center, detail::enclosing_radius(points, center) };
+	}
+
+	// Minimal bounding sphere, exact up to rounding (Welzl 1991), in expected linear time. The
+	// work is done in double on a copy of the points; the radius is then fitted to the points
+	// in T so they all pass sphere::contains. An empty span gives an empty sphere.
+	template<std::floating_point T>
+	sphere<T> minimal_sphere(std::span<const vec<T, 3>> points)
+	{
+		std::vector<vec<double, 3>> work;
+		return detail::minimal_sphere(points, work);
+	}
+
+	enum class sphere_fit
+	{
+		ritter,
+		minimal
+	};
+
+	// Sphere of each point range [offsets[i], offsets[i + 1]), e.g. the vertices of each meshlet,
+	// into spheres[i], on up to `threads` threads. Ranges are spread evenly by count, so very
+	// uneven ranges balance less well.
+	template<std::floating_point T>
+	void bounding_spheres(std::span<const vec<T, 3>> points, std::span<const uint32_t> offsets, std::span<sphere<T>> spheres, sphere_fit fit = sphere_fit::ritter, size_t threads = hardware_threads())
+	{
+		assert(offsets.size() == spheres.size() + 1 && "One offset per range plus the end");
+		assert((offsets.empty() || offsets.back() <= points.size()) && "Ranges lie within the points");
+		parallel_for(spheres.size(), [&](size_t begin, size_t end)
+		{
+			std::vector<vec<double, 3>> work;
+			for (size_t i = begin; i < end; i++)
+			{
+				const std::span<const vec<T, 3>> range = points.subspan(offsets[i], offsets[i + 1] - offsets[i]);
+				spheres[i] = fit == sphere_fit::ritter ? ritter_sphere(range) : detail::minimal_sphere(range, work);
+			}
+		}, 64, threads);
+	}
+
+}// namespace mafs
@@ -0,0 +1,558 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+#include "aabb.hpp"
+
+namespace mafs
+{
+	// Sweep-and-prune broadphase over boxes that move a little every frame. The box endpoints
+	// are kept sorted on all three axes, and each endpoint's position is known. Moved endpoints
+	// are insertion-sorted from where they were, so a frame costs about one step per moved
+	// endpoint plus one per endpoint passed. When a min and a max swap, the two boxes start or
+	// stop overlapping on that axis; the pair set changes only if their positions on the other
+	// two axes overlap too, so every swap is exact and the hash set of pairs is touched only on
+	// changes. update() reports the pairs added and removed instead of the full list.
+	// Inserted bodies are merged into the axes in one pass and paired with a sweep along the axis
+	// of widest spread that tests the other two axes of four boxes at a time with SSE.
+	template<std::floating_point T = float>
+	class sweep_and_prune
+	{
+	public:
+		// Two overlapping bodies, a < b.
+		struct pair
+		{
+			uint32_t a;
+			uint32_t b;
+			auto operator<=>(const pair&) const = default;
+		};
+
+		//-----------------------------Functions-----------------------------
+		// Bodies inserted and not removed, counting changes not yet applied by update().
+		size_t size() const { return body_count; }
+		size_t pair_count() const { return pair_total; }
+		const aabb<T, 3>& bounds(uint32_t handle) const { return boxes[handle]; }
+
+		// insert, move and remove take effect at the next update(). A handle stays valid until
+		// removed; a removed handle may be reused by a later insert.
+		uint32_t insert(const aabb<T, 3>& b)
+		{
+			assert(!b.is_empty() && "Empty box");
+			uint32_t handle;
+			if (free_bodies.empty())
+			{
+				handle = uint32_t(states.size());
+				assert(handle < (1u << 31) && "Endpoint ids are 32-bit");
+				states.push_back(body_state::free);
+				boxes.push_back(b);
+				positions.push_back(body_positions{});
+			}
+			else
+			{
+				handle = free_bodies.back();
+				free_bodies.pop_back();
+			}
+			boxes[handle] = b;
+			states[handle] = body_state::inserted;
+			pending.push_back(handle);
+			body_count++;
+			return handle;
+		}
+		void move(uint32_t handle, const aabb<T, 3>& b)
+		{
+			assert(handle < states.size() && states[handle] != body_state::free && states[handle] != body_state::removed && "Invalid handle");
+			assert(!b.is_empty() && "Empty box");
+			boxes[handle] = b;
+			if (states[handle] == body_state::idle)
+			{
+				states[handle] = body_state::moved;
+				pending.push_back(handle);
+			}
+		}
+		void remove(uint32_t handle)
+		{
+			assert(handle < states.size() && states[handle] != body_state::free && states[handle] != body_state::removed && "Invalid handle");
+			body_count--;
+			if (states[handle] == body_state::inserted)
+			{
+				// Never reached the axes. The handle is still pending, so it is recycled only
+				// by update(); reusing it now would queue it twice.
+				states[handle] = body_state::free;
+				return;
+			}
+			if (states[handle] == body_state::idle)
+				pending.push_back(handle);
+			states[handle] = body_state::removed;
+		}
+
+		// Applies the pending changes: removals, then moves, then insertions. Afterwards added
+		// and removed hold the net change of the pair set since the previous update, sorted.
+		void update()
+		{
+			added.clear();
+			removed.clear();
+			bool removals = false, insertions = false;
+			for (uint32_t h : pending)
+			{
+				removals = removals || states[h] == body_state::removed;
+				insertions = insertions || states[h] == body_state::inserted;
+			}
+			if (removals)
+				drop_removed();
+
+			size_t moves = 0;
+			for (uint32_t h : pending)
+				moves += states[h] == body_state::moved;
+			if (moves * 8 > size())
+				sort_all();
+			else
+				sort_moved();
+
+			if (insertions)
+				insert_pending();
+			for (uint32_t h : pending)
+				if (states[h] == body_state::free)
+					free_bodies.push_back(h);
+			pending.clear();
+			net_deltas();
+		}
+
+		bool overlapping(uint32_t a, uint32_t b) const { return find(key(a, b)) != empty_slot; }
+		// Calls fn(pair) for every overlapping pair, in no particular order.
+		template<typename F>
+		void for_each_pair(F&& fn) const
+		{
+			for (uint64_t k : keys)
+				if (k != empty_key)
+					fn(pair{ uint32_t(k >> 32), uint32_t(k) });
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		// The changes of the last update().
+		std::vector<pair> added;
+		std::vector<pair> removed;
+
+	private:
+		enum class body_state : uint8_t { free, inserted, idle, moved, removed };
+		// id is the body handle times two, plus one for a max.
+		struct endpoint
+		{
+			T value;
+			uint32_t id;
+		};
+		// Boxes in order of their mins along the sweep axis s, u and v being the other two axes.
+		// Padded with boxes that start at infinity, so that a packet of four never reads past the
+		// end and every scan stops.
+		struct sweep_list
+		{
+			void clear()
+			{
+				for (std::vector<T>* c : { &s_min, &s_max, &u_min, &u_max, &v_min, &v_max })
+					c->clear();
+				ids.clear();
+			}
+			void push(const aabb<T, 3>& b, uint32_t id, uint32_t s, uint32_t u, uint32_t v)
+			{
+				s_min.push_back(b.min[s]);
+				s_max.push_back(b.max[s]);
+				u_min.push_back(b.min[u]);
+				u_max.push_back(b.max[u]);
+				v_min.push_back(b.min[v]);
+				v_max.push_back(b.max[v]);
+				ids.push_back(id);
+			}
+			void pad()
+			{
+				for (int i = 0; i < 4; i++)
+				{
+					s_min.push_back(std::numeric_limits<T>::infinity());
+					for (std::vector<T>* c : { &s_max, &u_min, &u_max, &v_min, &v_max })
+						c->push_back(T(0));
+				}
+			}
+			size_t size() const { return ids.size(); }
+
+			std::vector<T> s_min, s_max, u_min, u_max, v_min, v_max;
+			std::vector<uint32_t> ids;
+		};
+		// Where a body's min and max sit on each axis; one cache line holds a body's six.
+		struct body_positions
+		{
+			uint32_t at[3][2];
+		};
+		static constexpr uint64_t empty_key = std::numeric_limits<uint64_t>::max();
+		static constexpr size_t empty_slot = std::numeric_limits<size_t>::max();
+
+		// On equal values mins sort before maxes, which matches the inclusive aabb::overlaps.
+		static constexpr bool less(const endpoint& x, const endpoint& y)
+		{
+			return x.value < y.value || (x.value == y.value && (x.id & 1) < (y.id & 1));
+		}
+		static constexpr uint64_t key(uint32_t a, uint32_t b)
+		{
+			return a < b ? uint64_t(a) << 32 | b : uint64_t(b) << 32 | a;
+		}
+
+		// Overlap of two bodies on the two axes other than a, by endpoint positions.
+		bool overlap_others(uint32_t x, uint32_t y, uint32_t a) const
+		{
+			const body_positions& p = positions[x];
+			const body_positions& q = positions[y];
+			const uint32_t b = a == 0 ? 1 : 0, c = a == 2 ? 1 : 2;
+			return p.at[b][0] < q.at[b][1] && q.at[b][0] < p.at[b][1] && p.at[c][0] < q.at[c][1] && q.at[c][0] < p.at[c][1];
+		}
+		void add_pair(uint32_t x, uint32_t y)
+		{
+			if (add(key(x, y)))
+				added.push_back(pair{ std::min(x, y), std::max(x, y) });
+		}
+		void remove_pair(uint32_t x, uint32_t y)
+		{
+			if (erase(key(x, y)))
+				removed.push_back(pair{ std::min(x, y), std::max(x, y) });
+		}
+
+		// One insertion-sort step at a time: the endpoint at p moves down past larger endpoints.
+		// A min passing a max starts an overlap on axis a, a max passing a min ends one.
+		// Positions on axis a are left stale when not tracked; the caller rewrites them.
+		template<bool Track = true>
+		void sort_down(uint32_t a, uint32_t p)
+		{
+			endpoint* axis = axes[a].data();
+			body_positions* position = positions.data();
+			const endpoint e = axis[p];
+			while (p > 0 && less(e, axis[p - 1]))
+			{
+				const endpoint f = axis[p - 1];
+				if (((e.id ^ f.id) & 1) && overlap_others(e.id >> 1, f.id >> 1, a))
+				{
+					if (e.id & 1)
+						remove_pair(e.id >> 1, f.id >> 1);
+					else
+						add_pair(e.id >> 1, f.id >> 1);
+				}
+				axis[p] = f;
+				if constexpr (Track)
+					position[f.id >> 1].at[a][f.id & 1] = p;
+				p--;
+			}
+			axis[p] = e;
+			if constexpr (Track)
+				position[e.id >> 1].at[a][e.id & 1] = p;
+		}
+		void sort_up(uint32_t a, uint32_t p)
+		{
+			endpoint* axis = axes[a].data();
+			body_positions* position = positions.data();
+			const uint32_t last = uint32_t(axes[a].size()) - 1;
+			const endpoint e = axis[p];
+			while (p < last && less(axis[p + 1], e))
+			{
+				const endpoint f = axis[p + 1];
+				if (((e.id ^ f.id) & 1) && overlap_others(e.id >> 1, f.id >> 1, a))
+				{
+					if (e.id & 1)
+						add_pair(e.id >> 1, f.id >> 1);
+					else
+						remove_pair(e.id >> 1, f.id >> 1);
+				}
+				axis[p] = f;
+				position[f.id >> 1].at[a][f.id & 1] = p;
+				p++;
+			}
+			axis[p] = e;
+			position[e.id >> 1].at[a][e.id & 1] = p;
+		}
+
+		// Few moves: each moved endpoint is sorted from its own position.
+		void sort_moved()
+		{
+			for (uint32_t h : pending)
+			{
+				if (states[h] != body_state::moved)
+					continue;
+				for (uint32_t a = 0; a < 3; a++)
+				{
+					const uint32_t lo = positions[h].at[a][0], hi = positions[h].at[a][1];
+					axes[a][lo].value = boxes[h].min[a];
+					axes[a][hi].value = boxes[h].max[a];
+					// Min down before max down and max up before min up, so that neither end
+					// of a box ever passes the other.
+					sort_down(a, lo);
+					sort_up(a, hi);
+					sort_up(a, positions[h].at[a][0]);
+					sort_down(a, positions[h].at[a][1]);
+				}
+				states[h] = body_state::idle;
+			}
+		}
+		// Many moves: reaching each moved endpoint would be a cache miss, so every value of an axis
+		// is refreshed in one pass, the axis is insertion-sorted front to back and its positions
+		// are written in a last pass. The other axes stay sorted meanwhile, so the swaps are exact
+		// as above.
+		void sort_all()
+		{
+			for (uint32_t a = 0; a < 3; a++)
+			{
+				endpoint* axis = axes[a].data();
+				const uint32_t n = uint32_t(axes[a].size());
+				for (uint32_t p = 0; p < n; p++)
+				{
+					const aabb<T, 3>& b = boxes[axis[p].id >> 1];
+					axis[p].value = axis[p].id & 1 ? b.max[a] : b.min[a];
+				}
+				for (uint32_t p = 1; p < n; p++)
+					if (less(axis[p], axis[p - 1]))
+						sort_down<false>(a, p);
+				for (uint32_t p = 0; p < n; p++)
+					positions[axis[p].id >> 1].at[a][axis[p].id & 1] = p;
+			}
+			for (uint32_t h : pending)
+				if (states[h] == body_state::moved)
+					states[h] = body_state::idle;
+		}
+
+		// Takes removed bodies off the axes and their pairs out of the table, then frees them.
+		void drop_removed()
+		{
+			for (uint32_t a = 0; a < 3; a++)
+			{
+				std::vector<endpoint>& axis = axes[a];
+				size_t out = 0;
+				for (size_t i = 0; i < axis.size(); i++)
+				{
+					const endpoint e = axis[i];
+					if (states[e.id >> 1] == body_state::removed)
+						continue;
+					axis[out] = e;
+					positions[e.id >> 1].at[a][e.id & 1] = uint32_t(out);
+					out++;
+				}
+				axis.resize(out);
+			}
+			// The table is rebuilt without them; erasing from an open-addressing table while
+			// walking it would move entries under the walk.
+			scratch_keys.clear();
+			for (uint64_t k : keys)
+			{
+				if (k == empty_key)
+					continue;
+				if (states[k >> 32] == body_state::removed || states[uint32_t(k)] == body_state::removed)
+					removed.push_back(pair{ uint32_t(k >> 32), uint32_t(k) });
+				else
+					scratch_keys.push_back(k);
+			}
+			std::fill(keys.begin(), keys.end(), empty_key);
+			pair_total = 0;
+			for (uint64_t k : scratch_keys)
+				add(k);
+			// update() recycles the handles once the pending list is done with.
+			for (uint32_t h : pending)
+				if (states[h] == body_state::removed)
+					states[h] = body_state::free;
+		}
+
+		// Merges the endpoints of the inserted bodies into the axes, then sweeps for their pairs:
+		// new against new, new against old boxes starting at or after them on the sweep axis,
+		// and old against new boxes starting strictly after them, so that each pair is found once.
+		void insert_pending()
+		{
+			vec<double, 3> sum(0.0), sum_squared(0.0);
+			for (uint32_t a = 0; a < 3; a++)
+			{
+				scratch_endpoints.clear();
+				for (uint32_t h : pending)
+				{
+					if (states[h] != body_state::inserted)
+						continue;
+					scratch_endpoints.push_back(endpoint{ boxes[h].min[a], h << 1 });
+					scratch_endpoints.push_back(endpoint{ boxes[h].max[a], h << 1 | 1 });
+				}
+				std::sort(scratch_endpoints.begin(), scratch_endpoints.end(), less);
+
+				// Merged from the back in place; positions change from the first new endpoint on.
+				std::vector<endpoint>& axis = axes[a];
+				size_t i = axis.size(), j = scratch_endpoints.size();
+				axis.resize(i + j);
+				for (size_t out = axis.size(); j > 0;)
+					axis[--out] = i > 0 && less(scratch_endpoints[j - 1], axis[i - 1]) ? axis[--i] : scratch_endpoints[--j];
+				for (size_t p = i; p < axis.size(); p++)
+					positions[axis[p].id >> 1].at[a][axis[p].id & 1] = uint32_t(p);
+
+				for (const endpoint& e : axis)
+				{
+					sum[a] += double(e.value);
+					sum_squared[a] += double(e.value) * double(e.value);
+				}
+			}
+
+			// Sweep along the axis where the endpoints spread the most.
+			const double n = double(axes[0].size());
+			const vec<double, 3> variance = sum_squared * n - sum * sum;
+			const uint32_t s = variance.x >= variance.y && variance.x >= variance.z ? 0 : variance.y >= variance.z ? 1 : 2;
+			const uint32_t u = (s + 1) % 3, v = (s + 2) % 3;
+			fresh.clear();
+			old.clear();
+			for (const endpoint& e : axes[s])
+			{
+				if (e.id & 1)
+					continue;
+				const uint32_t h = e.id >> 1;
+				(states[h] == body_state::inserted ? fresh : old).push(boxes[h], h, s, u, v);
+			}
+			fresh.pad();
+			old.pad();
+			prune(fresh, fresh, true, false);
+			prune(fresh, old, false, false);
+			prune(old, fresh, false, true);
+
+			for (uint32_t h : pending)
+				if (states[h] == body_state::inserted)
+					states[h] = body_state::idle;
+		}
+		// For each box of from, tests the boxes of to that start within it on the sweep axis: those
+		// after it when both lists are the same, else those starting at or after it, or strictly
+		// after it when strict.
+		void prune(const sweep_list& from, const sweep_list& to, bool same, bool strict)
+		{
+			size_t start = 0;
+			for (size_t i = 0; i < from.size(); i++)
+			{
+				const T lo = from.s_min[i], hi = from.s_max[i];
+				if (same)
+					start = i + 1;
+				else
+					while (strict ? to.s_min[start] <= lo : to.s_min[start] < lo)
+						start++;
+				size_t j = start;
+#if defined(MAFS_SSE2)
+				if constexpr (std::is_same_v<T, float>)
+				{
+					const __m128 s_hi = _mm_set1_ps(hi);
+					const __m128 u_lo = _mm_set1_ps(from.u_min[i]), u_hi = _mm_set1_ps(from.u_max[i]);
+					const __m128 v_lo = _mm_set1_ps(from.v_min[i]), v_hi = _mm_set1_ps(from.v_max[i]);
+					for (; to.s_min[j] <= hi; j += 4)
+					{
+						__m128 m = _mm_cmple_ps(_mm_loadu_ps(&to.s_min[j]), s_hi);
+						m = _mm_and_ps(m, _mm_cmple_ps(_mm_loadu_ps(&to.u_min[j]), u_hi));
+						m = _mm_and_ps(m, _mm_cmple_ps(u_lo, _mm_loadu_ps(&to.u_max[j])));
+						m = _mm_and_ps(m, _mm_cmple_ps(_mm_loadu_ps(&to.v_min[j]), v_hi));
+						m = _mm_and_ps(m, _mm_cmple_ps(v_lo, _mm_loadu_ps(&to.v_max[j])));
+						for (uint32_t mask = uint32_t(_mm_movemask_ps(m)); mask != 0; mask &= mask - 1)
+							add_pair(from.ids[i], to.ids[j + size_t(std::countr_zero(mask))]);
+					}
+					continue;
+				}
+#endif
+				for (; to.s_min[j] <= hi; j++)
+				{
+					if (to.u_min[j] <= from.u_max[i] && from.u_min[i] <= to.u_max[j] && to.v_min[j] <= from.v_max[i] && from.v_min[i] <= to.v_max[j])
+						add_pair(from.ids[i], to.ids[j]);
+				}
+			}
+		}
+
+		// A pair may be added and removed, or removed and added back, within one update. Only
+		// effective changes are recorded, so per pair they alternate and cancel in twos.
+		void net_deltas()
+		{
+			std::sort(added.begin(), added.end());
+			std::sort(removed.begin(), removed.end());
+			if (added.empty() || removed.empty())
+				return;
+			scratch_pairs.clear();
+			std::set_difference(added.begin(), added.end(), removed.begin(), removed.end(), std::back_inserter(scratch_pairs));
+			const size_t kept = scratch_pairs.size();
+			std::set_difference(removed.begin(), removed.end(), added.begin(), added.end(), std::back_inserter(scratch_pairs));
+			added.assign(scratch_pairs.begin(), scratch_pairs.begin() + kept);
+			removed.assign(scratch_pairs.begin() + kept, scratch_pairs.end());
+		}
+
+		// Pair set: open addressing with linear probing, Fibonacci hashing of the 64-bit keys.
+		size_t home(uint64_t k) const { return size_t((k * 0x9e3779b97f4a7c15ull) >> shift); }
+		size_t find(uint64_t k) const
+		{
+			if (keys.empty())
+				return empty_slot;
+			const size_t mask = keys.size() - 1;
+			for (size_t i = home(k); keys[i] != empty_key; i = (i + 1) & mask)
+				if (keys[i] == k)
+					return i;
+			return empty_slot;
+		}
+		// Returns false when the pair was already there.
+		bool add(uint64_t k)
+		{
+			if ((pair_total + 1) * 2 > keys.size())
+				grow();
+			const size_t mask = keys.size() - 1;
+			size_t i = home(k);
+			for (; keys[i] != empty_key; i = (i + 1) & mask)
+				if (keys[i] == k)
+					return false;
+			keys[i] = k;
+			pair_total++;
+			return true;
+		}
+		// Backward-shift deletion: later entries of the run move into the hole unless that would
+		// put them before their home slot.
+		bool erase(uint64_t k)
+		{
+			size_t i = find(k);
+			if (i == empty_slot)
+				return false;
+			const size_t mask = keys.size() - 1;
+			for (size_t j = (i + 1) & mask; keys[j] != empty_key; j = (j + 1) & mask)
+			{
+				if (((j - home(keys[j])) & mask) >= ((j - i) & mask))
+				{
+					keys[i] = keys[j];
+					i = j;
+				}
+			}
+			keys[i] = empty_key;
+			pair_total--;
+			return true;
+		}
+		void grow()
+		{
+			scratch_keys.clear();
+			for (uint64_t k : keys)
+				if (k != empty_key)
+					scratch_keys.push_back(k);
+			const size_t capacity = std::max<size_t>(64, keys.size() * 2);
+			keys.assign(capacity, empty_key);
+			shift = 64 - uint32_t(std::countr_zero(capacity));
+			pair_total = 0;
+			for (uint64_t k : scratch_keys)
+				add(k);
+		}
+
+		// Per body handle.
+		std::vector<aabb<T, 3>> boxes;
+		std::vector<body_state> states;
+		std::vector<uint32_t> free_bodies;
+		size_t body_count = 0;
+		// Bodies changed since the last update, possibly more than once.
+		std::vector<uint32_t> pending;
+		std::vector<body_positions> positions;
+		// Sorted endpoints per axis.
+		std::vector<endpoint> axes[3];
+		std::vector<uint64_t> keys;
+		size_t pair_total = 0;
+		uint32_t shift = 64;
+		// Buffers kept between updates.
+		std::vector<uint64_t> scratch_keys;
+		std::vector<pair> scratch_pairs;
+		std::vector<endpoint> scratch_endpoints;
+		sweep_list fresh, old;
+	};
+
+	using sweep_and_prunef = sweep_and_prune<float>;
+	using sweep_and_pruned = sweep_and_prune<double>;
+
+}// namespace mafs
@@ -0,0 +1,71 @@
+#pragma once
+#include <span>
+#include "quat.hpp"
+
+namespace mafs
+{
+	// Translation, rotation and scale; the matrix form is T * R * S.
+	template<std::floating_point T = float>
+	struct trs
+	{
+		vec<T, 3> translation;
+		quat<T> rotation;
+		vec<T, 3> scale = vec<T, 3>(T(1));
+	};
+
+	// Builds T * R * S directly: the rotation basis is expanded from the quaternion and
+	// each column is scaled in place, with no matrix products.
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> compose_trs(const vec<T, 3>& translation, const quat<T>& rotation, const vec<T, 3>& scale)
+	{
+		const mat<T, 3, 3> r = rotation.to_mat3();
+		mat<T, 4, 4> res;
+		for (size_t c = 0; c < 3; c++)
+		{
+			const vec<T, 3> axis = r[c] * scale[c];
+			res[c] = vec<T, 4>{ axis.x, axis.y, axis.z, T(0) };
+		}
+		res[3] = vec<T, 4>{ translation.x, translation.y, translation.z, T(1) };
+		return res;
+	}
+	template<std::floating_point T>
+	constexpr mat<T, 4, 4> compose_trs(const trs<T>& t)
+	{
+		return compose_trs(t.translation, t.rotation, t.scale);
+	}
+
+	// Inverse of compose_trs for affine matrices without shear. Scale comes from the column
+	// lengths; a negative determinant is folded into scale.x so the rotation stays proper.
+	template<std::floating_point T>
+	constexpr trs<T> decompose_trs(const mat<T, 4, 4>& m)
+	{
+		trs<T> res;
+		res.translation = m[3].xyz();
+		vec<T, 3> axes[3] = { m[0].xyz(), m[1].xyz(), m[2].xyz() };
+		res.scale = vec<T, 3>{ axes[0].norm(), axes[1].norm(), axes[2].norm() };
+		if (axes[0].dot(axes[1].cross(axes[2])) < T(0))
+			res.scale.x = -res.scale.x;
+		mat<T, 3, 3> r;
+		for (size_t c = 0; c < 3; c++)
+			r[c] = res.scale[c] != T(0) ? axes[c] / res.scale[c] : vec<T, 3>{};
+		res.rotation = quat<T>::from_mat3(r);
+		return res;
+	}
+
+	template<std::floating_point T>
+	void compose_trs_batch(std::span<const trs<T>> in, std::span<mat<T, 4, 4>> out)
+	{
+		assert(in.size() == out.size() && "Batch sizes do not match");
+		for (size_t i = 0; i < in.size(); i++)
+			out[i] = compose_trs(in[i]);
+	}
+
+	template<std::floating_point T>
+	void decompose_trs_batch(std::span<const mat<T, 4, 4>> in, std::span<trs<T>> out)
+	{
+		assert(in.size() == out.size() && "Batch sizes do not match");
+		for (size_t i = 0; i < in.size(); i++)
+			out[i] = decompose_trs(in[i]);
+	}
+
+}// namespace mafs
@@ -0,0 +1,273 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "aabb.hpp"
+#include "ray.hpp"
+
+namespace mafs
+{
+	// Distance along the ray and barycentric coordinates of the hit: the point is
+	// (1 - u - v) * v0 + u * v1 + v * v2.
+	template<std::floating_point T = float>
+	struct triangle_hit
+	{
+		T t = T(0);
+		T u = T(0);
+		T v = T(0);
+	};
+
+	namespace detail
+	{
+		// Möller-Trumbore on a triangle given as v0 and the edges v1 - v0, v2 - v0.
+		template<std::floating_point T>
+		constexpr bool intersect_triangle_edges(const ray<T, 3>& r, const vec<T, 3>& v0, const vec<T, 3>& e1, const vec<T, 3>& e2, T t_max, triangle_hit<T>& hit)
+		{
+			const vec<T, 3> p = r.direction.cross(e2);
+			const T det = e1.dot(p);
+			if (det == T(0))
+				return false;
+			const T inv_det = T(1) / det;
+			const vec<T, 3> s = r.origin - v0;
+			const T u = s.dot(p) * inv_det;
+			if (u < T(0) || u > T(1))
+				return false;
+			const vec<T, 3> q = s.cross(e1);
+			const T v = r.direction.dot(q) * inv_det;
+			if (v < T(0) || u + v > T(1))
+				return false;
+			const T t = e2.dot(q) * inv_det;
+			if (!(t >= T(0) && t < t_max))
+				return false;
+			hit = triangle_hit<T>{ t, u, v };
+			return true;
+		}
+
+		// Twice the signed area of the sheared triangle (0, p, q), which is the barycentric
+		// weight of the third vertex before normalization.
+		template<typename T>
+		constexpr T edge_function(T px, T py, T qx, T qy)
+		{
+			return px * qy - py * qx;
+		}
+		// Above this the sign of edge_function is certain, with or without FMA contraction.
+		template<typename V, std::floating_point T = float>
+		constexpr V edge_error_bound(const V& px, const V& py, const V& qx, const V& qy)
+		{
+			using std::abs;
+			return (abs(px * qy) + abs(py * qx)) * T(2 * std::numeric_limits<T>::epsilon());
+		}
+		// Results closer to zero than the bound are recomputed at this precision, where products
+		// of floats are exact. The signs then never depend on rounding, so the two triangles on
+		// an edge always agree on which side of it a ray passes. Doubles have no wider type and
+		// keep their rounded sign.
+		template<std::floating_point T>
+		using watertight_wide = std::conditional_t<std::is_same_v<T, float>, double, T>;
+		template<std::floating_point T>
+		constexpr T edge_function_exact_sign(T px, T py, T qx, T qy)
+		{
+			const T e = edge_function(px, py, qx, qy);
+			if ((e < T(0) ? -e : e) > edge_error_bound<T, T>(px, py, qx, qy))
+				return e;
+			using wide = watertight_wide<T>;
+			return T(edge_function<wide>(px, py, qx, qy));
+		}
+	}
+
+	// Möller-Trumbore ray/triangle test over [0, t_max). Both faces count; rays parallel to the
+	// plane miss.
+	template<std::floating_point T>
+	constexpr bool intersect_triangle(const ray<T, 3>& r, const vec<T, 3>& v0, const vec<T, 3>& v1, const vec<T, 3>& v2, T t_max, triangle_hit<T>& hit)
+	{
+		return detail::intersect_triangle_edges(r, v0, v1 - v0, v2 - v0, t_max, hit);
+	}
+
+	// Watertight ray/triangle test (Woop, Benthin and Wald 2013). The vertices are sheared into
+	// a space where the ray is the +z axis and the edge functions are evaluated there; a ray
+	// through an edge shared by two triangles hits at least one of them, which
+	// Möller-Trumbore does not guarantee. Both faces count.
+	template<std::floating_point T>
+	constexpr bool intersect_triangle_watertight(const ray<T, 3>& r, const vec<T, 3>& v0, const vec<T, 3>& v1, const vec<T, 3>& v2, T t_max, triangle_hit<T>& hit)
+	{
+		const detail::watertight_shear<T> s = detail::make_watertight_shear(r.direction);
+		const vec<T, 3> a = v0 - r.origin, b = v1 - r.origin, c = v2 - r.origin;
+		const T ax = a[s.kx] - s.sx * a[s.kz], ay = a[s.ky] - s.sy * a[s.kz];
+		const T bx = b[s.kx] - s.sx * b[s.kz], by = b[s.ky] - s.sy * b[s.kz];
+		const T cx = c[s.kx] - s.sx * c[s.kz], cy = c[s.ky] - s.sy * c[s.kz];
+		const T w0 = detail::edge_function_exact_sign(cx, cy, bx, by);
+		const T w1 = detail::edge_function_exact_sign(ax, ay, cx, cy);
+		const T w2 = detail::edge_function_exact_sign(bx, by, ax, ay);
+		if ((w0 < T(0) || w1 < T(0) || w2 < T(0)) && (w0 > T(0) || w1 > T(0) || w2 > T(0)))
+			return false;
+		const T det = w0 + w1 + w2;
+		if (det == T(0))
+			return false;
+		const T inv_det = T(1) / det;
+		const T t = (w0 * (s.sz * a[s.kz]) + w1 * (s.sz * b[s.kz]) + w2 * (s.sz * c[s.kz])) * inv_det;
+		if (!(t >= T(0) && t < t_max))
+			return false;
+		hit = triangle_hit<T>{ t, w1 * inv_det, w2 * inv_det };
+		return true;
+	}
+
+	// W triangles in SoA layout, v0[a][l] being axis a of the first vertex of lane l. Unset
+	// lanes are degenerate at the origin and never hit.
+	template<size_t W, std::floating_point T = float>
+	struct triangle_packet
+	{
+		static_assert(W >= 1 && W <= 32, "Packet masks hold at most 32 lanes");
+
+		constexpr void set(size_t lane, const vec<T, 3>& a, const vec<T, 3>& b, const vec<T, 3>& c)
+		{
+			for (size_t i = 0; i < 3; i++)
+			{
+				v0[i][lane] = a[i];
+				v1[i][lane] = b[i];
+				v2[i][lane] = c[i];
+			}
+		}
+
+		vec<T, W> v0[3];
+		vec<T, W> v1[3];
+		vec<T, W> v2[3];
+	};
+
+	// Per-lane hits of the packet tests; lanes outside the returned mask hold garbage.
+	template<size_t W, std::floating_point T = float>
+	struct triangle_packet_hit
+	{
+		vec<T, W> t;
+		vec<T, W> u;
+		vec<T, W> v;
+	};
+
+	// Packs an indexed mesh W triangles per packet; triangle i goes to lane i % W of packet i / W.
+	template<size_t W, std::floating_point T>
+	std::vector<triangle_packet<W, T>> pack_triangles(std::span<const vec<T, 3>> positions, std::span<const uint32_t> indices)
+	{
+		assert(indices.size() % 3 == 0 && "Indices must come in triangles");
+		const size_t count = indices.size() / 3;
+		std::vector<triangle_packet<W, T>> res((count + W - 1) / W);
+		for (size_t i = 0; i < count; i++)
+			res[i / W].set(i % W, positions[indices[3 * i]], positions[indices[3 * i + 1]], positions[indices[3 * i + 2]]);
+		return res;
+	}
+
+	namespace detail
+	{
+		template<size_t W>
+		constexpr uint32_t lane_mask() { return W == 32 ? ~0u : (1u << W) - 1; }
+
+		// Möller-Trumbore across lanes, where either the ray or the triangle may be broadcast.
+		// det == 0 needs no test of its own: its infinite reciprocal makes u NaN or infinite,
+		// which fails the range checks.
+		template<size_t W, std::floating_point T>
+		constexpr uint32_t intersect_triangle_lanes(const vec<T, W>* origin, const vec<T, W>* dir, const vec<T, W>* v0, const vec<T, W>* v1, const vec<T, W>* v2,
+			const vec<T, W>& t_max, triangle_packet_hit<W, T>& hit)
+		{
+			const vec<T, W> e1[3] = { v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2] };
+			const vec<T, W> e2[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+			const vec<T, W> p[3] = { dir[1] * e2[2] - dir[2] * e2[1], dir[2] * e2[0] - dir[0] * e2[2], dir[0] * e2[1] - dir[1] * e2[0] };
+			const vec<T, W> inv_det = vec<T, W>(T(1)) / (e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2]);
+			const vec<T, W> s[3] = { origin[0] - v0[0], origin[1] - v0[1], origin[2] - v0[2] };
+			const vec<T, W> q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+			hit.u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv_det;
+			hit.v = (dir[0] * q[0] + dir[1] * q[1] + dir[2] * q[2]) * inv_det;
+			hit.t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv_det;
+			const vec<T, W> zero(T(0));
+			const uint32_t mask = less_equal_mask(zero, hit.u) & less_equal_mask(zero, hit.v) & less_equal_mask(hit.u + hit.v, vec<T, W>(T(1)))
+				& less_equal_mask(zero, hit.t) & ~less_equal_mask(t_max, hit.t);
+			return mask & lane_mask<W>();
+		}
+
+		// The watertight test on vertices already sheared into ray space: x and y give the
+		// edge functions, z the distance.
+		template<size_t W, std::floating_point T>
+		constexpr uint32_t intersect_sheared_lanes(const vec<T, W>* a, const vec<T, W>* b, const vec<T, W>* c, const vec<T, W>& t_max, triangle_packet_hit<W, T>& hit)
+		{
+			vec<T, W> w0 = edge_function(c[0], c[1], b[0], b[1]);
+			vec<T, W> w1 = edge_function(a[0], a[1], c[0], c[1]);
+			vec<T, W> w2 = edge_function(b[0], b[1], a[0], a[1]);
+			const uint32_t uncertain = less_equal_mask(abs(w0), edge_error_bound<vec<T, W>, T>(c[0], c[1], b[0], b[1]))
+				| less_equal_mask(abs(w1), edge_error_bound<vec<T, W>, T>(a[0], a[1], c[0], c[1]))
+				| less_equal_mask(abs(w2), edge_error_bound<vec<T, W>, T>(b[0], b[1], a[0], a[1]));
+			// Rare: only rays passing within rounding distance of an edge take the scalar path.
+			for (uint32_t m = uncertain & lane_mask<W>(); m != 0; m &= m - 1)
+			{
+				const size_t l = size_t(std::countr_zero(m));
+				w0[l] = edge_function_exact_sign(c[0][l], c[1][l], b[0][l], b[1][l]);
+				w1[l] = edge_function_exact_sign(a[0][l], a[1][l], c[0][l], c[1][l]);
+				w2[l] = edge_function_exact_sign(b[0][l], b[1][l], a[0][l], a[1][l]);
+			}
+			const vec<T, W> zero(T(0));
+			const uint32_t negative = ~(less_equal_mask(zero, w0) & less_equal_mask(zero, w1) & less_equal_mask(zero, w2));
+			const uint32_t positive = ~(less_equal_mask(w0, zero) & less_equal_mask(w1, zero) & less_equal_mask(w2, zero));
+			// A zero det has all three weights zero, and its t below is NaN.
+			const vec<T, W> inv_det = vec<T, W>(T(1)) / (w0 + w1 + w2);
+			hit.t = (w0 * a[2] + w1 * b[2] + w2 * c[2]) * inv_det;
+			hit.u = w1 * inv_det;
+			hit.v = w2 * inv_det;
+			const uint32_t mask = ~(negative & positive) & less_equal_mask(zero, hit.t) & ~less_equal_mask(t_max, hit.t);
+			return mask & lane_mask<W>();
+		}
+	}
+
+	// One ray against W triangles. Bit l of the result is set when lane l is hit in [0, t_max);
+	// hit holds the distances and barycentrics of those lanes.
+	template<size_t W, std::floating_point T>
+	constexpr uint32_t intersect(const triangle_packet<W, T>& p, const ray<T, 3>& r, T t_max, triangle_packet_hit<W, T>& hit)
+	{
+		const vec<T, W> origin[3] = { vec<T, W>(r.origin.x), vec<T, W>(r.origin.y), vec<T, W>(r.origin.z) };
+		const vec<T, W> dir[3] = { vec<T, W>(r.direction.x), vec<T, W>(r.direction.y), vec<T, W>(r.direction.z) };
+		return detail::intersect_triangle_lanes(origin, dir, p.v0, p.v1, p.v2, vec<T, W>(t_max), hit);
+	}
+	// W rays against one triangle, each with its own t_max.
+	template<size_t W, std::floating_point T>
+	constexpr uint32_t intersect(const ray_packet<W, T>& rays, const vec<T, 3>& v0, const vec<T, 3>& v1, const vec<T, 3>& v2, const vec<T, W>& t_max, triangle_packet_hit<W, T>& hit)
+	{
+		const vec<T, W> a[3] = { vec<T, W>(v0.x), vec<T, W>(v0.y), vec<T, W>(v0.z) };
+		const vec<T, W> b[3] = { vec<T, W>(v1.x), vec<T, W>(v1.y), vec<T, W>(v1.z) };
+		const vec<T, W> c[3] = { vec<T, W>(v2.x), vec<T, W>(v2.y), vec<T, W>(v2.z) };
+		return detail::intersect_triangle_lanes(rays.origin, rays.direction, a, b, c, t_max, hit);
+	}
+
+	// Watertight versions of the two packet tests above.
+	template<size_t W, std::floating_point T>
+	constexpr uint32_t intersect_watertight(const triangle_packet<W, T>& p, const ray<T, 3>& r, T t_max, triangle_packet_hit<W, T>& hit)
+	{
+		// The shear axes belong to the ray, so picking components is not a per-lane select.
+		const detail::watertight_shear<T> s = detail::make_watertight_shear(r.direction);
+		const vec<T, W> sx(s.sx), sy(s.sy), sz(s.sz);
+		vec<T, W> sheared[3][3];
+		const vec<T, W>* vertices[3] = { p.v0, p.v1, p.v2 };
+		for (size_t k = 0; k < 3; k++)
+		{
+			const vec<T, W> z = vertices[k][s.kz] - vec<T, W>(r.origin[s.kz]);
+			sheared[k][0] = (vertices[k][s.kx] - vec<T, W>(r.origin[s.kx])) - sx * z;
+			sheared[k][1] = (vertices[k][s.ky] - vec<T, W>(r.origin[s.ky])) - sy * z;
+			sheared[k][2] = sz * z;
+		}
+		return detail::intersect_sheared_lanes(sheared[0], sheared[1], sheared[2], vec<T, W>(t_max), hit);
+	}
+	// The axes differ between lanes here, so the shear is applied as the matrix ray_packet::set
+	// stored. Its entries are 0, 1 and the shear factors, so each product is as exact as in the
+	// scalar test and shared vertices still shear to the same point.
+	template<size_t W, std::floating_point T>
+	constexpr uint32_t intersect_watertight(const ray_packet<W, T>& rays, const vec<T, 3>& v0, const vec<T, 3>& v1, const vec<T, 3>& v2, const vec<T, W>& t_max, triangle_packet_hit<W, T>& hit)
+	{
+		vec<T, W> sheared[3][3];
+		const vec<T, 3>* vertices[3] = { &v0, &v1, &v2 };
+		for (size_t k = 0; k < 3; k++)
+		{
+			const vec<T, W> rel[3] = { vec<T, W>((*vertices[k]).x) - rays.origin[0], vec<T, W>((*vertices[k]).y) - rays.origin[1], vec<T, W>((*vertices[k]).z) - rays.origin[2] };
+			for (size_t row = 0; row < 3; row++)
+				sheared[k][row] = rays.shear[row][0] * rel[0] + rays.shear[row][1] * rel[1] + rays.shear[row][2] * rel[2];
+		}
+		return detail::intersect_sheared_lanes(sheared[0], sheared[1], sheared[2], t_max, hit);
+	}
+
+}// namespace mafs
@@ -3,8 +3,15 @@
 #include <cassert>
 #include <concepts>
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
+#include <functional>
 #include <iostream>
+#include <type_traits>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MAFS_SSE2 1
+#include <immintrin.h>
+#endif
 
 namespace mafs {
 	template<typename T = float, size_t N = 3>
@@ -93,6 +100,31 @@ namespace mafs {
 		{
 			return *this * (U(1) / t);
 		}
+		// Component-wise product and quotient.
+		constexpr vec& operator*=(const vec& v)
+		{
+			for (size_t i = 0; i < N; ++i)
+				data[i] *= v[i];
+			return *this;
+		}
+		constexpr vec& operator/=(const vec& v)
+		{
+			for (size_t i = 0; i < N; ++i)
+				data[i] /= v[i];
+			return *this;
+		}
+		constexpr vec operator*(const vec& v) const
+		{
+			vec res = *this;
+			res *= v;
+			return res;
+		}
+		constexpr vec operator/(const vec& v) const
+		{
+			vec res = *this;
+			res /= v;
+			return res;
+		}
 		bool operator==(const vec& v) const {
 			if constexpr (std::floating_point<T>)
 			{
@@ -177,8 +209,17 @@ namespace mafs {
 			x = (it != init.end()) ? *it++ : T(0);
 			y = (it != init.end()) ? *it++ : T(0);
 		}
-		constexpr T& operator[] (size_t i) { return (&x)[i]; }
-		constexpr const T& operator[] (size_t i) const { return (&x)[i]; }
+		// (&x)[i] is not allowed during constant evaluation, so select the member explicitly there.
+		constexpr T& operator[] (size_t i)
+		{
+			if (std::is_constant_evaluated()) return i == 0 ? x : y;
+			return (&x)[i];
+		}
+		constexpr const T& operator[] (size_t i) const
+		{
+			if (std::is_constant_evaluated()) return i == 0 ? x : y;
+			return (&x)[i];
+		}
 
 		constexpr vec& operator +=(const vec& v)
 		{
@@ -233,6 +274,31 @@ namespace mafs {
 		{
 			return *this * (U(1) / t);
 		}
+		// Component-wise product and quotient.
+		constexpr vec& operator*=(const vec& v)
+		{
+			x *= v[0];
+			y *= v[1];
+			return *this;
+		}
+		constexpr vec& operator/=(const vec& v)
+		{
+			x /= v[0];
+			y /= v[1];
+			return *this;
+		}
+		constexpr vec operator*(const vec& v) const
+		{
+			vec res = *this;
+			res *= v;
+			return res;
+		}
+		constexpr vec operator/(const vec& v) const
+		{
+			vec res = *this;
+			res /= v;
+			return res;
+		}
 		bool operator==(const vec& v) const {
 			if constexpr (std::floating_point<T>)
 			{
@@ -294,8 +360,16 @@ namespace mafs {
 			y = (it != init.end()) ? *it++ : T(0);
 			z = (it != init.end()) ? *it++ : T(0);
 		}
-		constexpr T& operator[] (size_t i) { return (&x)[i]; }
-		constexpr const T& operator[] (size_t i) const { return (&x)[i]; }
+		constexpr T& operator[] (size_t i)
+		{
+			if (std::is_constant_evaluated()) return i == 0 ? x : i == 1 ? y : z;
+			return (&x)[i];
+		}
+		constexpr const T& operator[] (size_t i) const
+		{
+			if (std::is_constant_evaluated()) return i == 0 ? x : i == 1 ? y : z;
+			return (&x)[i];
+		}
 
 		constexpr vec& operator +=(const vec& v)
 		{
@@ -353,6 +427,33 @@ namespace mafs {
 		{
 			return *this * (U(1) / t);
 		}
+		// Component-wise product and quotient.
+		constexpr vec& operator*=(const vec& v)
+		{
+			x *= v[0];
+			y *= v[1];
+			z *= v[2];
+			return *this;
+		}
+		constexpr vec& operator/=(const vec& v)
+		{
+			x /= v[0];
+			y /= v[1];
+			z /= v[2];
+			return *this;
+		}
+		constexpr vec operator*(const vec& v) const
+		{
+			vec res = *this;
+			res *= v;
+			return res;
+		}
+		constexpr vec operator/(const vec& v) const
+		{
+			vec res = *this;
+			res /= v;
+			return res;
+		}
 		bool operator==(const vec& v) const {
 			if constexpr (std::floating_point<T>)
 			{
@@ -422,8 +523,16 @@ namespace mafs {
 			z = (it != init.end()) ? *it++ : T(0);
 			w = (it != init.end()) ? *it++ : T(0);
 		}
-		constexpr T& operator[] (size_t i) { return (&x)[i]; }
-		constexpr const T& operator[] (size_t i) const { return (&x)[i]; }
+		constexpr T& operator[] (size_t i)
+		{
+			if (std::is_constant_evaluated()) return i == 0 ? x : i == 1 ? y : i == 2 ? z : w;
+			return (&x)[i];
+		}
+		constexpr const T& operator[] (size_t i) const
+		{
+			if (std::is_constant_evaluated()) return i == 0 ? x : i == 1 ? y : i == 2 ? z : w;
+			return (&x)[i];
+		}
 
 		constexpr vec& operator +=(const vec& v)
 		{
@@ -484,6 +593,35 @@ namespace mafs {
 		{
 			return *this * (U(1) / t);
 		}
+		// Component-wise product and quotient.
+		constexpr vec& operator*=(const vec& v)
+		{
+			x *= v[0];
+			y *= v[1];
+			z *= v[2];
+			w *= v[3];
+			return *this;
+		}
+		constexpr vec& operator/=(const vec& v)
+		{
+			x /= v[0];
+			y /= v[1];
+			z /= v[2];
+			w /= v[3];
+			return *this;
+		}
+		constexpr vec operator*(const vec& v) const
+		{
+			vec res = *this;
+			res *= v;
+			return res;
+		}
+		constexpr vec operator/(const vec& v) const
+		{
+			vec res = *this;
+			res /= v;
+			return res;
+		}
 		bool operator==(const vec& v) const {
 			if constexpr (std::floating_point<T>)
 			{
@@ -534,6 +672,128 @@ namespace mafs {
 		constexpr vec<T, 3> xyz() const { return vec<T, 3>{x, y, z}; }
 	};
 
+	//-----------------------------Component-wise functions-----------------------------
+	// These also make vec<T, W> usable as a W-lane SIMD packet: the loops have a fixed
+	// trip count and no branches, so the compiler maps them onto vector instructions.
+	// Under -ftrapping-math GCC keeps float compares as branches, so min and max use the SSE
+	// instructions directly. minps(b, a) is b < a ? b : a, the same result as the loop for NaNs
+	// and signed zeros.
+	template<typename T, size_t N>
+	constexpr vec<T, N> min(const vec<T, N>& a, const vec<T, N>& b)
+	{
+		vec<T, N> res;
+		size_t i = 0;
+#if defined(MAFS_SSE2)
+		if (!std::is_constant_evaluated())
+		{
+			if constexpr (std::is_same_v<T, float>)
+			{
+#if defined(__AVX__)
+				for (; i + 8 <= N; i += 8)
+					_mm256_storeu_ps(&res[i], _mm256_min_ps(_mm256_loadu_ps(&b[i]), _mm256_loadu_ps(&a[i])));
+#endif
+				for (; i + 4 <= N; i += 4)
+					_mm_storeu_ps(&res[i], _mm_min_ps(_mm_loadu_ps(&b[i]), _mm_loadu_ps(&a[i])));
+			}
+			else if constexpr (std::is_same_v<T, double>)
+			{
+				for (; i + 2 <= N; i += 2)
+					_mm_storeu_pd(&res[i], _mm_min_pd(_mm_loadu_pd(&b[i]), _mm_loadu_pd(&a[i])));
+			}
+		}
+#endif
+		for (; i < N; i++)
+			res[i] = b[i] < a[i] ? b[i] : a[i];
+		return res;
+	}
+	template<typename T, size_t N>
+	constexpr vec<T, N> max(const vec<T, N>& a, const vec<T, N>& b)
+	{
+		vec<T, N> res;
+		size_t i = 0;
+#if defined(MAFS_SSE2)
+		if (!std::is_constant_evaluated())
+		{
+			if constexpr (std::is_same_v<T, float>)
+			{
+#if defined(__AVX__)
+				for (; i + 8 <= N; i += 8)
+					_mm256_storeu_ps(&res[i], _mm256_max_ps(_mm256_loadu_ps(&b[i]), _mm256_loadu_ps(&a[i])));
+#endif
+				for (; i + 4 <= N; i += 4)
+					_mm_storeu_ps(&res[i], _mm_max_ps(_mm_loadu_ps(&b[i]), _mm_loadu_ps(&a[i])));
+			}
+			else if constexpr (std::is_same_v<T, double>)
+			{
+				for (; i + 2 <= N; i += 2)
+					_mm_storeu_pd(&res[i], _mm_max_pd(_mm_loadu_pd(&b[i]), _mm_loadu_pd(&a[i])));
+			}
+		}
+#endif
+		for (; i < N; i++)
+			res[i] = a[i] < b[i] ? b[i] : a[i];
+		return res;
+	}
+	template<typename T, size_t N>
+	constexpr vec<T, N> abs(const vec<T, N>& a)
+	{
+		vec<T, N> res;
+		for (size_t i = 0; i < N; i++)
+			res[i] = a[i] < T(0) ? -a[i] : a[i];
+		return res;
+	}
+	template<std::floating_point T, size_t N>
+	constexpr vec<T, N> sqrt(const vec<T, N>& a)
+	{
+		vec<T, N> res;
+		size_t i = 0;
+#if defined(MAFS_SSE2)
+		// std::sqrt may set errno, which keeps compilers from vectorizing the loop below.
+		if (!std::is_constant_evaluated())
+		{
+			if constexpr (std::is_same_v<T, float>)
+			{
+#if defined(__AVX__)
+				for (; i + 8 <= N; i += 8)
+					_mm256_storeu_ps(&res[i], _mm256_sqrt_ps(_mm256_loadu_ps(&a[i])));
+#endif
+				for (; i + 4 <= N; i += 4)
+					_mm_storeu_ps(&res[i], _mm_sqrt_ps(_mm_loadu_ps(&a[i])));
+			}
+			else if constexpr (std::is_same_v<T, double>)
+			{
+				for (; i + 2 <= N; i += 2)
+					_mm_storeu_pd(&res[i], _mm_sqrt_pd(_mm_loadu_pd(&a[i])));
+			}
+		}
+#endif
+		for (; i < N; i++)
+			res[i] = std::sqrt(a[i]);
+		return res;
+	}
+	template<typename T, size_t N>
+	constexpr vec<bool, N> less_than(const vec<T, N>& a, const vec<T, N>& b)
+	{
+		vec<bool, N> res;
+		for (size_t i = 0; i < N; i++)
+			res[i] = a[i] < b[i];
+		return res;
+	}
+	template<typename T, size_t N>
+	constexpr vec<bool, N> greater_than(const vec<T, N>& a, const vec<T, N>& b)
+	{
+		return less_than(b, a);
+	}
+	// Picks a[i] where mask[i] is set and b[i] elsewhere.
+	template<typename T, size_t N>
+	constexpr vec<T, N> select(const vec<bool, N>& mask, const vec<T, N>& a, const vec<T, N>& b)
+	{
+		vec<T, N> res;
+		for (size_t i = 0; i < N; i++)
+			res[i] = mask[i] ? a[i] : b[i];
+		return res;
+	}
+
 	using vec3f = vec<float, 3>;
 	using vec3d = vec<double, 3>;
 	using vec3i = vec<int, 3>;
@@ -543,4 +803,20 @@ namespace mafs {
 
 }//namespace mafs
 
+// Lets integral vectors key unordered containers. Floating-point vectors compare with a
+// tolerance, which no hash can agree with, so they get none.
+template<typename T, size_t N>
+	requires std::integral<T>
+struct std::hash<mafs::vec<T, N>>
+{
+	size_t operator()(const mafs::vec<T, N>& v) const noexcept
+	{
+		// Multiply-xor per lane, then the high half folded down for tables that use the low bits.
+		uint64_t h = 0;
+		for (size_t i = 0; i < N; i++)
+			h = (h ^ uint64_t(v[i])) * 0x9e3779b97f4a7c15ull;
+		return size_t(h ^ (h >> 32));
+	}
+};
+
 
@@ -0,0 +1,275 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include "vec.hpp"
+
+namespace mafs
+{
+	// Accuracy tier of the packet approximations below. Max error against the correctly
+	// rounded result, in float ULPs, measured on the ranges noted with each function:
+	//
+	//                 sin/cos   atan2   acos   exp   log    pow
+	//   accurate          2        3       1     1     1    119
+	//   fast            232      590     787    70   207   1234
+	//
+	// fast uses lower-degree polynomials and skips atan2's second range reduction.
+	// pow is exp(y * log(x)), so its error scales with |y * log(x)| in both tiers.
+	enum class precision { fast, accurate };
+
+	template<size_t N>
+	struct sincos_result
+	{
+		vec<float, N> sin;
+		vec<float, N> cos;
+	};
+
+	namespace detail
+	{
+		inline constexpr float pi = 3.14159265358979f;
+		inline constexpr float half_pi = 1.57079632679490f;
+		inline constexpr float quarter_pi = 0.785398163397448f;
+
+		// Round to nearest for |x| < 2^22, without the libm call.
+		constexpr float round_nearest(float x)
+		{
+			return (x + 12582912.0f) - 12582912.0f;
+		}
+		constexpr float copysign(float mag, float sgn)
+		{
+			return std::bit_cast<float>((std::bit_cast<uint32_t>(mag) & 0x7fffffffu) | (std::bit_cast<uint32_t>(sgn) & 0x80000000u));
+		}
+		constexpr float fabs(float x)
+		{
+			return std::bit_cast<float>(std::bit_cast<uint32_t>(x) & 0x7fffffffu);
+		}
+		// Float comparisons on the bit patterns. Unlike a < b they cannot raise FP exceptions,
+		// so GCC if-converts and vectorizes the lane loops under the default -ftrapping-math.
+		// -0 orders below +0 and NaNs order outside +-inf.
+		constexpr int32_t ordered(float x)
+		{
+			const int32_t i = std::bit_cast<int32_t>(x);
+			return i ^ ((i >> 31) & 0x7fffffff);
+		}
+		constexpr bool less(float a, float b)
+		{
+			return ordered(a) < ordered(b);
+		}
+		constexpr bool is_nan(float x)
+		{
+			return (std::bit_cast<uint32_t>(x) & 0x7fffffffu) > 0x7f800000u;
+		}
+		// m ? a : b as a bit blend, which GCC cannot jump-thread back into a branch.
+		constexpr float blend(bool m, float a, float b)
+		{
+			const uint32_t mask = 0u - uint32_t(m);
+			return std::bit_cast<float>((std::bit_cast<uint32_t>(a) & mask) | (std::bit_cast<uint32_t>(b) & ~mask));
+		}
+
+		// The lane kernels are branch-free so the fixed-count loops calling them vectorize.
+		template<precision P>
+		constexpr void sincos_lane(float x, float& s, float& c)
+		{
+			// Cody-Waite reduction to [-pi/4, pi/4]. pi/2 is split into parts of at most 11 bits,
+			// so j * part is exact for |j| < 2^13.
+			const float j = round_nearest(x * 0.636619772367581f);
+			const int32_t q = int32_t(j);
+			float r = x - j * 1.5703125f;
+			r = r - j * 4.837512969970703125e-4f;
+			r = r - j * 7.54953362047672271728515625e-8f;
+			r = r - j * 2.5633440682570896e-12f;
+			const float z = r * r;
+			float sr, cr;
+			if constexpr (P == precision::accurate)
+			{
+				sr = r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+				cr = 1.0f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+			}
+			else
+			{
+				sr = r + r * z * (-0.166633904f + z * 8.16328193e-3f);
+				cr = 1.0f + z * (-0.499760557f + z * 4.04584523e-2f);
+			}
+			const bool swap = (q & 1) != 0;
+			s = blend(swap, cr, sr);
+			c = blend(swap, sr, cr);
+			s = blend((q & 2) != 0, -s, s);
+			c = blend(((q + 1) & 2) != 0, -c, c);
+		}
+
+		template<precision P>
+		constexpr float atan2_lane(float y, float x)
+		{
+			const float ax = fabs(x), ay = fabs(y);
+			const bool steep = less(ax, ay);
+			const float mx = blend(steep, ay, ax);
+			const float mn = blend(steep, ax, ay);
+			const float a = mn / blend(std::bit_cast<uint32_t>(mx) == 0u, 1.0f, mx);
+			float r;
+			if constexpr (P == precision::accurate)
+			{
+				const bool big = less(0.414213562f, a); // tan(pi/8)
+				const float t = blend(big, (a - 1.0f) / (a + 1.0f), a);
+				const float z = t * t;
+				r = blend(big, quarter_pi, 0.0f)
+					+ ((((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * t + t);
+			}
+			else
+			{
+				const float z = a * a;
+				r = a + a * z * (-0.332130719f + z * (0.186814174f + z * (-9.40979361e-2f + z * 2.48402791e-2f)));
+			}
+			r = blend(steep, half_pi - r, r);
+			r = blend(std::bit_cast<int32_t>(x) < 0, pi - r, r);
+			return copysign(r, y);
+		}
+
+		// acos is split around the sqrt so the caller can take it packet-wide: acos_arg gives
+		// 0.5 * (1 - |x|), acos_lane gets x and the square root of that value.
+		constexpr float acos_arg(float x)
+		{
+			return 0.5f * (1.0f - fabs(x));
+		}
+		template<precision P>
+		constexpr float acos_lane(float x, float root)
+		{
+			const float ax = fabs(x);
+			if constexpr (P == precision::accurate)
+			{
+				// acos(x) = pi/2 - asin(x) near zero, 2 * asin(sqrt((1 - |x|) / 2)) near one.
+				const bool big = less(0.5f, ax);
+				const float s = blend(big, root, ax);
+				const float z = s * s;
+				const float r = s + s * z * ((((4.2163199048e-2f * z + 2.4181311049e-2f) * z + 4.5470025998e-2f) * z + 7.4953002686e-2f) * z + 1.6666752422e-1f);
+				const float near_one = blend(std::bit_cast<int32_t>(x) < 0, pi - 2.0f * r, 2.0f * r);
+				return blend(big, near_one, half_pi - copysign(r, x));
+			}
+			else
+			{
+				// Abramowitz & Stegun 4.4.45; sqrt(1 - |x|) = sqrt(2) * root, with sqrt(2) folded into the coefficients.
+				const float r = root * (2.221346f + ax * (-0.29997506f + ax * (0.10502091f - ax * 0.02648723f)));
+				return blend(std::bit_cast<int32_t>(x) < 0, pi - r, r);
+			}
+		}
+
+		template<precision P>
+		constexpr float exp_lane(float x)
+		{
+			// Clamped so 2^n fits two exponent fields; the clamp also maps NaN to lo, restored at the end.
+			float c = blend(less(-104.0f, x), x, -104.0f);
+			c = blend(less(c, 89.0f), c, 89.0f);
+			const float n = round_nearest(c * 1.44269504088896f);
+			float r = c - n * 0.693359375f;
+			r = r - n * -2.12194440e-4f;
+			const float z = r * r;
+			float y;
+			if constexpr (P == precision::accurate)
+				y = ((((((1.9875691500e-4f * r + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r + 4.1665795894e-2f) * r + 1.6666665459e-1f) * r + 5.0000001201e-1f) * z + r) + 1.0f;
+			else
+				y = (((4.12777471e-2f * r + 0.167535139f) * r + 0.500051160f) * z + r) + 1.0f;
+			const int32_t ni = int32_t(n);
+			const int32_t h = ni >> 1;
+			y = y * std::bit_cast<float>((h + 127) << 23) * std::bit_cast<float>((ni - h + 127) << 23);
+			return blend(is_nan(x), x, y);
+		}
+
+		template<precision P>
+		constexpr float log_lane(float x)
+		{
+			// Denormals are scaled by 2^23 so the exponent field is meaningful.
+			const uint32_t ux = std::bit_cast<uint32_t>(x);
+			const bool tiny = ux < 0x00800000u;
+			const uint32_t bits = std::bit_cast<uint32_t>(blend(tiny, x * 8388608.0f, x));
+			const int32_t e = int32_t((bits >> 23) & 0xffu) - 126 - (tiny ? 23 : 0);
+			float m = std::bit_cast<float>((bits & 0x007fffffu) | 0x3f000000u); // [0.5, 1)
+			const bool lo = less(m, 0.707106781f);
+			const float fe = float(e - (lo ? 1 : 0));
+			m = blend(lo, m + m - 1.0f, m - 1.0f);
+			const float z = m * m;
+			float y;
+			if constexpr (P == precision::accurate)
+				y = ((((((((7.0376836292e-2f * m - 1.1514610310e-1f) * m + 1.1676998740e-1f) * m - 1.2420140846e-1f) * m + 1.4249322787e-1f) * m
+					- 1.6668057665e-1f) * m + 2.0000714765e-1f) * m - 2.4999993993e-1f) * m + 3.3333331174e-1f) * m * z;
+			else
+				y = (((-0.145925151f * m + 0.217765100f) * m - 0.252449975f) * m + 0.332854710f) * m * z;
+			y = y + fe * -2.12194440e-4f;
+			y = y - 0.5f * z;
+			float r = (m + y) + fe * 0.693359375f;
+			r = blend((ux & 0x7fffffffu) == 0u, -std::numeric_limits<float>::infinity(), r);
+			r = blend(ux == 0x7f800000u, x, r);
+			return blend(ux > 0x80000000u || is_nan(x), std::numeric_limits<float>::quiet_NaN(), r);
+		}
+	}// namespace detail
+
+	//-----------------------------Packet functions-----------------------------
+	// Valid for |x| <= 8192.
+	template<precision P = precision::accurate, size_t N>
+	constexpr sincos_result<N> sincos(const vec<float, N>& x)
+	{
+		sincos_result<N> res;
+		for (size_t i = 0; i < N; i++)
+			detail::sincos_lane<P>(x[i], res.sin[i], res.cos[i]);
+		return res;
+	}
+	template<precision P = precision::accurate, size_t N>
+	constexpr vec<float, N> sin(const vec<float, N>& x)
+	{
+		return sincos<P>(x).sin;
+	}
+	template<precision P = precision::accurate, size_t N>
+	constexpr vec<float, N> cos(const vec<float, N>& x)
+	{
+		return sincos<P>(x).cos;
+	}
+	// Follows std::atan2 for finite inputs including signed zeros; infinite inputs are not handled.
+	template<precision P = precision::accurate, size_t N>
+	constexpr vec<float, N> atan2(const vec<float, N>& y, const vec<float, N>& x)
+	{
+		vec<float, N> res;
+		for (size_t i = 0; i < N; i++)
+			res[i] = detail::atan2_lane<P>(y[i], x[i]);
+		return res;
+	}
+	// NaN outside [-1, 1].
+	template<precision P = precision::accurate, size_t N>
+	constexpr vec<float, N> acos(const vec<float, N>& x)
+	{
+		vec<float, N> arg;
+		for (size_t i = 0; i < N; i++)
+			arg[i] = detail::acos_arg(x[i]);
+		const vec<float, N> root = sqrt(arg);
+		vec<float, N> res;
+		for (size_t i = 0; i < N; i++)
+			res[i] = detail::acos_lane<P>(x[i], root[i]);
+		return res;
+	}
+	// Overflows to inf above 88.72 and flushes to 0 below -103.9, like std::exp.
+	template<precision P = precision::accurate, size_t N>
+	constexpr vec<float, N> exp(const vec<float, N>& x)
+	{
+		vec<float, N> res;
+		for (size_t i = 0; i < N; i++)
+			res[i] = detail::exp_lane<P>(x[i]);
+		return res;
+	}
+	// Handles denormals, 0 (-inf), inf and negative inputs (NaN) like std::log.
+	template<precision P = precision::accurate, size_t N>
+	constexpr vec<float, N> log(const vec<float, N>& x)
+	{
+		vec<float, N> res;
+		for (size_t i = 0; i < N; i++)
+			res[i] = detail::log_lane<P>(x[i]);
+		return res;
+	}
+	// exp(y * log(x)) for x >= 0; pow(x, 0) is 1. The error grows with |y * log(x)|,
+	// the table figure is for results within [1e-30, 1e30].
+	template<precision P = precision::accurate, size_t N>
+	constexpr vec<float, N> pow(const vec<float, N>& x, const vec<float, N>& y)
+	{
+		vec<float, N> res = exp<P>(y * log<P>(x));
+		for (size_t i = 0; i < N; i++)
+			res[i] = detail::blend((std::bit_cast<uint32_t>(y[i]) & 0x7fffffffu) == 0u, 1.0f, res[i]);
+		return res;
+	}
+
+}// namespace mafs
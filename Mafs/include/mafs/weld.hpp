@@ -0,0 +1,151 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "parallel.hpp"
+#include "spatial_hash.hpp"
+
+namespace mafs
+{
+	// A per-vertex attribute that must also match for two vertices to weld: `components` floats
+	// per vertex, each within `tolerance` of the other vertex's.
+	struct weld_attribute
+	{
+		std::span<const float> values;
+		size_t components = 1;
+		float tolerance = 0.0f;
+	};
+
+	// Welds vertices whose positions lie within a tolerance of each other, such as the copies an
+	// importer makes of every vertex for every triangle. build() hashes the positions into a
+	// spatial_hash_grid with cells of the tolerance, so a vertex's candidates sit in the at most
+	// 8 cells its tolerance box touches. Every vertex then joins the lowest-index vertex within
+	// tolerance whose attributes match, itself if there is none, and follows those links to the
+	// vertex that links to itself. Each step is parallel over the vertices and reads only what
+	// the previous one wrote, so the result does not depend on the thread count.
+	//
+	// Links chain: with a tolerance of 1, points at 0, 0.8 and 1.6 in that order become one
+	// vertex. Welded vertices keep the position of their lowest-index member.
+	class vertex_weld
+	{
+	public:
+		//-----------------------------Functions-----------------------------
+		// Welded vertex count.
+		size_t size() const { return unique.size(); }
+
+		// tolerance 0 welds equal positions only.
+		void build(std::span<const vec3f> positions, float tolerance, std::span<const weld_attribute> attributes = {}, size_t threads = hardware_threads())
+		{
+			assert(tolerance >= 0.0f && "Tolerance must not be negative");
+			assert(std::all_of(attributes.begin(), attributes.end(), [&](const weld_attribute& a) { return a.components > 0 && a.values.size() == positions.size() * a.components; })
+				&& "Attributes need `components` values per vertex");
+			const size_t n = positions.size();
+			// Cells below 2^-10 only make the grid sparser without excluding more candidates.
+			// Cell coordinates must also fit an int, so cells grow with the farthest coordinate;
+			// at 2^-29 of it they are still finer than the float spacing out there.
+			const size_t chunks = std::max<size_t>(1, std::min(threads, n / 16384));
+			std::vector<float> chunk_reach(chunks, 0.0f);
+			parallel_for(chunks, [&](size_t first, size_t last)
+			{
+				for (size_t c = first; c < last; c++)
+					for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; i++)
+						chunk_reach[c] = std::max({ chunk_reach[c], std::abs(positions[i].x), std::abs(positions[i].y), std::abs(positions[i].z) });
+			}, 1, threads);
+			const float reach = *std::max_element(chunk_reach.begin(), chunk_reach.end());
+			const float cell = std::max({ tolerance, 1.0f / 1024.0f, reach * 0x1p-29f });
+			if (grid.cell_size != cell || grid.table_size() < n)
+				grid = spatial_hash_grid(cell, n);
+			grid.build(positions, threads);
+
+			link.resize(n);
+			parallel_for(n, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					uint32_t first = uint32_t(i);
+					grid.for_each_neighbor(positions[i], tolerance, [&](uint32_t slot, float)
+					{
+						const uint32_t j = grid.indices[slot];
+						if (j < first && attributes_match(attributes, i, j))
+							first = j;
+					});
+					link[i] = first;
+				}
+			}, 256, threads);
+
+			// Vertices that link to themselves are numbered in input order by a prefix sum.
+			ids.resize(n + 1);
+			parallel_for(n, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					ids[i] = link[i] == i ? 1 : 0;
+			}, 4096, threads);
+			ids[n] = 0;
+			parallel_exclusive_scan(std::span<uint32_t>(ids), threads);
+
+			remap.resize(n);
+			unique.resize(ids[n]);
+			parallel_for(n, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					// Links only point to lower indices, so this ends.
+					uint32_t root = uint32_t(i);
+					while (link[root] != root)
+						root = link[root];
+					remap[i] = ids[root];
+					if (root == i)
+						unique[ids[i]] = uint32_t(i);
+				}
+			}, 4096, threads);
+		}
+
+		// out[k] = in[unique[k]]: positions, or any other per-vertex stream, of the welded vertices.
+		template<typename T>
+		void gather(std::span<const T> in, std::span<T> out, size_t threads = hardware_threads()) const
+		{
+			assert(out.size() == unique.size() && "Needs one output per welded vertex");
+			parallel_for(unique.size(), [&](size_t begin, size_t end)
+			{
+				for (size_t k = begin; k < end; k++)
+					out[k] = in[unique[k]];
+			}, 4096, threads);
+		}
+		// Rewrites an index buffer over the input vertices to index the welded vertices.
+		void remap_indices(std::span<uint32_t> indices, size_t threads = hardware_threads()) const
+		{
+			parallel_for(indices.size(), [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					assert(indices[i] < remap.size() && "Index out of range");
+					indices[i] = remap[indices[i]];
+				}
+			}, 4096, threads);
+		}
+
+		//-----------------------------Public Variables -----------------------------
+		// The welded vertex of each input vertex.
+		std::vector<uint32_t> remap;
+		// The input vertex each welded vertex keeps, ascending.
+		std::vector<uint32_t> unique;
+
+	private:
+		static bool attributes_match(std::span<const weld_attribute> attributes, size_t i, size_t j)
+		{
+			for (const weld_attribute& a : attributes)
+				for (size_t c = 0; c < a.components; c++)
+					if (!(std::abs(a.values[i * a.components + c] - a.values[j * a.components + c]) <= a.tolerance))
+						return false;
+			return true;
+		}
+
+		// Build scratch, kept so that a rebuild does not allocate.
+		spatial_hash_grid grid;
+		std::vector<uint32_t> link;
+		std::vector<uint32_t> ids;
+	};
+
+}// namespace mafs
@@ -0,0 +1,165 @@
+#include "../include/mafs/aabb.hpp"
+#include "../include/mafs/transform.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T, size_t N>
+    bool approx_equal(const mafs::vec<T, N>& a, const mafs::vec<T, N>& b, T eps = T(1e-4)) {
+        for (size_t i = 0; i < N; i++)
+            if (!approx_equal(a[i], b[i], eps)) return false;
+        return true;
+    }
+
+    std::vector<mafs::aabb3f> random_boxes(size_t count, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> pos(-10.0f, 10.0f), size(0.1f, 3.0f);
+        std::vector<mafs::aabb3f> res(count);
+        for (mafs::aabb3f& b : res)
+            b = mafs::aabb3f::from_center_extents(mafs::vec3f{ pos(rng), pos(rng), pos(rng) }, mafs::vec3f{ size(rng), size(rng), size(rng) });
+        return res;
+    }
+
+    void test_basics() {
+        const mafs::aabb3f empty;
+        assert_true(empty.is_empty() && empty.volume() == 0.0f && empty.surface_area() == 0.0f, "default box is empty");
+
+        const mafs::aabb3f a(mafs::vec3f{ 0.0f, 0.0f, 0.0f }, mafs::vec3f{ 1.0f, 2.0f, 3.0f });
+        assert_true(!a.is_empty() && approx_equal(a.center(), mafs::vec3f{ 0.5f, 1.0f, 1.5f }), "center");
+        assert_true(approx_equal(a.surface_area(), 22.0f) && approx_equal(a.volume(), 6.0f), "surface area and volume");
+        assert_true(empty.merge(a) == a, "merge into empty");
+
+        const mafs::aabb3f b = a.merge(mafs::vec3f{ -1.0f, 5.0f, 1.0f });
+        assert_true(b.min == mafs::vec3f{ -1.0f, 0.0f, 0.0f } && b.max == mafs::vec3f{ 1.0f, 5.0f, 3.0f }, "merge point");
+        assert_true(a.expand(0.5f) == mafs::aabb3f(mafs::vec3f(-0.5f), mafs::vec3f{ 1.5f, 2.5f, 3.5f }), "expand");
+
+        const std::vector<mafs::vec3f> points{ { 1.0f, 2.0f, 3.0f }, { -1.0f, 0.0f, 4.0f }, { 0.0f, 5.0f, -2.0f } };
+        const mafs::aabb3f from = mafs::aabb3f::from_points(points);
+        assert_true(from.min == mafs::vec3f{ -1.0f, 0.0f, -2.0f } && from.max == mafs::vec3f{ 1.0f, 5.0f, 4.0f }, "from_points");
+
+        assert_true(a.contains(mafs::vec3f{ 1.0f, 2.0f, 3.0f }) && !a.contains(mafs::vec3f{ 1.1f, 0.0f, 0.0f }), "contains point (closed)");
+        assert_true(b.contains(a) && !a.contains(b), "contains box");
+        assert_true(a.overlaps(mafs::aabb3f(mafs::vec3f(1.0f), mafs::vec3f(4.0f))) && !a.overlaps(mafs::aabb3f(mafs::vec3f(1.5f), mafs::vec3f(4.0f))), "overlaps");
+        assert_true(!a.overlaps(empty) && !empty.overlaps(a), "nothing overlaps the empty box");
+        assert_true(a.distance_squared(mafs::vec3f(0.5f)) == 0.0f && a.distance_squared(mafs::vec3f{ -1.0f, 0.0f, 5.0f }) == 1.0f + 4.0f, "distance to a point");
+        assert_true(empty.distance_squared(mafs::vec3f(0.0f)) == std::numeric_limits<float>::infinity(), "distance to the empty box");
+
+        const mafs::aabb2f rect(mafs::vec<float, 2>{ 0.0f, 0.0f }, mafs::vec<float, 2>{ 2.0f, 3.0f });
+        assert_true(approx_equal(rect.volume(), 6.0f), "aabb2f area");
+    }
+
+    void test_transform() {
+        const mafs::aabb3f box(mafs::vec3f{ -1.0f, 0.0f, 2.0f }, mafs::vec3f{ 2.0f, 1.0f, 3.0f });
+        const mafs::quatf r = mafs::quatf::from_axis_angle(mafs::vec3f{ 1.0f, 2.0f, 3.0f }.normalize(), 0.7f);
+        const mafs::mat4f m = mafs::compose_trs(mafs::vec3f{ 5.0f, -2.0f, 1.0f }, r, mafs::vec3f{ 2.0f, -1.0f, 0.5f });
+        const mafs::aabb3f fast = box.transform(m);
+
+        // Reference: the box around the eight transformed corners.
+        mafs::aabb3f slow;
+        for (int c = 0; c < 8; c++) {
+            const mafs::vec4f corner{ (c & 1) ? box.max.x : box.min.x, (c & 2) ? box.max.y : box.min.y, (c & 4) ? box.max.z : box.min.z, 1.0f };
+            slow = slow.merge((m * corner).xyz());
+        }
+        assert_true(approx_equal(fast.min, slow.min) && approx_equal(fast.max, slow.max), "Arvo transform matches corners");
+        assert_true(mafs::aabb3f().transform(m).is_empty(), "empty box stays empty");
+    }
+
+    void test_ray() {
+        const mafs::aabb3f box(mafs::vec3f(-1.0f), mafs::vec3f(1.0f));
+        float t = 0.0f;
+        assert_true(box.intersect(mafs::rayf(mafs::vec3f{ -5.0f, 0.0f, 0.0f }, mafs::vec3f{ 1.0f, 0.0f, 0.0f }), 100.0f, t) && approx_equal(t, 4.0f), "hit with entry distance");
+        assert_true(!box.intersects(mafs::rayf(mafs::vec3f{ -5.0f, 0.0f, 0.0f }, mafs::vec3f{ 1.0f, 0.0f, 0.0f }), 3.0f), "t_max cuts the ray short");
+        assert_true(!box.intersects(mafs::rayf(mafs::vec3f{ -5.0f, 0.0f, 0.0f }, mafs::vec3f{ -1.0f, 0.0f, 0.0f })), "box behind the ray");
+        assert_true(box.intersect(mafs::rayf(mafs::vec3f(0.5f), mafs::vec3f{ 0.3f, -0.2f, 1.0f }), 100.0f, t) && t == 0.0f, "origin inside");
+        assert_true(!box.intersects(mafs::rayf(mafs::vec3f{ -5.0f, 2.0f, 0.0f }, mafs::vec3f{ 1.0f, 0.0f, 0.0f })), "parallel miss");
+        assert_true(box.intersects(mafs::rayf(mafs::vec3f{ -5.0f, 1.0f, 0.0f }, mafs::vec3f{ 1.0f, 0.0f, 0.0f })), "ray along a face");
+        assert_true(box.intersects(mafs::rayf(mafs::vec3f{ -5.0f, -5.0f, -5.0f }, mafs::vec3f{ -1.0f, -1.0f, -1.0f } * -1.0f)), "diagonal hit");
+        assert_true(!mafs::aabb3f().intersects(mafs::rayf(mafs::vec3f(0.0f), mafs::vec3f{ 1.0f, 0.0f, 0.0f })), "empty box is never hit");
+    }
+
+    template<size_t W>
+    void check_packets(const std::string& name) {
+        const std::vector<mafs::aabb3f> boxes = random_boxes(W * 37 + 3, 7);
+        const std::vector<mafs::aabb_packet<W>> packets = mafs::pack_aabbs<W>(std::span<const mafs::aabb3f>(boxes));
+        assert_true(packets.size() == 38 && packets[5].get(2) == boxes[5 * W + 2], name + " packing");
+
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> pos(-15.0f, 15.0f);
+        std::normal_distribution<float> dir;
+        std::vector<uint32_t> masks(packets.size());
+        bool rays_match = true, entries_match = true, boxes_match = true;
+        size_t hits = 0;
+        for (int q = 0; q < 64; q++) {
+            mafs::vec3f d{ dir(rng), dir(rng), dir(rng) };
+            if (q % 8 == 0)
+                d[q % 3] = 0.0f;
+            const mafs::rayf r(mafs::vec3f{ pos(rng), pos(rng), pos(rng) }, d);
+            mafs::intersect(std::span<const mafs::aabb_packet<W>>(packets), r, 20.0f, std::span(masks));
+            for (size_t i = 0; i < boxes.size(); i++) {
+                const bool hit = (masks[i / W] >> (i % W)) & 1u;
+                float t = 0.0f;
+                rays_match = rays_match && hit == boxes[i].intersect(r, 20.0f, t);
+                hits += hit;
+            }
+            for (size_t p = 0; p < packets.size(); p++) {
+                mafs::vec<float, W> t_entry;
+                const uint32_t mask = mafs::intersect(packets[p], r, 20.0f, t_entry);
+                for (size_t l = 0; l < W && p * W + l < boxes.size(); l++) {
+                    float t = 0.0f;
+                    if ((mask >> l) & 1u && boxes[p * W + l].intersect(r, 20.0f, t))
+                        entries_match = entries_match && t == t_entry[l];
+                }
+                // Unused lanes never report a hit.
+                rays_match = rays_match && (p + 1 < packets.size() || (mask >> (boxes.size() - p * W)) == 0);
+            }
+
+            const mafs::aabb3f query = random_boxes(1, q)[0];
+            mafs::overlaps(std::span<const mafs::aabb_packet<W>>(packets), query, std::span(masks));
+            for (size_t i = 0; i < boxes.size(); i++)
+                boxes_match = boxes_match && bool((masks[i / W] >> (i % W)) & 1u) == boxes[i].overlaps(query);
+            boxes_match = boxes_match && (masks.back() >> (boxes.size() % W)) == 0;
+        }
+        assert_true(rays_match && hits > 0, name + " ray masks match the scalar test");
+        assert_true(entries_match, name + " entry distances match");
+        assert_true(boxes_match, name + " overlap masks match the scalar test");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing aabb basics..." << std::endl;
+    mafs::test::test_basics();
+
+    std::cout << "\nTesting aabb transform..." << std::endl;
+    mafs::test::test_transform();
+
+    std::cout << "\nTesting ray-box slab test..." << std::endl;
+    mafs::test::test_ray();
+
+    std::cout << "\nTesting aabb packets..." << std::endl;
+    mafs::test::check_packets<4>("aabb_packet<4>");
+    mafs::test::check_packets<8>("aabb_packet<8>");
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "../include/mafs/animation.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T, size_t N>
+    bool approx_equal(const mafs::vec<T, N>& a, const mafs::vec<T, N>& b, T eps = T(1e-4)) {
+        for (size_t i = 0; i < N; i++)
+            if (!approx_equal(a[i], b[i], eps)) return false;
+        return true;
+    }
+
+    bool same_rotation(const mafs::quatf& a, const mafs::quatf& b, float eps = 1e-4f) {
+        return approx_equal(std::abs(a.dot(b)), 1.0f, eps);
+    }
+
+    void test_vec3_linear() {
+        mafs::vec3_tracks tracks;
+        const float times[] = { 0.0f, 1.0f, 3.0f };
+        const mafs::vec3f values[] = { {0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 3.0f}, {3.0f, 2.0f, 1.0f} };
+        const float single_time[] = { 0.5f };
+        const mafs::vec3f single_value[] = { {7.0f, 8.0f, 9.0f} };
+        // More tracks than one packet, so the partial last packet is exercised too.
+        for (int i = 0; i < 11; i++)
+            tracks.add(times, values);
+        size_t single = tracks.add(single_time, single_value);
+        std::vector<mafs::vec3f> out(tracks.size());
+
+        tracks.sample(0.5f, std::span(out));
+        assert_true(approx_equal(out[0], mafs::vec3f{ 0.5f, 1.0f, 1.5f }) && approx_equal(out[10], out[0]), "linear sample inside first segment");
+        tracks.sample(2.0f, std::span(out));
+        assert_true(approx_equal(out[3], mafs::vec3f{ 2.0f, 2.0f, 2.0f }), "linear sample inside second segment");
+        tracks.sample(5.0f, std::span(out));
+        assert_true(approx_equal(out[0], values[2]), "sample after last key clamps");
+        tracks.sample(-1.0f, std::span(out));
+        assert_true(approx_equal(out[0], values[0]), "sample before first key clamps after seeking back");
+        assert_true(approx_equal(out[single], single_value[0]), "single-key track is constant");
+    }
+
+    void test_vec3_hermite() {
+        // p(t) = t^3 sampled with exact tangents 3t^2 is reproduced exactly by cubic Hermite.
+        std::vector<float> times;
+        std::vector<mafs::vec3f> values, tangents;
+        for (int k = 0; k <= 4; k++) {
+            float t = float(k) * 0.5f;
+            times.push_back(t);
+            values.push_back(mafs::vec3f{ t * t * t, t, 1.0f });
+            tangents.push_back(mafs::vec3f{ 3.0f * t * t, 1.0f, 0.0f });
+        }
+        mafs::vec3_tracks tracks(mafs::interpolation::hermite);
+        tracks.add(times, values, tangents, tangents);
+        std::vector<mafs::vec3f> out(1);
+        bool ok = true;
+        for (float t = 0.0f; t <= 2.0f; t += 0.05f) {
+            tracks.sample(t, std::span(out));
+            ok = ok && approx_equal(out[0], mafs::vec3f{ t * t * t, t, 1.0f }, 1e-4f);
+        }
+        assert_true(ok, "hermite reproduces a cubic");
+    }
+
+    void test_quat_tracks() {
+        const mafs::vec3f axis{ 0.0f, 1.0f, 0.0f };
+        const float times[] = { 0.0f, 1.0f, 2.0f };
+        const mafs::quatf keys[] = { mafs::quatf::identity(), mafs::quatf::from_axis_angle(axis, 1.5f), -mafs::quatf::from_axis_angle(axis, 2.5f) };
+
+        mafs::quat_tracks slerp_tracks(mafs::quat_interpolation::slerp), nlerp_tracks;
+        for (int i = 0; i < 9; i++) {
+            slerp_tracks.add(times, keys);
+            nlerp_tracks.add(times, keys);
+        }
+        std::vector<mafs::quatf> out(9), ref(9);
+        bool ok = true;
+        for (float t = 0.0f; t <= 2.0f; t += 0.125f) {
+            slerp_tracks.sample(t, std::span(out));
+            const mafs::quatf expected = mafs::quatf::from_axis_angle(axis, t <= 1.0f ? 1.5f * t : 1.5f + (t - 1.0f));
+            ok = ok && same_rotation(out[0], expected) && same_rotation(out[8], expected);
+        }
+        assert_true(ok, "slerp tracks have constant angular velocity and take the shorter arc");
+
+        ok = true;
+        for (float t = 0.0f; t <= 2.0f; t += 0.125f) {
+            nlerp_tracks.sample(t, std::span(out));
+            const int k = std::min(int(t), 1);
+            ok = ok && same_rotation(out[4], mafs::nlerp(keys[k], keys[k + 1], t - float(k)));
+        }
+        assert_true(ok, "nlerp tracks match scalar nlerp");
+    }
+
+    void test_blend() {
+        std::vector<mafs::vec3f> a{ {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f} }, b{ {2.0f, 4.0f, 6.0f}, {1.0f, 1.0f, 1.0f} }, out(2);
+        mafs::blend_poses(std::span<const mafs::vec3f>(a), std::span<const mafs::vec3f>(b), 0.25f, std::span(out));
+        assert_true(approx_equal(out[0], mafs::vec3f{ 0.5f, 1.0f, 1.5f }) && approx_equal(out[1], a[1]), "blend vec3 poses");
+
+        std::mt19937 rng(1);
+        std::normal_distribution<float> dist;
+        const size_t count = 13;
+        std::vector<mafs::quatf> qa(count), qb(count), qout(count);
+        for (size_t i = 0; i < count; i++) {
+            qa[i] = mafs::quatf(dist(rng), dist(rng), dist(rng), dist(rng)).normalize();
+            qb[i] = mafs::quatf(dist(rng), dist(rng), dist(rng), dist(rng)).normalize();
+        }
+        mafs::blend_poses(std::span<const mafs::quatf>(qa), std::span<const mafs::quatf>(qb), 0.3f, std::span(qout));
+        bool ok = true;
+        for (size_t i = 0; i < count; i++)
+            ok = ok && same_rotation(qout[i], mafs::nlerp(qa[i], qb[i], 0.3f));
+        assert_true(ok, "blend quaternion poses");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing linear vec3 tracks..." << std::endl;
+    mafs::test::test_vec3_linear();
+
+    std::cout << "\nTesting Hermite vec3 tracks..." << std::endl;
+    mafs::test::test_vec3_hermite();
+
+    std::cout << "\nTesting quaternion tracks..." << std::endl;
+    mafs::test::test_quat_tracks();
+
+    std::cout << "\nTesting pose blending..." << std::endl;
+    mafs::test::test_blend();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include "../include/mafs/bvh.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    struct mesh {
+        std::vector<mafs::vec3f> positions;
+        std::vector<uint32_t> indices;
+        size_t size() const { return indices.size() / 3; }
+    };
+
+    // Small random triangles scattered through a cube, plus a wavy sheet so some leaves are dense.
+    mesh make_mesh(size_t scattered, size_t grid) {
+        mesh m;
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> pos(-10.0f, 10.0f), offset(-0.8f, 0.8f);
+        for (size_t i = 0; i < scattered; i++) {
+            const mafs::vec3f c{ pos(rng), pos(rng), pos(rng) };
+            for (int k = 0; k < 3; k++) {
+                m.indices.push_back(uint32_t(m.positions.size()));
+                m.positions.push_back(c + mafs::vec3f{ offset(rng), offset(rng), offset(rng) });
+            }
+        }
+        const uint32_t base = uint32_t(m.positions.size());
+        for (size_t z = 0; z <= grid; z++)
+            for (size_t x = 0; x <= grid; x++) {
+                const float fx = -10.0f + 20.0f * float(x) / float(grid), fz = -10.0f + 20.0f * float(z) / float(grid);
+                m.positions.push_back(mafs::vec3f{ fx, std::sin(fx) * std::cos(fz), fz });
+            }
+        for (uint32_t z = 0; z < grid; z++)
+            for (uint32_t x = 0; x < grid; x++) {
+                const uint32_t i = base + z * uint32_t(grid + 1) + x;
+                m.indices.insert(m.indices.end(), { i, i + 1, i + uint32_t(grid) + 1, i + 1, i + uint32_t(grid) + 2, i + uint32_t(grid) + 1 });
+            }
+        return m;
+    }
+
+    mafs::bvh_hit brute_force(const mesh& m, const mafs::rayf& r, float t_max) {
+        mafs::bvh_hit hit;
+        hit.t = t_max;
+        for (uint32_t i = 0; i < m.size(); i++) {
+            mafs::triangle_hit<float> th;
+            if (mafs::intersect_triangle(r, m.positions[m.indices[3 * i]], m.positions[m.indices[3 * i + 1]], m.positions[m.indices[3 * i + 2]], hit.t, th)) {
+                hit.t = th.t;
+                hit.u = th.u;
+                hit.v = th.v;
+                hit.triangle = i;
+            }
+        }
+        return hit;
+    }
+
+    std::vector<mafs::rayf> make_rays(size_t count) {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> pos(-15.0f, 15.0f), dir(-1.0f, 1.0f);
+        std::vector<mafs::rayf> rays;
+        for (size_t i = 0; i < count; i++)
+            rays.emplace_back(mafs::vec3f{ pos(rng), pos(rng), pos(rng) }, mafs::vec3f{ dir(rng), dir(rng), dir(rng) }.normalize());
+        // Axis-aligned rays have infinite inverse components.
+        rays.emplace_back(mafs::vec3f{ 0.3f, 20.0f, 0.7f }, mafs::vec3f{ 0.0f, -1.0f, 0.0f });
+        rays.emplace_back(mafs::vec3f{ -20.0f, 0.1f, 0.2f }, mafs::vec3f{ 1.0f, 0.0f, 0.0f });
+        return rays;
+    }
+
+    // Distances can differ in the last bits between the edge and vertex forms, and triangles that
+    // share an edge can both claim the hit, so hits are compared by distance only.
+    bool same_hit(const mafs::bvh_hit& a, const mafs::bvh_hit& b) {
+        if (bool(a) != bool(b))
+            return false;
+        return !a || approx_equal(a.t, b.t, 1e-3f);
+    }
+
+    void check_tree(const mafs::bvh& tree, size_t triangles, const std::string& name) {
+        bool bounded = true, leaves_ok = true;
+        std::vector<int> seen(triangles, 0);
+        for (const mafs::bvh_node& n : tree.nodes) {
+            if (n.is_leaf()) {
+                leaves_ok = leaves_ok && n.first + n.count <= tree.triangles.size();
+                for (uint32_t i = n.first; i < n.first + n.count; i++) {
+                    seen[tree.triangle_ids[i]]++;
+                    const mafs::bvh_triangle& t = tree.triangles[i];
+                    // v0 + e1 rounds, so it may land just outside the box of the original vertex.
+                    const mafs::aabb3f b = n.bounds.expand(1e-5f);
+                    bounded = bounded && b.contains(t.v0) && b.contains(t.v0 + t.e1) && b.contains(t.v0 + t.e2);
+                }
+            }
+            else
+                for (uint32_t c = n.first; c < n.first + 2; c++)
+                    bounded = bounded && n.bounds.contains(tree.nodes[c].bounds);
+        }
+        bool once = true;
+        for (int s : seen)
+            once = once && s == 1;
+        assert_true(once && leaves_ok, name + " every triangle in exactly one leaf");
+        assert_true(bounded, name + " boxes contain their children");
+        assert_true(tree.nodes.size() <= 2 * triangles - 1, name + " node count");
+    }
+
+    template<typename Tree>
+    void check_queries(const Tree& tree, const mesh& m, const std::vector<mafs::rayf>& rays, const std::string& name) {
+        bool closest = true, any = true, limited = true;
+        size_t hits = 0;
+        for (const mafs::rayf& r : rays) {
+            const mafs::bvh_hit expect = brute_force(m, r, std::numeric_limits<float>::infinity());
+            const mafs::bvh_hit got = tree.intersect(r);
+            closest = closest && same_hit(expect, got);
+            if (got) {
+                hits++;
+                const uint32_t* tri = &m.indices[3 * got.triangle];
+                const mafs::vec3f p = m.positions[tri[0]] * (1.0f - got.u - got.v) + m.positions[tri[1]] * got.u + m.positions[tri[2]] * got.v;
+                closest = closest && (p - r.at(got.t)).norm() < 1e-3f;
+            }
+            any = any && tree.occluded(r) == bool(expect);
+            // Stopping short of the closest hit must hide it.
+            if (expect) {
+                limited = limited && !tree.occluded(r, expect.t * 0.999f) && !tree.intersect(r, expect.t * 0.999f);
+                limited = limited && same_hit(expect, tree.intersect(r, expect.t * 1.001f));
+            }
+        }
+        assert_true(closest && hits > rays.size() / 4, name + " closest hit matches brute force");
+        assert_true(any, name + " any hit matches brute force");
+        assert_true(limited, name + " t_max is respected");
+    }
+
+    void test_build() {
+        assert_true(sizeof(mafs::bvh_node) == 32, "node is 32 bytes");
+        const mesh m = make_mesh(3000, 40);
+        mafs::bvh_build_options options;
+        options.threads = 1;
+        check_tree(mafs::bvh::build(m.positions, m.indices, options), m.size(), "single-threaded");
+        options.threads = 4;
+        check_tree(mafs::bvh::build(m.positions, m.indices, options), m.size(), "4 threads");
+        // Large enough for the root to be binned on several threads.
+        const mesh big = make_mesh(2000, 190);
+        const mafs::bvh big_tree = mafs::bvh::build(big.positions, big.indices, options);
+        check_tree(big_tree, big.size(), "parallel binning");
+        check_queries(big_tree, big, make_rays(40), "parallel binning");
+        options.max_leaf_size = 1;
+        const mafs::bvh single = mafs::bvh::build(m.positions, m.indices, options);
+        bool small = true;
+        for (const mafs::bvh_node& n : single.nodes)
+            small = small && (!n.is_leaf() || n.count == 1);
+        assert_true(small, "max_leaf_size = 1");
+
+        // Identical triangles cannot be separated by the SAH and fall back to median splits.
+        mesh same;
+        same.positions = { mafs::vec3f{ 0.0f, 0.0f, 0.0f }, mafs::vec3f{ 1.0f, 0.0f, 0.0f }, mafs::vec3f{ 0.0f, 1.0f, 0.0f } };
+        for (int i = 0; i < 100; i++)
+            same.indices.insert(same.indices.end(), { 0, 1, 2 });
+        const mafs::bvh stacked = mafs::bvh::build(same.positions, same.indices);
+        check_tree(stacked, 100, "coincident triangles");
+        const mafs::bvh_hit hit = stacked.intersect(mafs::rayf(mafs::vec3f{ 0.25f, 0.25f, 1.0f }, mafs::vec3f{ 0.0f, 0.0f, -1.0f }));
+        assert_true(hit && approx_equal(hit.t, 1.0f) && approx_equal(hit.u, 0.25f) && approx_equal(hit.v, 0.25f), "hit on coincident triangles");
+
+        const mafs::bvh empty = mafs::bvh::build(std::span<const mafs::vec3f>(), std::span<const uint32_t>());
+        const mafs::rayf r(mafs::vec3f(0.0f), mafs::vec3f{ 1.0f, 0.0f, 0.0f });
+        assert_true(empty.nodes.empty() && !empty.intersect(r) && !empty.occluded(r), "empty mesh");
+    }
+
+    void test_queries() {
+        const mesh m = make_mesh(3000, 40);
+        const std::vector<mafs::rayf> rays = make_rays(300);
+        mafs::bvh_build_options options;
+        options.threads = 1;
+        const mafs::bvh tree = mafs::bvh::build(m.positions, m.indices, options);
+        check_queries(tree, m, rays, "binary");
+        options.threads = 8;
+        check_queries(mafs::bvh::build(m.positions, m.indices, options), m, rays, "binary, 8 threads");
+        options.bins = 4;
+        options.max_leaf_size = 2;
+        check_queries(mafs::bvh::build(m.positions, m.indices, options), m, rays, "binary, 4 bins");
+
+        const mafs::bvh4 tree4 = mafs::bvh4::from_bvh(tree);
+        const mafs::bvh8 tree8 = mafs::bvh8::from_bvh(tree);
+        assert_true(tree4.nodes.size() < tree.nodes.size() / 2 && tree8.nodes.size() < tree4.nodes.size(), "wide trees have fewer nodes");
+        check_queries(tree4, m, rays, "bvh4");
+        check_queries(tree8, m, rays, "bvh8");
+
+        // A single-leaf tree still collapses to one wide node.
+        mesh one;
+        one.positions = { mafs::vec3f{ 0.0f, 0.0f, 0.0f }, mafs::vec3f{ 1.0f, 0.0f, 0.0f }, mafs::vec3f{ 0.0f, 1.0f, 0.0f } };
+        one.indices = { 0, 1, 2 };
+        const mafs::bvh8 leaf = mafs::bvh8::from_bvh(mafs::bvh::build(one.positions, one.indices));
+        const mafs::rayf down(mafs::vec3f{ 0.2f, 0.2f, 1.0f }, mafs::vec3f{ 0.0f, 0.0f, -1.0f });
+        assert_true(leaf.nodes.size() == 1 && leaf.intersect(down) && leaf.occluded(down), "single leaf");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing bvh build..." << std::endl;
+    mafs::test::test_build();
+
+    std::cout << "\nTesting ray queries..." << std::endl;
+    mafs::test::test_queries();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
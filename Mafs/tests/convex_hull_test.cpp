@@ -0,0 +1,204 @@
+#include "../include/mafs/convex_hull.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    // Closed and consistently wound: every directed edge appears once, with its reverse.
+    template<typename T>
+    bool is_closed(const mafs::convex_hull<T>& hull) {
+        std::map<std::pair<uint32_t, uint32_t>, int> edges;
+        for (size_t t = 0; t < hull.indices.size(); t += 3)
+            for (size_t k = 0; k < 3; k++)
+                edges[{ hull.indices[t + k], hull.indices[t + (k + 1) % 3] }]++;
+        for (const auto& [e, count] : edges)
+            if (count != 1 || !edges.contains({ e.second, e.first }))
+                return false;
+        // Euler: V - E + F = 2 with E = 3F / 2.
+        const size_t faces = hull.indices.size() / 3;
+        return !hull.vertices.empty() && hull.vertices.size() + faces - edges.size() / 2 == 2;
+    }
+
+    // Every point lies below every face plane, up to tol.
+    template<typename T>
+    bool contains_all(const mafs::convex_hull<T>& hull, const std::vector<mafs::vec<T, 3>>& points, T tol) {
+        for (size_t t = 0; t < hull.indices.size(); t += 3) {
+            const mafs::vec<T, 3> a = hull.vertices[hull.indices[t]];
+            const mafs::vec<T, 3> n = (hull.vertices[hull.indices[t + 1]] - a).cross(hull.vertices[hull.indices[t + 2]] - a);
+            const T len = n.norm();
+            for (const mafs::vec<T, 3>& p : points)
+                if (n.dot(p - a) > tol * len)
+                    return false;
+        }
+        return true;
+    }
+
+    template<typename T>
+    T volume(const mafs::convex_hull<T>& hull) {
+        T v = T(0);
+        for (size_t t = 0; t < hull.indices.size(); t += 3)
+            v += hull.vertices[hull.indices[t]].dot(hull.vertices[hull.indices[t + 1]].cross(hull.vertices[hull.indices[t + 2]]));
+        return v / T(6);
+    }
+
+    void test_cube() {
+        std::mt19937 rng(71);
+        std::uniform_real_distribution<float> pos(-1.0f, 1.0f);
+        std::vector<mafs::vec3f> points(20000);
+        for (mafs::vec3f& p : points)
+            p = mafs::vec3f{ pos(rng), pos(rng), pos(rng) };
+        for (int c = 0; c < 8; c++)
+            points[size_t(c) * 997] = mafs::vec3f{ c & 1 ? 1.0f : -1.0f, c & 2 ? 1.0f : -1.0f, c & 4 ? 1.0f : -1.0f };
+        mafs::convex_hullf hull;
+        hull.build(points, 0, 1);
+        assert_true(hull.vertices.size() == 8 && hull.indices.size() == 36, "points in a cube give the cube");
+        assert_true(is_closed(hull) && std::abs(volume(hull) - 8.0f) < 1e-4f, "cube hull is closed with volume 8");
+        bool ids = true;
+        for (size_t i = 0; i < hull.vertices.size(); i++)
+            ids = ids && points[hull.vertex_ids[i]] == hull.vertices[i];
+        assert_true(ids, "vertex ids point back to the input");
+    }
+
+    void test_sphere() {
+        std::mt19937 rng(72);
+        std::normal_distribution<double> normal;
+        std::vector<mafs::vec3d> points(3000);
+        for (mafs::vec3d& p : points)
+            p = mafs::vec3d{ normal(rng), normal(rng), normal(rng) }.normalize() * 3.0 + mafs::vec3d{ 10.0, 0.0, -5.0 };
+        mafs::convex_hulld hull;
+        hull.build(points, 0, 1);
+        assert_true(hull.vertices.size() == points.size() && is_closed(hull), "every point on a sphere is a hull vertex");
+        assert_true(contains_all(hull, points, 1e-9), "the hull contains every point");
+
+        bool same = true;
+        for (size_t threads : { 2, 5 }) {
+            mafs::convex_hulld threaded;
+            threaded.build(points, 0, threads);
+            same = same && threaded.indices == hull.indices && threaded.vertex_ids == hull.vertex_ids;
+        }
+        assert_true(same, "threaded builds give the same hull");
+    }
+
+    void test_limit_and_reuse() {
+        std::mt19937 rng(73);
+        std::uniform_real_distribution<float> pos(-5.0f, 5.0f);
+        std::normal_distribution<float> normal;
+        std::vector<mafs::vec3f> blob(20000);
+        for (mafs::vec3f& p : blob)
+            p = mafs::vec3f{ normal(rng) * 2.0f, normal(rng), normal(rng) * 0.5f };
+        mafs::convex_hullf full;
+        full.build(blob);
+        assert_true(is_closed(full) && contains_all(full, blob, 1e-4f), "full hull of a gaussian blob");
+
+        // One object reused for many hulls of different sizes.
+        mafs::convex_hullf hull;
+        bool limited = true;
+        for (size_t limit : { 4, 5, 16, 40, 1000 }) {
+            hull.build(blob, limit);
+            limited = limited && hull.vertices.size() == std::min(limit, full.vertices.size()) && is_closed(hull) && contains_all(hull, hull.vertices, 1e-4f);
+            limited = limited && volume(hull) <= volume(full) && volume(hull) > 0.0f;
+        }
+        assert_true(limited, "vertex limit gives smaller closed convex hulls");
+
+        bool random_sets = true;
+        for (int t = 0; t < 50; t++) {
+            std::vector<mafs::vec3f> points(4 + size_t(t) * 7);
+            for (mafs::vec3f& p : points)
+                p = mafs::vec3f{ pos(rng), pos(rng), pos(rng) };
+            hull.build(points);
+            random_sets = random_sets && is_closed(hull) && contains_all(hull, points, 1e-4f);
+        }
+        assert_true(random_sets, "small random sets");
+    }
+
+    void test_degenerate() {
+        mafs::convex_hullf hull;
+        hull.build(std::vector<mafs::vec3f>{ { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } });
+        assert_true(hull.vertices.empty() && hull.indices.empty(), "three points give no hull");
+        std::vector<mafs::vec3f> flat;
+        for (int i = 0; i < 100; i++)
+            flat.push_back(mafs::vec3f{ float(i % 10), float(i / 10), 2.0f });
+        hull.build(flat);
+        assert_true(hull.indices.empty(), "coplanar points give no hull");
+
+        // A grid: many coplanar and collinear points on the faces, and duplicates.
+        std::vector<mafs::vec3f> grid;
+        for (int x = 0; x < 6; x++)
+            for (int y = 0; y < 6; y++)
+                for (int z = 0; z < 6; z++)
+                    for (int dup = 0; dup < 2; dup++)
+                        grid.push_back(mafs::vec3f{ float(x), float(y), float(z) * 0.5f });
+        hull.build(grid);
+        assert_true(is_closed(hull) && contains_all(hull, grid, 1e-4f) && std::abs(volume(hull) - 62.5f) < 1e-3f, "grid with coplanar faces and duplicates");
+    }
+
+    // Points on the two rim circles of a cylinder: the caps are exactly coplanar and the
+    // sides close to it, so new faces are slivers beside nearly coplanar neighbors.
+    void test_cylinder() {
+        bool cylinders = true;
+        for (unsigned seed = 0; seed < 10; seed++) {
+            std::mt19937 rng(80 + seed);
+            std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+            std::vector<mafs::vec3f> points(2000);
+            for (mafs::vec3f& p : points) {
+                const float a = angle(rng);
+                p = mafs::vec3f{ std::cos(a), std::sin(a), float(rng() & 1) };
+            }
+            mafs::convex_hullf hull;
+            hull.build(points, 0, 1);
+            cylinders = cylinders && is_closed(hull) && contains_all(hull, points, 1e-5f);
+        }
+        assert_true(cylinders, "float hulls of random cylinder rims contain every point");
+
+        std::mt19937 rng(90);
+        std::uniform_real_distribution<double> angle(0.0, 6.283185307179586);
+        std::vector<mafs::vec3d> circle(5000);
+        for (mafs::vec3d& p : circle) {
+            const double a = angle(rng);
+            p = mafs::vec3d{ std::cos(a), std::sin(a), 0.0 };
+        }
+        circle[0] = mafs::vec3d{ 0.0, 0.0, 1.0 };
+        circle[1] = mafs::vec3d{ 0.0, 0.0, -1.0 };
+        mafs::convex_hulld hull;
+        hull.build(circle, 0, 1);
+        assert_true(is_closed(hull) && contains_all(hull, circle, 1e-9), "cocircular points under two apexes");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing convex hull of a cube..." << std::endl;
+    mafs::test::test_cube();
+
+    std::cout << "\nTesting convex hull of a sphere..." << std::endl;
+    mafs::test::test_sphere();
+
+    std::cout << "\nTesting vertex limit and reuse..." << std::endl;
+    mafs::test::test_limit_and_reuse();
+
+    std::cout << "\nTesting degenerate inputs..." << std::endl;
+    mafs::test::test_degenerate();
+
+    std::cout << "\nTesting nearly degenerate inputs..." << std::endl;
+    mafs::test::test_cylinder();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
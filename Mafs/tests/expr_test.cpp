@@ -0,0 +1,79 @@
+#include "../include/mafs/expr.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T, size_t N>
+    bool approx_equal(const mafs::vec<T, N>& a, const mafs::vec<T, N>& b, T eps = T(1e-4)) {
+        for (size_t i = 0; i < N; i++)
+            if (!approx_equal(a[i], b[i], eps)) return false;
+        return true;
+    }
+
+    constexpr mafs::mat4 flip_y{ {1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f} };
+    constexpr mafs::mat4 scale2 = mafs::mat4(2.0f);
+
+    void test_chain() {
+        mafs::mat4 proj = mafs::perspective(1.0f, 1.3f, 0.1f, 100.0f);
+        mafs::mat4 view = mafs::look_at(mafs::vec3f{ 1.0f, 2.0f, 3.0f }, mafs::vec3f{ 0.0f }, mafs::vec3f{ 0.0f, 1.0f, 0.0f });
+        mafs::mat4 model = mafs::mat4(3.0f);
+        model[3] = mafs::vec4f{ 0.5f, -1.0f, 2.0f, 1.0f };
+        mafs::vec4f v{ 0.2f, 0.4f, -0.6f, 1.0f };
+
+        mafs::vec4f eager = proj * view * model * v;
+        mafs::vec4f lazy = mafs::chain(proj) * view * model * v;
+        assert_true(approx_equal(eager, lazy), "chain * vec matches eager product");
+
+        mafs::mat4 pvm = mafs::chain(proj) * view * model;
+        assert_true(approx_equal(pvm * v, eager), "chain converts to mat");
+
+        mafs::mat<float, 2, 3> a{ {1.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f} };
+        mafs::mat<float, 3, 4> b(1.0f);
+        mafs::vec<float, 2> r = mafs::chain(a) * b * mafs::vec4f{ 1.0f, 2.0f, 3.0f, 4.0f };
+        assert_true(approx_equal(r.x, 4.0f) && approx_equal(r.y, 5.0f), "chain of non-square factors");
+    }
+
+    void test_fixed_factors() {
+        mafs::mat4 proj = mafs::perspective(1.0f, 1.3f, 0.1f, 100.0f);
+        mafs::vec4f v{ 0.2f, 0.4f, -0.6f, 1.0f };
+
+        auto c = mafs::chain(proj) * mafs::fixed<flip_y> * mafs::fixed<scale2>;
+        assert_true(c.size() == 2, "adjacent fixed factors are fused");
+        assert_true(approx_equal(c * v, proj * (flip_y * (scale2 * v))), "fused chain * vec");
+
+        constexpr mafs::mat4 folded = mafs::chain(mafs::fixed<flip_y>) * mafs::fixed<scale2>;
+        static_assert(folded[1][1] == -2.0f && folded[3][3] == 2.0f, "fixed chain folds at compile time");
+        const mafs::mat4 product = mafs::chain(mafs::fixed<flip_y>) * mafs::fixed<scale2>;
+        assert_true(product == folded, "fixed chain gives the same product at run time");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing mat_chain..." << std::endl;
+    mafs::test::test_chain();
+
+    std::cout << "\nTesting fixed factors..." << std::endl;
+    mafs::test::test_fixed_factors();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "../include/mafs/frustum.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    // Clip-space reference; margin keeps points off the boundary.
+    bool clip_inside(const mafs::mat4f& m, const mafs::vec3f& p, mafs::clip_depth depth, float margin) {
+        const mafs::vec4f c = m * mafs::vec4f{ p.x, p.y, p.z, 1.0f };
+        const float near_bound = depth == mafs::clip_depth::zero_to_one ? 0.0f : -c.w;
+        return std::abs(c.x) < c.w - margin && std::abs(c.y) < c.w - margin && c.z > near_bound + margin && c.z < c.w - margin;
+    }
+    bool clip_outside(const mafs::mat4f& m, const mafs::vec3f& p, mafs::clip_depth depth, float margin) {
+        const mafs::vec4f c = m * mafs::vec4f{ p.x, p.y, p.z, 1.0f };
+        const float near_bound = depth == mafs::clip_depth::zero_to_one ? 0.0f : -c.w;
+        return std::abs(c.x) > c.w + margin || std::abs(c.y) > c.w + margin || c.z < near_bound - margin || c.z > c.w + margin;
+    }
+
+    const mafs::mat4f view = mafs::look_at(mafs::vec3f{ 3.0f, 2.0f, 10.0f }, mafs::vec3f{ 0.0f, 0.0f, 0.0f }, mafs::vec3f{ 0.0f, 1.0f, 0.0f });
+
+    void test_from_matrix() {
+        for (mafs::clip_depth depth : { mafs::clip_depth::minus_one_to_one, mafs::clip_depth::zero_to_one }) {
+            const std::string tag = depth == mafs::clip_depth::zero_to_one ? " (zero_to_one)" : " (minus_one_to_one)";
+            const mafs::mat4f m = mafs::perspective(1.0f, 1.5f, 0.5f, 40.0f, depth) * view;
+            const mafs::view_frustumf f = mafs::view_frustumf::from_matrix(m, depth);
+            bool unit = true;
+            for (const mafs::vec4f& p : f.planes)
+                unit = unit && approx_equal(p.xyz().norm(), 1.0f);
+            assert_true(unit, "unit plane normals" + tag);
+
+            std::mt19937 rng(2);
+            std::uniform_real_distribution<float> pos(-40.0f, 40.0f);
+            bool agree = true;
+            size_t inside = 0;
+            for (int i = 0; i < 4000; i++) {
+                const mafs::vec3f p{ pos(rng), pos(rng), pos(rng) };
+                if (clip_inside(m, p, depth, 1e-3f)) {
+                    agree = agree && f.contains(p);
+                    inside++;
+                }
+                else if (clip_outside(m, p, depth, 1e-3f))
+                    agree = agree && !f.contains(p);
+            }
+            assert_true(agree && inside > 100, "contains matches clip space" + tag);
+        }
+        // Near plane is 0.5 in front of the eye along the view direction.
+        const mafs::mat4f m = mafs::perspective(1.0f, 1.5f, 0.5f, 40.0f) * view;
+        const mafs::view_frustumf f = mafs::view_frustumf::from_matrix(m);
+        const mafs::vec3f eye{ 3.0f, 2.0f, 10.0f };
+        assert_true(approx_equal(f.distance(4, eye), -0.5f) && approx_equal(f.distance(5, eye), 40.0f, 1e-3f), "near and far distances");
+
+        const mafs::mat4f inf = mafs::perspective_infinite_reversed_z(1.0f, 1.5f, 0.5f) * view;
+        const mafs::view_frustumf fi = mafs::view_frustumf::from_matrix(inf, mafs::clip_depth::zero_to_one);
+        const mafs::vec3f forward = (mafs::vec3f(0.0f) - eye).normalize();
+        assert_true(fi.contains(eye + forward * 1e6f) && !fi.contains(eye + forward * 0.25f), "infinite reversed-z projection");
+    }
+
+    void test_scalar_bounds() {
+        const mafs::view_frustumf f = mafs::view_frustumf::from_matrix(mafs::perspective(1.0f, 1.0f, 1.0f, 100.0f));
+        // Camera at the origin looking down -z.
+        assert_true(f.intersects(mafs::spheref{ mafs::vec3f{ 0.0f, 0.0f, -10.0f }, 1.0f }), "sphere inside");
+        assert_true(f.intersects(mafs::spheref{ mafs::vec3f{ 0.0f, 0.0f, -0.5f }, 0.6f }), "sphere straddling the near plane");
+        assert_true(!f.intersects(mafs::spheref{ mafs::vec3f{ 0.0f, 0.0f, 5.0f }, 1.0f }), "sphere behind the camera");
+        assert_true(!f.intersects(mafs::spheref{ mafs::vec3f{ 0.0f, 0.0f, -10.0f }, -1.0f }), "empty sphere");
+
+        assert_true(f.intersects(mafs::aabb3f(mafs::vec3f{ -1.0f, -1.0f, -11.0f }, mafs::vec3f{ 1.0f, 1.0f, -9.0f })), "box inside");
+        assert_true(f.intersects(mafs::aabb3f(mafs::vec3f{ -100.0f, -100.0f, -50.0f }, mafs::vec3f{ 100.0f, 100.0f, 50.0f })), "box containing the frustum");
+        assert_true(!f.intersects(mafs::aabb3f(mafs::vec3f{ 20.0f, -1.0f, -11.0f }, mafs::vec3f{ 22.0f, 1.0f, -9.0f })), "box to the right");
+        assert_true(!f.intersects(mafs::aabb3f()), "empty box");
+
+        assert_true(f.contains(mafs::aabb3f(mafs::vec3f{ -1.0f, -1.0f, -11.0f }, mafs::vec3f{ 1.0f, 1.0f, -9.0f })), "contains a box inside");
+        assert_true(!f.contains(mafs::aabb3f(mafs::vec3f{ -1.0f, -1.0f, -11.0f }, mafs::vec3f{ 1.0f, 1.0f, 1.0f })), "does not contain a box crossing the near plane");
+        assert_true(!f.contains(mafs::aabb3f()), "does not contain the empty box");
+    }
+
+    template<size_t W>
+    void check_cull(const std::string& name) {
+        const mafs::view_frustumf f = mafs::view_frustumf::from_matrix(mafs::perspective(1.2f, 1.6f, 0.5f, 60.0f) * view);
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<float> pos(-60.0f, 60.0f), size(0.1f, 4.0f);
+        const size_t count = W * 1500 + 5;
+        std::vector<mafs::spheref> spheres(count);
+        std::vector<mafs::aabb3f> boxes(count);
+        for (size_t i = 0; i < count; i++) {
+            const mafs::vec3f c{ pos(rng), pos(rng), pos(rng) };
+            spheres[i] = mafs::spheref{ c, size(rng) };
+            boxes[i] = mafs::aabb3f::from_center_extents(c, mafs::vec3f{ size(rng), size(rng), size(rng) });
+        }
+        std::vector<uint32_t> expect_spheres, expect_boxes;
+        for (uint32_t i = 0; i < count; i++) {
+            if (f.intersects(spheres[i])) expect_spheres.push_back(i);
+            if (f.intersects(boxes[i])) expect_boxes.push_back(i);
+        }
+
+        const auto sphere_packets = mafs::pack_spheres<W>(std::span<const mafs::spheref>(spheres));
+        const auto box_packets = mafs::pack_aabbs<W>(std::span<const mafs::aabb3f>(boxes));
+        std::vector<uint32_t> out(sphere_packets.size() * W);
+        size_t n = mafs::cull(f, std::span<const mafs::sphere_packet<W>>(sphere_packets), std::span(out));
+        assert_true(expect_spheres.size() > 100 && std::vector<uint32_t>(out.begin(), out.begin() + n) == expect_spheres, name + " spheres match the scalar test");
+        n = mafs::cull(f, std::span<const mafs::aabb_packet<W>>(box_packets), std::span(out));
+        assert_true(expect_boxes.size() > 100 && std::vector<uint32_t>(out.begin(), out.begin() + n) == expect_boxes, name + " boxes match the scalar test");
+
+        // Small chunks and more threads than chunks exercise the slice compaction.
+        bool same = true;
+        for (size_t threads : { 1, 3, 8 }) {
+            std::fill(out.begin(), out.end(), 0u);
+            n = mafs::cull(f, std::span<const mafs::sphere_packet<W>>(sphere_packets), std::span(out), threads, 7);
+            same = same && std::vector<uint32_t>(out.begin(), out.begin() + n) == expect_spheres;
+            n = mafs::cull(f, std::span<const mafs::aabb_packet<W>>(box_packets), std::span(out), threads, 100);
+            same = same && std::vector<uint32_t>(out.begin(), out.begin() + n) == expect_boxes;
+        }
+        assert_true(same, name + " multithreaded cull matches");
+        assert_true(mafs::cull(f, std::span<const mafs::aabb_packet<W>>(), std::span(out), 4) == 0, name + " no packets");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing frustum plane extraction..." << std::endl;
+    mafs::test::test_from_matrix();
+
+    std::cout << "\nTesting scalar sphere and box tests..." << std::endl;
+    mafs::test::test_scalar_bounds();
+
+    std::cout << "\nTesting packet culling..." << std::endl;
+    mafs::test::check_cull<4>("W = 4");
+    mafs::test::check_cull<8>("W = 8");
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include "../include/mafs/kd_tree.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    // Uniform points plus a dense cluster and exact duplicates, which put many points on
+    // splitting planes.
+    std::vector<mafs::vec3f> make_points(size_t count) {
+        std::mt19937 rng(12);
+        std::uniform_real_distribution<float> pos(-10.0f, 10.0f), tight(-0.05f, 0.05f);
+        std::vector<mafs::vec3f> points;
+        for (size_t i = 0; i < count; i++) {
+            if (i % 5 == 0)
+                points.push_back(mafs::vec3f{ 2.0f + tight(rng), tight(rng), -3.0f + tight(rng) });
+            else if (i % 7 == 0)
+                points.push_back(points[i / 2]);
+            else
+                points.push_back(mafs::vec3f{ pos(rng), pos(rng), pos(rng) });
+        }
+        return points;
+    }
+
+    std::vector<float> brute_distances(const std::vector<mafs::vec3f>& points, const mafs::vec3f& q) {
+        std::vector<float> d;
+        for (const mafs::vec3f& p : points)
+            d.push_back((p - q).length_squared());
+        return d;
+    }
+
+    void test_build() {
+        const std::vector<mafs::vec3f> points = make_points(5000);
+        const mafs::kd_tree3f tree = mafs::kd_tree3f::build(points, 1);
+        std::vector<int> seen(points.size(), 0);
+        bool same = tree.size() == points.size();
+        for (size_t i = 0; i < tree.size(); i++) {
+            seen[tree.ids[i]]++;
+            same = same && tree.points[i] == points[tree.ids[i]];
+        }
+        bool once = true;
+        for (int s : seen)
+            once = once && s == 1;
+        assert_true(same && once, "points are a permutation of the input");
+
+        // Every node's median splits its range on its axis.
+        bool ordered = true;
+        std::vector<std::pair<size_t, size_t>> ranges{ { 0, tree.size() } };
+        while (!ranges.empty()) {
+            const auto [begin, end] = ranges.back();
+            ranges.pop_back();
+            if (end - begin <= mafs::kd_tree3f::leaf_size)
+                continue;
+            const size_t mid = (begin + end) / 2, axis = tree.axes[mid];
+            for (size_t i = begin; i < mid; i++)
+                ordered = ordered && tree.points[i][axis] <= tree.points[mid][axis];
+            for (size_t i = mid + 1; i < end; i++)
+                ordered = ordered && tree.points[i][axis] >= tree.points[mid][axis];
+            ranges.push_back({ begin, mid });
+            ranges.push_back({ mid + 1, end });
+        }
+        assert_true(ordered, "medians split their ranges");
+
+        const mafs::kd_tree3f threaded = mafs::kd_tree3f::build(points, 4);
+        assert_true(threaded.points == tree.points && threaded.ids == tree.ids && threaded.axes == tree.axes, "threaded build gives the same tree");
+
+        const mafs::kd_tree3f empty = mafs::kd_tree3f::build(std::span<const mafs::vec3f>());
+        std::vector<mafs::kd_neighbor<float>> found;
+        empty.radius_search(mafs::vec3f(0.0f), 1.0f, found);
+        assert_true(empty.nearest(mafs::vec3f(0.0f)).index == mafs::kd_neighbor<float>::none && found.empty(), "empty tree");
+    }
+
+    void test_knn() {
+        const std::vector<mafs::vec3f> points = make_points(5000);
+        const mafs::kd_tree3f tree = mafs::kd_tree3f::build(points);
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> pos(-12.0f, 12.0f);
+        bool match = true, sorted = true, nearest = true, limited = true;
+        for (int i = 0; i < 200; i++) {
+            // Half the queries sit inside the cluster.
+            const mafs::vec3f q = i % 2 == 0 ? mafs::vec3f{ pos(rng), pos(rng), pos(rng) } : mafs::vec3f{ 2.0f, 0.01f * pos(rng), -3.0f };
+            std::vector<float> expect = brute_distances(points, q);
+            std::sort(expect.begin(), expect.end());
+
+            for (size_t k : { 1, 5, 32 }) {
+                std::vector<mafs::kd_neighbor<float>> out(k);
+                const size_t n = tree.knn(q, out);
+                match = match && n == k;
+                for (size_t j = 0; j < n; j++) {
+                    match = match && out[j].distance_squared == expect[j] && (points[out[j].index] - q).length_squared() == expect[j];
+                    sorted = sorted && (j == 0 || out[j - 1].distance_squared <= out[j].distance_squared);
+                }
+            }
+            const mafs::kd_neighbor<float> best = tree.nearest(q);
+            nearest = nearest && best.distance_squared == expect[0];
+
+            // Only points strictly closer than max_distance count.
+            const float limit = std::sqrt(expect[3]);
+            std::vector<mafs::kd_neighbor<float>> out(10);
+            const size_t n = tree.knn(q, out, limit);
+            limited = limited && n == size_t(std::lower_bound(expect.begin(), expect.end(), limit * limit) - expect.begin());
+        }
+        assert_true(match, "knn matches brute force");
+        assert_true(sorted, "knn results are nearest first");
+        assert_true(nearest, "nearest matches brute force");
+        assert_true(limited, "max_distance limits knn");
+
+        std::vector<mafs::kd_neighbor<float>> all(points.size() + 10);
+        assert_true(tree.knn(mafs::vec3f(0.0f), all) == points.size(), "k larger than the tree");
+    }
+
+    void test_radius() {
+        const std::vector<mafs::vec3f> points = make_points(5000);
+        const mafs::kd_tree3f tree = mafs::kd_tree3f::build(points);
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> pos(-12.0f, 12.0f);
+        bool match = true;
+        size_t total = 0;
+        for (int i = 0; i < 200; i++) {
+            const mafs::vec3f q = i % 2 == 0 ? mafs::vec3f{ pos(rng), pos(rng), pos(rng) } : points[size_t(i) * 20];
+            const float radius = i % 3 == 0 ? 0.05f : 2.5f;
+            std::vector<uint32_t> expect;
+            const std::vector<float> d = brute_distances(points, q);
+            for (uint32_t j = 0; j < points.size(); j++)
+                if (d[j] <= radius * radius)
+                    expect.push_back(j);
+            std::vector<mafs::kd_neighbor<float>> found;
+            tree.radius_search(q, radius, found);
+            std::vector<uint32_t> got;
+            for (const mafs::kd_neighbor<float>& n : found) {
+                got.push_back(n.index);
+                match = match && n.distance_squared == d[n.index];
+            }
+            std::sort(got.begin(), got.end());
+            match = match && got == expect;
+            total += got.size();
+        }
+        assert_true(match && total > 1000, "radius search matches brute force");
+    }
+
+    void test_batches() {
+        const std::vector<mafs::vec3f> points = make_points(20000);
+        const mafs::kd_tree3f tree = mafs::kd_tree3f::build(points);
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> pos(-12.0f, 12.0f);
+        std::vector<mafs::vec3f> queries(1000);
+        for (mafs::vec3f& q : queries)
+            q = mafs::vec3f{ pos(rng), pos(rng), pos(rng) };
+
+        constexpr size_t k = 6;
+        bool knn_same = true, radius_same = true;
+        for (size_t threads : { 1, 3, 8 }) {
+            std::vector<mafs::kd_neighbor<float>> out(queries.size() * k);
+            std::vector<uint32_t> counts(queries.size());
+            tree.knn(queries, k, out, counts, threads);
+            std::vector<uint32_t> offsets;
+            std::vector<mafs::kd_neighbor<float>> found;
+            tree.radius_search(queries, 1.5f, offsets, found, threads);
+            radius_same = radius_same && offsets.size() == queries.size() + 1 && offsets.back() == found.size();
+            for (size_t i = 0; i < queries.size(); i++) {
+                std::vector<mafs::kd_neighbor<float>> single(k);
+                knn_same = knn_same && counts[i] == tree.knn(queries[i], single);
+                for (size_t j = 0; j < k; j++)
+                    knn_same = knn_same && out[i * k + j].index == single[j].index;
+                std::vector<mafs::kd_neighbor<float>> expect;
+                tree.radius_search(queries[i], 1.5f, expect);
+                radius_same = radius_same && offsets[i + 1] - offsets[i] == expect.size();
+                for (size_t j = 0; j < expect.size() && radius_same; j++)
+                    radius_same = found[offsets[i] + j].index == expect[j].index;
+            }
+        }
+        assert_true(knn_same, "batched knn matches single queries");
+        assert_true(radius_same, "batched radius search matches single queries");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing k-d tree build..." << std::endl;
+    mafs::test::test_build();
+
+    std::cout << "\nTesting knn..." << std::endl;
+    mafs::test::test_knn();
+
+    std::cout << "\nTesting radius search..." << std::endl;
+    mafs::test::test_radius();
+
+    std::cout << "\nTesting batched queries..." << std::endl;
+    mafs::test::test_batches();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "../include/mafs/lbvh.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    // Small boxes, a cluster of boxes sharing one center (equal Morton codes) and a few large ones.
+    std::vector<mafs::aabb3f> make_boxes(size_t count, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> pos(-20.0f, 20.0f), size(0.05f, 1.0f);
+        std::vector<mafs::aabb3f> boxes(count);
+        for (size_t i = 0; i < count; i++) {
+            const mafs::vec3f c = i % 7 == 0 ? mafs::vec3f{ 3.0f, 3.0f, 3.0f } : mafs::vec3f{ pos(rng), pos(rng), pos(rng) };
+            const float s = i % 101 == 0 ? 8.0f : size(rng);
+            boxes[i] = mafs::aabb3f::from_center_extents(c, mafs::vec3f{ s, size(rng), s });
+        }
+        return boxes;
+    }
+
+    // Every leaf is reached exactly once and every node's box holds its children's.
+    bool check_tree(const mafs::lbvh& tree) {
+        if (tree.size() == 0)
+            return tree.nodes.empty();
+        std::vector<int> reached(tree.size(), 0);
+        bool ok = true;
+        std::vector<uint32_t> stack{ tree.root() };
+        while (!stack.empty()) {
+            const uint32_t c = stack.back();
+            stack.pop_back();
+            if (c & mafs::lbvh::leaf_bit) {
+                reached[c & ~mafs::lbvh::leaf_bit]++;
+                continue;
+            }
+            const mafs::lbvh_node& n = tree.nodes[c];
+            for (uint32_t child : { n.left, n.right }) {
+                const mafs::aabb3f& b = child & mafs::lbvh::leaf_bit ? tree.leaf_bounds[child & ~mafs::lbvh::leaf_bit] : tree.nodes[child].bounds;
+                ok = ok && n.bounds.contains(b);
+                stack.push_back(child);
+            }
+        }
+        for (size_t i = 0; i < tree.size(); i++)
+            ok = ok && reached[i] == 1 && (i == 0 || tree.codes[i - 1] <= tree.codes[i]);
+        return ok;
+    }
+
+    template<typename Query, typename Test>
+    bool same_as_brute_force(const std::vector<mafs::aabb3f>& boxes, Query&& query, Test&& test) {
+        std::vector<uint32_t> got, expect;
+        query([&](uint32_t i) { got.push_back(i); });
+        for (uint32_t i = 0; i < boxes.size(); i++)
+            if (test(boxes[i]))
+                expect.push_back(i);
+        std::sort(got.begin(), got.end());
+        return got == expect;
+    }
+
+    bool check_queries(const mafs::lbvh& tree, const std::vector<mafs::aabb3f>& boxes, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> pos(-25.0f, 25.0f), size(0.1f, 6.0f), dir(-1.0f, 1.0f);
+        bool ok = true;
+        for (int i = 0; i < 100; i++) {
+            const mafs::aabb3f box = mafs::aabb3f::from_center_extents(mafs::vec3f{ pos(rng), pos(rng), pos(rng) }, mafs::vec3f(size(rng)));
+            ok = ok && same_as_brute_force(boxes, [&](auto fn) { tree.query(box, fn); }, [&](const mafs::aabb3f& b) { return b.overlaps(box); });
+            const mafs::rayf r(mafs::vec3f{ pos(rng), pos(rng), pos(rng) }, mafs::vec3f{ dir(rng), dir(rng), dir(rng) });
+            const float t_max = i % 2 == 0 ? 1000.0f : 10.0f;
+            ok = ok && same_as_brute_force(boxes, [&](auto fn) { tree.query(r, t_max, fn); }, [&](const mafs::aabb3f& b) { return b.intersects(r, t_max); });
+        }
+        return ok;
+    }
+
+    void test_build() {
+        const std::vector<mafs::aabb3f> boxes = make_boxes(20000, 51);
+        mafs::lbvh tree;
+        tree.build(boxes, 1);
+        assert_true(tree.nodes.size() == boxes.size() - 1 && check_tree(tree), "radix tree covers every leaf once");
+        mafs::aabb3f all;
+        for (const mafs::aabb3f& b : boxes)
+            all = all.merge(b);
+        assert_true(tree.bounds() == all, "root bounds are the union of the boxes");
+        assert_true(check_queries(tree, boxes, 52), "queries match brute force");
+
+        bool same = true;
+        for (size_t threads : { 2, 3, 8 }) {
+            mafs::lbvh threaded;
+            threaded.build(boxes, threads);
+            same = same && threaded.ids == tree.ids;
+            for (size_t i = 0; i < tree.nodes.size(); i++)
+                same = same && threaded.nodes[i].left == tree.nodes[i].left && threaded.nodes[i].right == tree.nodes[i].right && threaded.nodes[i].bounds == tree.nodes[i].bounds;
+        }
+        assert_true(same, "threaded builds give the same tree");
+
+        // Rebuilding the same object with fewer boxes, including the small cases.
+        bool small = true;
+        for (size_t n : { size_t(0), size_t(1), size_t(2), size_t(3), size_t(50) }) {
+            const std::vector<mafs::aabb3f> few(boxes.begin(), boxes.begin() + n);
+            tree.build(few, 4);
+            small = small && tree.size() == n && check_tree(tree) && check_queries(tree, few, 53);
+        }
+        assert_true(small, "rebuilds and tiny inputs");
+
+        // Every center the same: the tree comes from the index tie-break alone.
+        const std::vector<mafs::aabb3f> same_center(1000, mafs::aabb3f(mafs::vec3f(-1.0f), mafs::vec3f(1.0f)));
+        tree.build(same_center);
+        size_t found = 0;
+        tree.query(mafs::aabb3f(mafs::vec3f(0.0f), mafs::vec3f(0.5f)), [&](uint32_t) { found++; });
+        assert_true(check_tree(tree) && found == 1000, "identical boxes");
+    }
+
+    void test_refit() {
+        std::vector<mafs::aabb3f> boxes = make_boxes(30000, 54);
+        mafs::lbvh tree;
+        tree.build(boxes);
+        std::mt19937 rng(55);
+        std::uniform_real_distribution<float> step(-2.0f, 2.0f);
+        for (mafs::aabb3f& b : boxes) {
+            const mafs::vec3f d{ step(rng), step(rng), step(rng) };
+            b = mafs::aabb3f(b.min + d, b.max + d * 1.5f);
+        }
+        const std::vector<uint32_t> ids = tree.ids;
+        bool ok = true;
+        for (size_t threads : { 1, 4 }) {
+            tree.refit(boxes, threads);
+            ok = ok && tree.ids == ids && check_tree(tree) && check_queries(tree, boxes, 56);
+        }
+        assert_true(ok, "refit keeps the topology and updates the bounds");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing LBVH build..." << std::endl;
+    mafs::test::test_build();
+
+    std::cout << "\nTesting LBVH refit..." << std::endl;
+    mafs::test::test_refit();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
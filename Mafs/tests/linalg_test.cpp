@@ -0,0 +1,173 @@
+#include "../include/mafs/linalg.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T, size_t N>
+    bool approx_equal(const mafs::vec<T, N>& a, const mafs::vec<T, N>& b, T eps = T(1e-4)) {
+        for (size_t i = 0; i < N; i++)
+            if (!approx_equal(a[i], b[i], eps)) return false;
+        return true;
+    }
+
+    template<typename T, size_t R, size_t C>
+    mafs::mat<T, R, C> random_mat(std::mt19937& rng) {
+        std::uniform_real_distribution<T> dist(T(-1), T(1));
+        mafs::mat<T, R, C> m;
+        for (size_t c = 0; c < C; c++)
+            for (size_t r = 0; r < R; r++)
+                m(r, c) = dist(rng);
+        return m;
+    }
+
+    template<typename T, size_t N>
+    mafs::vec<T, N> random_vec(std::mt19937& rng) {
+        std::uniform_real_distribution<T> dist(T(-1), T(1));
+        mafs::vec<T, N> v;
+        for (size_t i = 0; i < N; i++)
+            v[i] = dist(rng);
+        return v;
+    }
+
+    template<typename T, size_t N>
+    mafs::mat<T, N, N> random_spd(std::mt19937& rng) {
+        mafs::mat<T, N, N> a = random_mat<T, N, N>(rng);
+        return a.transpose() * a + mafs::mat<T, N, N>(T(N));
+    }
+
+    void test_lu() {
+        std::mt19937 rng(1);
+        mafs::mat<double, 6, 6> a = random_mat<double, 6, 6>(rng);
+        mafs::vec<double, 6> b = random_vec<double, 6>(rng);
+        mafs::lu_result<double, 6> f = mafs::lu(a);
+        assert_true(!f.singular, "lu<6> not singular");
+        assert_true(approx_equal(a * f.solve(b), b, 1e-10), "lu<6> solve");
+
+        mafs::mat<double, 6, 6> inv = f.inverse();
+        mafs::mat<double, 6, 6> id = a * inv;
+        assert_true(approx_equal(id[2][2], 1.0, 1e-10) && approx_equal(id[3][1], 0.0, 1e-10), "lu<6> inverse");
+
+        mafs::mat3d m{ {2.0, 0.0, 0.0}, {0.0, 3.0, 0.0}, {1.0, 0.0, 4.0} };
+        assert_true(approx_equal(mafs::lu(m).determinant(), 24.0), "lu<3> determinant");
+
+        mafs::mat3f sing{ {1.0f, 2.0f, 3.0f}, {2.0f, 4.0f, 6.0f}, {0.0f, 1.0f, 0.0f} };
+        assert_true(mafs::lu(sing).singular, "lu<3> detects singular matrix");
+
+        constexpr mafs::mat3d cm{ {0.0, 1.0, 0.0}, {2.0, 0.0, 0.0}, {0.0, 0.0, 4.0} };
+        constexpr mafs::vec3d cx = mafs::lu(cm).solve(mafs::vec3d{ 2.0, 1.0, 8.0 });
+        static_assert(cx.x == 1.0 && cx.y == 1.0 && cx.z == 2.0, "lu is usable in constant expressions");
+        assert_true(approx_equal(mafs::lu(cm).solve(mafs::vec3d{ 2.0, 1.0, 8.0 }), cx, 1e-12), "lu gives the same solution at run time");
+    }
+
+    void test_ldlt() {
+        std::mt19937 rng(2);
+        mafs::mat<double, 12, 12> a = random_spd<double, 12>(rng);
+        mafs::vec<double, 12> b = random_vec<double, 12>(rng);
+        mafs::ldlt_result<double, 12> f = mafs::ldlt(a);
+        assert_true(f.positive_definite, "ldlt<12> positive definite");
+        assert_true(approx_equal(a * f.solve(b), b, 1e-10), "ldlt<12> solve");
+
+        mafs::mat3f indefinite{ {1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f} };
+        assert_true(!mafs::ldlt(indefinite).positive_definite, "ldlt<3> detects indefinite matrix");
+    }
+
+    void test_qr() {
+        std::mt19937 rng(3);
+        mafs::mat<double, 5, 5> a = random_mat<double, 5, 5>(rng);
+        mafs::vec<double, 5> b = random_vec<double, 5>(rng);
+        assert_true(approx_equal(a * mafs::qr(a).solve(b), b, 1e-10), "qr<5> solve");
+
+        // Overdetermined: the residual of the least-squares solution is orthogonal to the columns.
+        mafs::mat<double, 6, 3> ls = random_mat<double, 6, 3>(rng);
+        mafs::vec<double, 6> lb = random_vec<double, 6>(rng);
+        mafs::vec<double, 3> x = mafs::qr(ls).solve(lb);
+        mafs::vec<double, 3> normal = ls.transpose() * (ls * x - lb);
+        assert_true(approx_equal(normal, mafs::vec<double, 3>{}, 1e-10), "qr<6,3> least squares");
+
+        mafs::mat3f deficient{ {1.0f, 1.0f, 1.0f}, {2.0f, 2.0f, 2.0f}, {0.0f, 1.0f, 0.0f} };
+        assert_true(mafs::qr(deficient).rank_deficient, "qr<3> detects rank deficiency");
+
+        constexpr mafs::mat3d cm{ {0.0, 1.0, 0.0}, {2.0, 0.0, 3.0}, {1.0, 0.0, 4.0} };
+        constexpr mafs::vec3d cx = mafs::qr(cm).solve(mafs::vec3d{ 7.0, 1.0, 18.0 });
+        static_assert(mafs::detail::abs(cx.x - 1.0) < 1e-12 && mafs::detail::abs(cx.y - 2.0) < 1e-12 && mafs::detail::abs(cx.z - 3.0) < 1e-12, "qr is usable in constant expressions");
+        assert_true(approx_equal(mafs::qr(cm).solve(mafs::vec3d{ 7.0, 1.0, 18.0 }), cx, 1e-12), "qr gives the same solution at run time");
+    }
+
+    void test_batches() {
+        std::mt19937 rng(4);
+        const size_t count = 19; // not a multiple of the lane count
+        std::vector<mafs::mat<float, 6, 6>> a(count), spd(count);
+        std::vector<mafs::vec<float, 6>> b(count), x(count);
+        for (size_t i = 0; i < count; i++) {
+            a[i] = random_mat<float, 6, 6>(rng) + mafs::mat<float, 6, 6>(2.0f);
+            spd[i] = random_spd<float, 6>(rng);
+            b[i] = random_vec<float, 6>(rng);
+        }
+        std::span<const mafs::mat<float, 6, 6>> as(a), spds(spd);
+        std::span<const mafs::vec<float, 6>> bs(b);
+
+        bool ok = true;
+        mafs::lu_solve_batch(as, bs, std::span(x));
+        for (size_t i = 0; i < count; i++)
+            ok = ok && approx_equal(x[i], mafs::lu(a[i]).solve(b[i]), 1e-3f);
+        assert_true(ok, "lu_solve_batch matches lu");
+
+        ok = true;
+        mafs::ldlt_solve_batch(spds, bs, std::span(x));
+        for (size_t i = 0; i < count; i++)
+            ok = ok && approx_equal(x[i], mafs::ldlt(spd[i]).solve(b[i]), 1e-3f);
+        assert_true(ok, "ldlt_solve_batch matches ldlt");
+
+        ok = true;
+        mafs::qr_solve_batch<4>(as, bs, std::span(x));
+        for (size_t i = 0; i < count; i++)
+            ok = ok && approx_equal(x[i], mafs::qr(a[i]).solve(b[i]), 1e-3f);
+        assert_true(ok, "qr_solve_batch matches qr");
+
+        // A rank-deficient system comes back non-finite without disturbing the other lanes.
+        a[5] = mafs::mat<float, 6, 6>(0.0f);
+        mafs::qr_solve_batch<4>(as, bs, std::span(x));
+        ok = !std::isfinite(x[5][0]);
+        for (size_t i = 4; i < 8; i++)
+            ok = ok && (i == 5 || approx_equal(x[i], mafs::qr(a[i]).solve(b[i]), 1e-3f));
+        assert_true(ok, "qr_solve_batch rank-deficient lane");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing LU..." << std::endl;
+    mafs::test::test_lu();
+
+    std::cout << "\nTesting LDLT..." << std::endl;
+    mafs::test::test_ldlt();
+
+    std::cout << "\nTesting QR..." << std::endl;
+    mafs::test::test_qr();
+
+    std::cout << "\nTesting batched solvers..." << std::endl;
+    mafs::test::test_batches();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
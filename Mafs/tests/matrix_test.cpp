@@ -0,0 +1,140 @@
+#include "../include/mafs/matrix.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <string>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-5)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T, size_t R, size_t C>
+    bool approx_equal(const mafs::mat<T, R, C>& a, const mafs::mat<T, R, C>& b, T eps = T(1e-5)) {
+        for (size_t c = 0; c < C; c++)
+            for (size_t r = 0; r < R; r++)
+                if (!approx_equal(a[c][r], b[c][r], eps)) return false;
+        return true;
+    }
+
+    template<typename T>
+    mafs::vec<T, 3> project(const mafs::mat<T, 4, 4>& m, const mafs::vec<T, 3>& p) {
+        mafs::vec<T, 4> clip = m * mafs::vec<T, 4>{ p.x, p.y, p.z, T(1) };
+        return clip.xyz() / clip.w;
+    }
+
+    void test_mat_basics() {
+        mafs::mat4 zero;
+        assert_true(zero[2][3] == 0.0f && zero(3, 3) == 0.0f, "mat4 default constructor");
+
+        mafs::mat4 id = mafs::mat4::identity();
+        assert_true(id[0][0] == 1.0f && id[3][3] == 1.0f && id[1][0] == 0.0f, "mat4 identity");
+
+        mafs::mat<float, 2, 3> m{ {1.0f, 4.0f}, {2.0f, 5.0f}, {3.0f, 6.0f} };
+        assert_true(m(0, 2) == 3.0f && m(1, 0) == 4.0f, "mat<float, 2, 3> column initializer list");
+
+        mafs::mat<float, 3, 2> mt = m.transpose();
+        assert_true(mt(2, 0) == 3.0f && mt(0, 1) == 4.0f, "mat<float, 2, 3> transpose");
+
+        mafs::vec<float, 2> mv = m * mafs::vec<float, 3>{ 1.0f, 1.0f, 1.0f };
+        assert_true(approx_equal(mv.x, 6.0f) && approx_equal(mv.y, 15.0f), "mat<float, 2, 3> * vec");
+
+        mafs::mat<float, 2, 2> mm = m * mt;
+        assert_true(approx_equal(mm(0, 0), 14.0f) && approx_equal(mm(0, 1), 32.0f) && approx_equal(mm(1, 1), 77.0f), "mat * mat");
+
+        assert_true(id * mafs::mat4(2.0f) == mafs::mat4(2.0f), "mat4 identity product");
+        assert_true(m.ptr()[3] == 5.0f, "mat column-major ptr");
+    }
+
+    void test_projection() {
+        using mafs::clip_depth;
+        const float fovy = std::numbers::pi_v<float> / 3.0f;
+        const float n = 0.1f, f = 100.0f;
+
+        mafs::mat4 p = mafs::perspective(fovy, 16.0f / 9.0f, n, f);
+        assert_true(approx_equal(project(p, mafs::vec3f{ 0.0f, 0.0f, -n }).z, -1.0f), "perspective near -> -1");
+        assert_true(approx_equal(project(p, mafs::vec3f{ 0.0f, 0.0f, -f }).z, 1.0f, 1e-4f), "perspective far -> 1");
+
+        mafs::mat4 p01 = mafs::perspective(fovy, 16.0f / 9.0f, n, f, clip_depth::zero_to_one);
+        assert_true(approx_equal(project(p01, mafs::vec3f{ 0.0f, 0.0f, -n }).z, 0.0f), "perspective [0,1] near -> 0");
+        assert_true(approx_equal(project(p01, mafs::vec3f{ 0.0f, 0.0f, -f }).z, 1.0f, 1e-4f), "perspective [0,1] far -> 1");
+
+        mafs::mat4 fr = mafs::frustum(-1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 10.0f);
+        mafs::mat4 pf = mafs::perspective(std::numbers::pi_v<float> / 2.0f, 1.0f, 1.0f, 10.0f);
+        assert_true(approx_equal(fr, pf), "symmetric frustum == perspective");
+
+        mafs::mat4 rz = mafs::perspective_infinite_reversed_z(fovy, 1.0f, n);
+        assert_true(approx_equal(project(rz, mafs::vec3f{ 0.0f, 0.0f, -n }).z, 1.0f), "reversed-z near -> 1");
+        assert_true(approx_equal(project(rz, mafs::vec3f{ 0.0f, 0.0f, -1e7f }).z, 0.0f), "reversed-z infinity -> 0");
+
+        constexpr mafs::mat4 o = mafs::ortho(-2.0f, 2.0f, -1.0f, 1.0f, 0.0f, 10.0f);
+        static_assert(o[0][0] == 0.5f && o[3][3] == 1.0f, "ortho is usable in constant expressions");
+        constexpr mafs::mat4 cp = mafs::perspective_focal(2.0f, 2.0f, 1.0f, 3.0f);
+        static_assert(cp[0][0] == 1.0f && cp[1][1] == 2.0f && cp[2][2] == -2.0f && cp[3][2] == -3.0f, "perspective_focal is usable in constant expressions");
+        constexpr mafs::mat4 crz = mafs::perspective_infinite_reversed_z_focal(2.0f, 2.0f, 0.5f);
+        static_assert(crz[0][0] == 1.0f && crz[2][2] == 0.0f && crz[3][2] == 0.5f, "perspective_infinite_reversed_z_focal is usable in constant expressions");
+        constexpr mafs::mat4 cv = mafs::look_at_basis(mafs::vec3f{ 0.0f, 0.0f, 5.0f }, mafs::vec3f{ 0.0f, 0.0f, -1.0f }, mafs::vec3f{ 0.0f, 1.0f, 0.0f });
+        static_assert(cv[0][0] == 1.0f && cv[1][1] == 1.0f && cv[2][2] == 1.0f && cv[3][2] == -5.0f, "look_at_basis is usable in constant expressions");
+        assert_true(approx_equal(mafs::perspective_focal(1.0f / std::tan(fovy / 2.0f), 16.0f / 9.0f, n, f), p) &&
+            approx_equal(cv, mafs::look_at(mafs::vec3f{ 0.0f, 0.0f, 5.0f }, mafs::vec3f{ 0.0f }, mafs::vec3f{ 0.0f, 1.0f, 0.0f })), "constexpr builders match");
+        assert_true(approx_equal(project(o, mafs::vec3f{ 2.0f, 1.0f, -10.0f }).x, 1.0f) &&
+            approx_equal(project(o, mafs::vec3f{ 2.0f, 1.0f, -10.0f }).z, 1.0f), "ortho corner");
+
+        mafs::mat4 v = mafs::look_at(mafs::vec3f{ 0.0f, 0.0f, 5.0f }, mafs::vec3f{ 0.0f }, mafs::vec3f{ 0.0f, 1.0f, 0.0f });
+        mafs::vec3f eye_space = project(v, mafs::vec3f{ 1.0f, 2.0f, 0.0f });
+        assert_true(approx_equal(eye_space.x, 1.0f) && approx_equal(eye_space.y, 2.0f) && approx_equal(eye_space.z, -5.0f), "look_at");
+    }
+
+    void test_inverses() {
+        const float fovy = 1.2f;
+        mafs::mat4 id = mafs::mat4::identity();
+
+        mafs::mat4 p = mafs::perspective(fovy, 1.5f, 0.5f, 50.0f);
+        assert_true(approx_equal(mafs::inverse_perspective(p) * p, id), "inverse_perspective (perspective)");
+
+        mafs::mat4 fr = mafs::frustum(-1.0f, 2.0f, -0.5f, 1.5f, 1.0f, 20.0f, mafs::clip_depth::zero_to_one);
+        assert_true(approx_equal(mafs::inverse_perspective(fr) * fr, id), "inverse_perspective (off-center frustum)");
+
+        mafs::mat4 rz = mafs::perspective_infinite_reversed_z(fovy, 1.5f, 0.1f);
+        assert_true(approx_equal(mafs::inverse_perspective(rz) * rz, id), "inverse_perspective (reversed-z)");
+
+        mafs::vec3f world{ 0.3f, -0.2f, -7.0f };
+        mafs::vec3f ndc = project(rz, world);
+        mafs::vec3f back = project(mafs::inverse_perspective(rz), ndc);
+        assert_true(approx_equal(back.x, world.x, 1e-4f) && approx_equal(back.z, world.z, 1e-3f), "reversed-z unproject");
+
+        mafs::mat4 o = mafs::ortho(-3.0f, 1.0f, -2.0f, 4.0f, 0.5f, 30.0f);
+        assert_true(approx_equal(mafs::inverse_ortho(o) * o, id), "inverse_ortho");
+
+        mafs::mat4 v = mafs::look_at(mafs::vec3f{ 3.0f, 4.0f, -2.0f }, mafs::vec3f{ 1.0f, 0.0f, 1.0f }, mafs::vec3f{ 0.0f, 1.0f, 0.0f });
+        assert_true(approx_equal(mafs::inverse_rigid(v) * v, id), "inverse_rigid (look_at)");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing mat basics..." << std::endl;
+    mafs::test::test_mat_basics();
+
+    std::cout << "\nTesting projection and view builders..." << std::endl;
+    mafs::test::test_projection();
+
+    std::cout << "\nTesting analytical inverses..." << std::endl;
+    mafs::test::test_inverses();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "../include/mafs/morton.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    // One bit at a time.
+    uint64_t interleave(const mafs::vec3i& c, unsigned bits) {
+        uint64_t res = 0;
+        for (unsigned i = 0; i < bits; i++)
+            for (unsigned a = 0; a < 3; a++)
+                res |= uint64_t((uint32_t(c[a]) >> i) & 1u) << (3 * i + a);
+        return res;
+    }
+
+    void test_encoding() {
+        static_assert(mafs::morton_encode_30(mafs::vec3i{ 1, 0, 0 }) == 1 && mafs::morton_encode_30(mafs::vec3i{ 0, 1, 0 }) == 2 && mafs::morton_encode_30(mafs::vec3i{ 0, 0, 1 }) == 4);
+        static_assert(mafs::morton_encode_63(mafs::vec3i{ 0, 0, (1 << 21) - 1 }) == 0x4924924924924924ull);
+        static_assert(mafs::morton_decode_30(mafs::morton_encode_30(mafs::vec3i{ 1023, 5, 600 })).z == 600);
+
+        std::mt19937 rng(41);
+        bool match30 = true, match63 = true, round_trip = true;
+        for (int i = 0; i < 100000; i++) {
+            const mafs::vec3i c30{ int(rng() & 1023), int(rng() & 1023), int(rng() & 1023) };
+            const mafs::vec3i c63{ int(rng() & 0x1fffff), int(rng() & 0x1fffff), int(rng() & 0x1fffff) };
+            match30 = match30 && mafs::morton_encode_30(c30) == interleave(c30, 10);
+            match63 = match63 && mafs::morton_encode_63(c63) == interleave(c63, 21);
+            round_trip = round_trip && mafs::morton_decode_30(mafs::morton_encode_30(c30)) == c30 && mafs::morton_decode_63(mafs::morton_encode_63(c63)) == c63;
+        }
+        assert_true(match30, "30-bit codes interleave the bits");
+        assert_true(match63, "63-bit codes interleave the bits");
+        assert_true(round_trip, "decode inverts encode");
+
+        // Within one octant of the grid the codes stay below those of the next octant.
+        const uint32_t corner = mafs::morton_encode_30(mafs::vec3i{ 511, 511, 511 });
+        assert_true(corner < mafs::morton_encode_30(mafs::vec3i{ 512, 0, 0 }) && corner == (1u << 27) - 1, "octants are contiguous in code order");
+    }
+
+    void test_points() {
+        const mafs::aabb3f bounds(mafs::vec3f{ -1.0f, 0.0f, 10.0f }, mafs::vec3f{ 1.0f, 4.0f, 10.0f });
+        assert_true(mafs::morton_code_30(bounds.min, bounds) == 0, "min corner is code 0");
+        // The z extent is zero, so z always maps to cell 0.
+        assert_true(mafs::morton_decode_30(mafs::morton_code_30(bounds.max, bounds)) == mafs::vec3i{ 1023, 1023, 0 }, "max corner is the last cell");
+        assert_true(mafs::morton_decode_63(mafs::morton_code_63(mafs::vec3f{ -5.0f, 2.0f, 50.0f }, bounds)) == mafs::vec3i{ 0, 1 << 20, 0 }, "outside points are clamped");
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> pos(-2.0f, 5.0f);
+        std::vector<mafs::vec3f> points(70000);
+        for (mafs::vec3f& p : points)
+            p = mafs::vec3f{ pos(rng), pos(rng), pos(rng) + 10.0f };
+        std::vector<mafs::vec3i> cells(points.size());
+        for (size_t i = 0; i < points.size(); i++)
+            cells[i] = mafs::morton_decode_63(mafs::morton_code_63(points[i], bounds));
+        bool same = true;
+        for (size_t threads : { 1, 4 }) {
+            std::vector<uint32_t> codes30(points.size());
+            std::vector<uint64_t> codes63(points.size()), from_cells(points.size());
+            mafs::morton_codes(std::span<const mafs::vec3f>(points), bounds, std::span<uint32_t>(codes30), threads);
+            mafs::morton_codes(std::span<const mafs::vec3f>(points), bounds, std::span<uint64_t>(codes63), threads);
+            mafs::morton_codes(std::span<const mafs::vec3i>(cells), std::span<uint64_t>(from_cells), threads);
+            for (size_t i = 0; i < points.size(); i++)
+                same = same && codes30[i] == mafs::morton_code_30(points[i], bounds) && codes63[i] == mafs::morton_code_63(points[i], bounds) && from_cells[i] == codes63[i];
+        }
+        assert_true(same, "batched codes match single codes");
+
+        std::vector<uint32_t> codes, order;
+        mafs::morton_order(std::span<const mafs::vec3f>(points), bounds, codes, order, 3);
+        bool sorted = true;
+        for (size_t i = 0; i < points.size(); i++) {
+            sorted = sorted && codes[i] == mafs::morton_code_30(points[order[i]], bounds);
+            sorted = sorted && (i == 0 || codes[i - 1] < codes[i] || (codes[i - 1] == codes[i] && order[i - 1] < order[i]));
+        }
+        assert_true(sorted, "morton_order sorts points by code");
+    }
+
+    template<typename K>
+    void check_radix_sort(size_t count, size_t key_bits, const std::string& name) {
+        std::mt19937_64 rng(count + key_bits);
+        std::vector<K> keys(count);
+        // Few distinct keys so stability shows, and a constant high byte so a pass is skipped.
+        for (K& k : keys)
+            k = K(rng() % 5000) | (K(0x5a) << (key_bits - 8));
+        std::vector<std::pair<K, uint32_t>> expect(count);
+        for (size_t i = 0; i < count; i++)
+            expect[i] = { keys[i], uint32_t(i) };
+        std::stable_sort(expect.begin(), expect.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        bool same = true;
+        for (size_t threads : { 1, 2, 5 }) {
+            std::vector<K> k = keys;
+            std::vector<uint32_t> v(count);
+            for (size_t i = 0; i < count; i++)
+                v[i] = uint32_t(i);
+            mafs::radix_sort(std::span<K>(k), std::span<uint32_t>(v), key_bits, threads);
+            for (size_t i = 0; i < count; i++)
+                same = same && k[i] == expect[i].first && v[i] == expect[i].second;
+        }
+        assert_true(same, name);
+    }
+
+    void test_radix_sort() {
+        check_radix_sort<uint32_t>(300000, 30, "32-bit keys match std::stable_sort");
+        check_radix_sort<uint64_t>(200000, 63, "64-bit keys match std::stable_sort");
+        check_radix_sort<uint32_t>(1000, 16, "small input");
+
+        std::vector<uint32_t> keys{ 3, 1, 2 }, values{ 30, 10, 20 };
+        mafs::radix_sort(std::span<uint32_t>(keys), std::span<uint32_t>(values));
+        assert_true(keys == std::vector<uint32_t>{ 1, 2, 3 } && values == std::vector<uint32_t>{ 10, 20, 30 }, "values follow their keys");
+        std::vector<uint32_t> none;
+        mafs::radix_sort(std::span<uint32_t>(none), std::span<uint32_t>(none));
+        assert_true(none.empty(), "empty input");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing Morton encoding..." << std::endl;
+    mafs::test::test_encoding();
+
+    std::cout << "\nTesting Morton codes of points..." << std::endl;
+    mafs::test::test_points();
+
+    std::cout << "\nTesting radix sort..." << std::endl;
+    mafs::test::test_radix_sort();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include "../include/mafs/normals.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    bool near(const mafs::vec3f& a, const mafs::vec3f& b, float eps) {
+        return (a - b).norm() <= eps;
+    }
+
+    struct mesh {
+        std::vector<mafs::vec3f> positions;
+        std::vector<mafs::vec<float, 2>> uvs;
+        std::vector<uint32_t> indices;
+    };
+
+    // A grid of (n + 1)^2 vertices over [0, 1]^2, each quad split along its diagonal.
+    mesh grid(uint32_t n, bool mirrored_u = false) {
+        mesh m;
+        for (uint32_t j = 0; j <= n; j++)
+            for (uint32_t i = 0; i <= n; i++) {
+                const float u = float(i) / float(n), v = float(j) / float(n);
+                m.positions.push_back(mafs::vec3f{ u, v, 0.0f });
+                m.uvs.push_back(mafs::vec<float, 2>{ mirrored_u ? -u : u, v });
+            }
+        for (uint32_t j = 0; j < n; j++)
+            for (uint32_t i = 0; i < n; i++) {
+                const uint32_t a = j * (n + 1) + i, b = a + 1, c = a + n + 1, d = c + 1;
+                m.indices.insert(m.indices.end(), { a, b, d, a, d, c });
+            }
+        return m;
+    }
+
+    // A latitude-longitude sphere with a seam column and u around the equator; poles excluded.
+    mesh sphere(uint32_t rings, uint32_t segments) {
+        mesh m;
+        for (uint32_t j = 1; j < rings; j++)
+            for (uint32_t i = 0; i <= segments; i++) {
+                const float theta = 3.14159265f * float(j) / float(rings), phi = 6.2831853f * float(i) / float(segments);
+                m.positions.push_back(mafs::vec3f{ std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) });
+                m.uvs.push_back(mafs::vec<float, 2>{ float(i) / float(segments), float(j) / float(rings) });
+            }
+        for (uint32_t j = 0; j + 2 < rings; j++)
+            for (uint32_t i = 0; i < segments; i++) {
+                const uint32_t a = j * (segments + 1) + i, b = a + 1, c = a + segments + 1, d = c + 1;
+                m.indices.insert(m.indices.end(), { a, c, d, a, d, b });
+            }
+        return m;
+    }
+
+    // Sphere vertices off the seam and the rings next to the poles, whose triangles are all on one side.
+    bool sphere_interior(size_t v, uint32_t rings, uint32_t segments) {
+        const size_t row = v / (segments + 1), column = v % (segments + 1);
+        return row > 0 && row + 2 < rings && column > 0 && column < segments;
+    }
+
+    void test_normals() {
+        // A cube of 8 shared corners; vertex 1 is in two triangles of one face and one of the others.
+        const std::vector<mafs::vec3f> cube = {
+            { -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+            { -1, -1, 1 }, { 1, -1, 1 }, { 1, 1, 1 }, { -1, 1, 1 },
+        };
+        const std::vector<uint32_t> cube_indices = {
+            0, 2, 1, 0, 3, 2,  4, 5, 6, 4, 6, 7,  0, 1, 5, 0, 5, 4,
+            2, 3, 7, 2, 7, 6,  1, 2, 6, 1, 6, 5,  0, 4, 7, 0, 7, 3,
+        };
+        mafs::mesh_normals normals;
+        normals.build(cube_indices, cube.size());
+        std::vector<mafs::vec3f> out(cube.size());
+        normals.compute_normals(cube, out, mafs::normal_weighting::angle);
+        bool diagonal = true;
+        for (size_t v = 0; v < cube.size(); v++)
+            diagonal = diagonal && near(out[v], cube[v].normalize(), 1e-5f);
+        assert_true(diagonal, "angle-weighted cube normals are the diagonals");
+        normals.compute_normals(cube, out, mafs::normal_weighting::area);
+        assert_true(!near(out[1], cube[1].normalize(), 1e-2f) && std::abs(out[1].norm() - 1.0f) < 1e-5f, "area-weighted normals follow the triangulation");
+
+        const mesh s = sphere(32, 64);
+        normals.build(s.indices, s.positions.size());
+        out.resize(s.positions.size());
+        float worst = 0.0f;
+        for (auto weighting : { mafs::normal_weighting::area, mafs::normal_weighting::angle }) {
+            normals.compute_normals(s.positions, out, weighting);
+            for (size_t v = 0; v < out.size(); v++)
+                if (sphere_interior(v, 32, 64))
+                    worst = std::max(worst, (out[v] - s.positions[v]).norm());
+        }
+        assert_true(worst < 0.01f, "sphere normals point outward");
+
+        // An unused vertex and a degenerate triangle.
+        const std::vector<mafs::vec3f> flat = { { 0, 0, 0 }, { 1, 0, 0 }, { 2, 0, 0 }, { 5, 5, 5 } };
+        const std::vector<uint32_t> flat_indices = { 0, 1, 2 };
+        normals.build(flat_indices, flat.size());
+        out.resize(flat.size());
+        normals.compute_normals(flat, out);
+        assert_true(out[0] == mafs::vec3f(0.0f, 0.0f, 1.0f) && out[3] == mafs::vec3f(0.0f, 0.0f, 1.0f), "degenerate vertices fall back to +z");
+    }
+
+    void test_tangents() {
+        mafs::mesh_normals normals;
+        for (bool mirrored : { false, true }) {
+            const mesh m = grid(5, mirrored);
+            normals.build(m.indices, m.positions.size());
+            std::vector<mafs::vec3f> n(m.positions.size());
+            std::vector<mafs::vec4f> t(m.positions.size());
+            normals.compute_normals(m.positions, n);
+            normals.compute_tangents(m.positions, n, m.uvs, t);
+            bool exact = true;
+            const float sign = mirrored ? -1.0f : 1.0f;
+            for (size_t v = 0; v < t.size(); v++) {
+                const mafs::vec3f bitangent = n[v].cross(t[v].xyz()) * t[v].w;
+                exact = exact && near(t[v].xyz(), mafs::vec3f{ sign, 0.0f, 0.0f }, 1e-5f) && t[v].w == sign && near(bitangent, mafs::vec3f{ 0.0f, 1.0f, 0.0f }, 1e-5f);
+            }
+            assert_true(exact, mirrored ? "mirrored UVs flip the tangent and w" : "plane tangents follow u, bitangents v");
+        }
+
+        // On the sphere u runs east: the tangent is the unit longitude direction.
+        const mesh s = sphere(32, 64);
+        normals.build(s.indices, s.positions.size());
+        std::vector<mafs::vec3f> n(s.positions.size());
+        std::vector<mafs::vec4f> t(s.positions.size());
+        normals.compute_normals(s.positions, n);
+        normals.compute_tangents(s.positions, n, s.uvs, t);
+        float worst = 0.0f, orthogonal = 0.0f;
+        bool signs = true;
+        for (size_t v = 0; v < t.size(); v++) {
+            const mafs::vec3f& p = s.positions[v];
+            const mafs::vec3f east = mafs::vec3f{ -p.y, p.x, 0.0f }.normalize();
+            if (sphere_interior(v, 32, 64))
+                worst = std::max(worst, (t[v].xyz() - east).norm());
+            orthogonal = std::max(orthogonal, std::abs(t[v].xyz().dot(n[v])));
+            // v runs south, and cross(outward, east) points north.
+            signs = signs && t[v].w == -1.0f;
+        }
+        assert_true(worst < 0.02f && orthogonal < 1e-5f, "sphere tangents run along u in the tangent plane");
+        assert_true(signs, "sphere bitangent sign");
+
+        std::vector<uint32_t> packed(t.size());
+        normals.compute_tangents(s.positions, n, s.uvs, packed);
+        bool round_trip = true;
+        for (size_t v = 0; v < t.size(); v++) {
+            const mafs::vec4f u = mafs::mesh_normals::unpack_tangent(packed[v]);
+            round_trip = round_trip && near(u.xyz(), t[v].xyz(), 5e-4f) && u.w == t[v].w;
+        }
+        assert_true(round_trip, "packed tangents round trip");
+    }
+
+    void test_packed_and_threads() {
+        // Large enough for build() to count in several chunks.
+        const mesh m = grid(160);
+        mafs::mesh_normals one, many;
+        one.build(m.indices, m.positions.size(), 1);
+        many.build(m.indices, m.positions.size(), 4);
+        assert_true(one.corners == many.corners && one.corner_offsets == many.corner_offsets, "corner order does not depend on threads");
+
+        std::vector<mafs::vec3f> curved = m.positions;
+        for (mafs::vec3f& p : curved)
+            p.z = std::sin(p.x * 7.0f) * std::cos(p.y * 5.0f) * 0.2f;
+        std::vector<mafs::vec3f> a(curved.size()), b(curved.size());
+        one.compute_normals(curved, a, mafs::normal_weighting::angle, 1);
+        many.compute_normals(curved, b, mafs::normal_weighting::angle, 4);
+        assert_true(a == b, "normals do not depend on threads");
+
+        std::vector<uint32_t> packed(curved.size());
+        many.compute_normals(curved, std::span<uint32_t>(packed), mafs::normal_weighting::angle, 4);
+        const mafs::quantization_error e = mafs::unit_vec_codec32::measure(a, packed);
+        assert_true(e.max < 1e-4f, "packed normals within the codec error");
+
+        std::vector<mafs::vec4f> ta(curved.size()), tb(curved.size());
+        one.compute_tangents(curved, a, m.uvs, ta, 1);
+        many.compute_tangents(curved, a, m.uvs, tb, 4);
+        assert_true(ta == tb, "tangents do not depend on threads");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing normals..." << std::endl;
+    mafs::test::test_normals();
+
+    std::cout << "\nTesting tangents..." << std::endl;
+    mafs::test::test_tangents();
+
+    std::cout << "\nTesting packed output and threads..." << std::endl;
+    mafs::test::test_packed_and_threads();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include "../include/mafs/octree.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    // Boxes of mixed sizes, a few of them partly or wholly outside the world.
+    mafs::aabb3f random_box(std::mt19937& rng) {
+        std::uniform_real_distribution<float> pos(-55.0f, 55.0f), unit(0.0f, 1.0f);
+        const float size = unit(rng) < 0.05f ? 20.0f * unit(rng) : 1.5f * unit(rng) * unit(rng);
+        const mafs::vec3f c{ pos(rng), pos(rng), pos(rng) };
+        return mafs::aabb3f::from_center_extents(c, mafs::vec3f{ size, size * unit(rng), size * 0.5f } + 0.001f);
+    }
+
+    // Every object sits in the list of its node, inside that node's loose bounds unless it is
+    // in the root, and the node links are consistent.
+    bool check_tree(const mafs::loose_octreef& tree) {
+        using octree = mafs::loose_octreef;
+        bool ok = true;
+        size_t objects = 0;
+        std::vector<bool> free_node(tree.nodes.size(), false);
+        for (uint32_t n : tree.free_nodes)
+            free_node[n] = true;
+        for (uint32_t n = 0; n < tree.nodes.size(); n++) {
+            if (free_node[n])
+                continue;
+            const octree::node& node = tree.nodes[n];
+            uint32_t count = 0;
+            for (uint32_t h = node.first_object; h != octree::none; h = tree.objects[h].next) {
+                ok = ok && tree.objects[h].node == n;
+                ok = ok && (n == 0 || octree::loose_bounds(node).contains(tree.objects[h].bounds));
+                count++;
+            }
+            ok = ok && count == node.object_count;
+            objects += count;
+            bool has_children = false;
+            for (uint32_t c : node.children)
+                if (c != octree::none) {
+                    ok = ok && !free_node[c] && tree.nodes[c].parent == n && tree.nodes[c].half == node.half * 0.5f;
+                    has_children = true;
+                }
+            // Empty leaves are pruned.
+            ok = ok && (n == 0 || count > 0 || has_children);
+        }
+        return ok && objects == tree.size();
+    }
+
+    template<typename Query, typename Test>
+    bool same_as_brute_force(const mafs::loose_octreef& tree, const std::vector<uint32_t>& live, Query&& query, Test&& test) {
+        std::vector<uint32_t> got, expect;
+        query([&](uint32_t h) { got.push_back(h); });
+        for (uint32_t h : live)
+            if (test(tree.bounds(h)))
+                expect.push_back(h);
+        std::sort(got.begin(), got.end());
+        std::sort(expect.begin(), expect.end());
+        return got == expect;
+    }
+
+    void test_updates() {
+        std::mt19937 rng(31);
+        std::uniform_real_distribution<float> step(-0.3f, 0.3f);
+        mafs::loose_octreef tree(mafs::aabb3f(mafs::vec3f(-50.0f), mafs::vec3f(50.0f)), 6);
+        std::vector<uint32_t> live;
+        for (int i = 0; i < 3000; i++)
+            live.push_back(tree.insert(random_box(rng)));
+        assert_true(tree.size() == 3000 && check_tree(tree), "inserts build a valid tree");
+
+        // Small moves mostly stay in their nodes; jumps relocate.
+        size_t stayed = 0;
+        for (uint32_t h : live) {
+            const mafs::vec3f d{ step(rng), step(rng), step(rng) };
+            stayed += tree.move(h, mafs::aabb3f(tree.bounds(h).min + d, tree.bounds(h).max + d));
+        }
+        for (size_t i = 0; i < live.size(); i += 3)
+            tree.move(live[i], random_box(rng));
+        assert_true(stayed > live.size() / 2 && check_tree(tree), "moves keep the tree valid");
+
+        // Remove half, reinsert some; handles are reused.
+        std::shuffle(live.begin(), live.end(), rng);
+        for (size_t i = 0; i < 1500; i++)
+            tree.remove(live[i]);
+        live.erase(live.begin(), live.begin() + 1500);
+        bool reused = true;
+        for (int i = 0; i < 500; i++) {
+            const uint32_t h = tree.insert(random_box(rng));
+            reused = reused && h < 3000;
+            live.push_back(h);
+        }
+        assert_true(reused && tree.size() == 2000 && check_tree(tree), "removal and handle reuse");
+
+        for (uint32_t h : live)
+            tree.remove(h);
+        assert_true(tree.size() == 0 && tree.node_count() == 1, "removing everything prunes to the root");
+        tree.insert(random_box(rng));
+        tree.clear();
+        assert_true(tree.size() == 0 && tree.node_count() == 1 && tree.objects.empty(), "clear");
+    }
+
+    void test_queries() {
+        std::mt19937 rng(32);
+        std::uniform_real_distribution<float> pos(-60.0f, 60.0f), unit(0.0f, 1.0f), dir(-1.0f, 1.0f);
+        mafs::loose_octreef tree(mafs::aabb3f(mafs::vec3f(-50.0f), mafs::vec3f(50.0f)));
+        std::vector<uint32_t> live;
+        for (int i = 0; i < 4000; i++)
+            live.push_back(tree.insert(random_box(rng)));
+        for (size_t i = 0; i < live.size(); i += 2)
+            tree.move(live[i], random_box(rng));
+
+        bool boxes = true, spheres = true, frustums = true, rays = true;
+        for (int i = 0; i < 100; i++) {
+            const mafs::aabb3f box = random_box(rng).expand(10.0f * unit(rng));
+            boxes = boxes && same_as_brute_force(tree, live,
+                [&](auto fn) { tree.query(box, fn); }, [&](const mafs::aabb3f& b) { return b.overlaps(box); });
+
+            const mafs::spheref s{ mafs::vec3f{ pos(rng), pos(rng), pos(rng) }, 15.0f * unit(rng) };
+            spheres = spheres && same_as_brute_force(tree, live,
+                [&](auto fn) { tree.query(s, fn); }, [&](const mafs::aabb3f& b) { return b.distance_squared(s.center) <= s.radius * s.radius; });
+
+            const mafs::vec3f eye{ pos(rng), pos(rng), pos(rng) };
+            const mafs::mat4f view = mafs::look_at(eye, eye + mafs::vec3f{ dir(rng), dir(rng), dir(rng) }, mafs::vec3f{ 0.0f, 1.0f, 0.0f });
+            const mafs::view_frustumf f = mafs::view_frustumf::from_matrix(mafs::perspective(0.5f + unit(rng), 1.5f, 0.1f, 10.0f + 80.0f * unit(rng)) * view);
+            frustums = frustums && same_as_brute_force(tree, live,
+                [&](auto fn) { tree.query(f, fn); }, [&](const mafs::aabb3f& b) { return f.intersects(b); });
+
+            const mafs::rayf r(eye, mafs::vec3f{ dir(rng), dir(rng), dir(rng) });
+            const float t_max = i % 2 == 0 ? 1000.0f : 20.0f;
+            rays = rays && same_as_brute_force(tree, live,
+                [&](auto fn) { tree.query(r, t_max, fn); }, [&](const mafs::aabb3f& b) { return b.intersects(r, t_max); });
+        }
+        assert_true(boxes, "box queries match brute force");
+        assert_true(spheres, "sphere queries match brute force");
+        assert_true(frustums, "frustum queries match brute force");
+        assert_true(rays, "ray queries match brute force");
+
+        size_t count = 0;
+        tree.query(mafs::spheref{ mafs::vec3f(0.0f), -1.0f }, [&](uint32_t) { count++; });
+        assert_true(count == 0, "empty sphere finds nothing");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing octree updates..." << std::endl;
+    mafs::test::test_updates();
+
+    std::cout << "\nTesting octree queries..." << std::endl;
+    mafs::test::test_queries();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
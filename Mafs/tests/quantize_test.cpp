@@ -0,0 +1,131 @@
+#include "../include/mafs/quantize.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T, size_t N>
+    bool approx_equal(const mafs::vec<T, N>& a, const mafs::vec<T, N>& b, T eps = T(1e-4)) {
+        for (size_t i = 0; i < N; i++)
+            if (!approx_equal(a[i], b[i], eps)) return false;
+        return true;
+    }
+
+    std::vector<mafs::quatf> random_rotations(size_t count) {
+        std::mt19937 rng(3);
+        std::normal_distribution<float> dist;
+        std::vector<mafs::quatf> res(count);
+        for (mafs::quatf& q : res)
+            q = mafs::quatf(dist(rng), dist(rng), dist(rng), dist(rng)).normalize();
+        // Each component as the largest one, both signs, and exact axes.
+        res[0] = mafs::quatf(1.0f, 0.0f, 0.0f, 0.0f);
+        res[1] = mafs::quatf(0.0f, -1.0f, 0.0f, 0.0f);
+        res[2] = mafs::quatf(0.0f, 0.0f, 1.0f, 0.0f);
+        res[3] = mafs::quatf(0.0f, 0.0f, 0.0f, -1.0f);
+        res[4] = mafs::quatf(0.5f, -0.5f, 0.5f, -0.5f);
+        return res;
+    }
+
+    // Encodes in batch and checks it against the scalar path and the documented bound.
+    template<typename Codec>
+    void check_quat_codec(const std::string& name) {
+        const std::vector<mafs::quatf> rotations = random_rotations(1003);
+        std::vector<typename Codec::storage> codes(rotations.size());
+        std::vector<mafs::quatf> decoded(rotations.size());
+        Codec::encode_batch(std::span<const mafs::quatf>(rotations), std::span(codes));
+        Codec::decode_batch(std::span<const typename Codec::storage>(codes), std::span(decoded));
+
+        bool same = true, unit = true;
+        for (size_t i = 0; i < rotations.size(); i++) {
+            same = same && codes[i] == Codec::encode(rotations[i]) && approx_equal(decoded[i].q, Codec::decode(codes[i]).q, 1e-6f);
+            unit = unit && approx_equal(decoded[i].norm(), 1.0f, 1e-5f);
+            same = same && (uint64_t(codes[i]) >> Codec::bits) == 0;
+        }
+        assert_true(same, name + " batch matches scalar encode/decode");
+        assert_true(unit, name + " decodes unit quaternions");
+        const mafs::quantization_error err = Codec::measure(rotations, codes);
+        assert_true(err.max < Codec::max_angle_error && err.rms < err.max, name + " angle error within bound");
+    }
+
+    void test_quat_codecs() {
+        check_quat_codec<mafs::quat_codec29>("quat_codec29");
+        check_quat_codec<mafs::quat_codec32>("quat_codec32");
+        check_quat_codec<mafs::quat_codec48>("quat_codec48");
+        assert_true(approx_equal(mafs::quat_codec32::max_angle_error, 0.0048f, 1e-4f), "documented bound");
+        assert_true(sizeof(mafs::quat_codec32::storage) == 4 && sizeof(mafs::quat_codec48::storage) == 8, "storage sizes");
+
+        const mafs::quatf q = mafs::quatf::from_axis_angle(mafs::vec3f{ 0.0f, 0.6f, 0.8f }, 2.0f);
+        const mafs::quatf from_negated = mafs::quat_codec32::decode(mafs::quat_codec32::encode(-q));
+        assert_true(approx_equal(std::abs(from_negated.dot(q)), 1.0f, 1e-5f), "q and -q encode the same rotation");
+    }
+
+    void test_vec3_codec() {
+        const mafs::vec3f lo{ -100.0f, 0.0f, -8.0f }, hi{ 100.0f, 50.0f, 8.0f };
+        const mafs::vec3_codec<16> codec(lo, hi);
+        const mafs::vec3f step = codec.resolution();
+        assert_true(approx_equal(step, (hi - lo) / 65535.0f, 1e-7f), "resolution");
+
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<mafs::vec3f> points(517);
+        for (mafs::vec3f& p : points)
+            p = lo + (hi - lo) * mafs::vec3f{ unit(rng), unit(rng), unit(rng) };
+        points[0] = lo;
+        points[1] = hi;
+        std::vector<mafs::vec3_codec<16>::storage> codes(points.size());
+        std::vector<mafs::vec3f> decoded(points.size());
+        codec.encode_batch(std::span<const mafs::vec3f>(points), std::span(codes));
+        codec.decode_batch(std::span<const mafs::vec3_codec<16>::storage>(codes), std::span(decoded));
+
+        bool same = true, within = true;
+        for (size_t i = 0; i < points.size(); i++) {
+            same = same && codes[i] == codec.encode(points[i]) && decoded[i] == codec.decode(codes[i]);
+            for (size_t c = 0; c < 3; c++)
+                within = within && std::abs(decoded[i][c] - points[i][c]) <= step[c] * 0.51f;
+        }
+        assert_true(same, "batch matches scalar encode/decode");
+        assert_true(within, "error per axis at most half a step");
+        assert_true(decoded[0] == lo && approx_equal(decoded[1], hi), "bounds are exact");
+        const mafs::quantization_error err = codec.measure(points, codes);
+        assert_true(err.max <= step.norm() * 0.51f, "measured error");
+
+        const mafs::vec3f clamped = codec.decode(codec.encode(mafs::vec3f{ 1e30f, -1e30f, 0.0f }));
+        assert_true(approx_equal(clamped.x, hi.x) && clamped.y == lo.y && std::abs(clamped.z) <= step.z * 0.5f, "out-of-box values clamp");
+
+        // A flat axis decodes to its bound.
+        const mafs::vec3_codec<10> flat(mafs::vec3f{ 0.0f, 2.0f, 0.0f }, mafs::vec3f{ 1.0f, 2.0f, 1.0f });
+        assert_true(flat.decode(flat.encode(mafs::vec3f{ 0.5f, 7.0f, 0.25f })).y == 2.0f, "degenerate axis");
+        assert_true(sizeof(mafs::vec3_codec<10>::storage) == 4 && sizeof(mafs::vec3_codec<21>::storage) == 8, "storage sizes");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing smallest-three quaternion codecs..." << std::endl;
+    mafs::test::test_quat_codecs();
+
+    std::cout << "\nTesting bounded vec3 codec..." << std::endl;
+    mafs::test::test_vec3_codec();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
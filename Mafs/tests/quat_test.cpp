@@ -0,0 +1,175 @@
+#include "../include/mafs/quat.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T, size_t N>
+    bool approx_equal(const mafs::vec<T, N>& a, const mafs::vec<T, N>& b, T eps = T(1e-4)) {
+        for (size_t i = 0; i < N; i++)
+            if (!approx_equal(a[i], b[i], eps)) return false;
+        return true;
+    }
+
+    // Treats q and -q as the same rotation.
+    bool same_rotation(const mafs::quatf& a, const mafs::quatf& b, float eps = 1e-4f) {
+        return approx_equal(std::abs(a.dot(b)), 1.0f, eps);
+    }
+
+    mafs::quatf random_quat(std::mt19937& rng) {
+        std::normal_distribution<float> dist(0.0f, 1.0f);
+        return mafs::quatf(dist(rng), dist(rng), dist(rng), dist(rng)).normalize();
+    }
+
+    void test_product() {
+        const mafs::vec3f z{ 0.0f, 0.0f, 1.0f };
+        mafs::quatf a = mafs::quatf::from_axis_angle(z, 0.5f);
+        mafs::quatf b = mafs::quatf::from_axis_angle(z, 0.75f);
+        assert_true(same_rotation(a * b, mafs::quatf::from_axis_angle(z, 1.25f)), "product adds angles about one axis");
+
+        // Hamilton product matches matrix composition.
+        std::mt19937 rng(1);
+        bool ok = true;
+        for (int i = 0; i < 100; i++) {
+            mafs::quatf p = random_quat(rng), q = random_quat(rng);
+            mafs::mat3f m = p.to_mat3() * q.to_mat3();
+            mafs::mat3f pq = (p * q).to_mat3();
+            for (size_t c = 0; c < 3; c++)
+                ok = ok && approx_equal(m[c], pq[c]);
+        }
+        assert_true(ok, "product matches matrix composition");
+
+        mafs::quatf c = a;
+        c *= b;
+        assert_true(c == a * b, "operator*=");
+        assert_true(same_rotation(a * a.inverse(), mafs::quatf::identity()), "inverse");
+
+        mafs::quatf h(0.0f, 0.0f, 0.0f, 2.0f);
+        assert_true(approx_equal((h * h.inverse()).q, mafs::quatf::identity().q), "inverse of non-unit quaternion");
+    }
+
+    void test_rotate() {
+        mafs::quatf r = mafs::quatf::from_axis_angle(mafs::vec3f{ 0.0f, 0.0f, 1.0f }, 3.14159265f * 0.5f);
+        assert_true(approx_equal(r * mafs::vec3f{ 1.0f, 0.0f, 0.0f }, mafs::vec3f{ 0.0f, 1.0f, 0.0f }), "rotate x by 90 deg about z");
+
+        std::mt19937 rng(2);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        bool ok = true;
+        for (int i = 0; i < 100; i++) {
+            mafs::quatf q = random_quat(rng);
+            mafs::vec3f v{ dist(rng), dist(rng), dist(rng) };
+            ok = ok && approx_equal(q.rotate(v), q.to_mat3() * v);
+        }
+        assert_true(ok, "rotate matches to_mat3");
+
+        constexpr mafs::quatf cq(0.0f, 0.0f, 1.0f, 0.0f);
+        constexpr mafs::vec3f cv = cq * mafs::vec3f{ 1.0f, 2.0f, 3.0f };
+        static_assert(cv.x == -1.0f && cv.y == -2.0f && cv.z == 3.0f, "rotate is usable in constant expressions");
+        assert_true(approx_equal(cq * mafs::vec3f{ 1.0f, 2.0f, 3.0f }, cv), "rotate gives the same result at run time");
+    }
+
+    void test_conversions() {
+        std::mt19937 rng(3);
+        bool ok3 = true, ok4 = true;
+        for (int i = 0; i < 100; i++) {
+            mafs::quatf q = random_quat(rng);
+            ok3 = ok3 && same_rotation(mafs::quatf::from_mat3(q.to_mat3()), q);
+            ok4 = ok4 && same_rotation(mafs::quatf::from_mat4(q.to_mat4()), q);
+        }
+        assert_true(ok3, "mat3 round trip");
+        assert_true(ok4, "mat4 round trip");
+
+        mafs::mat4f m = mafs::quatf::identity().to_mat4();
+        assert_true(m == mafs::mat4f::identity(), "identity to_mat4");
+    }
+
+    void test_interpolation() {
+        const mafs::vec3f y{ 0.0f, 1.0f, 0.0f };
+        mafs::quatf a = mafs::quatf::identity();
+        mafs::quatf b = mafs::quatf::from_axis_angle(y, 2.0f);
+        assert_true(same_rotation(mafs::slerp(a, b, 0.25f), mafs::quatf::from_axis_angle(y, 0.5f)), "slerp has constant angular velocity");
+        assert_true(same_rotation(mafs::nlerp(a, b, 0.0f), a) && same_rotation(mafs::nlerp(a, b, 1.0f), b), "nlerp endpoints");
+        assert_true(same_rotation(mafs::slerp(a, -b, 0.5f), mafs::quatf::from_axis_angle(y, 1.0f)), "slerp takes the shorter arc");
+        assert_true(same_rotation(mafs::slerp(a, a, 0.3f), a), "slerp of equal quaternions");
+
+        // Worst rotation-angle deviation of slerp_fast from slerp, measured in double so
+        // acos near 1 does not swamp the result.
+        std::mt19937 rng(4);
+        double max_err = 0.0;
+        for (int i = 0; i < 2000; i++) {
+            mafs::quatf pf = random_quat(rng), qf = random_quat(rng);
+            mafs::quatd p(pf.q.x, pf.q.y, pf.q.z, pf.q.w), q(qf.q.x, qf.q.y, qf.q.z, qf.q.w);
+            for (int s = 0; s <= 64; s++) {
+                double t = double(s) / 64.0;
+                double d = std::min(std::abs(mafs::slerp(p, q, t).dot(mafs::slerp_fast(p, q, t))), 1.0);
+                max_err = std::max(max_err, 2.0 * std::acos(d));
+            }
+        }
+        std::cout << "slerp_fast max angular error: " << max_err << " rad" << std::endl;
+        assert_true(max_err < 2e-3, "slerp_fast stays within 2e-3 rad of slerp");
+    }
+
+    void test_batches() {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        const size_t count = 37;
+        std::vector<mafs::quatf> qs(count);
+        std::vector<mafs::vec3f> in(count), out(count);
+        for (size_t i = 0; i < count; i++) {
+            qs[i] = random_quat(rng);
+            in[i] = mafs::vec3f{ dist(rng), dist(rng), dist(rng) };
+        }
+
+        bool ok = true;
+        mafs::rotate_batch(qs[0], std::span<const mafs::vec3f>(in), std::span(out));
+        for (size_t i = 0; i < count; i++)
+            ok = ok && approx_equal(out[i], qs[0] * in[i]);
+        assert_true(ok, "rotate_batch with one quaternion");
+
+        ok = true;
+        mafs::rotate_batch(std::span<const mafs::quatf>(qs), std::span<const mafs::vec3f>(in), std::span(out));
+        for (size_t i = 0; i < count; i++)
+            ok = ok && approx_equal(out[i], qs[i] * in[i]);
+        assert_true(ok, "rotate_batch with per-element quaternions");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing quaternion product..." << std::endl;
+    mafs::test::test_product();
+
+    std::cout << "\nTesting vector rotation..." << std::endl;
+    mafs::test::test_rotate();
+
+    std::cout << "\nTesting matrix conversions..." << std::endl;
+    mafs::test::test_conversions();
+
+    std::cout << "\nTesting interpolation..." << std::endl;
+    mafs::test::test_interpolation();
+
+    std::cout << "\nTesting batched rotation..." << std::endl;
+    mafs::test::test_batches();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include "../include/mafs/skinning.hpp"
+#include "../include/mafs/transform.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T, size_t N>
+    bool approx_equal(const mafs::vec<T, N>& a, const mafs::vec<T, N>& b, T eps = T(1e-4)) {
+        for (size_t i = 0; i < N; i++)
+            if (!approx_equal(a[i], b[i], eps)) return false;
+        return true;
+    }
+
+    mafs::mat3x4f to_mat3x4(const mafs::mat4f& m) {
+        return mafs::mat3x4f{ m[0].xyz(), m[1].xyz(), m[2].xyz(), m[3].xyz() };
+    }
+
+    // A random skinned mesh: rigid bones and four normalized influences per vertex.
+    struct test_mesh {
+        std::vector<mafs::quatf> rotations;
+        std::vector<mafs::vec3f> translations;
+        std::vector<mafs::skin_joints> joints;
+        std::vector<mafs::vec4f> weights;
+        std::vector<mafs::vec3f> positions, normals;
+
+        test_mesh(size_t bones, size_t vertices, unsigned seed) {
+            std::mt19937 rng(seed);
+            std::normal_distribution<float> dist;
+            std::uniform_real_distribution<float> unit(0.05f, 1.0f);
+            std::uniform_int_distribution<int> bone(0, int(bones) - 1);
+            for (size_t b = 0; b < bones; b++) {
+                rotations.push_back(mafs::quatf(dist(rng), dist(rng), dist(rng), dist(rng)).normalize());
+                translations.push_back(mafs::vec3f{ dist(rng), dist(rng), dist(rng) });
+            }
+            for (size_t v = 0; v < vertices; v++) {
+                joints.push_back(mafs::skin_joints{ uint16_t(bone(rng)), uint16_t(bone(rng)), uint16_t(bone(rng)), uint16_t(bone(rng)) });
+                mafs::vec4f w{ unit(rng), unit(rng), unit(rng), unit(rng) };
+                weights.push_back(w / (w.x + w.y + w.z + w.w));
+                positions.push_back(mafs::vec3f{ dist(rng), dist(rng), dist(rng) });
+                normals.push_back(mafs::vec3f{ dist(rng), dist(rng), dist(rng) }.normalize());
+            }
+        }
+        template<typename Bone>
+        mafs::skin_job<Bone> job(const std::vector<Bone>& palette, std::vector<mafs::vec3f>& out_positions, std::vector<mafs::vec3f>& out_normals) const {
+            out_positions.resize(positions.size());
+            out_normals.resize(normals.size());
+            return mafs::skin_job<Bone>{ palette, joints, weights, positions, normals, out_positions, out_normals };
+        }
+    };
+
+    void test_dual_quat() {
+        const mafs::quatf r = mafs::quatf::from_axis_angle(mafs::vec3f{ 0.0f, 0.6f, 0.8f }, 1.2f);
+        const mafs::vec3f t{ 1.0f, -2.0f, 3.0f };
+        const mafs::dual_quatf dq = mafs::dual_quatf::from_rotation_translation(r, t);
+        const mafs::vec3f p{ 0.5f, 0.25f, -1.0f };
+        assert_true(approx_equal(dq.transform_point(p), r * p + t), "transform_point rotates then translates");
+        assert_true(approx_equal(dq.translation(), t), "translation round trip");
+        assert_true(approx_equal(dq.transform_vector(p), r * p), "transform_vector ignores translation");
+
+        const mafs::mat4f m = mafs::compose_trs(t, r, mafs::vec3f(1.0f));
+        const mafs::dual_quatf from_m = mafs::dual_quatf::from_mat4(m);
+        assert_true(approx_equal(from_m.transform_point(p), dq.transform_point(p)), "from_mat4");
+        const mafs::mat4f back = dq.to_mat4();
+        bool ok = true;
+        for (size_t c = 0; c < 4; c++)
+            ok = ok && approx_equal(back[c], m[c]);
+        assert_true(ok, "to_mat4");
+
+        const mafs::dual_quatf other = mafs::dual_quatf::from_rotation_translation(mafs::quatf::from_axis_angle(mafs::vec3f{ 1.0f, 0.0f, 0.0f }, -0.7f), mafs::vec3f{ 0.0f, 4.0f, 0.0f });
+        assert_true(approx_equal((dq * other).transform_point(p), dq.transform_point(other.transform_point(p))), "product composes transforms");
+        assert_true(approx_equal((dq * 3.0f).normalize().transform_point(p), dq.transform_point(p)), "normalize removes scale");
+    }
+
+    void test_lbs() {
+        // 13 vertices: one full packet and a partial one.
+        const test_mesh mesh(6, 13, 1);
+        std::vector<mafs::mat4f> palette4;
+        std::vector<mafs::mat3x4f> palette3;
+        for (size_t b = 0; b < mesh.rotations.size(); b++) {
+            palette4.push_back(mafs::compose_trs(mesh.translations[b], mesh.rotations[b], mafs::vec3f{ 1.0f, 2.0f, 0.5f }));
+            palette3.push_back(to_mat3x4(palette4.back()));
+        }
+        std::vector<mafs::vec3f> p3, n3, p4, n4;
+        mafs::skin_lbs(mesh.job(palette3, p3, n3));
+        mafs::skin_lbs(mesh.job(palette4, p4, n4));
+
+        bool ok = true, same = true;
+        for (size_t v = 0; v < mesh.positions.size(); v++) {
+            mafs::mat4f blended(0.0f);
+            for (size_t k = 0; k < 4; k++)
+                for (size_t c = 0; c < 4; c++)
+                    blended[c] += palette4[mesh.joints[v][k]][c] * mesh.weights[v][k];
+            const mafs::vec4f p = blended * mafs::vec4f{ mesh.positions[v].x, mesh.positions[v].y, mesh.positions[v].z, 1.0f };
+            const mafs::vec4f n = blended * mafs::vec4f{ mesh.normals[v].x, mesh.normals[v].y, mesh.normals[v].z, 0.0f };
+            ok = ok && approx_equal(p3[v], p.xyz()) && approx_equal(n3[v], n.xyz().normalize());
+            same = same && approx_equal(p3[v], p4[v]) && approx_equal(n3[v], n4[v]);
+        }
+        assert_true(ok, "mat3x4 palette matches blended-matrix reference");
+        assert_true(same, "mat4 palette matches mat3x4 palette");
+    }
+
+    void test_dqs() {
+        const test_mesh mesh(6, 13, 2);
+        std::vector<mafs::dual_quatf> palette;
+        for (size_t b = 0; b < mesh.rotations.size(); b++)
+            palette.push_back(mafs::dual_quatf::from_rotation_translation(mesh.rotations[b], mesh.translations[b]));
+        std::vector<mafs::vec3f> out_p, out_n;
+        mafs::skin_dqs(mesh.job(palette, out_p, out_n));
+
+        bool ok = true;
+        for (size_t v = 0; v < mesh.positions.size(); v++) {
+            const mafs::dual_quatf& pivot = palette[mesh.joints[v][0]];
+            mafs::dual_quatf blended(mafs::quatf(0.0f, 0.0f, 0.0f, 0.0f), mafs::quatf(0.0f, 0.0f, 0.0f, 0.0f));
+            for (size_t k = 0; k < 4; k++) {
+                const mafs::dual_quatf& bone = palette[mesh.joints[v][k]];
+                blended = blended + bone * (bone.real.dot(pivot.real) < 0.0f ? -mesh.weights[v][k] : mesh.weights[v][k]);
+            }
+            blended = blended.normalize();
+            ok = ok && approx_equal(out_p[v], blended.transform_point(mesh.positions[v])) && approx_equal(out_n[v], blended.transform_vector(mesh.normals[v]));
+        }
+        assert_true(ok, "DQS matches scalar dual quaternion blend");
+
+        // A flipped bone is the same rotation and must not change the result.
+        std::vector<mafs::dual_quatf> flipped = palette;
+        for (mafs::dual_quatf& bone : flipped)
+            if (&bone != &flipped[0])
+                bone = bone * -1.0f;
+        std::vector<mafs::vec3f> flip_p, flip_n;
+        mafs::skin_dqs(mesh.job(flipped, flip_p, flip_n));
+        ok = true;
+        for (size_t v = 0; v < mesh.positions.size(); v++)
+            ok = ok && approx_equal(flip_p[v], out_p[v]) && approx_equal(flip_n[v], out_n[v]);
+        assert_true(ok, "DQS is invariant to antipodal bones");
+
+        // Two bones twisting in opposite directions: DQS keeps the distance to the axis,
+        // LBS collapses it (candy wrapper).
+        const mafs::vec3f axis{ 1.0f, 0.0f, 0.0f };
+        const std::vector<mafs::dual_quatf> twist{ mafs::dual_quatf::from_rotation_translation(mafs::quatf::from_axis_angle(axis, 1.4f), {}),
+            mafs::dual_quatf::from_rotation_translation(mafs::quatf::from_axis_angle(axis, -1.4f), {}) };
+        const std::vector<mafs::mat3x4f> twist_lbs{ to_mat3x4(twist[0].to_mat4()), to_mat3x4(twist[1].to_mat4()) };
+        const std::vector<mafs::skin_joints> joints{ mafs::skin_joints{ 0, 1, 0, 0 } };
+        const std::vector<mafs::vec4f> weights{ mafs::vec4f{ 0.5f, 0.5f, 0.0f, 0.0f } };
+        const std::vector<mafs::vec3f> positions{ mafs::vec3f{ 0.0f, 1.0f, 0.0f } };
+        std::vector<mafs::vec3f> dq_out(1), lbs_out(1);
+        mafs::skin_dqs(mafs::skin_job<mafs::dual_quatf>{ twist, joints, weights, positions, {}, dq_out, {} });
+        mafs::skin_lbs(mafs::skin_job<mafs::mat3x4f>{ twist_lbs, joints, weights, positions, {}, lbs_out, {} });
+        assert_true(approx_equal(dq_out[0].norm(), 1.0f) && lbs_out[0].norm() < 0.5f, "DQS preserves volume under twist");
+    }
+
+    void test_parallel() {
+        const test_mesh a(8, 1000, 3), b(8, 37, 4);
+        std::vector<mafs::mat3x4f> palette;
+        for (size_t i = 0; i < a.rotations.size(); i++)
+            palette.push_back(to_mat3x4(mafs::compose_trs(a.translations[i], a.rotations[i], mafs::vec3f(1.0f))));
+        std::vector<mafs::vec3f> pa, na, pb, nb, ref_pa, ref_na, ref_pb, ref_nb;
+        const std::vector<mafs::skin_job<mafs::mat3x4f>> jobs{ a.job(palette, pa, na), b.job(palette, pb, nb) };
+        // Small chunks and more threads than chunks of the small mesh.
+        mafs::skin_lbs(std::span<const mafs::skin_job<mafs::mat3x4f>>(jobs), 3, 64);
+        mafs::skin_lbs(a.job(palette, ref_pa, ref_na));
+        mafs::skin_lbs(b.job(palette, ref_pb, ref_nb));
+        assert_true(pa == ref_pa && na == ref_na && pb == ref_pb && nb == ref_nb, "multithreaded LBS matches single mesh");
+
+        std::vector<mafs::dual_quatf> dq_palette;
+        for (size_t i = 0; i < a.rotations.size(); i++)
+            dq_palette.push_back(mafs::dual_quatf::from_rotation_translation(a.rotations[i], a.translations[i]));
+        const std::vector<mafs::skin_job<mafs::dual_quatf>> dq_jobs{ a.job(dq_palette, pa, na), b.job(dq_palette, pb, nb) };
+        mafs::skin_dqs(std::span<const mafs::skin_job<mafs::dual_quatf>>(dq_jobs), 4, 100);
+        mafs::skin_dqs(a.job(dq_palette, ref_pa, ref_na));
+        mafs::skin_dqs(b.job(dq_palette, ref_pb, ref_nb));
+        assert_true(pa == ref_pa && na == ref_na && pb == ref_pb && nb == ref_nb, "multithreaded DQS matches single mesh");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing dual quaternions..." << std::endl;
+    mafs::test::test_dual_quat();
+
+    std::cout << "\nTesting linear blend skinning..." << std::endl;
+    mafs::test::test_lbs();
+
+    std::cout << "\nTesting dual quaternion skinning..." << std::endl;
+    mafs::test::test_dqs();
+
+    std::cout << "\nTesting multithreaded skinning..." << std::endl;
+    mafs::test::test_parallel();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "../include/mafs/spatial_hash.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    // Uniform particles plus a dense blob, with some on negative coordinates and cell borders.
+    std::vector<mafs::vec3f> make_particles(size_t count) {
+        std::mt19937 rng(21);
+        std::uniform_real_distribution<float> pos(-10.0f, 10.0f), tight(-0.3f, 0.3f);
+        std::vector<mafs::vec3f> points;
+        for (size_t i = 0; i < count; i++) {
+            if (i % 4 == 0)
+                points.push_back(mafs::vec3f{ 1.0f + tight(rng), -2.0f + tight(rng), tight(rng) });
+            else if (i % 9 == 0)
+                points.push_back(mafs::vec3f{ float(int(pos(rng))), float(int(pos(rng))), -1.0f });
+            else
+                points.push_back(mafs::vec3f{ pos(rng), pos(rng), pos(rng) });
+        }
+        return points;
+    }
+
+    void test_cells() {
+        const mafs::spatial_hash_grid grid(0.5f, 1000);
+        assert_true(grid.table_size() == 1024, "table size rounds up to a power of two");
+        assert_true(grid.cell(mafs::vec3f{ 0.25f, -0.25f, 1.0f }) == mafs::vec3i{ 0, -1, 2 }, "cells floor toward negative infinity");
+        bool in_range = true;
+        for (int i = -50; i < 50; i++)
+            in_range = in_range && grid.bucket(mafs::vec3i{ i, -i, i * 7 }) < grid.table_size();
+        assert_true(in_range, "buckets fall inside the table");
+    }
+
+    void test_build() {
+        const std::vector<mafs::vec3f> points = make_particles(50000);
+        mafs::spatial_hash_grid grid(0.75f, points.size());
+        grid.build(points, 1);
+        bool sorted = grid.cell_start.size() == grid.table_size() + 1 && grid.cell_start.back() == points.size();
+        std::vector<int> seen(points.size(), 0);
+        for (size_t b = 0; b < grid.table_size(); b++)
+            for (uint32_t s = grid.cell_start[b]; s < grid.cell_start[b + 1]; s++) {
+                sorted = sorted && grid.bucket(grid.cell(grid.positions[s])) == b && grid.positions[s] == points[grid.indices[s]];
+                // Stable: input order within a bucket.
+                sorted = sorted && (s == grid.cell_start[b] || grid.indices[s - 1] < grid.indices[s]);
+                seen[grid.indices[s]]++;
+            }
+        assert_true(sorted, "particles are sorted by bucket");
+        assert_true(std::all_of(seen.begin(), seen.end(), [](int s) { return s == 1; }), "every particle appears once");
+
+        bool same = true;
+        for (size_t threads : { 2, 3, 8 }) {
+            mafs::spatial_hash_grid threaded(0.75f, points.size());
+            threaded.build(points, threads);
+            same = same && threaded.cell_start == grid.cell_start && threaded.indices == grid.indices;
+        }
+        assert_true(same, "threaded builds give the same order");
+
+        // Rebuilding with fewer particles reuses the grid.
+        grid.build(std::span<const mafs::vec3f>(points.data(), 100), 4);
+        std::vector<uint32_t> found;
+        grid.radius_search(points[0], 0.75f, found);
+        const bool small = grid.size() == 100 && grid.cell_start.back() == 100 && std::all_of(found.begin(), found.end(), [](uint32_t i) { return i < 100; });
+        grid.build(std::span<const mafs::vec3f>());
+        found.clear();
+        grid.radius_search(points[0], 0.75f, found);
+        assert_true(small && grid.size() == 0 && found.empty(), "rebuilds and empty grids");
+    }
+
+    void test_queries() {
+        const std::vector<mafs::vec3f> points = make_particles(20000);
+        std::mt19937 rng(4);
+        std::uniform_real_distribution<float> pos(-11.0f, 11.0f);
+        bool match = true;
+        size_t total = 0;
+        // A tiny table forces many cells into each bucket.
+        for (size_t table : { size_t(64), points.size() }) {
+            mafs::spatial_hash_grid grid(1.0f, table);
+            grid.build(points);
+            for (int i = 0; i < 300; i++) {
+                const mafs::vec3f q = i % 2 == 0 ? mafs::vec3f{ pos(rng), pos(rng), pos(rng) } : points[size_t(i) * 50];
+                const float radius = i % 3 == 0 ? 1.0f : 0.3f;
+                std::vector<uint32_t> expect;
+                for (uint32_t j = 0; j < points.size(); j++)
+                    if ((points[j] - q).length_squared() <= radius * radius)
+                        expect.push_back(j);
+                std::vector<uint32_t> got;
+                grid.for_each_neighbor(q, radius, [&](uint32_t slot, float d) {
+                    match = match && d == (points[grid.indices[slot]] - q).length_squared();
+                    got.push_back(grid.indices[slot]);
+                });
+                std::sort(got.begin(), got.end());
+                match = match && got == expect;
+                total += got.size();
+            }
+        }
+        assert_true(match && total > 1000, "neighbor queries match brute force");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing cells and buckets..." << std::endl;
+    mafs::test::test_cells();
+
+    std::cout << "\nTesting spatial hash build..." << std::endl;
+    mafs::test::test_build();
+
+    std::cout << "\nTesting neighbor queries..." << std::endl;
+    mafs::test::test_queries();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include "../include/mafs/sphere.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    bool contains_all(const mafs::spheref& s, const std::vector<mafs::vec3f>& points) {
+        for (const mafs::vec3f& p : points)
+            if (!s.contains(p))
+                return false;
+        return true;
+    }
+
+    // Smallest of the spheres through 1 to 4 of the points that hold them all.
+    double brute_force_radius(const std::vector<mafs::vec3f>& points) {
+        std::vector<mafs::vec3d> p;
+        for (const mafs::vec3f& q : points)
+            p.push_back(mafs::vec3d{ q.x, q.y, q.z });
+        const size_t n = p.size();
+        double best = INFINITY;
+        auto consider = [&](std::initializer_list<size_t> idx) {
+            mafs::vec3d through[4];
+            size_t k = 0;
+            for (size_t i : idx)
+                through[k++] = p[i];
+            const mafs::sphered s = mafs::detail::sphere_through(through, k);
+            if (s.radius < 0.0)
+                return;
+            for (const mafs::vec3d& q : p)
+                if (q.distance(s.center) > s.radius * (1.0 + 1e-9) + 1e-9)
+                    return;
+            best = std::min(best, s.radius);
+        };
+        for (size_t a = 0; a < n; a++)
+            for (size_t b = a; b < n; b++) {
+                consider({ a, b });
+                for (size_t c = b + 1; c < n; c++) {
+                    consider({ a, b, c });
+                    for (size_t d = c + 1; d < n; d++)
+                        consider({ a, b, c, d });
+                }
+            }
+        return best;
+    }
+
+    std::vector<mafs::vec3f> random_points(size_t count, std::mt19937& rng, float offset) {
+        std::uniform_real_distribution<float> pos(-3.0f, 3.0f);
+        std::vector<mafs::vec3f> points(count);
+        for (mafs::vec3f& p : points)
+            p = mafs::vec3f{ pos(rng) + offset, pos(rng) * 0.5f, pos(rng) * 2.0f - offset };
+        return points;
+    }
+
+    void test_single() {
+        std::mt19937 rng(61);
+        bool contain = true, tight = true, exact = true;
+        for (int t = 0; t < 200; t++) {
+            const std::vector<mafs::vec3f> points = random_points(5 + t % 13, rng, float(t));
+            const mafs::spheref r = mafs::ritter_sphere(std::span<const mafs::vec3f>(points));
+            const mafs::spheref m = mafs::minimal_sphere(std::span<const mafs::vec3f>(points));
+            contain = contain && contains_all(r, points) && contains_all(m, points);
+            tight = tight && m.radius <= r.radius * 1.0001f;
+            exact = exact && std::abs(m.radius - brute_force_radius(points)) <= 1e-4 * m.radius;
+        }
+        assert_true(contain, "every point is inside both spheres");
+        assert_true(tight, "the minimal sphere is no larger than Ritter's");
+        assert_true(exact, "the minimal sphere matches brute force");
+
+        // Points on a sphere far from the origin: the minimal sphere is that sphere.
+        std::normal_distribution<float> normal;
+        std::vector<mafs::vec3f> shell(5000);
+        const mafs::vec3f center{ 1000.0f, -200.0f, 50.0f };
+        for (mafs::vec3f& p : shell)
+            p = center + mafs::vec3f{ normal(rng), normal(rng), normal(rng) }.normalize() * 4.0f;
+        const mafs::spheref m = mafs::minimal_sphere(std::span<const mafs::vec3f>(shell));
+        const mafs::spheref r = mafs::ritter_sphere(std::span<const mafs::vec3f>(shell));
+        assert_true(contains_all(m, shell) && m.center.distance(center) < 1e-3f && std::abs(m.radius - 4.0f) < 1e-3f, "points on a sphere");
+        assert_true(contains_all(r, shell) && r.radius < 4.0f * 1.25f, "Ritter stays close on a sphere");
+    }
+
+    void test_degenerate() {
+        const std::vector<mafs::vec3f> none;
+        assert_true(mafs::ritter_sphere(std::span<const mafs::vec3f>(none)).radius < 0.0f && mafs::minimal_sphere(std::span<const mafs::vec3f>(none)).radius < 0.0f, "no points give an empty sphere");
+
+        const std::vector<mafs::vec3f> one(20, mafs::vec3f{ 1.0f, 2.0f, 3.0f });
+        const mafs::spheref r1 = mafs::ritter_sphere(std::span<const mafs::vec3f>(one));
+        const mafs::spheref m1 = mafs::minimal_sphere(std::span<const mafs::vec3f>(one));
+        assert_true(r1.radius == 0.0f && m1.radius == 0.0f && m1.center == one[0] && contains_all(m1, one), "repeated point");
+
+        std::vector<mafs::vec3f> line;
+        for (int i = 0; i <= 30; i++)
+            line.push_back(mafs::vec3f{ 1.0f, 1.0f, 1.0f } * float(i % 2 ? i : -i));
+        const mafs::spheref m = mafs::minimal_sphere(std::span<const mafs::vec3f>(line));
+        assert_true(contains_all(m, line) && std::abs(m.radius - 29.5f * std::sqrt(3.0f)) < 1e-3f, "collinear points");
+
+        // Coplanar points on a circle: every four are cocircular.
+        std::vector<mafs::vec3f> circle;
+        for (int i = 0; i < 64; i++)
+            circle.push_back(mafs::vec3f{ std::cos(0.1f * float(i)) * 2.0f, std::sin(0.1f * float(i)) * 2.0f, 5.0f });
+        const mafs::spheref c = mafs::minimal_sphere(std::span<const mafs::vec3f>(circle));
+        assert_true(contains_all(c, circle) && std::abs(c.radius - float(brute_force_radius(circle))) < 1e-4f, "cocircular points");
+    }
+
+    void test_batched() {
+        std::mt19937 rng(62);
+        std::vector<mafs::vec3f> points;
+        std::vector<uint32_t> offsets{ 0 };
+        for (int m = 0; m < 700; m++) {
+            const std::vector<mafs::vec3f> meshlet = random_points(m % 5 == 0 ? 3 : 64, rng, float(m % 40));
+            points.insert(points.end(), meshlet.begin(), meshlet.end());
+            offsets.push_back(uint32_t(points.size()));
+        }
+        offsets.push_back(offsets.back());
+        const size_t count = offsets.size() - 1;
+        bool same = true;
+        for (mafs::sphere_fit fit : { mafs::sphere_fit::ritter, mafs::sphere_fit::minimal })
+            for (size_t threads : { 1, 3 }) {
+                std::vector<mafs::spheref> spheres(count);
+                mafs::bounding_spheres(std::span<const mafs::vec3f>(points), std::span<const uint32_t>(offsets), std::span<mafs::spheref>(spheres), fit, threads);
+                for (size_t i = 0; i < count; i++) {
+                    const std::span<const mafs::vec3f> range(points.data() + offsets[i], offsets[i + 1] - offsets[i]);
+                    const mafs::spheref expect = fit == mafs::sphere_fit::ritter ? mafs::ritter_sphere(range) : mafs::minimal_sphere(range);
+                    same = same && spheres[i].center == expect.center && spheres[i].radius == expect.radius;
+                }
+            }
+        assert_true(same, "batched spheres match single calls");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing bounding spheres..." << std::endl;
+    mafs::test::test_single();
+
+    std::cout << "\nTesting degenerate point sets..." << std::endl;
+    mafs::test::test_degenerate();
+
+    std::cout << "\nTesting batched bounding spheres..." << std::endl;
+    mafs::test::test_batched();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
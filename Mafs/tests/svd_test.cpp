@@ -0,0 +1,149 @@
+#include "../include/mafs/svd.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-5)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T>
+    bool approx_equal(const mafs::mat<T, 3, 3>& a, const mafs::mat<T, 3, 3>& b, T eps = T(1e-5)) {
+        for (size_t c = 0; c < 3; c++)
+            for (size_t r = 0; r < 3; r++)
+                if (!approx_equal(a(r, c), b(r, c), eps)) return false;
+        return true;
+    }
+
+    template<typename T>
+    T determinant(const mafs::mat<T, 3, 3>& m) {
+        return m[0].dot(m[1].cross(m[2]));
+    }
+
+    template<typename T>
+    bool is_rotation(const mafs::mat<T, 3, 3>& m, T eps = T(1e-5)) {
+        return approx_equal(m.transpose() * m, mafs::mat<T, 3, 3>::identity(), eps) && approx_equal(determinant(m), T(1), eps);
+    }
+
+    mafs::mat3f random_mat(std::mt19937& rng) {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        mafs::mat3f m;
+        for (size_t c = 0; c < 3; c++)
+            for (size_t r = 0; r < 3; r++)
+                m(r, c) = dist(rng);
+        return m;
+    }
+
+    template<typename T>
+    mafs::mat<T, 3, 3> reconstruct(const mafs::svd_result<T>& d) {
+        mafs::mat<T, 3, 3> us = d.u;
+        for (size_t c = 0; c < 3; c++)
+            us[c] *= d.sigma[c];
+        return us * d.v.transpose();
+    }
+
+    void test_svd() {
+        std::mt19937 rng(5);
+        mafs::mat3f a = random_mat(rng);
+        mafs::svd_result<float> d = mafs::svd(a);
+        assert_true(approx_equal(reconstruct(d), a), "svd reconstructs A");
+        assert_true(is_rotation(d.u) && is_rotation(d.v), "svd U and V are rotations");
+        assert_true(std::abs(d.sigma[0]) >= std::abs(d.sigma[1]) && std::abs(d.sigma[1]) >= std::abs(d.sigma[2]), "svd sigma sorted");
+        assert_true((d.sigma[2] < 0.0f) == (determinant(a) < 0.0f), "svd sigma[2] carries det sign");
+
+        mafs::mat3f diag(0.0f);
+        diag(0, 0) = 1.0f; diag(1, 1) = 3.0f; diag(2, 2) = 2.0f;
+        mafs::svd_result<float> dd = mafs::svd(diag);
+        assert_true(approx_equal(dd.sigma[0], 3.0f) && approx_equal(dd.sigma[1], 2.0f) && approx_equal(dd.sigma[2], 1.0f), "svd of diagonal matrix");
+
+        mafs::mat3f rank1{ {1.0f, 2.0f, 3.0f}, {2.0f, 4.0f, 6.0f}, {-1.0f, -2.0f, -3.0f} };
+        mafs::svd_result<float> dr = mafs::svd(rank1);
+        assert_true(approx_equal(reconstruct(dr), rank1, 1e-4f) && approx_equal(dr.sigma[1], 0.0f, 1e-3f), "svd of rank-1 matrix");
+
+        mafs::svd_result<float> dz = mafs::svd(mafs::mat3f());
+        assert_true(is_rotation(dz.u) && approx_equal(dz.sigma[0], 0.0f), "svd of zero matrix");
+    }
+
+    void test_polar() {
+        std::mt19937 rng(6);
+        mafs::mat3f a = random_mat(rng);
+        mafs::polar_result<float> p = mafs::polar(a);
+        assert_true(is_rotation(p.r), "polar R is a rotation");
+        assert_true(approx_equal(p.s, p.s.transpose()), "polar S is symmetric");
+        assert_true(approx_equal(p.r * p.s, a), "polar R * S == A");
+    }
+
+    void test_eigen() {
+        mafs::mat3d s{ {4.0, 1.0, 0.5}, {1.0, 3.0, 0.2}, {0.5, 0.2, 1.0} };
+        mafs::eigen_result<double> e = mafs::eigen_symmetric(s);
+        bool ok = e.values[0] >= e.values[1] && e.values[1] >= e.values[2];
+        for (size_t i = 0; i < 3; i++) {
+            mafs::vec3d av = s * e.vectors[i];
+            mafs::vec3d lv = e.vectors[i] * e.values[i];
+            ok = ok && approx_equal(av.x, lv.x, 1e-12) && approx_equal(av.y, lv.y, 1e-12) && approx_equal(av.z, lv.z, 1e-12);
+        }
+        assert_true(ok, "eigen_symmetric A v = lambda v");
+        assert_true(approx_equal(e.values[0] + e.values[1] + e.values[2], 8.0, 1e-12), "eigen_symmetric trace");
+    }
+
+    void test_batches() {
+        std::mt19937 rng(7);
+        const size_t count = 21;
+        std::vector<mafs::mat3f> a(count), sym(count);
+        for (size_t i = 0; i < count; i++) {
+            a[i] = random_mat(rng);
+            sym[i] = a[i].transpose() * a[i];
+        }
+        std::vector<mafs::svd_result<float>> svds(count);
+        std::vector<mafs::polar_result<float>> polars(count);
+        std::vector<mafs::eigen_result<float>> eigens(count);
+        mafs::svd_batch(std::span<const mafs::mat3f>(a), std::span(svds));
+        mafs::polar_batch(std::span<const mafs::mat3f>(a), std::span(polars));
+        mafs::eigen_symmetric_batch(std::span<const mafs::mat3f>(sym), std::span(eigens));
+
+        bool svd_ok = true, polar_ok = true, eigen_ok = true;
+        for (size_t i = 0; i < count; i++) {
+            mafs::svd_result<float> d = mafs::svd(a[i]);
+            svd_ok = svd_ok && approx_equal(svds[i].sigma[0], d.sigma[0]) && approx_equal(svds[i].sigma[2], d.sigma[2]) && approx_equal(reconstruct(svds[i]), a[i]);
+            polar_ok = polar_ok && approx_equal(polars[i].r * polars[i].s, a[i]);
+            eigen_ok = eigen_ok && approx_equal(eigens[i].values[0], mafs::eigen_symmetric(sym[i]).values[0], 1e-4f);
+        }
+        assert_true(svd_ok, "svd_batch matches svd");
+        assert_true(polar_ok, "polar_batch R * S == A");
+        assert_true(eigen_ok, "eigen_symmetric_batch matches eigen_symmetric");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing svd..." << std::endl;
+    mafs::test::test_svd();
+
+    std::cout << "\nTesting polar..." << std::endl;
+    mafs::test::test_polar();
+
+    std::cout << "\nTesting eigen_symmetric..." << std::endl;
+    mafs::test::test_eigen();
+
+    std::cout << "\nTesting batched decompositions..." << std::endl;
+    mafs::test::test_batches();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
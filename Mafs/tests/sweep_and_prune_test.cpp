@@ -0,0 +1,171 @@
+#include "../include/mafs/sweep_and_prune.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    using pair_set = std::set<mafs::sweep_and_prunef::pair>;
+
+    pair_set brute_force(const std::vector<mafs::aabb3f>& boxes, const std::vector<bool>& alive) {
+        pair_set res;
+        for (uint32_t i = 0; i < boxes.size(); i++)
+            for (uint32_t j = i + 1; j < boxes.size(); j++)
+                if (alive[i] && alive[j] && boxes[i].overlaps(boxes[j]))
+                    res.insert({ i, j });
+        return res;
+    }
+
+    pair_set current_pairs(const mafs::sweep_and_prunef& sap) {
+        pair_set res;
+        sap.for_each_pair([&](const mafs::sweep_and_prunef::pair& p) { res.insert(p); });
+        return res;
+    }
+
+    // Applies the deltas to the previous set; false if one of them is not a change.
+    bool apply_deltas(pair_set& pairs, const mafs::sweep_and_prunef& sap) {
+        for (const auto& p : sap.removed)
+            if (pairs.erase(p) != 1)
+                return false;
+        for (const auto& p : sap.added)
+            if (!pairs.insert(p).second)
+                return false;
+        return std::is_sorted(sap.added.begin(), sap.added.end()) && std::is_sorted(sap.removed.begin(), sap.removed.end());
+    }
+
+    void test_touching() {
+        mafs::sweep_and_prunef sap;
+        const uint32_t a = sap.insert(mafs::aabb3f(mafs::vec3f{ 0.0f, 0.0f, 0.0f }, mafs::vec3f{ 1.0f, 1.0f, 1.0f }));
+        const uint32_t b = sap.insert(mafs::aabb3f(mafs::vec3f{ 1.0f, 0.0f, 0.0f }, mafs::vec3f{ 2.0f, 1.0f, 1.0f }));
+        const uint32_t c = sap.insert(mafs::aabb3f(mafs::vec3f{ 0.0f, 1.5f, 0.0f }, mafs::vec3f{ 2.0f, 2.0f, 1.0f }));
+        sap.update();
+        assert_true(sap.pair_count() == 1 && sap.overlapping(a, b) && sap.added.size() == 1 && sap.removed.empty(), "touching boxes overlap");
+
+        // c drops onto both; b leaves a, then comes back within one update.
+        sap.move(c, mafs::aabb3f(mafs::vec3f{ 0.0f, 0.5f, 0.0f }, mafs::vec3f{ 2.0f, 1.0f, 1.0f }));
+        sap.move(b, mafs::aabb3f(mafs::vec3f{ 1.5f, 0.0f, 0.0f }, mafs::vec3f{ 2.5f, 1.0f, 1.0f }));
+        sap.update();
+        assert_true(sap.pair_count() == 2 && !sap.overlapping(a, b) && sap.added.size() == 2 && sap.removed.size() == 1, "deltas of a move");
+        sap.move(b, mafs::aabb3f(mafs::vec3f{ 5.0f, 0.0f, 0.0f }, mafs::vec3f{ 6.0f, 1.0f, 1.0f }));
+        sap.move(b, mafs::aabb3f(mafs::vec3f{ 1.5f, 0.0f, 0.0f }, mafs::vec3f{ 2.5f, 1.0f, 1.0f }));
+        sap.update();
+        assert_true(sap.added.empty() && sap.removed.empty(), "no deltas when nothing changes");
+        sap.remove(a);
+        sap.update();
+        assert_true(sap.size() == 2 && sap.pair_count() == 1 && sap.removed.size() == 1 && sap.removed[0].a == a, "removing a body removes its pairs");
+    }
+
+    // A body removed in the frame it was inserted: its handle is reused only after update().
+    void test_remove_before_update() {
+        mafs::sweep_and_prunef sap;
+        const mafs::aabb3f box(mafs::vec3f(0.0f), mafs::vec3f(1.0f));
+        const uint32_t a = sap.insert(box);
+        sap.remove(a);
+        assert_true(sap.size() == 0, "a body removed before update is not counted");
+        const uint32_t b = sap.insert(box);
+        sap.update();
+        assert_true(a != b && sap.size() == 1 && sap.pair_count() == 0 && sap.added.empty() && !sap.overlapping(b, b), "no self-pair from a reinserted handle");
+        const uint32_t c = sap.insert(box);
+        sap.update();
+        assert_true(c == a && sap.size() == 2 && sap.pair_count() == 1 && sap.overlapping(b, c), "handle recycled by update");
+    }
+
+    // Random frames of small moves, teleports, insertions and removals against brute force.
+    void test_random_frames() {
+        std::mt19937 rng(91);
+        std::uniform_real_distribution<float> pos(0.0f, 20.0f), size(0.2f, 3.0f), step(-0.3f, 0.3f), coin(0.0f, 1.0f);
+        auto random_box = [&] {
+            const mafs::vec3f lo{ pos(rng), pos(rng), pos(rng) };
+            return mafs::aabb3f(lo, lo + mafs::vec3f{ size(rng), size(rng), size(rng) });
+        };
+        std::vector<mafs::aabb3f> boxes;
+        std::vector<bool> alive;
+        mafs::sweep_and_prunef sap;
+        auto add = [&] {
+            const mafs::aabb3f b = random_box();
+            const uint32_t h = sap.insert(b);
+            if (h >= boxes.size()) {
+                boxes.resize(h + 1);
+                alive.resize(h + 1);
+            }
+            boxes[h] = b;
+            alive[h] = true;
+        };
+        for (int i = 0; i < 300; i++)
+            add();
+
+        pair_set pairs;
+        bool exact = true, deltas = true;
+        for (int frame = 0; frame < 60; frame++) {
+            sap.update();
+            deltas = deltas && apply_deltas(pairs, sap);
+            exact = exact && pairs == brute_force(boxes, alive) && pairs == current_pairs(sap) && sap.pair_count() == pairs.size();
+
+            // Most bodies move on odd frames, which resorts whole axes; few on even frames.
+            const float moving = frame % 2 ? 0.5f : 0.05f;
+            for (uint32_t h = 0; h < boxes.size(); h++) {
+                if (!alive[h])
+                    continue;
+                const float r = coin(rng);
+                if (r < moving) {
+                    const mafs::vec3f d{ step(rng), step(rng), step(rng) };
+                    boxes[h] = mafs::aabb3f(boxes[h].min + d, boxes[h].max + d);
+                    sap.move(h, boxes[h]);
+                }
+                else if (r < moving + 0.02f) {
+                    boxes[h] = random_box();
+                    sap.move(h, boxes[h]);
+                }
+                else if (r < moving + 0.04f) {
+                    sap.remove(h);
+                    alive[h] = false;
+                }
+            }
+            // A few insertions each frame, and a burst that goes through the full sort.
+            const int insertions = frame == 30 ? 100 : int(coin(rng) * 6.0f);
+            for (int i = 0; i < insertions; i++)
+                add();
+        }
+        assert_true(exact, "pairs match brute force every frame");
+        assert_true(deltas, "deltas turn one frame's pairs into the next");
+    }
+
+    void test_double() {
+        mafs::sweep_and_pruned sap;
+        std::vector<uint32_t> h;
+        for (int i = 0; i < 10; i++)
+            h.push_back(sap.insert(mafs::aabb3d(mafs::vec3d{ double(i), 0.0, 0.0 }, mafs::vec3d{ double(i) + 2.0, 1.0, 1.0 })));
+        sap.update();
+        assert_true(sap.pair_count() == 17, "chain of boxes in double");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing touching boxes and deltas..." << std::endl;
+    mafs::test::test_touching();
+    mafs::test::test_remove_before_update();
+
+    std::cout << "\nTesting random frames..." << std::endl;
+    mafs::test::test_random_frames();
+
+    std::cout << "\nTesting double precision..." << std::endl;
+    mafs::test::test_double();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "../include/mafs/transform.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-5)) {
+        return std::abs(a - b) < eps;
+    }
+
+    template<typename T, size_t N>
+    bool approx_equal(const mafs::vec<T, N>& a, const mafs::vec<T, N>& b, T eps = T(1e-5)) {
+        for (size_t i = 0; i < N; i++)
+            if (!approx_equal(a[i], b[i], eps)) return false;
+        return true;
+    }
+
+    template<typename T, size_t R, size_t C>
+    bool approx_equal(const mafs::mat<T, R, C>& a, const mafs::mat<T, R, C>& b, T eps = T(1e-5)) {
+        for (size_t c = 0; c < C; c++)
+            if (!approx_equal(a[c], b[c], eps)) return false;
+        return true;
+    }
+
+    // q and -q are the same rotation.
+    bool same_rotation(const mafs::quatf& a, const mafs::quatf& b) {
+        return approx_equal(std::abs(a.dot(b)), 1.0f);
+    }
+
+    mafs::mat4 reference_trs(const mafs::vec3f& t, const mafs::quatf& r, const mafs::vec3f& s) {
+        mafs::mat4 tm = mafs::mat4::identity();
+        tm[3] = mafs::vec4f{ t.x, t.y, t.z, 1.0f };
+        mafs::mat3f r3 = r.to_mat3();
+        mafs::mat4 rm = mafs::mat4::identity();
+        for (size_t c = 0; c < 3; c++)
+            rm[c] = mafs::vec4f{ r3[c].x, r3[c].y, r3[c].z, 0.0f };
+        mafs::mat4 sm(1.0f);
+        sm(0, 0) = s.x; sm(1, 1) = s.y; sm(2, 2) = s.z;
+        return tm * rm * sm;
+    }
+
+    void test_quat_basis() {
+        mafs::quatf r = mafs::quatf::from_axis_angle(mafs::vec3f{ 0.0f, 0.0f, 1.0f }, 1.5707963f);
+        mafs::vec3f x = r.to_mat3() * mafs::vec3f{ 1.0f, 0.0f, 0.0f };
+        assert_true(approx_equal(x, mafs::vec3f{ 0.0f, 1.0f, 0.0f }), "quat to_mat3 rotates x to y");
+
+        const mafs::vec3f axes[] = { {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, mafs::vec3f{ 1.0f, 2.0f, -1.0f }.normalize() };
+        const float angles[] = { 0.3f, 2.0f, 3.1f, -2.9f };
+        bool ok = true;
+        for (const auto& axis : axes)
+            for (float angle : angles) {
+                mafs::quatf q = mafs::quatf::from_axis_angle(axis, angle);
+                ok = ok && same_rotation(mafs::quatf::from_mat3(q.to_mat3()), q);
+            }
+        assert_true(ok, "quat from_mat3 inverts to_mat3 on every branch");
+    }
+
+    void test_compose() {
+        mafs::vec3f t{ 1.0f, -2.0f, 3.0f };
+        mafs::quatf r = mafs::quatf::from_axis_angle(mafs::vec3f{ 1.0f, 1.0f, 0.0f }.normalize(), 0.8f);
+        mafs::vec3f s{ 2.0f, 0.5f, 1.5f };
+        assert_true(approx_equal(mafs::compose_trs(t, r, s), reference_trs(t, r, s)), "compose_trs == T * R * S");
+
+        mafs::trs<float> id;
+        assert_true(approx_equal(mafs::compose_trs(id), mafs::mat4::identity()), "default trs is identity");
+    }
+
+    void test_decompose() {
+        mafs::vec3f t{ 4.0f, 0.5f, -1.0f };
+        mafs::quatf r = mafs::quatf::from_axis_angle(mafs::vec3f{ 0.0f, 1.0f, 1.0f }.normalize(), 2.4f);
+        mafs::vec3f s{ 3.0f, 1.0f, 0.25f };
+        mafs::trs<float> d = mafs::decompose_trs(mafs::compose_trs(t, r, s));
+        assert_true(approx_equal(d.translation, t) && approx_equal(d.scale, s) && same_rotation(d.rotation, r), "decompose_trs round trip");
+
+        mafs::vec3f mirrored{ -2.0f, 1.0f, 1.0f };
+        mafs::mat4 m = mafs::compose_trs(t, r, mirrored);
+        mafs::trs<float> dm = mafs::decompose_trs(m);
+        assert_true(dm.scale.x < 0.0f && approx_equal(mafs::compose_trs(dm), m), "decompose_trs keeps reflections in scale");
+    }
+
+    void test_batches() {
+        std::vector<mafs::trs<float>> in(5);
+        for (size_t i = 0; i < in.size(); i++) {
+            in[i].translation = mafs::vec3f{ float(i), 1.0f, -float(i) };
+            in[i].rotation = mafs::quatf::from_axis_angle(mafs::vec3f{ 0.0f, 1.0f, 0.0f }, 0.4f * float(i));
+            in[i].scale = mafs::vec3f{ 1.0f + float(i), 1.0f, 2.0f };
+        }
+        std::vector<mafs::mat4> mats(in.size());
+        std::vector<mafs::trs<float>> out(in.size());
+        mafs::compose_trs_batch(std::span<const mafs::trs<float>>(in), std::span(mats));
+        mafs::decompose_trs_batch(std::span<const mafs::mat4>(mats), std::span(out));
+        bool ok = true;
+        for (size_t i = 0; i < in.size(); i++)
+            ok = ok && approx_equal(out[i].translation, in[i].translation) && approx_equal(out[i].scale, in[i].scale) && same_rotation(out[i].rotation, in[i].rotation);
+        assert_true(ok, "compose_trs_batch / decompose_trs_batch round trip");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing quat basis conversion..." << std::endl;
+    mafs::test::test_quat_basis();
+
+    std::cout << "\nTesting compose_trs..." << std::endl;
+    mafs::test::test_compose();
+
+    std::cout << "\nTesting decompose_trs..." << std::endl;
+    mafs::test::test_decompose();
+
+    std::cout << "\nTesting batched TRS..." << std::endl;
+    mafs::test::test_batches();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
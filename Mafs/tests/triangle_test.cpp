@@ -0,0 +1,218 @@
+#include "../include/mafs/triangle.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    template<typename T>
+    bool approx_equal(T a, T b, T eps = T(1e-4)) {
+        return std::abs(a - b) < eps;
+    }
+
+    bool same_hit(const mafs::triangle_hit<float>& a, const mafs::triangle_hit<float>& b, float eps = 1e-4f) {
+        return approx_equal(a.t, b.t, eps) && approx_equal(a.u, b.u, eps) && approx_equal(a.v, b.v, eps);
+    }
+
+    struct scene {
+        std::vector<mafs::vec3f> a, b, c;
+        std::vector<mafs::rayf> rays;
+    };
+
+    scene make_scene(size_t triangles, size_t rays) {
+        scene s;
+        std::mt19937 rng(4);
+        std::uniform_real_distribution<float> pos(-2.0f, 2.0f), offset(-1.5f, 1.5f), dir(-1.0f, 1.0f);
+        for (size_t i = 0; i < triangles; i++) {
+            const mafs::vec3f c{ pos(rng), pos(rng), pos(rng) };
+            s.a.push_back(c + mafs::vec3f{ offset(rng), offset(rng), offset(rng) });
+            s.b.push_back(c + mafs::vec3f{ offset(rng), offset(rng), offset(rng) });
+            s.c.push_back(c + mafs::vec3f{ offset(rng), offset(rng), offset(rng) });
+        }
+        for (size_t i = 0; i < rays; i++)
+            s.rays.emplace_back(mafs::vec3f{ pos(rng), pos(rng), pos(rng) } * 2.0f, mafs::vec3f{ dir(rng), dir(rng), dir(rng) });
+        s.rays.emplace_back(mafs::vec3f{ 0.1f, 5.0f, 0.2f }, mafs::vec3f{ 0.0f, -1.0f, 0.0f });
+        s.rays.emplace_back(mafs::vec3f{ 0.1f, 0.3f, -5.0f }, mafs::vec3f{ 0.0f, 0.0f, 2.0f });
+        return s;
+    }
+
+    void test_scalar() {
+        const mafs::vec3f v0{ 0.0f, 0.0f, 0.0f }, v1{ 1.0f, 0.0f, 0.0f }, v2{ 0.0f, 1.0f, 0.0f };
+        const mafs::rayf down(mafs::vec3f{ 0.25f, 0.5f, 2.0f }, mafs::vec3f{ 0.0f, 0.0f, -2.0f });
+        mafs::triangle_hit<float> mt, wt;
+        const bool hit_mt = mafs::intersect_triangle(down, v0, v1, v2, 10.0f, mt);
+        const bool hit_wt = mafs::intersect_triangle_watertight(down, v0, v1, v2, 10.0f, wt);
+        assert_true(hit_mt && hit_wt && same_hit(mt, mafs::triangle_hit<float>{ 1.0f, 0.25f, 0.5f }) && same_hit(mt, wt), "known hit");
+        assert_true(!mafs::intersect_triangle(down, v0, v1, v2, 1.0f, mt) && !mafs::intersect_triangle_watertight(down, v0, v1, v2, 1.0f, wt), "t_max is exclusive");
+        const mafs::rayf up(mafs::vec3f{ 0.25f, 0.5f, 2.0f }, mafs::vec3f{ 0.0f, 0.0f, 1.0f });
+        assert_true(!mafs::intersect_triangle(up, v0, v1, v2, 10.0f, mt) && !mafs::intersect_triangle_watertight(up, v0, v1, v2, 10.0f, wt), "behind the origin");
+        const mafs::rayf flat(mafs::vec3f{ -1.0f, 0.2f, 0.0f }, mafs::vec3f{ 1.0f, 0.0f, 0.0f });
+        assert_true(!mafs::intersect_triangle(flat, v0, v1, v2, 10.0f, mt) && !mafs::intersect_triangle_watertight(flat, v0, v1, v2, 10.0f, wt), "ray in the plane");
+        const mafs::rayf back(mafs::vec3f{ 0.25f, 0.25f, -1.0f }, mafs::vec3f{ 0.0f, 0.0f, 1.0f });
+        assert_true(mafs::intersect_triangle_watertight(back, v0, v1, v2, 10.0f, wt) && same_hit(wt, mafs::triangle_hit<float>{ 1.0f, 0.25f, 0.25f }), "back face");
+
+        const scene s = make_scene(200, 200);
+        size_t hits = 0;
+        bool agree = true;
+        for (const mafs::rayf& r : s.rays)
+            for (size_t i = 0; i < s.a.size(); i++) {
+                const bool h0 = mafs::intersect_triangle(r, s.a[i], s.b[i], s.c[i], 100.0f, mt);
+                const bool h1 = mafs::intersect_triangle_watertight(r, s.a[i], s.b[i], s.c[i], 100.0f, wt);
+                // Rays grazing an edge may go either way.
+                if (h0 && h1)
+                    agree = agree && same_hit(mt, wt, 1e-3f);
+                else if (h0 != h1) {
+                    const mafs::triangle_hit<float>& h = h0 ? mt : wt;
+                    agree = agree && (h.u < 1e-4f || h.v < 1e-4f || h.u + h.v > 1.0f - 1e-4f);
+                }
+                hits += h1;
+            }
+        assert_true(agree && hits > 100, "watertight matches Moller-Trumbore away from edges");
+    }
+
+    // A jittered grid of triangles with rays aimed exactly at points on the shared edges and
+    // vertices. Every ray lands inside the mesh, so the watertight test must never miss.
+    void test_watertight() {
+        constexpr uint32_t n = 8;
+        std::mt19937 rng(8);
+        std::uniform_real_distribution<float> jitter(-0.3f, 0.3f), unit(0.0f, 1.0f), dir(-0.6f, 0.6f);
+        std::vector<mafs::vec3f> grid;
+        for (uint32_t y = 0; y <= n; y++)
+            for (uint32_t x = 0; x <= n; x++) {
+                const bool border = x == 0 || y == 0 || x == n || y == n;
+                grid.push_back(mafs::vec3f{ float(x) + (border ? 0.0f : jitter(rng)), float(y) + (border ? 0.0f : jitter(rng)), jitter(rng) * 0.5f });
+            }
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y < n; y++)
+            for (uint32_t x = 0; x < n; x++) {
+                const uint32_t i = y * (n + 1) + x;
+                indices.insert(indices.end(), { i, i + 1, i + n + 2, i, i + n + 2, i + n + 1 });
+            }
+
+        size_t holes_mt = 0, holes_wt = 0, holes_packet = 0;
+        const auto packets = mafs::pack_triangles<8>(std::span<const mafs::vec3f>(grid), std::span<const uint32_t>(indices));
+        for (int k = 0; k < 5000; k++) {
+            // A point on a random interior edge, or a vertex, shot at from a random direction.
+            const uint32_t x = 1 + rng() % (n - 2), y = 1 + rng() % (n - 2);
+            const uint32_t i = y * (n + 1) + x;
+            const uint32_t ends[3] = { i + 1, i + n + 1, i + n + 2 };
+            const float f = k % 10 == 0 ? 0.0f : unit(rng);
+            const mafs::vec3f target = grid[i] + (grid[ends[rng() % 3]] - grid[i]) * f;
+            const mafs::vec3f d{ dir(rng), dir(rng), -1.0f };
+            const mafs::rayf r(target - d * 3.0f, d);
+
+            bool hit_mt = false, hit_wt = false;
+            mafs::triangle_hit<float> h;
+            for (size_t t = 0; t < indices.size() / 3; t++) {
+                hit_mt = hit_mt || mafs::intersect_triangle(r, grid[indices[3 * t]], grid[indices[3 * t + 1]], grid[indices[3 * t + 2]], 100.0f, h);
+                hit_wt = hit_wt || mafs::intersect_triangle_watertight(r, grid[indices[3 * t]], grid[indices[3 * t + 1]], grid[indices[3 * t + 2]], 100.0f, h);
+            }
+            uint32_t any = 0;
+            mafs::triangle_packet_hit<8> ph;
+            for (const auto& p : packets)
+                any |= mafs::intersect_watertight(p, r, 100.0f, ph);
+            holes_mt += !hit_mt;
+            holes_wt += !hit_wt;
+            holes_packet += any == 0;
+        }
+        std::cout << "  Moller-Trumbore missed " << holes_mt << " of 5000 edge rays" << std::endl;
+        assert_true(holes_wt == 0, "watertight never misses a shared edge");
+        assert_true(holes_packet == 0, "watertight packets never miss a shared edge");
+    }
+
+    template<size_t W>
+    void check_packets(const std::string& name) {
+        const scene s = make_scene(W * 40 + 3, 200);
+        std::vector<mafs::vec3f> positions;
+        std::vector<uint32_t> indices;
+        for (size_t i = 0; i < s.a.size(); i++) {
+            indices.insert(indices.end(), { uint32_t(positions.size()), uint32_t(positions.size() + 1), uint32_t(positions.size() + 2) });
+            positions.insert(positions.end(), { s.a[i], s.b[i], s.c[i] });
+        }
+        const auto packets = mafs::pack_triangles<W>(std::span<const mafs::vec3f>(positions), std::span<const uint32_t>(indices));
+
+        // One ray against W triangles.
+        bool match = true, match_wt = true;
+        size_t hits = 0;
+        for (const mafs::rayf& r : s.rays)
+            for (size_t p = 0; p < packets.size(); p++) {
+                mafs::triangle_packet_hit<W> ph;
+                const uint32_t mask = mafs::intersect(packets[p], r, 3.0f, ph);
+                mafs::triangle_packet_hit<W> pw;
+                const uint32_t mask_wt = mafs::intersect_watertight(packets[p], r, 3.0f, pw);
+                for (size_t l = 0; l < W; l++) {
+                    const size_t i = p * W + l;
+                    mafs::triangle_hit<float> h;
+                    const bool expect = i < s.a.size() && mafs::intersect_triangle(r, s.a[i], s.b[i], s.c[i], 3.0f, h);
+                    const bool got = (mask >> l) & 1u;
+                    match = match && (got == expect) && (!got || same_hit(h, mafs::triangle_hit<float>{ ph.t[l], ph.u[l], ph.v[l] }));
+                    const bool expect_wt = i < s.a.size() && mafs::intersect_triangle_watertight(r, s.a[i], s.b[i], s.c[i], 3.0f, h);
+                    const bool got_wt = (mask_wt >> l) & 1u;
+                    match_wt = match_wt && (got_wt == expect_wt) && (!got_wt || same_hit(h, mafs::triangle_hit<float>{ pw.t[l], pw.u[l], pw.v[l] }));
+                    hits += got;
+                }
+            }
+        assert_true(match && hits > 50, name + " one ray, W triangles");
+        assert_true(match_wt, name + " one ray, W triangles, watertight");
+
+        // W rays against one triangle, with their own t_max.
+        match = match_wt = true;
+        hits = 0;
+        for (size_t first = 0; first < s.rays.size(); first += W) {
+            mafs::ray_packet<W> rays;
+            mafs::vec<float, W> t_max(100.0f);
+            for (size_t l = 0; l < W && first + l < s.rays.size(); l++) {
+                rays.set(l, s.rays[first + l]);
+                t_max[l] = 1.0f + float(l);
+            }
+            for (size_t i = 0; i < s.a.size(); i++) {
+                mafs::triangle_packet_hit<W> ph, pw;
+                const uint32_t mask = mafs::intersect(rays, s.a[i], s.b[i], s.c[i], t_max, ph);
+                const uint32_t mask_wt = mafs::intersect_watertight(rays, s.a[i], s.b[i], s.c[i], t_max, pw);
+                for (size_t l = 0; l < W; l++) {
+                    mafs::triangle_hit<float> h;
+                    const bool valid = first + l < s.rays.size();
+                    const bool expect = valid && mafs::intersect_triangle(s.rays[first + l], s.a[i], s.b[i], s.c[i], t_max[l], h);
+                    const bool got = (mask >> l) & 1u;
+                    match = match && (got == expect) && (!got || same_hit(h, mafs::triangle_hit<float>{ ph.t[l], ph.u[l], ph.v[l] }));
+                    const bool expect_wt = valid && mafs::intersect_triangle_watertight(s.rays[first + l], s.a[i], s.b[i], s.c[i], t_max[l], h);
+                    const bool got_wt = (mask_wt >> l) & 1u;
+                    match_wt = match_wt && (got_wt == expect_wt) && (!got_wt || same_hit(h, mafs::triangle_hit<float>{ pw.t[l], pw.u[l], pw.v[l] }));
+                    hits += got;
+                }
+            }
+        }
+        assert_true(match && hits > 50, name + " W rays, one triangle");
+        assert_true(match_wt, name + " W rays, one triangle, watertight");
+        assert_true(mafs::ray_packet<W>().get(0).direction == mafs::vec3f(0.0f), name + " unset lanes");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing scalar ray/triangle tests..." << std::endl;
+    mafs::test::test_scalar();
+
+    std::cout << "\nTesting watertightness..." << std::endl;
+    mafs::test::test_watertight();
+
+    std::cout << "\nTesting packet tests..." << std::endl;
+    mafs::test::check_packets<4>("W = 4");
+    mafs::test::check_packets<8>("W = 8");
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
@@ -412,6 +412,41 @@ namespace mafs::test {
         std::cout << vektor;
     }
 
+    void test_vec_componentwise() {
+        mafs::vec<float, 3> a{ 1.0f, -2.0f, 3.0f };
+        mafs::vec<float, 3> b{ 2.0f, 4.0f, -1.0f };
+        mafs::vec<float, 3> prod = a * b;
+        assert_true(approx_equal(prod.x, 2.0f) && approx_equal(prod.y, -8.0f) && approx_equal(prod.z, -3.0f), "vec<float, 3> component-wise product");
+
+        mafs::vec<float, 3> quot = a / b;
+        assert_true(approx_equal(quot.x, 0.5f) && approx_equal(quot.y, -0.5f) && approx_equal(quot.z, -3.0f), "vec<float, 3> component-wise quotient");
+
+        assert_true(mafs::min(a, b) == mafs::vec<float, 3>{1.0f, -2.0f, -1.0f}, "vec<float, 3> min");
+        assert_true(mafs::max(a, b) == mafs::vec<float, 3>{2.0f, 4.0f, 3.0f}, "vec<float, 3> max");
+        assert_true(mafs::abs(a) == mafs::vec<float, 3>{1.0f, 2.0f, 3.0f}, "vec<float, 3> abs");
+
+        mafs::vec<float, 8> lanes(4.0f);
+        lanes[5] = 9.0f;
+        mafs::vec<float, 8> roots = mafs::sqrt(lanes);
+        assert_true(approx_equal(roots[0], 2.0f) && approx_equal(roots[5], 3.0f), "vec<float, 8> sqrt");
+
+        mafs::vec<bool, 8> mask = mafs::less_than(lanes, mafs::vec<float, 8>(5.0f));
+        mafs::vec<float, 8> picked = mafs::select(mask, lanes, mafs::vec<float, 8>(0.0f));
+        assert_true(approx_equal(picked[0], 4.0f) && approx_equal(picked[5], 0.0f), "vec<float, 8> less_than and select");
+
+        // The SSE path keeps the scalar results: a NaN in b is dropped, a NaN in a is kept.
+        mafs::vec<float, 9> lo(1.0f), hi(2.0f);
+        lo[2] = 3.0f;
+        hi[3] = std::nanf("");
+        mafs::vec<float, 9> mins = mafs::min(lo, hi), maxs = mafs::max(lo, hi);
+        assert_true(mins[0] == 1.0f && mins[2] == 2.0f && mins[3] == 1.0f && mins[8] == 1.0f, "vec<float, 9> min");
+        assert_true(maxs[0] == 2.0f && maxs[2] == 3.0f && maxs[3] == 1.0f && maxs[8] == 2.0f, "vec<float, 9> max");
+        assert_true(std::isnan(mafs::max(hi, lo)[3]) && std::isnan(mafs::min(hi, lo)[3]), "vec<float, 9> min/max NaN order");
+
+        mafs::vec<int, 4> ia{ 1, 2, 3, 4 };
+        assert_true(ia * mafs::vec<int, 4>(2) == mafs::vec<int, 4>{2, 4, 6, 8}, "vec<int, 4> component-wise product");
+    }
+
 } // namespace mafs::test
 
 int main() {
@@ -430,6 +465,9 @@ int main() {
     std::cout << "\nTesting vec<int, 3>..." << std::endl;
     mafs::test::test_vec_int();
 
+    std::cout << "\nTesting component-wise functions..." << std::endl;
+    mafs::test::test_vec_componentwise();
+
     std::cout << "\nTesting edge cases..." << std::endl;
     mafs::test::test_edge_cases();
 
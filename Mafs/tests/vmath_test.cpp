@@ -0,0 +1,132 @@
+#include "../include/mafs/vmath.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    // Distance between two floats in units in the last place.
+    int64_t ulp_distance(float a, float b) {
+        auto ordered = [](float f) {
+            int32_t i = std::bit_cast<int32_t>(f);
+            return i < 0 ? int64_t(INT32_MIN) - i : int64_t(i);
+        };
+        return std::abs(ordered(a) - ordered(b));
+    }
+
+    using packet = mafs::vec<float, 8>;
+
+    // Max ULP error of approx over `count` uniform samples of [lo, hi], against the double reference.
+    int64_t max_ulp(const std::function<packet(const packet&)>& approx, const std::function<double(double)>& reference,
+        float lo, float hi, int count = 1 << 18) {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dist(lo, hi);
+        int64_t worst = 0;
+        for (int i = 0; i < count; i += 8) {
+            packet x;
+            for (size_t k = 0; k < 8; k++)
+                x[k] = dist(rng);
+            packet y = approx(x);
+            for (size_t k = 0; k < 8; k++)
+                worst = std::max(worst, ulp_distance(y[k], float(reference(double(x[k])))));
+        }
+        return worst;
+    }
+
+    template<mafs::precision P>
+    void test_tier(const std::string& name, int64_t trig, int64_t at2, int64_t ac, int64_t ex, int64_t lg, int64_t pw) {
+        using mafs::precision;
+        int64_t e = std::max(
+            max_ulp([](const packet& x) { return mafs::sin<P>(x); }, [](double x) { return std::sin(x); }, -8192.0f, 8192.0f),
+            max_ulp([](const packet& x) { return mafs::cos<P>(x); }, [](double x) { return std::cos(x); }, -8192.0f, 8192.0f));
+        std::cout << name << " sin/cos: " << e << " ulp" << std::endl;
+        assert_true(e <= trig, name + " sin/cos error bound");
+
+        // atan2 on the unit circle scaled by a random radius, so every octant is covered.
+        e = max_ulp([](const packet& t) {
+            packet y, x;
+            for (size_t k = 0; k < 8; k++) { y[k] = std::sin(t[k]) * 3.0f; x[k] = std::cos(t[k]) * 3.0f; }
+            return mafs::atan2<P>(y, x);
+            }, [](double t) { return std::atan2(double(std::sin(float(t)) * 3.0f), double(std::cos(float(t)) * 3.0f)); }, -3.14159f, 3.14159f);
+        std::cout << name << " atan2: " << e << " ulp" << std::endl;
+        assert_true(e <= at2, name + " atan2 error bound");
+
+        e = max_ulp([](const packet& x) { return mafs::acos<P>(x); }, [](double x) { return std::acos(x); }, -1.0f, 1.0f);
+        std::cout << name << " acos: " << e << " ulp" << std::endl;
+        assert_true(e <= ac, name + " acos error bound");
+
+        e = max_ulp([](const packet& x) { return mafs::exp<P>(x); }, [](double x) { return std::exp(x); }, -87.0f, 88.0f);
+        std::cout << name << " exp: " << e << " ulp" << std::endl;
+        assert_true(e <= ex, name + " exp error bound");
+
+        e = std::max(
+            max_ulp([](const packet& x) { return mafs::log<P>(x); }, [](double x) { return std::log(x); }, 1e-6f, 1e6f),
+            max_ulp([](const packet& x) { return mafs::log<P>(x); }, [](double x) { return std::log(x); }, 0.5f, 2.0f));
+        std::cout << name << " log: " << e << " ulp" << std::endl;
+        assert_true(e <= lg, name + " log error bound");
+
+        // Bases in [0.1, 10] and exponents keeping results within [1e-30, 1e30].
+        e = max_ulp([](const packet& t) {
+            packet x, y;
+            for (size_t k = 0; k < 8; k++) { x[k] = 0.1f + std::abs(t[k]) * 9.9f; y[k] = t[k] * 30.0f; }
+            return mafs::pow<P>(x, y);
+            }, [](double t) {
+                float x = 0.1f + std::abs(float(t)) * 9.9f, y = float(t) * 30.0f;
+                return std::pow(double(x), double(y)); }, -1.0f, 1.0f);
+        std::cout << name << " pow: " << e << " ulp" << std::endl;
+        assert_true(e <= pw, name + " pow error bound");
+    }
+
+    void test_special_values() {
+        const float inf = std::numeric_limits<float>::infinity();
+        mafs::vec4f l = mafs::log(mafs::vec4f{ 0.0f, -1.0f, inf, 1e-40f });
+        assert_true(l.x == -inf && std::isnan(l.y) && l.z == inf && std::abs(l.w - std::log(1e-40f)) < 1e-4f, "log special values");
+
+        mafs::vec4f e = mafs::exp(mafs::vec4f{ 100.0f, -200.0f, 0.0f, std::nanf("") });
+        assert_true(e.x == inf && e.y == 0.0f && e.z == 1.0f && std::isnan(e.w), "exp special values");
+
+        mafs::vec4f a = mafs::atan2(mafs::vec4f{ 0.0f, -0.0f, 0.0f, 1.0f }, mafs::vec4f{ -1.0f, -1.0f, 0.0f, 0.0f });
+        assert_true(a.x == std::atan2(0.0f, -1.0f) && a.y == std::atan2(-0.0f, -1.0f) && a.z == 0.0f
+            && std::abs(a.w - 1.5707964f) < 1e-6f, "atan2 signed zeros and axes");
+
+        mafs::vec4f c = mafs::acos(mafs::vec4f{ 1.0f, -1.0f, 0.0f, 2.0f });
+        assert_true(c.x == 0.0f && std::abs(c.y - 3.1415927f) < 1e-6f && std::abs(c.z - 1.5707964f) < 1e-6f && std::isnan(c.w), "acos special values");
+
+        mafs::vec4f p = mafs::pow(mafs::vec4f{ 0.0f, 0.0f, 2.0f, 4.0f }, mafs::vec4f{ 2.0f, 0.0f, 10.0f, 0.5f });
+        assert_true(p.x == 0.0f && p.y == 1.0f && std::abs(p.z - 1024.0f) < 1e-3f && std::abs(p.w - 2.0f) < 1e-6f, "pow special values");
+
+        constexpr mafs::vec4f cs = mafs::cos(mafs::vec4f(0.0f));
+        static_assert(cs.x == 1.0f, "cos is usable in constant expressions");
+        assert_true(mafs::cos(mafs::vec4f(0.0f)) == cs, "cos gives the same result at run time");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing accurate tier..." << std::endl;
+    mafs::test::test_tier<mafs::precision::accurate>("accurate", 2, 4, 2, 1, 2, 128);
+
+    std::cout << "\nTesting fast tier..." << std::endl;
+    mafs::test::test_tier<mafs::precision::fast>("fast", 256, 640, 800, 80, 256, 1280);
+
+    std::cout << "\nTesting special values..." << std::endl;
+    mafs::test::test_special_values();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}
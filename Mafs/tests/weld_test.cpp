@@ -0,0 +1,166 @@
+#include "../include/mafs/weld.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace mafs::test {
+
+    void assert_true(bool condition, const std::string& test_name) {
+        if (condition) {
+            std::cout << "[PASS] " << test_name << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] " << test_name << std::endl;
+            assert(false);
+        }
+    }
+
+    // The welding rule one vertex at a time: join the lowest earlier vertex within tolerance.
+    std::vector<uint32_t> reference_weld(const std::vector<mafs::vec3f>& p, float tolerance) {
+        std::vector<uint32_t> link(p.size()), remap(p.size());
+        uint32_t next = 0;
+        for (uint32_t i = 0; i < p.size(); i++) {
+            link[i] = i;
+            for (uint32_t j = 0; j < i; j++)
+                if ((p[i] - p[j]).length_squared() <= tolerance * tolerance) {
+                    link[i] = j;
+                    break;
+                }
+            remap[i] = link[i] == i ? next++ : remap[link[i]];
+        }
+        return remap;
+    }
+
+    void test_cube() {
+        // Four corners per face, as an exporter writes a cube with flat normals.
+        std::vector<mafs::vec3f> positions, normals;
+        std::vector<uint32_t> indices;
+        for (int axis = 0; axis < 3; axis++)
+            for (float side : { -1.0f, 1.0f }) {
+                mafs::vec3f n(0.0f);
+                n[axis] = side;
+                const uint32_t base = uint32_t(positions.size());
+                for (int k = 0; k < 4; k++) {
+                    mafs::vec3f p = n;
+                    p[(axis + 1) % 3] = k & 1 ? 1.0f : -1.0f;
+                    p[(axis + 2) % 3] = k & 2 ? 1.0f : -1.0f;
+                    positions.push_back(p);
+                    normals.push_back(n);
+                }
+                indices.insert(indices.end(), { base, base + 1, base + 3, base, base + 3, base + 2 });
+            }
+
+        mafs::vertex_weld weld;
+        weld.build(positions, 0.0f);
+        bool corners = weld.size() == 8;
+        std::vector<mafs::vec3f> welded(weld.size());
+        weld.gather<mafs::vec3f>(positions, welded);
+        for (size_t i = 0; i < positions.size(); i++)
+            corners = corners && welded[weld.remap[i]] == positions[i];
+        assert_true(corners, "cube welds to its 8 corners");
+
+        std::vector<uint32_t> remapped = indices;
+        weld.remap_indices(remapped);
+        bool same_triangles = true;
+        for (size_t i = 0; i < indices.size(); i++)
+            same_triangles = same_triangles && welded[remapped[i]] == positions[indices[i]];
+        assert_true(same_triangles, "remapped indices keep the triangles");
+
+        const mafs::weld_attribute flat_normals{ std::span<const float>(&normals[0].x, normals.size() * 3), 3, 0.01f };
+        weld.build(positions, 0.0f, std::span<const mafs::weld_attribute>(&flat_normals, 1));
+        assert_true(weld.size() == 24, "differing normals keep face corners apart");
+    }
+
+    void test_tolerance() {
+        const std::vector<mafs::vec3f> p = {
+            { 0.0f, 0.0f, 0.0f }, { 0.0004f, 0.0f, 0.0f }, { 0.0f, 0.002f, 0.0f }, { 0.0f, 0.0f, -0.0003f }, { 5.0f, 5.0f, 5.0f },
+        };
+        mafs::vertex_weld weld;
+        weld.build(p, 0.001f);
+        assert_true(weld.size() == 3 && weld.remap[1] == 0 && weld.remap[3] == 0 && weld.remap[2] == 1 && weld.unique[1] == 2, "near vertices weld, farther ones stay");
+
+        // Clusters of jittered copies plus loose points, against the one-at-a-time rule.
+        std::mt19937 rng(50);
+        std::uniform_real_distribution<float> pos(-3.0f, 3.0f), jitter(-0.02f, 0.02f);
+        std::vector<mafs::vec3f> points;
+        for (int i = 0; i < 1500; i++) {
+            const mafs::vec3f c{ pos(rng), pos(rng), pos(rng) };
+            for (int k = 0; k < 1 + i % 4; k++)
+                points.push_back(c + mafs::vec3f{ jitter(rng), jitter(rng), jitter(rng) });
+        }
+        std::shuffle(points.begin(), points.end(), rng);
+        bool match = true;
+        for (float tolerance : { 0.01f, 0.05f, 0.2f }) {
+            weld.build(points, tolerance);
+            match = match && weld.remap == reference_weld(points, tolerance);
+        }
+        assert_true(match, "matches welding one vertex at a time");
+
+        // Far from the origin the cells grow so that their coordinates still fit an int.
+        const std::vector<mafs::vec3f> far = {
+            { 3.072e9f, 1.0f, 0.0f }, { -5.0e9f, 2.0e9f, 7.0f }, { 3.072e9f, 1.0f, 0.0f }, { 3.072e9f + 256.0f, 1.0f, 0.0f }, { -5.0e9f, 2.0e9f, 7.0f },
+        };
+        weld.build(far, 0.0f);
+        assert_true(weld.size() == 3 && weld.remap == std::vector<uint32_t>{ 0, 1, 0, 2, 1 }, "equal positions weld far from the origin");
+    }
+
+    void test_threads() {
+        // Enough vertices for the grid to build in several chunks.
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> pos(0.0f, 40.0f), jitter(-1e-5f, 1e-5f);
+        std::vector<mafs::vec3f> points;
+        for (int i = 0; i < 20000; i++) {
+            const mafs::vec3f c{ pos(rng), pos(rng), pos(rng) };
+            for (int k = 0; k < 3; k++)
+                points.push_back(c + mafs::vec3f{ jitter(rng), jitter(rng), jitter(rng) });
+        }
+        mafs::vertex_weld one, many;
+        one.build(points, 1e-4f, {}, 1);
+        many.build(points, 1e-4f, {}, 4);
+        assert_true(one.remap == many.remap && one.unique == many.unique && one.size() == 20000, "result does not depend on threads");
+    }
+
+    void test_hash() {
+        std::unordered_map<mafs::vec3i, int> cells;
+        for (int z = -8; z < 8; z++)
+            for (int y = -8; y < 8; y++)
+                for (int x = -8; x < 8; x++)
+                    cells[mafs::vec3i{ x, y, z }] = x + 100 * y + 10000 * z;
+        bool found = cells.size() == 16 * 16 * 16;
+        for (const auto& [key, value] : cells)
+            found = found && value == key.x + 100 * key.y + 10000 * key.z;
+        assert_true(found && cells.count(mafs::vec3i{ 8, 0, 0 }) == 0, "vec3i keys an unordered_map");
+
+        std::unordered_set<size_t> hashes;
+        const std::hash<mafs::vec4i> hash;
+        for (int a = 0; a < 4; a++)
+            for (int b = 0; b < 4; b++)
+                for (int c = 0; c < 4; c++)
+                    for (int d = 0; d < 4; d++)
+                        hashes.insert(hash(mafs::vec4i{ a, b, c, d }));
+        assert_true(hashes.size() == 256 && std::hash<mafs::vec<int64_t, 2>>{}(mafs::vec<int64_t, 2>{ 1, 2 }) != std::hash<mafs::vec<int64_t, 2>>{}(mafs::vec<int64_t, 2>{ 2, 1 }),
+            "vec4i hashes of permutations differ");
+    }
+
+} // namespace mafs::test
+
+int main() {
+    std::cout << "Testing exact welding..." << std::endl;
+    mafs::test::test_cube();
+
+    std::cout << "\nTesting tolerance..." << std::endl;
+    mafs::test::test_tolerance();
+
+    std::cout << "\nTesting threads..." << std::endl;
+    mafs::test::test_threads();
+
+    std::cout << "\nTesting std::hash..." << std::endl;
+    mafs::test::test_hash();
+
+    std::cout << "\nAll tests completed!" << std::endl;
+    return 0;
+}